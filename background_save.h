@@ -0,0 +1,266 @@
+/***********************************************************************
+ * Header:
+ *    BACKGROUND SAVE
+ * Summary:
+ *    Snapshot a live container without stopping the program that owns
+ *    it. fork() gives a child process a copy-on-write image of the
+ *    whole address space; the child saves the container as it was at
+ *    the fork, while the parent keeps changing its own copy. Only the
+ *    pages the parent writes to are ever duplicated.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        background_save : A forked snapshot and its report
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "snapshot.h"       // for CUSTOM_SNAPSHOT_POSIX
+
+#ifdef CUSTOM_SNAPSHOT_POSIX
+
+#include <cerrno>           // for errno, EINTR
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uint64_t
+#include <cstdio>           // for std::rename
+#include <cstdlib>          // for strtoull
+#include <cstring>          // for strstr
+#include <string>           // for the temporary file name
+#include <fcntl.h>          // for open
+#include <sys/types.h>      // for pid_t
+#include <sys/wait.h>       // for waitpid
+#include <unistd.h>         // for fork, pipe, _exit
+
+class TestBackgroundSave; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************
+    * BACKGROUND SAVE
+    * One forked save at a time:
+    *    background_save bg;
+    *    bg.start(us, "set.snap");   // returns at once
+    *    ... keep using us ...
+    *    bg.wait();                  // true if the file is whole
+    * The child writes and syncs path.tmp, renames it
+    * over path and syncs the directory, so path is
+    * always a complete snapshot, even across a power
+    * loss, and wait() is true only once it is. It
+    * sends back how many bytes it wrote and how much
+    * memory copy-on-write duplicated while it ran:
+    * the pages of its image the parent wrote to, read
+    * from Private_Dirty in /proc/self/smaps_rollup as
+    * Redis does. Elsewhere than Linux that is 0.
+    *
+    * fork() copies only the calling thread, so start()
+    * must be called where no other thread is changing
+    * the container or holds a lock the save needs.
+    ****************************************/
+   class background_save
+   {
+      friend class ::TestBackgroundSave; // give unit tests access to the privates
+   public:
+
+      //
+      // Construct
+      //
+      background_save() : pid(-1), fdResult(-1), gateFd(-1), succeeded(false),
+                          numBytes(0), numCowBytes(0) {}
+      ~background_save() { wait(); }
+      background_save(const background_save&) = delete;
+      background_save& operator = (const background_save&) = delete;
+
+      //
+      // Save
+      //
+      template <class Container>
+      bool start(Container& container, const char* path);
+      bool running();
+      bool wait();
+
+      //
+      // Status
+      //
+      size_t bytes_written() const { return numBytes; }
+      size_t cow_bytes() const { return numCowBytes; }
+
+   private:
+
+      // what the child sends back through the pipe
+      struct report
+      {
+         uint64_t ok;         // 1 if the snapshot is in place
+         uint64_t bytes;      // size of the snapshot
+         uint64_t cowBytes;   // memory duplicated while the child ran
+      };
+
+      static size_t privateDirty();
+      void finish(int status);
+
+      pid_t pid;              // the child, -1 if none is running
+      int fdResult;           // the read end of the report pipe
+      int gateFd;             // for tests, the child waits for a byte here
+      bool succeeded;         // of the last save that finished
+      size_t numBytes;        // written by the last save
+      size_t numCowBytes;     // duplicated during the last save
+   };
+
+   /*****************************************
+    * BACKGROUND SAVE :: START
+    * Fork, and in the child save container to path
+    *     INPUT  : anything with save(int fd), and where
+    *     OUTPUT : true if the child is running
+    ****************************************/
+   template <class Container>
+   bool background_save::start(Container& container, const char* path)
+   {
+      wait();
+
+      int fds[2];
+      if (pipe(fds) != 0)
+         return false;
+      std::string tmp = std::string(path) + ".tmp";
+
+      pid_t child = fork();
+      if (child < 0)
+      {
+         ::close(fds[0]);
+         ::close(fds[1]);
+         return false;
+      }
+
+      if (child == 0)
+      {
+         // the child: nothing here may return to the caller's code
+         ::close(fds[0]);
+         size_t before = privateDirty();
+         if (gateFd >= 0)
+         {
+            char go;
+            while (::read(gateFd, &go, 1) < 0 && errno == EINTR)
+               ;
+         }
+
+         report r = { 0, 0, 0 };
+         int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+         if (fd >= 0)
+         {
+            bool ok = container.save(fd);
+            off_t end = lseek(fd, 0, SEEK_END);
+            ok = ok && snapshot_detail::sync_file(fd);
+            ::close(fd);
+            ok = ok && std::rename(tmp.c_str(), path) == 0;
+            if (!ok)
+               unlink(tmp.c_str());
+
+            // until the directory is synced a power loss can undo the rename
+            ok = ok && snapshot_detail::sync_directory(path);
+            r.ok = ok ? 1 : 0;
+            r.bytes = end > 0 ? (uint64_t)end : 0;
+         }
+         size_t after = privateDirty();
+         r.cowBytes = after > before ? after - before : 0;
+         snapshot_detail::write_all(fds[1], &r, sizeof(r));
+         _exit(r.ok ? 0 : 1);
+      }
+
+      ::close(fds[1]);
+      pid = child;
+      fdResult = fds[0];
+      return true;
+   }
+
+   /*****************************************
+    * BACKGROUND SAVE :: RUNNING
+    * Is the child still saving? Collects its report
+    * if it has just finished.
+    ****************************************/
+   inline bool background_save::running()
+   {
+      if (pid < 0)
+         return false;
+      int status = 0;
+      pid_t done = waitpid(pid, &status, WNOHANG);
+      if (done == 0)
+         return true;
+      finish(done == pid ? status : -1);
+      return false;
+   }
+
+   /*****************************************
+    * BACKGROUND SAVE :: WAIT
+    * Wait for the child to finish
+    *     OUTPUT : true if the last save succeeded
+    ****************************************/
+   inline bool background_save::wait()
+   {
+      if (pid >= 0)
+      {
+         int status = 0;
+         pid_t done;
+         while ((done = waitpid(pid, &status, 0)) < 0 && errno == EINTR)
+            ;
+         finish(done == pid ? status : -1);
+      }
+      return succeeded;
+   }
+
+   /*****************************************
+    * BACKGROUND SAVE :: FINISH
+    * Read the child's report once it has exited
+    ****************************************/
+   inline void background_save::finish(int status)
+   {
+      report r = { 0, 0, 0 };
+      ssize_t got;
+      while ((got = ::read(fdResult, &r, sizeof(r))) < 0 && errno == EINTR)
+         ;
+      ::close(fdResult);
+      fdResult = -1;
+      pid = -1;
+
+      succeeded = got == (ssize_t)sizeof(r) && r.ok == 1 &&
+                  status != -1 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+      numBytes = (size_t)r.bytes;
+      numCowBytes = (size_t)r.cowBytes;
+   }
+
+   /*****************************************
+    * BACKGROUND SAVE :: PRIVATE DIRTY
+    * Bytes of this process's memory no other process
+    * shares. Right after fork() nearly all of it is
+    * shared; every page either side writes to after
+    * that becomes private to the child as well.
+    ****************************************/
+   inline size_t background_save::privateDirty()
+   {
+#ifdef __linux__
+      int fd = ::open("/proc/self/smaps_rollup", O_RDONLY);
+      if (fd < 0)
+         return 0;
+      char buffer[4096];
+      ssize_t got = ::read(fd, buffer, sizeof(buffer) - 1);
+      ::close(fd);
+      if (got <= 0)
+         return 0;
+      buffer[got] = '\0';
+      const char* p = strstr(buffer, "Private_Dirty:");
+      if (p == nullptr)
+         return 0;
+      return (size_t)strtoull(p + sizeof("Private_Dirty:") - 1, nullptr, 10) * 1024;
+#else
+      return 0;
+#endif
+   }
+
+} // namespace custom
+
+#endif // CUSTOM_SNAPSHOT_POSIX
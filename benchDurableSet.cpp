@@ -0,0 +1,104 @@
+/***********************************************************************
+ * Header:
+ *    Bench Durable Set
+ * Summary:
+ *    Driver to measure durable_unordered_set throughput. For each sync
+ *    interval it inserts distinct ints from one or more threads, then
+ *    calls sync(), and reports operations per second including that
+ *    last sync. Run it on the file system you care about:
+ *       benchDurableSet [directory] [operations]
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#include "durable_set.h"    // for durable_unordered_set
+
+#include <chrono>           // for std::chrono::steady_clock
+#include <cstdio>           // for std::printf
+#include <cstdlib>          // for strtoul
+#include <string>           // for the paths
+#include <thread>           // for the writer threads
+#include <vector>           // for the writer threads
+#include <unistd.h>         // for unlink, getpid
+
+#ifdef CUSTOM_SNAPSHOT_POSIX
+
+/**********************************************************************
+ * RUN
+ * Insert numOps ints from numThreads threads at one sync interval
+ *    OUTPUT : operations per second, or 0 if the set failed
+ ***********************************************************************/
+double run(const std::string& path, std::chrono::microseconds interval,
+           int numThreads, int numOps)
+{
+   unlink((path + ".log").c_str());
+   unlink((path + ".snap").c_str());
+   custom::durable_unordered_set<int> ds(path.c_str(), interval);
+   if (!ds.is_open())
+      return 0.0;
+
+   int perThread = numOps / numThreads;
+   auto begin = std::chrono::steady_clock::now();
+   std::vector<std::thread> threads;
+   for (int t = 0; t < numThreads; t++)
+      threads.push_back(std::thread([&ds, t, perThread]()
+      {
+         for (int i = 0; i < perThread; i++)
+            ds.insert(t * perThread + i);
+      }));
+   for (size_t t = 0; t < threads.size(); t++)
+      threads[t].join();
+   bool synced = ds.sync();
+   auto end = std::chrono::steady_clock::now();
+
+   ds.close();
+   unlink((path + ".log").c_str());
+   unlink((path + ".snap").c_str());
+   double seconds = std::chrono::duration<double>(end - begin).count();
+   return synced ? perThread * numThreads / seconds : 0.0;
+}
+
+/**********************************************************************
+ * MAIN
+ * Every interval with one thread, and no interval with eight, where
+ * group commit lets the threads share each fdatasync
+ ***********************************************************************/
+int main(int argc, char** argv)
+{
+   std::string directory = argc > 1 ? argv[1] : "/tmp";
+   int numOps = argc > 2 ? (int)strtoul(argv[2], nullptr, 10) : 20000;
+   std::string path = directory + "/benchDurableSet" + std::to_string(getpid());
+
+   struct setting
+   {
+      const char* name;
+      std::chrono::microseconds interval;
+      int threads;
+   } settings[] =
+   {
+      { "0",      std::chrono::microseconds(0),      1 },
+      { "0",      std::chrono::microseconds(0),      8 },
+      { "1 ms",   std::chrono::microseconds(1000),   1 },
+      { "10 ms",  std::chrono::microseconds(10000),  1 },
+      { "100 ms", std::chrono::microseconds(100000), 1 },
+   };
+
+   for (size_t i = 0; i < sizeof(settings) / sizeof(settings[0]); i++)
+   {
+      // without a sync interval every insert waits for the disk
+      int ops = settings[i].interval.count() ? numOps * 100 : numOps;
+      double rate = run(path, settings[i].interval, settings[i].threads, ops);
+      std::printf("interval %-6s %d thread%-2s %12.0f ops/s\n", settings[i].name, settings[i].threads,
+                  settings[i].threads == 1 ? ": " : "s:", rate);
+   }
+   return 0;
+}
+
+#else // !CUSTOM_SNAPSHOT_POSIX
+
+int main()
+{
+   return 0;
+}
+
+#endif // CUSTOM_SNAPSHOT_POSIX
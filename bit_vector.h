@@ -0,0 +1,462 @@
+/***********************************************************************
+ * Header:
+ *    BIT VECTOR
+ * Summary:
+ *    A packed vector of bits with rank and select. One bit per flag
+ *    in 64 bit words, so a bitmap of n flags takes n/8 bytes and the
+ *    bulk operations work a register at a time.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        bit_vector : packed bits with rank, select and bulk logic
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uint64_t
+#include <initializer_list> // for std::initializer_list
+#include <utility>          // for std::swap
+#include "vector.h"         // for the words and the rank samples
+#include "simd.h"           // for the runtime dispatch
+
+class TestBitVector; // forward declaration for unit tests
+
+namespace custom
+{
+   namespace bit_detail
+   {
+      /*****************************************
+       * POPCOUNT / COUNT TRAILING ZEROS
+       * One word. GCC and clang have builtins, the
+       * rest get the classic bit tricks.
+       ****************************************/
+      inline size_t popcount(uint64_t w)
+      {
+#if defined(__GNUC__)
+         return (size_t)__builtin_popcountll(w);
+#else
+         w = w - ((w >> 1) & 0x5555555555555555ull);
+         w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+         w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0full;
+         return (size_t)((w * 0x0101010101010101ull) >> 56);
+#endif
+      }
+
+      inline size_t ctz(uint64_t w)
+      {
+         assert(w != 0);
+#if defined(__GNUC__)
+         return (size_t)__builtin_ctzll(w);
+#else
+         size_t n = 0;
+         for (; !(w & 1); w >>= 1)
+            n++;
+         return n;
+#endif
+      }
+
+      /*****************************************
+       * POPCOUNT WORDS
+       * Ones in n words. With the popcnt instruction
+       * four counters keep the pipeline full, otherwise
+       * fall back one word at a time.
+       ****************************************/
+#ifdef CUSTOM_SIMD_X86
+      __attribute__((target("popcnt")))
+      inline size_t popcount_hw(const uint64_t* p, size_t n)
+      {
+         size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+         size_t i = 0;
+         for (; i + 4 <= n; i += 4)
+         {
+            c0 += (size_t)__builtin_popcountll(p[i]);
+            c1 += (size_t)__builtin_popcountll(p[i + 1]);
+            c2 += (size_t)__builtin_popcountll(p[i + 2]);
+            c3 += (size_t)__builtin_popcountll(p[i + 3]);
+         }
+         for (; i < n; i++)
+            c0 += (size_t)__builtin_popcountll(p[i]);
+         return c0 + c1 + c2 + c3;
+      }
+#endif
+
+      inline size_t popcount_words(const uint64_t* p, size_t n)
+      {
+#ifdef CUSTOM_SIMD_X86
+         static const bool hasPopcnt = []()
+         {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("popcnt") != 0;
+         }();
+         if (hasPopcnt && simd_active() != SIMD_SCALAR)
+            return popcount_hw(p, n);
+#endif
+         size_t count = 0;
+         for (size_t i = 0; i < n; i++)
+            count += popcount(p[i]);
+         return count;
+      }
+
+      /*****************************************
+       * BULK LOGIC
+       * dst[i] = dst[i] OP src[i] for n words, a whole
+       * register at a time through the simd dispatch.
+       * The operation is spelled out at each width so
+       * the unaligned register type never becomes a
+       * template argument, which would lose its alignment.
+       ****************************************/
+      enum logic { LOGIC_AND, LOGIC_OR, LOGIC_XOR, LOGIC_ANDNOT };
+
+      template <logic L>
+      struct bulk_op
+      {
+         static void scalar(uint64_t* dst, const uint64_t* src, size_t n)
+         {
+            for (size_t i = 0; i < n; i++)
+               dst[i] = L == LOGIC_AND ? dst[i] & src[i] :
+                        L == LOGIC_OR  ? dst[i] | src[i] :
+                        L == LOGIC_XOR ? dst[i] ^ src[i] :
+                                         dst[i] & ~src[i];
+         }
+#ifdef CUSTOM_SIMD_X86
+         template <size_t W>
+         static CUSTOM_SIMD_INLINE void run(uint64_t* dst, const uint64_t* src, size_t n)
+         {
+            typedef typename simd_detail::lanes<uint64_t, W>::uvec uvec;
+            const size_t count = simd_detail::lanes<uint64_t, W>::count;
+            size_t i = 0;
+            for (; i + count <= n; i += count)
+            {
+               uvec a = *(uvec*)(dst + i);
+               uvec b = *(const uvec*)(src + i);
+               *(uvec*)(dst + i) = L == LOGIC_AND ? a & b :
+                                   L == LOGIC_OR  ? a | b :
+                                   L == LOGIC_XOR ? a ^ b :
+                                                    a & ~b;
+            }
+            scalar(dst + i, src + i, n - i);
+         }
+#endif
+      };
+   } // namespace bit_detail
+
+   /*****************************************
+    * BIT VECTOR
+    * Bit i is bit i % 64 of words[i / 64]. Bits past
+    * size() in the last word are always zero, so the
+    * counts and the bulk logic never need a mask.
+    *
+    * rank() and select() use a count of the ones before
+    * every superblock of 512 bits, built by build_index().
+    * Any change throws the samples away, and until the
+    * next build_index() the queries count from the start.
+    * Queries never write, so any number of threads may
+    * query one bit_vector that none of them changes.
+    ****************************************/
+   class bit_vector
+   {
+      friend class ::TestBitVector; // give unit tests access to the privates
+   public:
+
+      //
+      // Construct
+      //
+      bit_vector() : numBits(0), indexed(false) {}
+      bit_vector(size_t numBits, bool value = false) : numBits(0), indexed(false)
+      {
+         resize(numBits, value);
+      }
+      bit_vector(const std::initializer_list<bool>& l) : numBits(0), indexed(false)
+      {
+         reserve(l.size());
+         for (auto it = l.begin(); it != l.end(); ++it)
+            push_back(*it);
+      }
+
+      //
+      // Assign
+      //
+      void swap(bit_vector& rhs)
+      {
+         words.swap(rhs.words);
+         superCounts.swap(rhs.superCounts);
+         std::swap(numBits, rhs.numBits);
+         std::swap(indexed, rhs.indexed);
+      }
+
+      //
+      // Access
+      //
+      bool operator [] (size_t index) const { return test(index); }
+      bool test(size_t index) const
+      {
+         assert(index < numBits);
+         return (words[index / 64] >> (index % 64)) & 1;
+      }
+      void set(size_t index, bool value = true)
+      {
+         assert(index < numBits);
+         uint64_t bit = (uint64_t)1 << (index % 64);
+         if (value)
+            words[index / 64] |= bit;
+         else
+            words[index / 64] &= ~bit;
+         indexed = false;
+      }
+      void reset(size_t index) { set(index, false); }
+      void flip(size_t index)
+      {
+         assert(index < numBits);
+         words[index / 64] ^= (uint64_t)1 << (index % 64);
+         indexed = false;
+      }
+      const uint64_t* data() const { return words.empty() ? nullptr : &words[0]; }
+
+      //
+      // Insert
+      //
+      void push_back(bool value)
+      {
+         if (numBits % 64 == 0)
+            words.push_back(0);
+         numBits++;
+         if (value)
+            words.back() |= (uint64_t)1 << ((numBits - 1) % 64);
+         indexed = false;
+      }
+      void reserve(size_t newCapacity) { words.reserve(wordsFor(newCapacity)); }
+      void resize(size_t newBits, bool value = false);
+      void fill(bool value);
+
+      //
+      // Remove
+      //
+      void clear()
+      {
+         words.clear();
+         numBits = 0;
+         indexed = false;
+      }
+      void pop_back()
+      {
+         if (numBits > 0)
+            resize(numBits - 1);
+      }
+
+      //
+      // Bulk logic, both vectors the same size
+      //
+      bit_vector& operator &= (const bit_vector& rhs) { bulk<bit_detail::LOGIC_AND>(rhs);    return *this; }
+      bit_vector& operator |= (const bit_vector& rhs) { bulk<bit_detail::LOGIC_OR>(rhs);     return *this; }
+      bit_vector& operator ^= (const bit_vector& rhs) { bulk<bit_detail::LOGIC_XOR>(rhs);    return *this; }
+      bit_vector& and_not(const bit_vector& rhs)      { bulk<bit_detail::LOGIC_ANDNOT>(rhs); return *this; }
+
+      //
+      // Query
+      //
+      void build_index();
+      size_t count() const;
+      size_t rank(size_t index) const;
+      size_t select(size_t k) const;
+      size_t find_next(size_t index) const;
+      size_t find_first() const { return find_next(0); }
+      bool any()  const { return count() != 0; }
+      bool none() const { return count() == 0; }
+
+      //
+      // Status
+      //
+      size_t size()       const { return numBits; }
+      size_t capacity()   const { return words.capacity() * 64; }
+      bool empty()        const { return numBits == 0; }
+      size_t word_count() const { return words.size(); }
+
+   private:
+
+      static const size_t superBits = 512;                // bits per rank sample
+      static const size_t superWords = superBits / 64;    // words per rank sample
+
+      static size_t wordsFor(size_t bits) { return (bits + 63) / 64; }
+
+      template <bit_detail::logic L>
+      void bulk(const bit_vector& rhs)
+      {
+         assert(numBits == rhs.numBits);
+         if (words.empty())
+            return;
+         simd_detail::dispatch<bit_detail::bulk_op<L>, void>(
+            std::true_type(), &words[0], &rhs.words[0], words.size());
+         indexed = false;
+      }
+
+      custom::vector<uint64_t> words;                // the bits, 64 to a word
+      custom::vector<uint64_t> superCounts;          // ones before each superblock, plus the total
+      size_t numBits;                                // the number of bits currently used
+      bool indexed;                                  // superCounts matches words
+   };
+
+   /***************************************
+    * BIT VECTOR :: RESIZE
+    * New bits take value. When shrinking, the
+    * bits past the end are cleared to keep the
+    * last word tidy.
+    **************************************/
+   inline void bit_vector::resize(size_t newBits, bool value)
+   {
+      size_t oldBits = numBits;
+      words.resize(wordsFor(newBits), value ? ~(uint64_t)0 : 0);
+
+      // the old last word already had its tail cleared
+      if (value && newBits > oldBits && oldBits % 64 != 0)
+         words[oldBits / 64] |= ~(uint64_t)0 << (oldBits % 64);
+
+      numBits = newBits;
+      if (numBits % 64 != 0)
+         words.back() &= ~(uint64_t)0 >> (64 - numBits % 64);
+      indexed = false;
+   }
+
+   /***************************************
+    * BIT VECTOR :: FILL
+    * Set every bit to value
+    **************************************/
+   inline void bit_vector::fill(bool value)
+   {
+      for (size_t i = 0; i < words.size(); i++)
+         words[i] = value ? ~(uint64_t)0 : 0;
+      if (value && numBits % 64 != 0)
+         words.back() &= ~(uint64_t)0 >> (64 - numBits % 64);
+      indexed = false;
+   }
+
+   /***************************************
+    * BIT VECTOR :: BUILD INDEX
+    * Count the ones in each superblock. Call it
+    * after the last change and before the queries.
+    **************************************/
+   inline void bit_vector::build_index()
+   {
+      size_t numSuper = (words.size() + superWords - 1) / superWords;
+      superCounts.resize(numSuper + 1);
+      size_t total = 0;
+      for (size_t s = 0; s < numSuper; s++)
+      {
+         superCounts[s] = total;
+         size_t first = s * superWords;
+         size_t num = (words.size() - first < superWords) ? words.size() - first : superWords;
+         total += bit_detail::popcount_words(&words[first], num);
+      }
+      superCounts[numSuper] = total;
+      indexed = true;
+   }
+
+   /***************************************
+    * BIT VECTOR :: COUNT
+    * The number of ones
+    **************************************/
+   inline size_t bit_vector::count() const
+   {
+      if (indexed)
+         return (size_t)superCounts.back();
+      return words.empty() ? 0 : bit_detail::popcount_words(&words[0], words.size());
+   }
+
+   /***************************************
+    * BIT VECTOR :: RANK
+    * The number of ones before index
+    *     INPUT  : index, from 0 to size()
+    *     OUTPUT : ones in [0, index)
+    **************************************/
+   inline size_t bit_vector::rank(size_t index) const
+   {
+      assert(index <= numBits);
+      size_t iWord = index / 64;
+      size_t r;
+      if (indexed)
+      {
+         r = (size_t)superCounts[index / superBits];
+         for (size_t w = index / superBits * superWords; w < iWord; w++)
+            r += bit_detail::popcount(words[w]);
+      }
+      else
+         r = iWord ? bit_detail::popcount_words(&words[0], iWord) : 0;
+      if (index % 64 != 0)
+         r += bit_detail::popcount(words[iWord] & (~(uint64_t)0 >> (64 - index % 64)));
+      return r;
+   }
+
+   /***************************************
+    * BIT VECTOR :: SELECT
+    * Where the k-th one is, counting from zero.
+    * Binary search the samples, then walk at most
+    * one superblock of words. Without the samples,
+    * walk the words from the start.
+    *     INPUT  : k
+    *     OUTPUT : its index, or size() if there are
+    *              not that many ones
+    **************************************/
+   inline size_t bit_vector::select(size_t k) const
+   {
+      if (k >= count())
+         return numBits;
+
+      // the last superblock with at most k ones before it
+      size_t lo = 0;
+      if (indexed)
+      {
+         size_t hi = superCounts.size() - 1;
+         while (hi - lo > 1)
+         {
+            size_t mid = (lo + hi) / 2;
+            if ((size_t)superCounts[mid] <= k)
+               lo = mid;
+            else
+               hi = mid;
+         }
+         k -= (size_t)superCounts[lo];
+      }
+
+      for (size_t w = lo * superWords; ; w++)
+      {
+         size_t ones = bit_detail::popcount(words[w]);
+         if (k < ones)
+         {
+            uint64_t bits = words[w];
+            for (; k > 0; k--)
+               bits &= bits - 1;   // drop the lowest one
+            return w * 64 + bit_detail::ctz(bits);
+         }
+         k -= ones;
+      }
+   }
+
+   /***************************************
+    * BIT VECTOR :: FIND NEXT
+    * The first one at or after index
+    *     OUTPUT : its index, or size() if none
+    **************************************/
+   inline size_t bit_vector::find_next(size_t index) const
+   {
+      if (index >= numBits)
+         return numBits;
+      size_t w = index / 64;
+      uint64_t bits = words[w] & (~(uint64_t)0 << (index % 64));
+      while (bits == 0)
+      {
+         if (++w == words.size())
+            return numBits;
+         bits = words[w];
+      }
+      return w * 64 + bit_detail::ctz(bits);
+   }
+
+} // namespace custom
@@ -0,0 +1,915 @@
+/***********************************************************************
+ * Header:
+ *    DISK SET
+ * Summary:
+ *    A set that lives in a file and can be far larger than memory.
+ *    It uses extendible hashing: a directory of pages of elements,
+ *    where a page that fills up splits in two on its own and only the
+ *    directory entries that pointed at it change. Growing never
+ *    rehashes the whole table. Pages are read and written through a
+ *    fixed number of frames in memory, evicted with CLOCK. The saved
+ *    directory is never overwritten until a newer one is on disk.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definitions of:
+ *        buffer_pool                  : Pages of a file cached in frames
+ *        disk_unordered_set           : An extendible hash in a file
+ *        disk_unordered_set::iterator : An iterator through the pages
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "snapshot.h"       // for CUSTOM_SNAPSHOT_POSIX
+
+#ifdef CUSTOM_SNAPSHOT_POSIX
+
+#include <cassert>          // because I am paranoid
+#include <cerrno>           // for errno, EINTR
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uint32_t, uint64_t
+#include <cstring>          // for std::memset
+#include <functional>       // for std::hash, std::equal_to
+#include <type_traits>      // for std::is_trivially_copyable
+#include <fcntl.h>          // for open
+#include <sys/stat.h>       // for fstat
+#include <unistd.h>         // for pread, ftruncate
+#include "pair.h"           // for insert's result
+#include "vector.h"         // for the frames and the directory
+#include "bit_vector.h"     // for which pages are buckets and which are free
+#include "simd.h"           // for searching a bucket
+
+class TestDiskSet; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************
+    * BUFFER POOL
+    * numFrames pages of a file held in memory. pin()
+    * brings a page in, if it is not already, and keeps
+    * it there until unpin(). When every frame is full,
+    * the CLOCK hand sweeps the frames: one used since
+    * the last sweep gets a second chance, the first
+    * one that was not is written back if dirty and
+    * given to the new page. Pages are read and written
+    * whole with pread and pwrite.
+    ****************************************/
+   class buffer_pool
+   {
+      friend class ::TestDiskSet; // give unit tests access to the privates
+   public:
+
+      //
+      // Construct
+      //
+      buffer_pool(size_t numFrames, size_t pageBytes);
+      buffer_pool(const buffer_pool&) = delete;
+      buffer_pool& operator = (const buffer_pool&) = delete;
+
+      //
+      // Pages
+      //
+      void attach(int fd);
+      unsigned char* pin(uint64_t page, bool fresh = false);
+      void unpin(uint64_t page, bool dirty);
+      bool flush();
+
+      //
+      // Status
+      //
+      size_t frame_count() const { return frames.size(); }
+      size_t reads() const { return numReads; }
+      size_t writes() const { return numWrites; }
+
+   private:
+
+      struct frame
+      {
+         uint64_t page;       // held here, if used
+         uint32_t pins;       // callers still using it
+         bool used;           // holds a page at all
+         bool referenced;     // pinned since the hand last passed
+         bool dirty;          // changed since it was read
+      };
+      enum : uint32_t { NONE = 0xffffffff };
+
+      unsigned char* data(size_t iFrame) { return (unsigned char*)&memory[0] + iFrame * pageBytes; }
+      size_t victim();
+      bool writeBack(size_t iFrame);
+
+      custom::vector<frame> frames;       // what each frame holds
+      custom::vector<uint64_t> memory;    // the frames themselves, 8 byte aligned
+      custom::vector<uint32_t> frameOf;   // the frame of each page, or NONE
+      size_t pageBytes;                   // of every page
+      size_t hand;                        // where the CLOCK sweep resumes
+      int fd;                             // the file the pages are in
+      size_t numReads;                    // pages read from the file
+      size_t numWrites;                   // pages written to it
+   };
+
+   inline buffer_pool::buffer_pool(size_t numFrames, size_t pageBytes)
+      : pageBytes(pageBytes), hand(0), fd(-1), numReads(0), numWrites(0)
+   {
+      assert(numFrames >= 2);             // a split holds two pages at once
+      assert(pageBytes % sizeof(uint64_t) == 0);
+      frame empty = { 0, 0, false, false, false };
+      frames.resize(numFrames, empty);
+      memory.resize(numFrames * pageBytes / sizeof(uint64_t), 0);
+   }
+
+   /*****************************************
+    * BUFFER POOL :: ATTACH
+    * Forget every page, without writing any back, and
+    * read from fd from now on
+    ****************************************/
+   inline void buffer_pool::attach(int fd)
+   {
+      for (size_t i = 0; i < frames.size(); i++)
+         frames[i].used = false;
+      frameOf.clear();
+      hand = 0;
+      this->fd = fd;
+   }
+
+   /*****************************************
+    * BUFFER POOL :: PIN
+    * The frame holding page, reading it in if needed.
+    * A fresh page is a new one: it starts zeroed and
+    * is not read at all.
+    *     OUTPUT : nullptr if every frame is pinned or
+    *              the page could not be read
+    ****************************************/
+   inline unsigned char* buffer_pool::pin(uint64_t page, bool fresh)
+   {
+      if (page < frameOf.size() && frameOf[(size_t)page] != NONE)
+      {
+         size_t iFrame = frameOf[(size_t)page];
+         frames[iFrame].pins++;
+         frames[iFrame].referenced = true;
+         return data(iFrame);
+      }
+
+      size_t iFrame = victim();
+      if (iFrame == frames.size())
+         return nullptr;
+      if (frames[iFrame].used)
+      {
+         if (!writeBack(iFrame))
+            return nullptr;
+         frameOf[(size_t)frames[iFrame].page] = NONE;
+         frames[iFrame].used = false;
+      }
+
+      unsigned char* p = data(iFrame);
+      size_t got = 0;
+      while (!fresh && got < pageBytes)
+      {
+         ssize_t n = ::pread(fd, p + got, pageBytes - got, (off_t)(page * pageBytes + got));
+         if (n < 0 && errno == EINTR)
+            continue;
+         if (n < 0)
+            return nullptr;
+         if (n == 0)
+            break;                         // past the end of the file
+         got += (size_t)n;
+      }
+      if (!fresh)
+         numReads++;
+      std::memset(p + got, 0, pageBytes - got);
+
+      frame f = { page, 1, true, true, fresh };
+      frames[iFrame] = f;
+      if (page >= frameOf.size())
+         frameOf.resize((size_t)page * 2 + 1, NONE);
+      frameOf[(size_t)page] = (uint32_t)iFrame;
+      return p;
+   }
+
+   /*****************************************
+    * BUFFER POOL :: UNPIN
+    * Done with page for now, having changed it or not
+    ****************************************/
+   inline void buffer_pool::unpin(uint64_t page, bool dirty)
+   {
+      assert(page < frameOf.size() && frameOf[(size_t)page] != NONE);
+      frame& f = frames[frameOf[(size_t)page]];
+      assert(f.pins > 0);
+      f.pins--;
+      f.dirty = f.dirty || dirty;
+   }
+
+   /*****************************************
+    * BUFFER POOL :: FLUSH
+    * Write back every dirty page. They stay cached.
+    ****************************************/
+   inline bool buffer_pool::flush()
+   {
+      for (size_t i = 0; i < frames.size(); i++)
+         if (frames[i].used && !writeBack(i))
+            return false;
+      return true;
+   }
+
+   /*****************************************
+    * BUFFER POOL :: VICTIM
+    * The CLOCK sweep: an empty frame, or the first
+    * unpinned one not referenced since the last pass.
+    * Two passes clear every reference bit, so a third
+    * finding nothing means everything is pinned.
+    ****************************************/
+   inline size_t buffer_pool::victim()
+   {
+      for (size_t step = 0; step < 3 * frames.size(); step++)
+      {
+         size_t i = hand;
+         hand = (hand + 1) % frames.size();
+         if (!frames[i].used)
+            return i;
+         if (frames[i].pins)
+            continue;
+         if (frames[i].referenced)
+            frames[i].referenced = false;
+         else
+            return i;
+      }
+      return frames.size();
+   }
+
+   inline bool buffer_pool::writeBack(size_t iFrame)
+   {
+      frame& f = frames[iFrame];
+      if (!f.dirty)
+         return true;
+      if (!snapshot_detail::write_all_at(fd, data(iFrame), pageBytes, (off_t)(f.page * pageBytes)))
+         return false;
+      numWrites++;
+      f.dirty = false;
+      return true;
+   }
+
+   /*****************************************
+    * DISK UNORDERED SET
+    * The file is a run of pages:
+    *    page 0      : the file header
+    *    other pages : buckets, | depth | count | T... |,
+    *                  the directory saved by the last
+    *                  flush(), named by the header, and
+    *                  free pages
+    * The directory has 2^globalDepth entries and lives
+    * in memory while the file is open; the low
+    * globalDepth bits of an element's hash pick its
+    * entry. A bucket with local depth d is shared by
+    * the 2^(globalDepth - d) entries that agree on
+    * their low d bits. A full bucket splits on bit d,
+    * doubling the directory only if d is globalDepth.
+    * Buckets never merge, as unordered_set never
+    * shrinks.
+    *
+    * T must be trivially copyable: elements are their
+    * bytes in the page. Changes reach the file when
+    * their page is evicted; the file is whole again
+    * after flush() or close(). A new bucket only ever
+    * takes a free page, never one of the saved
+    * directory, and flush() writes the new directory
+    * into free pages and syncs it before the header
+    * names it. Only then are the old directory's pages
+    * free, so a crash between flushes still leaves the
+    * last saved directory whole. Its checksum is in
+    * the header all the same.
+    ****************************************/
+   template <typename T,
+             typename Hash = std::hash<T>,
+             typename EqPred = std::equal_to<T>>
+   class disk_unordered_set
+   {
+      friend class ::TestDiskSet; // give unit tests access to the privates
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "disk_unordered_set keeps elements as their bytes, T must be trivially copyable");
+   public:
+      static const size_t pageBytes = 4096;
+
+      //
+      // Construct
+      //
+      disk_unordered_set(size_t numFrames = 256)
+         : pool(numFrames, pageBytes), fd(-1), globalDepth(0), numElements(0), numPages(0),
+           numBuckets(0), directoryPage(0), directoryPages(0), nextFree(0), failed(false) {}
+      disk_unordered_set(const char* path, size_t numFrames = 256)
+         : disk_unordered_set(numFrames)
+      {
+         open(path);
+      }
+      ~disk_unordered_set() { close(); }
+      disk_unordered_set(const disk_unordered_set&) = delete;
+      disk_unordered_set& operator = (const disk_unordered_set&) = delete;
+
+      //
+      // File
+      //
+      bool open(const char* path);
+      bool flush();
+      void close();
+      bool is_open() const { return fd >= 0; }
+      bool good() const { return !failed; }
+
+      //
+      // Iterator
+      //
+      class iterator;
+      iterator begin();
+      iterator end() { return iterator(); }
+
+      //
+      // Access
+      //
+      iterator find(const T& t);
+
+      //
+      // Insert
+      //
+      custom::pair<iterator, bool> insert(const T& t);
+
+      //
+      // Remove
+      //
+      iterator erase(const T& t);
+
+      //
+      // Status
+      //
+      size_t size() const { return (size_t)numElements; }
+      bool empty() const { return size() == 0; }
+      size_t bucket_count() const { return (size_t)numBuckets; }
+      size_t global_depth() const { return (size_t)globalDepth; }
+      size_t page_reads() const { return pool.reads(); }
+      size_t page_writes() const { return pool.writes(); }
+
+   private:
+
+      // the first bytes of page 0
+      struct file_header
+      {
+         uint32_t magic;          // marks a file we wrote
+         uint32_t version;        // the layout of the pages
+         uint32_t elementSize;    // sizeof(T)
+         uint32_t pageBytes;      // of every page
+         uint64_t numElements;    // in all the buckets
+         uint64_t numPages;       // in the file, used or free
+         uint64_t globalDepth;    // log2 of the directory's size
+         uint64_t directoryPage;  // where the directory starts
+         uint64_t directorySum;   // checksum of the directory's bytes
+      };
+      // the first bytes of a bucket
+      struct page_header
+      {
+         uint32_t localDepth;     // hash bits its elements share
+         uint32_t count;          // elements that follow
+      };
+      static const uint32_t diskMagic = 0x4b534443;   // "CDSK"
+      static const size_t capacity = (pageBytes - sizeof(page_header)) / sizeof(T);
+      static_assert(capacity >= 2, "T is too large for a page");
+
+      static page_header* header(unsigned char* p) { return (page_header*)p; }
+      static T* slots(unsigned char* p) { return (T*)(p + sizeof(page_header)); }
+      size_t slot(size_t hash) const { return hash & (directory.size() - 1); }
+
+      // where t is among the n elements at s, or n. Plain numbers with
+      // plain equality are compared a register at a time.
+      static size_t locate(const T* s, size_t n, const T& t)
+      {
+         return locate(s, n, t, std::integral_constant<bool, simd_detail::simd_ok<T>::value &&
+                                   std::is_same<EqPred, std::equal_to<T>>::value>());
+      }
+      static size_t locate(const T* s, size_t n, const T& t, std::true_type)
+      {
+         return n ? simd_detail::dispatch<simd_detail::find_op, size_t>(std::true_type(), s, n, t) : 0;
+      }
+      static size_t locate(const T* s, size_t n, const T& t, std::false_type)
+      {
+         size_t i = 0;
+         while (i < n && !EqPred()(s[i], t))
+            i++;
+         return i;
+      }
+
+      static size_t pagesFor(size_t entries)
+      {
+         return (entries * sizeof(uint64_t) + pageBytes - 1) / pageBytes;
+      }
+      uint64_t allocate(size_t num);
+      bool split(uint64_t page, size_t hash);
+      void seek(iterator& it, uint64_t page, size_t iSlot);
+
+      buffer_pool pool;                     // the buckets in memory
+      custom::vector<uint64_t> directory;   // the bucket of each hash prefix
+      int fd;                               // the file
+      uint64_t globalDepth;                 // log2 of the directory's size
+      uint64_t numElements;                 // in all the buckets
+      uint64_t numPages;                    // in the file, used or free
+      uint64_t numBuckets;                  // pages that are buckets
+      bit_vector bucketPages;               // which pages are buckets
+      bit_vector freePages;                 // which pages may be given out
+      uint64_t directoryPage;               // where the saved directory starts, 0 if none
+      uint64_t directoryPages;              // and how many pages it takes
+      uint64_t nextFree;                    // no page before this one is free
+      bool failed;                          // a page could not be read or written
+   };
+
+   /************************************************
+    * DISK UNORDERED SET ITERATOR
+    * A bucket and a slot in it. The iterator keeps a
+    * copy of the element, so it stays readable when
+    * the page is evicted; any insert or erase
+    * invalidates it, as a rehash does in unordered_set.
+    ************************************************/
+   template <typename T, typename H, typename E>
+   class disk_unordered_set <T, H, E> ::iterator
+   {
+      friend class ::TestDiskSet; // give unit tests access to the privates
+      template <typename TT, typename HH, typename EE>
+      friend class custom::disk_unordered_set;
+   public:
+      //
+      // Construct
+      //
+      iterator() : pSet(nullptr), page(0), iSlot(0), value() {}
+
+      //
+      // Compare
+      //
+      bool operator == (const iterator& rhs) const { return page == rhs.page && iSlot == rhs.iSlot; }
+      bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+
+      //
+      // Access
+      //
+      const T& operator * () const { return value; }
+
+      //
+      // Arithmetic
+      //
+      iterator& operator ++ ()
+      {
+         if (page)
+            pSet->seek(*this, page, iSlot + 1);
+         return *this;
+      }
+      iterator operator ++ (int postfix)
+      {
+         iterator temp = *this;
+         ++(*this);
+         return temp;
+      }
+
+   private:
+      disk_unordered_set* pSet;   // the set this walks
+      uint64_t page;              // the bucket, 0 at the end
+      size_t iSlot;               // in the bucket
+      T value;                    // a copy of the element there
+   };
+
+   /*****************************************
+    * DISK UNORDERED SET :: OPEN
+    * Open the set in path, or start an empty one
+    * there if the file is new or empty
+    *     OUTPUT : false if the file is not a set of T
+    ****************************************/
+   template <typename T, typename H, typename E>
+   bool disk_unordered_set <T, H, E> ::open(const char* path)
+   {
+      close();
+      failed = false;
+      fd = ::open(path, O_RDWR | O_CREAT, 0644);
+      if (fd < 0)
+         return false;
+      pool.attach(fd);
+
+      // nothing is loaded yet, so close() would flush an empty set over the file
+      struct stat info;
+      if (fstat(fd, &info) != 0)
+      {
+         ::close(fd);
+         fd = -1;
+         return false;
+      }
+      if (info.st_size == 0)
+      {
+         // one empty bucket that every hash shares
+         globalDepth = 0;
+         numElements = 0;
+         numPages = 2;
+         numBuckets = 1;
+         bucketPages.clear();
+         bucketPages.resize(2);
+         bucketPages.set(1);
+         freePages.clear();
+         freePages.resize(2);
+         directoryPage = directoryPages = 0;
+         nextFree = 2;
+         directory.clear();
+         directory.push_back(1);
+         unsigned char* p = pool.pin(1, true);
+         header(p)->localDepth = 0;
+         header(p)->count = 0;
+         pool.unpin(1, true);
+         if (flush())
+            return true;
+         close();
+         return false;
+      }
+
+      file_header h;
+      bool ok = snapshot_detail::read_all_at(fd, &h, sizeof(h), 0) &&
+                h.magic == diskMagic && h.version == SNAPSHOT_VERSION &&
+                h.elementSize == sizeof(T) && h.pageBytes == pageBytes &&
+                h.numPages >= 3 && h.globalDepth < 8 * sizeof(size_t) &&
+                h.directoryPage >= 1 &&
+                h.directoryPage + pagesFor((size_t)1 << h.globalDepth) <= h.numPages;
+      if (ok)
+      {
+         globalDepth = h.globalDepth;
+         numElements = h.numElements;
+         numPages = h.numPages;
+         directory.clear();
+         directory.resize((size_t)1 << globalDepth, 0);
+         directoryPage = h.directoryPage;
+         directoryPages = pagesFor(directory.size());
+         size_t directoryBytes = directory.size() * sizeof(uint64_t);
+         ok = snapshot_detail::read_all_at(fd, &directory[0], directoryBytes,
+                                           (off_t)(directoryPage * pageBytes)) &&
+              snapshot_detail::checksum((const char*)&directory[0], directoryBytes) ==
+                 h.directorySum;
+
+         // every page the directory does not name, other than its own, is free
+         bucketPages.clear();
+         bucketPages.resize((size_t)numPages);
+         for (size_t i = 0; ok && i < directory.size(); i++)
+         {
+            uint64_t page = directory[i];
+            ok = page >= 1 && page < numPages &&
+                 (page < directoryPage || page >= directoryPage + directoryPages);
+            if (ok)
+               bucketPages.set((size_t)page);
+         }
+         numBuckets = bucketPages.count();
+         freePages.clear();
+         freePages.resize((size_t)numPages);
+         for (uint64_t page = 1; page < numPages; page++)
+            freePages.set((size_t)page, !bucketPages[(size_t)page]);
+         for (uint64_t page = directoryPage; page < directoryPage + directoryPages; page++)
+            freePages.reset((size_t)page);
+         nextFree = 1;
+      }
+      if (!ok)
+      {
+         ::close(fd);
+         fd = -1;
+         directory.clear();
+         bucketPages.clear();
+         freePages.clear();
+         return false;
+      }
+      return true;
+   }
+
+   /*****************************************
+    * DISK UNORDERED SET :: FLUSH
+    * Write back every dirty bucket, then the directory
+    * into free pages, and sync. Only then write the
+    * header that names the new directory, sync again,
+    * and free the old directory's pages.
+    ****************************************/
+   template <typename T, typename H, typename E>
+   bool disk_unordered_set <T, H, E> ::flush()
+   {
+      if (!is_open())
+         return false;
+      size_t directoryBytes = directory.size() * sizeof(uint64_t);
+      uint64_t newPages = pagesFor(directory.size());
+      uint64_t newPage = allocate((size_t)newPages);
+      file_header h = { diskMagic, SNAPSHOT_VERSION, (uint32_t)sizeof(T), (uint32_t)pageBytes,
+                        numElements, numPages, globalDepth, newPage,
+                        snapshot_detail::checksum((const char*)&directory[0], directoryBytes) };
+      bool ok = pool.flush() &&
+                snapshot_detail::write_all_at(fd, &directory[0], directoryBytes,
+                                              (off_t)(newPage * pageBytes)) &&
+                snapshot_detail::sync_file(fd) &&
+                snapshot_detail::write_all_at(fd, &h, sizeof(h), 0) &&
+                snapshot_detail::sync_file(fd);
+
+      // the directory the header does not name is free
+      uint64_t oldPage = ok ? directoryPage : newPage;
+      uint64_t oldPages = ok ? directoryPages : newPages;
+      for (uint64_t page = oldPage; page < oldPage + oldPages; page++)
+         freePages.set((size_t)page);
+      if (oldPages && oldPage < nextFree)
+         nextFree = oldPage;
+      if (!ok)
+      {
+         failed = true;
+         return false;
+      }
+      directoryPage = newPage;
+      directoryPages = newPages;
+      return true;
+   }
+
+   /*****************************************
+    * DISK UNORDERED SET :: ALLOCATE
+    * num free pages in a row, the first such run, or
+    * new pages at the end of the file
+    *     OUTPUT : the first of them, no longer free
+    ****************************************/
+   template <typename T, typename H, typename E>
+   uint64_t disk_unordered_set <T, H, E> ::allocate(size_t num)
+   {
+      size_t start = freePages.find_next((size_t)nextFree);
+      size_t run = 0;
+      for (size_t page = start; page < freePages.size() && run < num; page++)
+      {
+         if (freePages[page])
+            run++;
+         else
+         {
+            page = freePages.find_next(page);
+            start = page--;
+            run = 0;
+         }
+      }
+
+      // a run too short at the end of the file goes on past it
+      if (start + num > numPages)
+      {
+         numPages = start + num;
+         bucketPages.resize((size_t)numPages);
+         freePages.resize((size_t)numPages);
+      }
+      for (size_t page = start; page < start + num; page++)
+         freePages.reset(page);
+      if (num == 1)
+         nextFree = start + 1;
+      return start;
+   }
+
+   /*****************************************
+    * DISK UNORDERED SET :: CLOSE
+    * Flush and close the file
+    ****************************************/
+   template <typename T, typename H, typename E>
+   void disk_unordered_set <T, H, E> ::close()
+   {
+      if (!is_open())
+         return;
+      flush();
+      ::close(fd);
+      fd = -1;
+      pool.attach(-1);
+      directory.clear();
+      bucketPages.clear();
+      freePages.clear();
+      globalDepth = numElements = numPages = numBuckets = 0;
+      directoryPage = directoryPages = nextFree = 0;
+   }
+
+   /*****************************************
+    * DISK UNORDERED SET :: BEGIN
+    * The first element of the first non-empty bucket
+    ****************************************/
+   template <typename T, typename H, typename E>
+   typename disk_unordered_set <T, H, E> ::iterator disk_unordered_set <T, H, E> ::begin()
+   {
+      iterator it;
+      if (is_open())
+         seek(it, 1, 0);
+      return it;
+   }
+
+   /*****************************************
+    * DISK UNORDERED SET :: FIND
+    * Look in the one bucket t's hash leads to
+    ****************************************/
+   template <typename T, typename H, typename E>
+   typename disk_unordered_set <T, H, E> ::iterator disk_unordered_set <T, H, E> ::find(const T& t)
+   {
+      if (!is_open())
+         return end();
+      uint64_t page = directory[slot(H()(t))];
+      unsigned char* p = pool.pin(page);
+      if (p == nullptr)
+      {
+         failed = true;
+         return end();
+      }
+      iterator it;
+      T* s = slots(p);
+      size_t i = locate(s, header(p)->count, t);
+      if (i < header(p)->count)
+      {
+         it.pSet = this;
+         it.page = page;
+         it.iSlot = i;
+         it.value = s[i];
+      }
+      pool.unpin(page, false);
+      return it;
+   }
+
+   /*****************************************
+    * DISK UNORDERED SET :: INSERT
+    * Add t to its bucket, splitting the bucket first
+    * while it is full
+    *     OUTPUT : where t is, and whether it went in. It
+    *              does not if it was already there, if
+    *              more elements share its hash than fit
+    *              a page, or if the file failed.
+    ****************************************/
+   template <typename T, typename H, typename E>
+   custom::pair<typename disk_unordered_set <T, H, E> ::iterator, bool>
+   disk_unordered_set <T, H, E> ::insert(const T& t)
+   {
+      if (!is_open())
+         return custom::pair<iterator, bool>(end(), false);
+      size_t hash = H()(t);
+      for (;;)
+      {
+         uint64_t page = directory[slot(hash)];
+         unsigned char* p = pool.pin(page);
+         if (p == nullptr)
+         {
+            failed = true;
+            return custom::pair<iterator, bool>(end(), false);
+         }
+
+         iterator it;
+         it.pSet = this;
+         it.page = page;
+         it.value = t;
+         page_header* ph = header(p);
+         T* s = slots(p);
+         size_t i = locate(s, ph->count, t);
+         if (i < ph->count)
+         {
+            it.iSlot = i;
+            it.value = s[i];
+            pool.unpin(page, false);
+            return custom::pair<iterator, bool>(it, false);
+         }
+
+         if (ph->count < capacity)
+         {
+            it.iSlot = ph->count;
+            s[ph->count++] = t;
+            pool.unpin(page, true);
+            numElements++;
+            return custom::pair<iterator, bool>(it, true);
+         }
+         pool.unpin(page, false);
+         if (!split(page, hash))
+            return custom::pair<iterator, bool>(end(), false);
+      }
+   }
+
+   /*****************************************
+    * DISK UNORDERED SET :: SPLIT
+    * Split the full bucket page, which hash leads to,
+    * on the next bit of the hash. The new bucket takes
+    * the elements with that bit set, and the directory
+    * entries for them.
+    *     OUTPUT : false if no split can make room
+    ****************************************/
+   template <typename T, typename H, typename E>
+   bool disk_unordered_set <T, H, E> ::split(uint64_t page, size_t hash)
+   {
+      unsigned char* p = pool.pin(page);
+      if (p == nullptr)
+      {
+         failed = true;
+         return false;
+      }
+      page_header* ph = header(p);
+      T* s = slots(p);
+      uint32_t depth = ph->localDepth;
+
+      // if every element has the same hash as the new one, no bit tells them apart
+      bool same = true;
+      for (uint32_t i = 0; same && i < ph->count; i++)
+         same = H()(s[i]) == hash;
+      if (same || depth + 1 >= 8 * sizeof(size_t))
+      {
+         pool.unpin(page, false);
+         return false;
+      }
+
+      uint64_t newPage = allocate(1);
+      unsigned char* q = pool.pin(newPage, true);
+      if (q == nullptr)
+      {
+         freePages.set((size_t)newPage);
+         if (newPage < nextFree)
+            nextFree = newPage;
+         pool.unpin(page, false);
+         failed = true;
+         return false;
+      }
+      bucketPages.set((size_t)newPage);
+      numBuckets++;
+      if (depth == globalDepth)
+      {
+         size_t half = directory.size();
+         directory.resize(half * 2, 0);
+         for (size_t i = 0; i < half; i++)
+            directory[half + i] = directory[i];
+         globalDepth++;
+      }
+
+      page_header* qh = header(q);
+      T* qs = slots(q);
+      uint32_t kept = 0;
+      for (uint32_t i = 0; i < ph->count; i++)
+         if (H()(s[i]) >> depth & 1)
+            qs[qh->count++] = s[i];
+         else
+            s[kept++] = s[i];
+      ph->count = kept;
+      ph->localDepth = qh->localDepth = depth + 1;
+
+      // every entry sharing the bucket's low depth bits, with bit depth set
+      size_t low = hash & (((size_t)1 << depth) - 1);
+      for (size_t i = low | ((size_t)1 << depth); i < directory.size(); i += (size_t)2 << depth)
+         directory[i] = newPage;
+
+      pool.unpin(newPage, true);
+      pool.unpin(page, true);
+      return true;
+   }
+
+   /*****************************************
+    * DISK UNORDERED SET :: ERASE
+    * Remove t, moving the last element of its bucket
+    * into its place
+    *     OUTPUT : the element after the removed one, or
+    *              end() if t was not there
+    ****************************************/
+   template <typename T, typename H, typename E>
+   typename disk_unordered_set <T, H, E> ::iterator disk_unordered_set <T, H, E> ::erase(const T& t)
+   {
+      iterator it = find(t);
+      if (it == end())
+         return it;
+      unsigned char* p = pool.pin(it.page);
+      if (p == nullptr)
+      {
+         failed = true;
+         return end();
+      }
+      page_header* ph = header(p);
+      T* s = slots(p);
+      s[it.iSlot] = s[--ph->count];
+      pool.unpin(it.page, true);
+      numElements--;
+      seek(it, it.page, it.iSlot);
+      return it;
+   }
+
+   /*****************************************
+    * DISK UNORDERED SET :: SEEK
+    * Point it at slot iSlot of page, or the first
+    * element after that, or the end
+    ****************************************/
+   template <typename T, typename H, typename E>
+   void disk_unordered_set <T, H, E> ::seek(iterator& it, uint64_t page, size_t iSlot)
+   {
+      it = iterator();
+      for (page = bucketPages.find_next((size_t)page); page < numPages;
+           page = bucketPages.find_next((size_t)page + 1), iSlot = 0)
+      {
+         unsigned char* p = pool.pin(page);
+         if (p == nullptr)
+         {
+            failed = true;
+            return;
+         }
+         bool here = iSlot < header(p)->count;
+         if (here)
+         {
+            it.pSet = this;
+            it.page = page;
+            it.iSlot = iSlot;
+            it.value = slots(p)[iSlot];
+         }
+         pool.unpin(page, false);
+         if (here)
+            return;
+      }
+   }
+
+} // namespace custom
+
+#endif // CUSTOM_SNAPSHOT_POSIX
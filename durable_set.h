@@ -0,0 +1,641 @@
+/***********************************************************************
+ * Header:
+ *    DURABLE SET
+ * Summary:
+ *    An unordered_set that survives a crash. Every change is appended
+ *    to a log before it is acknowledged, a background thread writes
+ *    and syncs the log for many changes at once (group commit), and
+ *    opening the set again loads the last snapshot and replays the
+ *    log on top of it.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        durable_unordered_set : A logged, recoverable hash
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "snapshot.h"       // for snapshot_serializer, CUSTOM_SNAPSHOT_POSIX
+
+#ifdef CUSTOM_SNAPSHOT_POSIX
+
+#include <cassert>          // because I am paranoid
+#include <cerrno>           // for errno, EINTR
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uint32_t, uint64_t
+#include <cstdio>           // for std::rename
+#include <cstring>          // for std::memcpy
+#include <chrono>           // for std::chrono::microseconds
+#include <condition_variable> // for std::condition_variable
+#include <functional>       // for std::hash, std::equal_to
+#include <mutex>            // for std::mutex
+#include <sstream>          // for records of a custom serializer
+#include <string>           // for the paths and the record buffer
+#include <thread>           // for the sync thread
+#include <type_traits>      // for std::integral_constant
+#include <fcntl.h>          // for open
+#include <unistd.h>         // for ftruncate, unlink
+#include "pair.h"           // for the hash's insert
+#include "vector.h"         // for the records to undo
+#include "hash.h"           // for the set itself
+
+class TestDurableSet; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************
+    * DURABLE UNORDERED SET
+    * Two files sit beside each other:
+    *    path.snap : an epoch, then an unordered_set snapshot
+    *    path.log  : a header with an epoch, then records
+    * Each record is
+    *    | checksum | length << 1 | op | payload |
+    * with the checksum over everything after it, so a
+    * record torn by a crash is found and dropped.
+    * checkpoint() writes a new snapshot with the next
+    * epoch and starts an empty log with that epoch; a
+    * log whose epoch is not the snapshot's is stale
+    * and is never replayed.
+    *
+    * With a sync interval of zero, insert() and erase()
+    * return only once their record is on disk; callers
+    * on many threads share each fdatasync. With an
+    * interval, they return at once and the log is
+    * synced at least that often, so a crash loses at
+    * most one interval of changes.
+    *
+    * Once the log cannot be written, the changes that
+    * did not reach it are undone in memory, so the set
+    * holds only what recovery would, and the set
+    * refuses every change until it is opened again.
+    ****************************************/
+   template <typename T,
+             typename Hash = std::hash<T>,
+             typename EqPred = std::equal_to<T>,
+             typename Serializer = snapshot_serializer<T>>
+   class durable_unordered_set
+   {
+      friend class ::TestDurableSet; // give unit tests access to the privates
+   public:
+
+      //
+      // Construct
+      //
+      durable_unordered_set() : fd(-1), syncInterval(0), appended(0), durable(0), wanted(0),
+                                epoch(0), numSyncs(0), failed(false), stopping(false) {}
+      durable_unordered_set(const char* path,
+                            std::chrono::microseconds syncInterval = std::chrono::microseconds(0))
+         : durable_unordered_set()
+      {
+         open(path, syncInterval);
+      }
+      ~durable_unordered_set() { close(); }
+      durable_unordered_set(const durable_unordered_set&) = delete;
+      durable_unordered_set& operator = (const durable_unordered_set&) = delete;
+
+      //
+      // File
+      //
+      bool open(const char* path,
+                std::chrono::microseconds syncInterval = std::chrono::microseconds(0));
+      void close();
+      bool is_open() const { return fd >= 0; }
+      bool sync();
+      bool checkpoint();
+
+      //
+      // Access
+      //
+      bool contains(const T& t)
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         return set.find(t) != set.end();
+      }
+
+      //
+      // Insert
+      //
+      bool insert(const T& t);
+
+      //
+      // Remove
+      //
+      bool erase(const T& t);
+
+      //
+      // Status
+      //
+      size_t size()
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         return set.size();
+      }
+      bool empty() { return size() == 0; }
+
+   private:
+
+      enum : uint32_t { OP_INSERT = 0, OP_ERASE = 1 };
+
+      // the first bytes of the log
+      struct log_header
+      {
+         uint32_t magic;     // marks a log we wrote
+         uint32_t version;   // the layout of the records
+         uint64_t epoch;     // the snapshot these records follow
+      };
+      static const uint32_t logMagic = 0x474f4c43;   // "CLOG"
+      static const size_t recordBytes = 2 * sizeof(uint32_t);
+
+      static void encode(std::string& buffer, uint32_t op, const T& t);
+      static void encodePayload(std::string& buffer, const T& t, std::true_type);
+      static void encodePayload(std::string& buffer, const T& t, std::false_type);
+      static bool decodePayload(const char* p, size_t num, T& t, std::true_type);
+      static bool decodePayload(const char* p, size_t num, T& t, std::false_type);
+
+      bool recover();
+      uint64_t readSnapshot();
+      size_t replay(const std::string& log);
+      bool decode(const std::string& log, size_t& offset, uint32_t& op, T& t);
+      void rollback(const std::string& records);
+      bool startLog(uint64_t newEpoch);
+      bool commit(std::unique_lock<std::mutex>& lock, uint64_t lsn);
+      void syncLoop();
+
+      unordered_set<T, Hash, EqPred> set;      // everything, in memory
+      std::string snapPath;                    // path.snap
+      std::string logPath;                     // path.log
+      int fd;                                  // the log, opened for append
+      std::chrono::microseconds syncInterval;  // zero to sync before returning
+      std::string pending;                     // records not yet written
+      uint64_t appended;                       // records made since open
+      uint64_t durable;                        // of those, how many are on disk
+      uint64_t wanted;                         // a caller is waiting for this many
+      uint64_t epoch;                          // of the snapshot the log follows
+      size_t numSyncs;                         // fdatasync calls so far
+      bool failed;                             // a write or a sync went wrong
+      bool stopping;                           // close() wants the thread gone
+      std::mutex mutex;                        // guards all of the above
+      std::mutex ioMutex;                      // held while the files are written
+      std::condition_variable cvWork;          // wakes the sync thread
+      std::condition_variable cvDurable;       // wakes callers waiting on a sync
+      std::thread syncer;                      // writes and syncs the log
+   };
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: OPEN
+    * Recover the set from path.snap and path.log, then
+    * start the sync thread
+    *     INPUT  : the path, without an extension, and
+    *              how long changes may wait for a sync
+    *     OUTPUT : true if the set is open
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool durable_unordered_set <T, H, E, S> ::open(const char* path, std::chrono::microseconds syncInterval)
+   {
+      close();
+      snapPath = std::string(path) + ".snap";
+      logPath = std::string(path) + ".log";
+      this->syncInterval = syncInterval;
+      appended = durable = wanted = 0;
+      numSyncs = 0;
+      failed = stopping = false;
+
+      if (!recover())
+      {
+         if (fd >= 0)
+            ::close(fd);
+         fd = -1;
+         set.clear();
+         return false;
+      }
+      syncer = std::thread([this]() { syncLoop(); });
+      return true;
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: CLOSE
+    * Sync what is pending, stop the thread, and close
+    * the log. The set is emptied.
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   void durable_unordered_set <T, H, E, S> ::close()
+   {
+      if (syncer.joinable())
+      {
+         {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+         }
+         cvWork.notify_one();
+         syncer.join();
+      }
+      if (fd >= 0)
+         ::close(fd);
+      fd = -1;
+      set.clear();
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: INSERT
+    * Add t and log it, if it is not already there
+    *     OUTPUT : whether t went in. If its record could
+    *              not be made durable it is taken out
+    *              again and this is false.
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool durable_unordered_set <T, H, E, S> ::insert(const T& t)
+   {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (!is_open() || failed || set.find(t) != set.end())
+         return false;
+      set.insert(t);
+      encode(pending, OP_INSERT, t);
+      return commit(lock, ++appended);
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: ERASE
+    * Remove t and log it, if it is there
+    *     OUTPUT : whether t was removed. If its record
+    *              could not be made durable it is put
+    *              back and this is false.
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool durable_unordered_set <T, H, E, S> ::erase(const T& t)
+   {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (!is_open() || failed || set.find(t) == set.end())
+         return false;
+      set.erase(t);
+      encode(pending, OP_ERASE, t);
+      return commit(lock, ++appended);
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: SYNC
+    * Wait until every change so far is on disk,
+    * whatever the sync interval
+    *     OUTPUT : false if the log could not be written
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool durable_unordered_set <T, H, E, S> ::sync()
+   {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (!is_open())
+         return false;
+      if (wanted < appended)
+         wanted = appended;
+      cvWork.notify_one();
+      uint64_t lsn = appended;
+      cvDurable.wait(lock, [this, lsn]() { return durable >= lsn || failed; });
+      return durable >= lsn;
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: COMMIT
+    * With no sync interval, hand the record at lsn to
+    * the sync thread and wait for it to reach the disk.
+    * Callers that arrive while a sync is under way
+    * all go out together in the next one.
+    *     OUTPUT : whether this record is on disk. A
+    *              later batch failing does not change
+    *              the answer for an earlier one.
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool durable_unordered_set <T, H, E, S> ::commit(std::unique_lock<std::mutex>& lock, uint64_t lsn)
+   {
+      if (syncInterval.count() != 0)
+         return true;
+      if (wanted < lsn)
+         wanted = lsn;
+      cvWork.notify_one();
+      cvDurable.wait(lock, [this, lsn]() { return durable >= lsn || failed; });
+      return durable >= lsn;
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: SYNC LOOP
+    * The sync thread. It takes every pending record at
+    * once, writes them with one write() and makes them
+    * durable with one fdatasync, either because a
+    * caller is waiting or because the interval is up.
+    * A batch that fails is cut back off the log and
+    * undone in memory along with everything after it.
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   void durable_unordered_set <T, H, E, S> ::syncLoop()
+   {
+      std::unique_lock<std::mutex> lock(mutex);
+      for (;;)
+      {
+         auto ready = [this]() { return stopping || (wanted > durable && !failed); };
+         if (syncInterval.count() == 0)
+            cvWork.wait(lock, ready);
+         else
+            cvWork.wait_for(lock, syncInterval, ready);
+
+         if (pending.empty())
+         {
+            if (stopping)
+               return;
+            continue;
+         }
+
+         std::string batch;
+         batch.swap(pending);
+         uint64_t batchLsn = appended;
+         uint64_t batchEpoch = epoch;
+         lock.unlock();
+
+         bool ok = true;
+         {
+            std::lock_guard<std::mutex> io(ioMutex);
+            // a checkpoint since the swap saved these changes in its snapshot
+            lock.lock();
+            bool stale = batchEpoch != epoch;
+            lock.unlock();
+            if (!stale)
+            {
+               off_t before = lseek(fd, 0, SEEK_END);
+               ok = before >= 0 &&
+                    snapshot_detail::write_all(fd, batch.data(), batch.size()) &&
+                    snapshot_detail::sync_file(fd);
+               if (!ok && before >= 0 && ftruncate(fd, before) == 0)
+                  snapshot_detail::sync_file(fd);
+               lock.lock();
+               numSyncs++;
+               lock.unlock();
+            }
+         }
+
+         lock.lock();
+         if (!ok)
+         {
+            failed = true;
+            rollback(batch + pending);
+            pending.clear();
+         }
+         else if (durable < batchLsn)
+            durable = batchLsn;
+         cvDurable.notify_all();
+      }
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: CHECKPOINT
+    * Save the whole set as the next epoch's snapshot,
+    * then start an empty log for that epoch. A crash
+    * between the two leaves a log from the old epoch,
+    * which recovery ignores.
+    *     OUTPUT : true if the snapshot was written
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool durable_unordered_set <T, H, E, S> ::checkpoint()
+   {
+      std::lock_guard<std::mutex> io(ioMutex);
+      std::unique_lock<std::mutex> lock(mutex);
+      if (!is_open())
+         return false;
+
+      std::string tmp = snapPath + ".tmp";
+      int snapFd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (snapFd < 0)
+         return false;
+      uint64_t newEpoch = epoch + 1;
+      bool ok = snapshot_detail::write_all(snapFd, (const char*)&newEpoch, sizeof(newEpoch)) &&
+                set.template save<S>(snapFd) && snapshot_detail::sync_file(snapFd);
+      ::close(snapFd);
+
+      // the rename must be on disk before the log it makes stale is emptied
+      if (!ok || std::rename(tmp.c_str(), snapPath.c_str()) != 0 ||
+          !snapshot_detail::sync_directory(snapPath))
+      {
+         unlink(tmp.c_str());
+         return false;
+      }
+
+      // everything made so far is in the snapshot now
+      pending.clear();
+      durable = appended;
+      bool started = startLog(newEpoch);
+      if (!started)
+         failed = true;
+      cvDurable.notify_all();
+      return started;
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: RECOVER
+    * Load the snapshot, replay the log if it follows
+    * that snapshot, and cut off a torn last record
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool durable_unordered_set <T, H, E, S> ::recover()
+   {
+      set.clear();
+      epoch = readSnapshot();
+      if (epoch == (uint64_t)-1)
+         return false;
+
+      fd = ::open(logPath.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+      if (fd < 0)
+         return false;
+      std::string log;
+      char buffer[65536];
+      ssize_t got;
+      while ((got = ::read(fd, buffer, sizeof(buffer))) > 0)
+         log.append(buffer, (size_t)got);
+      if (got < 0)
+         return false;
+
+      log_header header;
+      if (log.size() < sizeof(header))
+         return startLog(epoch);
+      std::memcpy(&header, log.data(), sizeof(header));
+      if (header.magic != logMagic || header.version != SNAPSHOT_VERSION || header.epoch != epoch)
+         return startLog(epoch);
+
+      size_t good = replay(log);
+      if (good < log.size())
+         return ftruncate(fd, (off_t)good) == 0 && snapshot_detail::sync_file(fd);
+      return true;
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: READ SNAPSHOT
+    * Load path.snap into the set, if there is one
+    *     OUTPUT : its epoch, 0 if there is no snapshot,
+    *              or -1 if it could not be read. A
+    *              snapshot that is there but cannot be
+    *              opened is -1: taking it for none would
+    *              empty the log it makes current.
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   uint64_t durable_unordered_set <T, H, E, S> ::readSnapshot()
+   {
+      int snapFd = ::open(snapPath.c_str(), O_RDONLY);
+      if (snapFd < 0)
+         return errno == ENOENT ? 0 : (uint64_t)-1;
+      uint64_t snapEpoch = (uint64_t)-1;
+      if (::read(snapFd, &snapEpoch, sizeof(snapEpoch)) != (ssize_t)sizeof(snapEpoch) ||
+          !set.template load<S>(snapFd))
+         snapEpoch = (uint64_t)-1;
+      ::close(snapFd);
+      return snapEpoch;
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: REPLAY
+    * Apply each whole, intact record after the header
+    *     OUTPUT : the bytes of the log that were good
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   size_t durable_unordered_set <T, H, E, S> ::replay(const std::string& log)
+   {
+      size_t offset = sizeof(log_header);
+      uint32_t op;
+      T t;
+      while (decode(log, offset, op, t))
+      {
+         if (op == OP_INSERT)
+         {
+            if (set.find(t) == set.end())
+               set.insert(t);
+         }
+         else
+            set.erase(t);
+      }
+      return offset;
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: DECODE
+    * The record at offset, if it is whole and intact
+    *     OUTPUT : false at the end of the good records;
+    *              otherwise op and t, and offset moved
+    *              past the record
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool durable_unordered_set <T, H, E, S> ::decode(const std::string& log, size_t& offset,
+                                                   uint32_t& op, T& t)
+   {
+      if (offset + recordBytes > log.size())
+         return false;
+      uint32_t sum;
+      uint32_t lengthOp;
+      std::memcpy(&sum, log.data() + offset, sizeof(sum));
+      std::memcpy(&lengthOp, log.data() + offset + sizeof(sum), sizeof(lengthOp));
+      size_t length = lengthOp >> 1;
+      const char* payload = log.data() + offset + recordBytes;
+      if (offset + recordBytes + length > log.size() ||
+          snapshot_detail::checksum(log.data() + offset + sizeof(sum),
+                                    sizeof(lengthOp) + length) != sum ||
+          !decodePayload(payload, length, t, std::integral_constant<bool, S::elementSize != 0>()))
+         return false;
+      op = lengthOp & 1;
+      offset += recordBytes + length;
+      return true;
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: ROLLBACK
+    * Undo the records that never reached the log,
+    * newest first. Each one changed the set when it
+    * was made, so its opposite puts the set back.
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   void durable_unordered_set <T, H, E, S> ::rollback(const std::string& records)
+   {
+      custom::vector<uint32_t> ops;
+      custom::vector<T> elements;
+      size_t offset = 0;
+      uint32_t op;
+      T t;
+      while (decode(records, offset, op, t))
+      {
+         ops.push_back(op);
+         elements.push_back(t);
+      }
+      for (size_t i = ops.size(); i-- > 0;)
+      {
+         if (ops[i] == OP_INSERT)
+            set.erase(elements[i]);
+         else if (set.find(elements[i]) == set.end())
+            set.insert(elements[i]);
+      }
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: START LOG
+    * Empty the log and give it a header for newEpoch
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool durable_unordered_set <T, H, E, S> ::startLog(uint64_t newEpoch)
+   {
+      log_header header = { logMagic, SNAPSHOT_VERSION, newEpoch };
+      if (ftruncate(fd, 0) != 0 ||
+          !snapshot_detail::write_all(fd, (const char*)&header, sizeof(header)) ||
+          !snapshot_detail::sync_file(fd))
+         return false;
+      epoch = newEpoch;
+      return true;
+   }
+
+   /*****************************************
+    * DURABLE UNORDERED SET :: ENCODE
+    * Append one record for op on t to buffer
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   void durable_unordered_set <T, H, E, S> ::encode(std::string& buffer, uint32_t op, const T& t)
+   {
+      size_t start = buffer.size();
+      buffer.append(recordBytes, '\0');
+      encodePayload(buffer, t, std::integral_constant<bool, S::elementSize != 0>());
+      uint32_t lengthOp = (uint32_t)((buffer.size() - start - recordBytes) << 1) | op;
+      std::memcpy(&buffer[start + sizeof(uint32_t)], &lengthOp, sizeof(lengthOp));
+      uint32_t sum = snapshot_detail::checksum(&buffer[start + sizeof(uint32_t)],
+                                               buffer.size() - start - sizeof(uint32_t));
+      std::memcpy(&buffer[start], &sum, sizeof(sum));
+   }
+
+   template <typename T, typename H, typename E, typename S>
+   void durable_unordered_set <T, H, E, S> ::encodePayload(std::string& buffer, const T& t, std::true_type)
+   {
+      buffer.append((const char*)&t, sizeof(T));
+   }
+
+   template <typename T, typename H, typename E, typename S>
+   void durable_unordered_set <T, H, E, S> ::encodePayload(std::string& buffer, const T& t, std::false_type)
+   {
+      std::ostringstream out;
+      S::write(out, t);
+      buffer += out.str();
+   }
+
+   template <typename T, typename H, typename E, typename S>
+   bool durable_unordered_set <T, H, E, S> ::decodePayload(const char* p, size_t num, T& t, std::true_type)
+   {
+      if (num != sizeof(T))
+         return false;
+      std::memcpy((void*)&t, p, sizeof(T));
+      return true;
+   }
+
+   template <typename T, typename H, typename E, typename S>
+   bool durable_unordered_set <T, H, E, S> ::decodePayload(const char* p, size_t num, T& t, std::false_type)
+   {
+      std::istringstream in(std::string(p, num));
+      return S::read(in, t);
+   }
+
+} // namespace custom
+
+#endif // CUSTOM_SNAPSHOT_POSIX
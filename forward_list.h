@@ -0,0 +1,368 @@
+/***********************************************************************
+ * Header:
+ *    FORWARD LIST
+ * Summary:
+ *    Our custom implementation of std::forward_list. Each node has
+ *    only a next pointer, so it is one pointer smaller than a list
+ *    node and an insert writes one fewer pointer. That suits hash
+ *    chains, which are only ever walked front to back.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        forward_list           : A singly linked list
+ *        forward_list::iterator : An iterator through forward_list
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <memory>           // for std::allocator, std::allocator_traits
+#include <utility>          // for std::move, std::forward
+#include <initializer_list> // for std::initializer_list
+
+class TestForwardList; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /**************************************************
+    * FORWARD LIST
+    * Just like std::forward_list: the work happens
+    * after a position, starting from before_begin().
+    *
+    * It also keeps a tail pointer and a count so it
+    * can stand in for list as an unordered_set bucket,
+    * which appends with insert(end(), t) and push_back()
+    * and removes with erase(it). Those two walk from the
+    * head to find the node in front, which in a hash
+    * chain is a node or two away.
+    **************************************************/
+   template <typename T, typename A = std::allocator<T>>
+   class forward_list
+   {
+      friend class ::TestForwardList; // give unit tests access to the privates
+
+      // the part of a node before_begin() can point at
+      struct Link
+      {
+         Link* pNext;
+      };
+
+   public:
+
+      //
+      // Construct
+      //
+      forward_list(const A& a = A()) : alloc(a), nodeAlloc(a), numElements(0), pTail(nullptr)
+      {
+         head.pNext = nullptr;
+      }
+      forward_list(const std::initializer_list<T>& il, const A& a = A()) : forward_list(a)
+      {
+         for (const T& item : il)
+            push_back(item);
+      }
+      template <class Iterator>
+      forward_list(Iterator first, Iterator last, const A& a = A()) : forward_list(a)
+      {
+         for (Iterator it = first; it != last; ++it)
+            push_back(*it);
+      }
+      forward_list(const forward_list& rhs) : forward_list(rhs.alloc)
+      {
+         for (Link* p = rhs.head.pNext; p; p = p->pNext)
+            push_back(*node(p)->data());
+      }
+      forward_list(forward_list&& rhs) : forward_list(rhs.alloc)
+      {
+         swap(rhs);
+      }
+      ~forward_list()
+      {
+         clear();
+      }
+
+      //
+      // Assign
+      //
+      forward_list& operator = (const forward_list& rhs)
+      {
+         if (this != &rhs)
+         {
+            forward_list copy(rhs);
+            swap(copy);
+         }
+         return *this;
+      }
+      forward_list& operator = (forward_list&& rhs)
+      {
+         clear();
+         swap(rhs);
+         return *this;
+      }
+      void swap(forward_list& rhs)
+      {
+         std::swap(head.pNext, rhs.head.pNext);
+         std::swap(pTail, rhs.pTail);
+         std::swap(numElements, rhs.numElements);
+      }
+
+      //
+      // Iterator
+      //
+      class iterator;
+      iterator before_begin() { return iterator(&head); }
+      iterator begin()        { return iterator(head.pNext); }
+      iterator end()          { return iterator(nullptr); }
+
+      //
+      // Access
+      //
+      T& front() { assert(head.pNext); return *node(head.pNext)->data(); }
+      T& back()  { assert(pTail);      return *node(pTail)->data(); }
+      iterator find(const T& value);
+
+      //
+      // Insert
+      //
+      void push_front(const T& data) { linkAfter(&head, newNode(data)); }
+      void push_front(T&& data)      { linkAfter(&head, newNode(std::move(data))); }
+      void push_back(const T& data)  { linkAfter(last(), newNode(data)); }
+      void push_back(T&& data)       { linkAfter(last(), newNode(std::move(data))); }
+      iterator insert_after(iterator pos, const T& data) { return iterator(linkAfter(pos.p, newNode(data))); }
+      iterator insert_after(iterator pos, T&& data)      { return iterator(linkAfter(pos.p, newNode(std::move(data)))); }
+      iterator insert(iterator it, const T& data)        { return insert_after(before(it), data); }
+      iterator insert(iterator it, T&& data)             { return insert_after(before(it), std::move(data)); }
+      void splice_after(iterator pos, forward_list& rhs);
+      void splice_after(iterator pos, forward_list& rhs, iterator it);
+
+      //
+      // Remove
+      //
+      void pop_front() { if (head.pNext) erase_after(before_begin()); }
+      void clear();
+      iterator erase_after(iterator pos);
+      iterator erase(iterator it) { return erase_after(before(it)); }
+
+      //
+      // Status
+      //
+      bool empty()  const { return head.pNext == nullptr; }
+      size_t size() const { return numElements; }
+
+   private:
+
+      /**************************************************
+       * NODE
+       * A link and the raw storage for one element
+       **************************************************/
+      struct Node : Link
+      {
+         alignas(T) unsigned char buffer[sizeof(T)];
+
+         T* data() { return (T*)buffer; }
+      };
+      typedef typename std::allocator_traits<A>::template rebind_alloc<Node> NodeAlloc;
+
+      static Node* node(Link* p) { return static_cast<Node*>(p); }
+      Link* last()               { return pTail ? pTail : &head; }
+      iterator before(iterator it);
+      Link* linkAfter(Link* pos, Node* p);
+      template <class U>
+      Node* newNode(U&& data);
+
+      A         alloc;        // constructs and destroys the elements
+      NodeAlloc nodeAlloc;    // allocates the nodes
+      size_t numElements;     // though we could count, it is faster to keep a variable
+      Link   head;            // head.pNext is the first node
+      Link*  pTail;           // the last node, nullptr when empty
+   };
+
+   /*************************************************
+    * FORWARD LIST ITERATOR
+    * Iterate through a forward_list, front to back
+    ************************************************/
+   template <typename T, typename A>
+   class forward_list <T, A> ::iterator
+   {
+      friend class ::TestForwardList; // give unit tests access to the privates
+      template <typename TT, typename AA>
+      friend class custom::forward_list;
+   public:
+      // constructors, destructors, and assignment operator
+      iterator() : p(nullptr) {}
+      iterator(Link* p) : p(p) {}
+      iterator(const iterator& rhs) : p(rhs.p) {}
+      iterator& operator = (const iterator& rhs)
+      {
+         p = rhs.p;
+         return *this;
+      }
+
+      // equals, not equals operator
+      bool operator == (const iterator& rhs) const { return p == rhs.p; }
+      bool operator != (const iterator& rhs) const { return p != rhs.p; }
+
+      // dereference operator, not valid on before_begin()
+      T& operator * () { return *node(p)->data(); }
+
+      // prefix and postfix increment
+      iterator& operator ++ () { p = p->pNext; return *this; }
+      iterator operator ++ (int) { iterator tmp = *this; p = p->pNext; return tmp; }
+
+   private:
+      Link* p;     // the node, nullptr at the end
+   };
+
+   /*****************************************
+    * FORWARD LIST :: NEW NODE / LINK AFTER
+    * Build a node around a copy of data, then hook
+    * it in after pos, moving the tail if pos was last
+    ****************************************/
+   template <typename T, typename A>
+   template <class U>
+   typename forward_list <T, A> ::Node* forward_list <T, A> ::newNode(U&& data)
+   {
+      Node* p = nodeAlloc.allocate(1);
+      try
+      {
+         alloc.construct(p->data(), std::forward<U>(data));
+      }
+      catch (...)
+      {
+         nodeAlloc.deallocate(p, 1);
+         throw;
+      }
+      return p;
+   }
+
+   template <typename T, typename A>
+   typename forward_list <T, A> ::Link* forward_list <T, A> ::linkAfter(Link* pos, Node* p)
+   {
+      assert(pos);
+      if (pos == last())
+         pTail = p;
+      p->pNext = pos->pNext;
+      pos->pNext = p;
+      numElements++;
+      return p;
+   }
+
+   /*****************************************
+    * FORWARD LIST :: BEFORE
+    * The position in front of it. end() is after the
+    * tail, so only a position in the middle walks.
+    ****************************************/
+   template <typename T, typename A>
+   typename forward_list <T, A> ::iterator forward_list <T, A> ::before(iterator it)
+   {
+      if (it.p == nullptr)
+         return iterator(last());
+      Link* p = &head;
+      while (p->pNext != it.p)
+      {
+         assert(p->pNext);
+         p = p->pNext;
+      }
+      return iterator(p);
+   }
+
+   /*****************************************
+    * FORWARD LIST :: FIND
+    * The first element equal to value, or end()
+    ****************************************/
+   template <typename T, typename A>
+   typename forward_list <T, A> ::iterator forward_list <T, A> ::find(const T& value)
+   {
+      for (Link* p = head.pNext; p; p = p->pNext)
+         if (*node(p)->data() == value)
+            return iterator(p);
+      return end();
+   }
+
+   /*****************************************
+    * FORWARD LIST :: ERASE AFTER
+    * Remove the element following pos
+    *     OUTPUT : the element that now follows pos
+    ****************************************/
+   template <typename T, typename A>
+   typename forward_list <T, A> ::iterator forward_list <T, A> ::erase_after(iterator pos)
+   {
+      Link* p = pos.p->pNext;
+      assert(p);
+      pos.p->pNext = p->pNext;
+      if (p == pTail)
+         pTail = (pos.p == &head) ? nullptr : pos.p;
+      alloc.destroy(node(p)->data());
+      nodeAlloc.deallocate(node(p), 1);
+      numElements--;
+      return iterator(pos.p->pNext);
+   }
+
+   /*****************************************
+    * FORWARD LIST :: CLEAR
+    ****************************************/
+   template <typename T, typename A>
+   void forward_list <T, A> ::clear()
+   {
+      Link* p = head.pNext;
+      while (p)
+      {
+         Link* pNext = p->pNext;
+         alloc.destroy(node(p)->data());
+         nodeAlloc.deallocate(node(p), 1);
+         p = pNext;
+      }
+      head.pNext = nullptr;
+      pTail = nullptr;
+      numElements = 0;
+   }
+
+   /*****************************************
+    * FORWARD LIST :: SPLICE AFTER
+    * Move every node of rhs, or the one node after it,
+    * to follow pos. Nothing is copied or allocated;
+    * the two lists must share an allocator.
+    ****************************************/
+   template <typename T, typename A>
+   void forward_list <T, A> ::splice_after(iterator pos, forward_list& rhs)
+   {
+      assert(&rhs != this);
+      if (rhs.empty())
+         return;
+      if (pos.p == last())
+         pTail = rhs.pTail;
+      rhs.pTail->pNext = pos.p->pNext;
+      pos.p->pNext = rhs.head.pNext;
+      numElements += rhs.numElements;
+
+      rhs.head.pNext = nullptr;
+      rhs.pTail = nullptr;
+      rhs.numElements = 0;
+   }
+
+   template <typename T, typename A>
+   void forward_list <T, A> ::splice_after(iterator pos, forward_list& rhs, iterator it)
+   {
+      Link* p = it.p->pNext;
+      if (p == nullptr || pos.p == it.p || pos.p == p)
+         return;
+
+      // unhook from rhs
+      it.p->pNext = p->pNext;
+      if (p == rhs.pTail)
+         rhs.pTail = (it.p == &rhs.head) ? nullptr : it.p;
+      rhs.numElements--;
+
+      linkAfter(pos.p, node(p));
+   }
+
+} // namespace custom
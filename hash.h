@@ -21,9 +21,12 @@
 
 #include "list.h"     // because this->buckets[0] is a list
 #include "vector.h"   // because this->buckets is a vector
+#include "snapshot.h" // for save and load
 #include <memory>     // for std::allocator
 #include <functional> // for std::hash
 #include <cmath>      // for std::ceil
+#include <cstring>    // for std::memcpy
+#include <type_traits> // for std::integral_constant
 
 
 class TestHash;             // forward declaration for Hash unit tests
@@ -37,7 +40,8 @@ namespace custom
 template <typename T,
           typename Hash = std::hash<T>,
           typename EqPred = std::equal_to<T>,
-          typename A = std::allocator<T> >
+          typename A = std::allocator<T>,
+          typename B = custom::list<T, A> >
 class unordered_set
 {
    friend class ::TestHash;   // give unit tests access to the privates
@@ -45,10 +49,11 @@ public:
    //
    // Construct
    //
-   unordered_set() :numElements(0), maxLoadFactor(1.0), buckets(8)
+   unordered_set() :numElements(0), maxLoadFactor(1.0), buckets(8), dirtyAll(true)
    {
    }
-   unordered_set(size_t numBuckets) : numElements(0), maxLoadFactor(1.0), buckets(numBuckets)
+   unordered_set(size_t numBuckets) : numElements(0), maxLoadFactor(1.0), buckets(numBuckets),
+                                      dirtyAll(true)
    {
    }
    unordered_set(const unordered_set&  rhs)
@@ -60,7 +65,7 @@ public:
        *this = std::move(rhs);
    }
    template <class Iterator>
-   unordered_set(Iterator first, Iterator last)
+   unordered_set(Iterator first, Iterator last) : dirtyAll(true)
    {
       reserve(last - first);
       maxLoadFactor = 1.0;
@@ -76,6 +81,7 @@ public:
       numElements = rhs.numElements;
       maxLoadFactor = rhs.maxLoadFactor;
       buckets = rhs.buckets;
+      dirtyAll = true;
       return *this;
    }
    unordered_set& operator=(unordered_set&& rhs)
@@ -83,10 +89,12 @@ public:
       numElements = std::move(rhs.numElements);
       maxLoadFactor = std::move(rhs.maxLoadFactor);
       buckets = std::move(rhs.buckets);
+      dirtyAll = true;
 
       rhs.numElements = 0;
       rhs.maxLoadFactor = 1.0;
       rhs.buckets.resize(8);
+      rhs.dirtyAll = true;
 
       return *this;
    }
@@ -104,6 +112,7 @@ public:
       swap(numElements, rhs.numElements);
       swap(maxLoadFactor, rhs.maxLoadFactor);
       swap(buckets, rhs.buckets);
+      dirtyAll = rhs.dirtyAll = true;
    }
 
    //
@@ -125,7 +134,7 @@ public:
    }
    iterator end()
    {
-      return iterator(buckets.end(), buckets.end(), buckets[0].end());
+      return iterator(buckets.end(), buckets.end(), typename B::iterator());
    }
    local_iterator begin(size_t iBucket)
    {
@@ -155,6 +164,8 @@ public:
    {
       rehash(min_buckets_required(num));
    }
+   template <class Producer>
+   bool assign_from(size_t numBuckets, size_t num, Producer produce);
 
    //
    // Remove
@@ -164,6 +175,7 @@ public:
       for (auto& bucket : buckets)
          bucket.clear();
       numElements = 0;
+      dirtyAll = true;
    }
    iterator erase(const T& t);
 
@@ -199,6 +211,57 @@ public:
       maxLoadFactor = m;
    }
 
+   //
+   // Save
+   //
+   template <class Serializer = snapshot_serializer<T>>
+   bool save(std::ostream& out);
+   template <class Serializer = snapshot_serializer<T>>
+   bool load(std::istream& in);
+#ifdef CUSTOM_SNAPSHOT_POSIX
+   template <class Serializer = snapshot_serializer<T>>
+   bool save(int fd)
+   {
+      fd_streambuf buf(fd);
+      std::ostream out(&buf);
+      return save<Serializer>(out) && buf.pubsync() == 0;
+   }
+   // reads ahead, so the snapshot should run to the end of the file
+   template <class Serializer = snapshot_serializer<T>>
+   bool load(int fd)
+   {
+      fd_streambuf buf(fd);
+      std::istream in(&buf);
+      return load<Serializer>(in);
+   }
+#endif // CUSTOM_SNAPSHOT_POSIX
+
+   //
+   // Changes
+   //
+   size_t page_count() const
+   {
+      return (bucket_count() + SNAPSHOT_PAGE_BUCKETS - 1) / SNAPSHOT_PAGE_BUCKETS;
+   }
+   bool page_dirty(size_t page) const
+   {
+      return dirtyAll || (dirtyPages[page / 64] >> (page % 64) & 1);
+   }
+   bool dirty_all() const
+   {
+      return dirtyAll;
+   }
+   void clear_dirty()
+   {
+      dirtyPages.clear();
+      dirtyPages.resize((page_count() + 63) / 64, 0);
+      dirtyAll = false;
+   }
+   template <class Serializer = snapshot_serializer<T>>
+   bool save_delta(std::ostream& out);
+   template <class Serializer = snapshot_serializer<T>>
+   bool apply_delta(std::istream& in);
+
 private:
 
    size_t min_buckets_required(size_t num) const
@@ -206,9 +269,38 @@ private:
       return (size_t)std::ceil(num / maxLoadFactor);
    }
 
-   custom::vector<custom::list<T,A>> buckets;  // each bucket in the hash
+   // note that a bucket changed; once everything has, there is nothing to note
+   void markDirty(size_t iBucket)
+   {
+      if (!dirtyAll)
+      {
+         size_t page = iBucket / SNAPSHOT_PAGE_BUCKETS;
+         dirtyPages[page / 64] |= (uint64_t)1 << (page % 64);
+      }
+   }
+
+   // the elements as raw bytes, in batches, or one at a time through Serializer
+   static const size_t SNAPSHOT_BATCH_BYTES = 65536;
+   template <class Serializer>
+   bool saveElements(std::ostream& out, std::true_type);
+   template <class Serializer>
+   bool saveElements(std::ostream& out, std::false_type);
+   template <class Serializer>
+   bool loadElements(std::istream& in, size_t numBuckets, size_t num, std::true_type);
+   template <class Serializer>
+   bool loadElements(std::istream& in, size_t numBuckets, size_t num, std::false_type);
+   template <class Serializer>
+   bool applyPage(std::istream& in, size_t count, size_t first, size_t last,
+                  custom::vector<unsigned char>& batch, std::true_type);
+   template <class Serializer>
+   bool applyPage(std::istream& in, size_t count, size_t first, size_t last,
+                  custom::vector<unsigned char>& batch, std::false_type);
+
+   custom::vector<B> buckets;                  // each bucket in the hash
    int numElements;                            // number of elements in the Hash
    float maxLoadFactor;                        // the ratio of elements to buckets signifying a rehash
+   custom::vector<uint64_t> dirtyPages;        // a bit per page of buckets changed since clear_dirty()
+   bool dirtyAll;                              // every page has, or the bucket array was replaced
 };
 
 
@@ -216,11 +308,11 @@ private:
  * UNORDERED SET ITERATOR
  * Iterator for an unordered set
  ************************************************/
-template <typename T, typename H, typename E, typename A>
-class unordered_set <T, H, E, A> ::iterator
+template <typename T, typename H, typename E, typename A, typename B>
+class unordered_set <T, H, E, A, B> ::iterator
 {
    friend class ::TestHash;   // give unit tests access to the privates
-   template <typename TT, typename HH, typename EE, typename AA>
+   template <typename TT, typename HH, typename EE, typename AA, typename BB>
    friend class custom::unordered_set;
 public:
    //
@@ -228,9 +320,9 @@ public:
    iterator() : itVectorEnd(), itVector(), itList()
    {
    }
-   iterator(const typename custom::vector<custom::list<T> >::iterator& itVectorEnd,
-            const typename custom::vector<custom::list<T> >::iterator& itVector,
-            const typename custom::list<T>::iterator &itList)
+   iterator(const typename custom::vector<B>::iterator& itVectorEnd,
+            const typename custom::vector<B>::iterator& itVector,
+            const typename B::iterator &itList)
    : itVectorEnd(itVectorEnd), itVector(itVector), itList(itList)
    {
    }
@@ -289,9 +381,11 @@ public:
    }
 
 private:
-   typename vector<list<T>>::iterator itVectorEnd;
-   typename list<T>::iterator itList;
-   typename vector<list<T>>::iterator itVector;
+   void nextBucket();
+
+   typename vector<B>::iterator itVectorEnd;
+   typename B::iterator itList;
+   typename vector<B>::iterator itVector;
 };
 
 
@@ -299,12 +393,12 @@ private:
  * UNORDERED SET LOCAL ITERATOR
  * Iterator for a single bucket in an unordered set
  ************************************************/
-template <typename T, typename H, typename E, typename A>
-class unordered_set <T, H, E, A> ::local_iterator
+template <typename T, typename H, typename E, typename A, typename B>
+class unordered_set <T, H, E, A, B> ::local_iterator
 {
    friend class ::TestHash;   // give unit tests access to the privates
 
-   template <typename TT, typename HH, typename EE, typename AA>
+   template <typename TT, typename HH, typename EE, typename AA, typename BB>
    friend class custom::unordered_set;
 public:
    //
@@ -313,7 +407,7 @@ public:
    local_iterator() : itList()
    {
    }
-   local_iterator(const typename custom::list<T>::iterator& itList) : itList(itList)
+   local_iterator(const typename B::iterator& itList) : itList(itList)
    {
    }
    local_iterator(const local_iterator& rhs) : itList(rhs.itList)
@@ -364,7 +458,7 @@ public:
    }
 
 private:
-   typename list<T>::iterator itList;
+   typename B::iterator itList;
 };
 
 
@@ -372,16 +466,21 @@ private:
  * UNORDERED SET :: ERASE
  * Remove one element from the unordered set
  ****************************************/
-template <typename T, typename Hash, typename E, typename A>
-typename unordered_set <T, Hash, E, A> ::iterator unordered_set<T,Hash,E,A>::erase(const T& t)
+template <typename T, typename Hash, typename E, typename A, typename B>
+typename unordered_set <T, Hash, E, A, B> ::iterator unordered_set<T, Hash, E, A, B>::erase(const T& t)
 {
    iterator itErase = find(t);
    if (itErase == end())
       return itErase;
-   iterator itReturn = itErase;
-   ++itReturn;
-   (*itErase.itVector).erase(itErase.itList);
+
+   // the bucket tells us what follows the erased element. If that is the
+   // end of the bucket, move on to the next non-empty one.
+   iterator itReturn(itErase.itVectorEnd, itErase.itVector,
+                     (*itErase.itVector).erase(itErase.itList));
    numElements--;
+   markDirty(&*itErase.itVector - &buckets[0]);
+   if (itReturn.itList == (*itReturn.itVector).end())
+      itReturn.nextBucket();
    return itReturn;
 }
 
@@ -389,35 +488,29 @@ typename unordered_set <T, Hash, E, A> ::iterator unordered_set<T,Hash,E,A>::era
  * UNORDERED SET :: INSERT
  * Insert one element into the hash
  ****************************************/
-template <typename T, typename H, typename E, typename A>
-custom::pair<typename custom::unordered_set<T, H, E, A>::iterator, bool> unordered_set<T, H, E, A>::insert(const T& t)
+template <typename T, typename H, typename E, typename A, typename B>
+custom::pair<typename custom::unordered_set<T, H, E, A, B>::iterator, bool> unordered_set<T, H, E, A, B>::insert(const T& t)
 {
    size_t iBucket = bucket(t);
    // Check if the element already exists in the bucket
    for (auto it = buckets[iBucket].begin(); it != buckets[iBucket].end(); ++it)
    {
       if (*it == t)
-         return { iterator(buckets.end(), typename custom::vector<custom::list<T, A>>::iterator(iBucket, buckets), buckets[iBucket].rbegin()), false }; // Element already exists
+         return { iterator(buckets.end(), typename custom::vector<B>::iterator(iBucket, buckets), it), false }; // Element already exists
    }
    if (min_buckets_required(numElements + 1) > bucket_count())
    {
       reserve(numElements * 2);
       iBucket = bucket(t);
    }
-   buckets[iBucket].push_back(t);
+   typename B::iterator itList = buckets[iBucket].insert(buckets[iBucket].end(), t);
    numElements++;
+   markDirty(iBucket);
 
-   return { iterator(buckets.end(), typename custom::vector<custom::list<T, A>>::iterator(iBucket, buckets), buckets[iBucket].rbegin()), true };
-   /*iterator(
-      buckets.end(),
-      typename custom::vector<custom::list<T, A>>::iterator(iBucket, buckets),
-      itList
-   );*/
-   
-   //return custom::pair<custom::unordered_set<T, H, E, A>::iterator, bool>(iterator(), true);
+   return { iterator(buckets.end(), typename custom::vector<B>::iterator(iBucket, buckets), itList), true };
 }
-template <typename T, typename H, typename E, typename A>
-void unordered_set<T, H, E, A>::insert(const std::initializer_list<T> & il)
+template <typename T, typename H, typename E, typename A, typename B>
+void unordered_set<T, H, E, A, B>::insert(const std::initializer_list<T> & il)
 {
 }
 
@@ -425,13 +518,13 @@ void unordered_set<T, H, E, A>::insert(const std::initializer_list<T> & il)
  * UNORDERED SET :: REHASH
  * Re-Hash the unordered set by numBuckets
  ****************************************/
-template <typename T, typename Hash, typename E, typename A>
-void unordered_set<T, Hash, E, A>::rehash(size_t numBuckets)
+template <typename T, typename Hash, typename E, typename A, typename B>
+void unordered_set<T, Hash, E, A, B>::rehash(size_t numBuckets)
 {
    if (numBuckets <= bucket_count())
       return; // Don't rehash to a smaller size
 
-   custom::vector<custom::list<T, A>> newBuckets(numBuckets);
+   custom::vector<B> newBuckets(numBuckets);
 
    // Reinsert all elements into new buckets
    for (auto& bucket : buckets)
@@ -445,27 +538,339 @@ void unordered_set<T, Hash, E, A>::rehash(size_t numBuckets)
 
    // Assign new bucket structure
    buckets = std::move(newBuckets);
+   dirtyAll = true;
+}
+
+
+/*****************************************
+ * UNORDERED SET :: SAVE
+ * Write a header with the bucket count and load
+ * factor, then every element in bucket order
+ *    | snapshot_header | bucket 0 | bucket 1 | ...
+ *     OUTPUT : whether the stream took it all
+ ****************************************/
+template <typename T, typename H, typename E, typename A, typename B>
+template <class Serializer>
+bool unordered_set<T, H, E, A, B>::save(std::ostream& out)
+{
+   static_assert(Serializer::elementSize == 0 || Serializer::elementSize == sizeof(T),
+                 "a serializer either copies all of T or writes it itself");
+
+   snapshot_header header = { SNAPSHOT_MAGIC, SNAPSHOT_VERSION, Serializer::elementSize,
+                              maxLoadFactor, (uint64_t)numElements, (uint64_t)bucket_count() };
+   if (!out.write((const char*)&header, sizeof(header)))
+      return false;
+   return saveElements<Serializer>(out, std::integral_constant<bool, Serializer::elementSize != 0>());
+}
+
+template <typename T, typename H, typename E, typename A, typename B>
+template <class Serializer>
+bool unordered_set<T, H, E, A, B>::saveElements(std::ostream& out, std::true_type)
+{
+   size_t perBatch = SNAPSHOT_BATCH_BYTES > sizeof(T) ? SNAPSHOT_BATCH_BYTES / sizeof(T) : 1;
+   custom::vector<unsigned char> batch;
+   batch.resize_for_overwrite(perBatch * sizeof(T));
+
+   size_t used = 0;
+   for (auto& bucket : buckets)
+      for (auto it = bucket.begin(); it != bucket.end(); ++it)
+      {
+         std::memcpy(&batch[used * sizeof(T)], &*it, sizeof(T));
+         if (++used == perBatch)
+         {
+            out.write((const char*)&batch[0], used * sizeof(T));
+            used = 0;
+         }
+      }
+   if (used)
+      out.write((const char*)&batch[0], used * sizeof(T));
+   return (bool)out;
+}
+
+template <typename T, typename H, typename E, typename A, typename B>
+template <class Serializer>
+bool unordered_set<T, H, E, A, B>::saveElements(std::ostream& out, std::false_type)
+{
+   for (auto& bucket : buckets)
+      for (auto it = bucket.begin(); it != bucket.end(); ++it)
+         Serializer::write(out, *it);
+   return (bool)out;
+}
+
+/*****************************************
+ * UNORDERED SET :: LOAD
+ * Replace the contents with a saved set, building
+ * it the way assign_from() does. With the same hash,
+ * every bucket comes back in the order it was saved.
+ *     OUTPUT : false, and an empty set, if the stream
+ *              does not hold a snapshot of this T
+ ****************************************/
+template <typename T, typename H, typename E, typename A, typename B>
+template <class Serializer>
+bool unordered_set<T, H, E, A, B>::load(std::istream& in)
+{
+   clear();
+
+   snapshot_header header;
+   if (!in.read((char*)&header, sizeof(header)) ||
+       header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+       header.elementSize != Serializer::elementSize ||
+       header.numBuckets == 0 || !(header.maxLoadFactor > 0.0f))
+      return false;
+
+   maxLoadFactor = header.maxLoadFactor;
+   if (loadElements<Serializer>(in, (size_t)header.numBuckets, (size_t)header.numElements,
+                                std::integral_constant<bool, Serializer::elementSize != 0>()))
+      return true;
+   clear();
+   return false;
 }
 
+template <typename T, typename H, typename E, typename A, typename B>
+template <class Serializer>
+bool unordered_set<T, H, E, A, B>::loadElements(std::istream& in, size_t numBuckets, size_t num,
+                                                std::true_type)
+{
+   return assign_from(numBuckets, num, [&in](T* dest, size_t max) -> size_t
+   {
+      return in.read((char*)dest, max * sizeof(T)) ? max : 0;
+   });
+}
+
+template <typename T, typename H, typename E, typename A, typename B>
+template <class Serializer>
+bool unordered_set<T, H, E, A, B>::loadElements(std::istream& in, size_t numBuckets, size_t num,
+                                                std::false_type)
+{
+   custom::vector<B> newBuckets(numBuckets);
+   buckets = std::move(newBuckets);
+   for (; num; num--)
+   {
+      T t;
+      if (!Serializer::read(in, t))
+         return false;
+      size_t iBucket = bucket(t);
+      buckets[iBucket].push_back(std::move(t));
+      numElements++;
+   }
+   return true;
+}
+
+/*****************************************
+ * UNORDERED SET :: ASSIGN FROM
+ * Replace the contents with num distinct elements
+ * that produce() writes in batches. The bucket array
+ * is sized once, then each element goes straight to
+ * the back of its bucket: no duplicate checks and no
+ * rehashing along the way. produce is called as
+ * produce(T* dest, size_t max) and returns how many
+ * it wrote; zero or less means it failed.
+ *     INPUT  : the bucket count, how many elements,
+ *              and the callable that makes them
+ *     OUTPUT : false, and an empty set, if produce()
+ *              failed before num elements
+ ****************************************/
+template <typename T, typename H, typename E, typename A, typename B>
+template <class Producer>
+bool unordered_set<T, H, E, A, B>::assign_from(size_t numBuckets, size_t num, Producer produce)
+{
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "assign_from batches raw elements, T must be trivially copyable");
+   clear();
+   custom::vector<B> newBuckets(numBuckets ? numBuckets : 1);
+   buckets = std::move(newBuckets);
+
+   size_t perBatch = SNAPSHOT_BATCH_BYTES > sizeof(T) ? SNAPSHOT_BATCH_BYTES / sizeof(T) : 1;
+   custom::vector<unsigned char> batch;
+   batch.resize_for_overwrite((num < perBatch ? num : perBatch) * sizeof(T));
+
+   while (num)
+   {
+      auto written = produce((T*)&batch[0], num < perBatch ? num : perBatch);
+      if (written <= 0)
+      {
+         clear();
+         return false;
+      }
+      const T* p = (const T*)&batch[0];
+      for (size_t i = 0; i < (size_t)written; i++)
+         buckets[bucket(p[i])].push_back(p[i]);
+      numElements += (int)written;
+      num -= (size_t)written;
+   }
+   return true;
+}
+
+/*****************************************
+ * UNORDERED SET :: SAVE DELTA
+ * Write every page of buckets that changed since
+ * clear_dirty(), in the layout snapshot.h describes.
+ * With apply_delta() on a copy that matched this set
+ * at clear_dirty(), the copy matches it again.
+ *     OUTPUT : whether the stream took it all
+ ****************************************/
+template <typename T, typename H, typename E, typename A, typename B>
+template <class Serializer>
+bool unordered_set<T, H, E, A, B>::save_delta(std::ostream& out)
+{
+   static_assert(Serializer::elementSize == 0 || Serializer::elementSize == sizeof(T),
+                 "a serializer either copies all of T or writes it itself");
+
+   uint64_t numPages = 0;
+   for (size_t page = 0; page < page_count(); page++)
+      if (page_dirty(page))
+         numPages++;
+   snapshot_header header = { SNAPSHOT_DELTA_MAGIC, SNAPSHOT_VERSION, Serializer::elementSize,
+                              maxLoadFactor, (uint64_t)numElements, (uint64_t)bucket_count() };
+   out.write((const char*)&header, sizeof(header));
+   out.write((const char*)&numPages, sizeof(numPages));
+
+   for (size_t page = 0; page < page_count() && out; page++)
+   {
+      if (!page_dirty(page))
+      {
+         // a clean word of the bitmap skips 64 pages at once
+         if (!dirtyAll && page % 64 == 0 && dirtyPages[page / 64] == 0)
+            page += 63;
+         continue;
+      }
+      size_t first = page * SNAPSHOT_PAGE_BUCKETS;
+      size_t last = first + SNAPSHOT_PAGE_BUCKETS < bucket_count() ? first + SNAPSHOT_PAGE_BUCKETS
+                                                                  : bucket_count();
+      uint64_t pageHeader[2] = { (uint64_t)page, 0 };
+      for (size_t i = first; i < last; i++)
+         pageHeader[1] += buckets[i].size();
+      out.write((const char*)pageHeader, sizeof(pageHeader));
+      for (size_t i = first; i < last; i++)
+         for (auto it = buckets[i].begin(); it != buckets[i].end(); ++it)
+            Serializer::write(out, *it);
+   }
+   return (bool)out;
+}
+
+/*****************************************
+ * UNORDERED SET :: APPLY DELTA
+ * Replace each page the delta holds with its
+ * elements, straight into their buckets
+ *     OUTPUT : false, and an empty set, if the delta
+ *              is not for this T and bucket count or
+ *              does not add up
+ ****************************************/
+template <typename T, typename H, typename E, typename A, typename B>
+template <class Serializer>
+bool unordered_set<T, H, E, A, B>::apply_delta(std::istream& in)
+{
+   snapshot_header header;
+   uint64_t numPages;
+   custom::vector<unsigned char> batch;
+   if (!in.read((char*)&header, sizeof(header)) ||
+       header.magic != SNAPSHOT_DELTA_MAGIC || header.version != SNAPSHOT_VERSION ||
+       header.elementSize != Serializer::elementSize || header.numBuckets != bucket_count() ||
+       !in.read((char*)&numPages, sizeof(numPages)))
+   {
+      clear();
+      return false;
+   }
+
+   for (; numPages; numPages--)
+   {
+      uint64_t pageHeader[2];
+      if (!in.read((char*)pageHeader, sizeof(pageHeader)) || pageHeader[0] >= page_count())
+         break;
+      size_t first = (size_t)pageHeader[0] * SNAPSHOT_PAGE_BUCKETS;
+      size_t last = first + SNAPSHOT_PAGE_BUCKETS < bucket_count() ? first + SNAPSHOT_PAGE_BUCKETS
+                                                                  : bucket_count();
+      for (size_t i = first; i < last; i++)
+      {
+         numElements -= (int)buckets[i].size();
+         buckets[i].clear();
+      }
+      if (!applyPage<Serializer>(in, (size_t)pageHeader[1], first, last, batch,
+                                 std::integral_constant<bool, Serializer::elementSize != 0>()))
+         break;
+      markDirty(first);
+   }
+
+   if (numPages || (uint64_t)numElements != header.numElements)
+   {
+      clear();
+      return false;
+   }
+   maxLoadFactor = header.maxLoadFactor;
+   return true;
+}
+
+/*****************************************
+ * UNORDERED SET :: APPLY PAGE
+ * Read count elements into buckets first..last,
+ * in batches when they are raw bytes
+ *     OUTPUT : false if the stream ran out or an
+ *              element belongs to another page
+ ****************************************/
+template <typename T, typename H, typename E, typename A, typename B>
+template <class Serializer>
+bool unordered_set<T, H, E, A, B>::applyPage(std::istream& in, size_t count, size_t first, size_t last,
+                                             custom::vector<unsigned char>& batch, std::true_type)
+{
+   size_t perBatch = SNAPSHOT_BATCH_BYTES > sizeof(T) ? SNAPSHOT_BATCH_BYTES / sizeof(T) : 1;
+   while (count)
+   {
+      size_t n = count < perBatch ? count : perBatch;
+      if (batch.size() < n * sizeof(T))
+         batch.resize_for_overwrite(n * sizeof(T));
+      if (!in.read((char*)&batch[0], n * sizeof(T)))
+         return false;
+      for (size_t i = 0; i < n; i++)
+      {
+         const T& t = *(const T*)&batch[i * sizeof(T)];
+         size_t iBucket = bucket(t);
+         if (iBucket < first || iBucket >= last)
+            return false;
+         buckets[iBucket].push_back(t);
+         numElements++;
+      }
+      count -= n;
+   }
+   return true;
+}
+
+template <typename T, typename H, typename E, typename A, typename B>
+template <class Serializer>
+bool unordered_set<T, H, E, A, B>::applyPage(std::istream& in, size_t count, size_t first, size_t last,
+                                             custom::vector<unsigned char>& batch, std::false_type)
+{
+   for (; count; count--)
+   {
+      T t;
+      if (!Serializer::read(in, t))
+         return false;
+      size_t iBucket = bucket(t);
+      if (iBucket < first || iBucket >= last)
+         return false;
+      buckets[iBucket].push_back(t);
+      numElements++;
+   }
+   return true;
+}
 
 /*****************************************
  * UNORDERED SET :: FIND
  * Find an element in an unordered set
  ****************************************/
-template <typename T, typename H, typename E, typename A>
-typename unordered_set <T, H, E, A> ::iterator unordered_set<T, H, E, A>::find(const T& t)
+template <typename T, typename H, typename E, typename A, typename B>
+typename unordered_set <T, H, E, A, B> ::iterator unordered_set<T, H, E, A, B>::find(const T& t)
 {
    // Identify bucket number corresponding to "t"
    size_t iBucket = bucket(t);
 
-   // Get a list iterator to the element using the list’s find() method.
-   typename custom::list<T, A>::iterator itList = buckets[iBucket].find(t);
+   // Get a bucket iterator to the element using the bucket's find() method.
+   typename B::iterator itList = buckets[iBucket].find(t);
 
    // Create an iterator to return
    if (itList != buckets[iBucket].end())
       return iterator(
          buckets.end(),
-         typename custom::vector<custom::list<T, A>>::iterator(iBucket, buckets),
+         typename custom::vector<B>::iterator(iBucket, buckets),
          itList
       );
 
@@ -476,8 +881,8 @@ typename unordered_set <T, H, E, A> ::iterator unordered_set<T, H, E, A>::find(c
  * UNORDERED SET :: ITERATOR :: INCREMENT
  * Advance by one element in an unordered set
  ****************************************/
-template <typename T, typename H, typename E, typename A>
-typename unordered_set <T, H, E, A> ::iterator & unordered_set<T, H, E, A>::iterator::operator ++ ()
+template <typename T, typename H, typename E, typename A, typename B>
+typename unordered_set <T, H, E, A, B> ::iterator & unordered_set<T, H, E, A, B>::iterator::operator ++ ()
 {
 
    // Only advance if we are not at the end
@@ -490,22 +895,33 @@ typename unordered_set <T, H, E, A> ::iterator & unordered_set<T, H, E, A>::iter
       return *this;
 
    // We are at the end of the list. Find the next bucket.
+   nextBucket();
+   return *this;
+}
+
+/*****************************************
+ * UNORDERED SET :: ITERATOR :: NEXT BUCKET
+ * Move to the start of the next non-empty bucket,
+ * or to end() if there is none
+ ****************************************/
+template <typename T, typename H, typename E, typename A, typename B>
+void unordered_set<T, H, E, A, B>::iterator::nextBucket()
+{
    ++itVector;
    while (itVector != itVectorEnd && (*itVector).empty())
       ++itVector;
    if (itVector != itVectorEnd)
       itList = (*itVector).begin();
-
-   return *this;
-
+   else
+      itList = typename B::iterator();
 }
 
 /*****************************************
  * SWAP
  * Stand-alone unordered set swap
  ****************************************/
-template <typename T, typename H, typename E, typename A>
-void swap(unordered_set<T,H,E,A>& lhs, unordered_set<T,H,E,A>& rhs)
+template <typename T, typename H, typename E, typename A, typename B>
+void swap(unordered_set<T,H,E,A,B>& lhs, unordered_set<T,H,E,A,B>& rhs)
 {
    lhs.swap(rhs);
 }
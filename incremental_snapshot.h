@@ -0,0 +1,397 @@
+/***********************************************************************
+ * Header:
+ *    INCREMENTAL SNAPSHOT
+ * Summary:
+ *    Snapshots of a large unordered_set that cost what changed, not
+ *    what is there. A full snapshot is taken now and then; in between,
+ *    each save appends a delta holding only the pages of buckets that
+ *    changed since the save before it. Loading replays the chain on
+ *    top of the full snapshot, and the chain is kept short enough that
+ *    recovery never costs much more than loading the full one.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        incremental_snapshot : A full snapshot and a chain of deltas
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "snapshot.h"       // for snapshot_serializer, CUSTOM_SNAPSHOT_POSIX
+
+#ifdef CUSTOM_SNAPSHOT_POSIX
+
+#include <cerrno>           // for errno, EINTR
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uint32_t, uint64_t
+#include <cstdio>           // for std::rename
+#include <cstring>          // for std::memcpy
+#include <functional>       // for std::hash, std::equal_to
+#include <sstream>          // for building and reading a delta
+#include <string>           // for the paths
+#include <fcntl.h>          // for open
+#include <sys/stat.h>       // for fstat
+#include <unistd.h>         // for read, ftruncate, unlink
+#include "pair.h"           // for the hash's insert
+#include "hash.h"           // for the set itself
+
+class TestIncrementalSnapshot; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************
+    * INCREMENTAL SNAPSHOT
+    * Two files sit beside each other:
+    *    path.snap  : a generation, then an unordered_set
+    *                 snapshot
+    *    path.delta : a header with a generation, then
+    *                 | checksum | length | delta |
+    * where each delta is what save_delta() writes and
+    * the checksum covers the length and the delta. A
+    * delta log whose generation is not the snapshot's
+    * is stale, and a delta torn by a crash is cut off.
+    *
+    * save() appends a delta when it can. It takes a
+    * full snapshot instead, and starts an empty chain
+    * for the next generation, when the set was rehashed
+    * or cleared, when the chain has maxDeltas deltas,
+    * or when the deltas add up to as many bytes as the
+    * snapshot. A load therefore reads at most about
+    * twice the snapshot. compact() does the same merge
+    * from the files alone, without the live set.
+    *
+    * The set's change tracking belongs to one
+    * incremental_snapshot: each save clears it.
+    ****************************************/
+   template <typename T,
+             typename Hash = std::hash<T>,
+             typename EqPred = std::equal_to<T>,
+             typename Serializer = snapshot_serializer<T>>
+   class incremental_snapshot
+   {
+      friend class ::TestIncrementalSnapshot; // give unit tests access to the privates
+   public:
+      typedef unordered_set<T, Hash, EqPred> set_type;
+
+      //
+      // Construct
+      //
+      incremental_snapshot(const char* path, size_t maxDeltas = 16)
+         : snapPath(std::string(path) + ".snap"), deltaPath(std::string(path) + ".delta"),
+           maxDeltas(maxDeltas), generation(0), numDeltas(0), deltaBytes(0), snapBytes(0),
+           known(false) {}
+
+      //
+      // Save
+      //
+      bool save(set_type& us);
+      bool save_full(set_type& us);
+      bool load(set_type& us);
+      bool compact();
+
+      //
+      // Status
+      //
+      size_t delta_count() const { return numDeltas; }
+      size_t delta_bytes() const { return deltaBytes; }
+      size_t snapshot_bytes() const { return snapBytes; }
+
+   private:
+
+      // the first bytes of path.delta
+      struct delta_header
+      {
+         uint32_t magic;        // marks a delta log we wrote
+         uint32_t version;      // the layout of the records
+         uint64_t generation;   // the snapshot these deltas follow
+      };
+      static const uint32_t deltaMagic = 0x4c445343;   // "CSDL"
+      static const size_t recordBytes = sizeof(uint32_t) + sizeof(uint64_t);
+
+      bool saveDelta(set_type& us);
+      uint64_t readSnapshot(set_type& us);
+      bool replay(set_type& us);
+      bool startChain(uint64_t newGeneration);
+
+      std::string snapPath;     // path.snap
+      std::string deltaPath;    // path.delta
+      size_t maxDeltas;         // the longest chain before a full snapshot
+      uint64_t generation;      // of the snapshot the chain follows
+      size_t numDeltas;         // in the chain
+      size_t deltaBytes;        // of the chain, headers and all
+      size_t snapBytes;         // of the snapshot
+      bool known;               // the counts above match the files
+   };
+
+   /*****************************************
+    * INCREMENTAL SNAPSHOT :: SAVE
+    * Append a delta of what changed in us since the
+    * last save, or take a full snapshot if a delta
+    * would not do or the chain is long enough
+    *     OUTPUT : true if us is on disk as it is now
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool incremental_snapshot <T, H, E, S> ::save(set_type& us)
+   {
+      if (!known || us.dirty_all() || numDeltas >= maxDeltas || deltaBytes >= snapBytes)
+         return save_full(us);
+      return saveDelta(us);
+   }
+
+   /*****************************************
+    * INCREMENTAL SNAPSHOT :: SAVE FULL
+    * Write us as the next generation's snapshot, then
+    * start an empty chain for that generation. A crash
+    * between the two leaves a chain from the old
+    * generation, which load() ignores.
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool incremental_snapshot <T, H, E, S> ::save_full(set_type& us)
+   {
+      if (!known)
+      {
+         // whatever is on disk, the next generation must be newer
+         generation = 0;
+         int fd = ::open(snapPath.c_str(), O_RDONLY);
+         if (fd >= 0)
+         {
+            if (::read(fd, &generation, sizeof(generation)) != (ssize_t)sizeof(generation))
+               generation = 0;
+            ::close(fd);
+         }
+      }
+
+      std::string tmp = snapPath + ".tmp";
+      int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0)
+         return false;
+      uint64_t newGeneration = generation + 1;
+      bool ok = snapshot_detail::write_all(fd, (const char*)&newGeneration, sizeof(newGeneration)) &&
+                us.template save<S>(fd) && snapshot_detail::sync_file(fd);
+      off_t end = lseek(fd, 0, SEEK_END);
+      ::close(fd);
+
+      // the rename must be on disk before the chain it makes stale is emptied
+      if (!ok || std::rename(tmp.c_str(), snapPath.c_str()) != 0 ||
+          !snapshot_detail::sync_directory(snapPath))
+      {
+         unlink(tmp.c_str());
+         return false;
+      }
+
+      known = false;
+      if (!startChain(newGeneration))
+         return false;
+      snapBytes = end > 0 ? (size_t)end : 0;
+      known = true;
+      us.clear_dirty();
+      return true;
+   }
+
+   /*****************************************
+    * INCREMENTAL SNAPSHOT :: SAVE DELTA
+    * Append the pages that changed as one record. If
+    * it cannot all be written, the log is cut back so
+    * the next delta does not land after a torn one.
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool incremental_snapshot <T, H, E, S> ::saveDelta(set_type& us)
+   {
+      std::ostringstream out;
+      if (!us.template save_delta<S>(out))
+         return false;
+      std::string record(recordBytes, '\0');
+      record += out.str();
+      uint64_t length = record.size() - recordBytes;
+      std::memcpy(&record[sizeof(uint32_t)], &length, sizeof(length));
+      uint32_t sum = snapshot_detail::checksum(&record[sizeof(uint32_t)], record.size() - sizeof(uint32_t));
+      std::memcpy(&record[0], &sum, sizeof(sum));
+
+      int fd = ::open(deltaPath.c_str(), O_WRONLY);
+      if (fd < 0)
+      {
+         known = false;
+         return false;
+      }
+      off_t before = lseek(fd, 0, SEEK_END);
+      bool ok = before >= 0 && snapshot_detail::write_all(fd, record.data(), record.size()) &&
+                snapshot_detail::sync_file(fd);
+      if (!ok && before >= 0 && ftruncate(fd, before) != 0)
+         known = false;
+      ::close(fd);
+      if (!ok)
+         return false;
+
+      numDeltas++;
+      deltaBytes += record.size();
+      us.clear_dirty();
+      return true;
+   }
+
+   /*****************************************
+    * INCREMENTAL SNAPSHOT :: LOAD
+    * Load the snapshot into us and replay the chain
+    * that follows it, cutting off a torn last delta.
+    * Afterwards the next save() can be a delta.
+    *     OUTPUT : false, and an empty set, if the files
+    *              could not be read
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool incremental_snapshot <T, H, E, S> ::load(set_type& us)
+   {
+      known = false;
+      uint64_t onDisk = readSnapshot(us);
+      if (onDisk == (uint64_t)-1)
+      {
+         us.clear();
+         return false;
+      }
+      generation = onDisk;
+      if (!replay(us))
+      {
+         us.clear();
+         return false;
+      }
+      known = true;
+      us.clear_dirty();
+      return true;
+   }
+
+   /*****************************************
+    * INCREMENTAL SNAPSHOT :: COMPACT
+    * Merge the chain into a new full snapshot, from
+    * the files alone
+    *     OUTPUT : true if the chain is empty now
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool incremental_snapshot <T, H, E, S> ::compact()
+   {
+      set_type merged;
+      if (!load(merged))
+         return false;
+      if (numDeltas == 0)
+         return true;
+      return save_full(merged);
+   }
+
+   /*****************************************
+    * INCREMENTAL SNAPSHOT :: READ SNAPSHOT
+    * Load path.snap into us, if there is one
+    *     OUTPUT : its generation, 0 if there is no
+    *              snapshot, or -1 if it could not be read
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   uint64_t incremental_snapshot <T, H, E, S> ::readSnapshot(set_type& us)
+   {
+      us.clear();
+      snapBytes = 0;
+      int fd = ::open(snapPath.c_str(), O_RDONLY);
+      if (fd < 0)
+         return errno == ENOENT ? 0 : (uint64_t)-1;
+      uint64_t snapGeneration = (uint64_t)-1;
+      struct stat info;
+      if (fstat(fd, &info) == 0 &&
+          ::read(fd, &snapGeneration, sizeof(snapGeneration)) == (ssize_t)sizeof(snapGeneration) &&
+          us.template load<S>(fd))
+         snapBytes = (size_t)info.st_size;
+      else
+         snapGeneration = (uint64_t)-1;
+      ::close(fd);
+      return snapGeneration;
+   }
+
+   /*****************************************
+    * INCREMENTAL SNAPSHOT :: REPLAY
+    * Apply each whole, intact delta of a chain that
+    * follows this generation's snapshot. A stale or
+    * missing chain is started over.
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool incremental_snapshot <T, H, E, S> ::replay(set_type& us)
+   {
+      numDeltas = 0;
+      deltaBytes = 0;
+      int fd = ::open(deltaPath.c_str(), O_RDWR);
+      if (fd < 0)
+         return errno == ENOENT && startChain(generation);
+      std::string log;
+      char buffer[65536];
+      ssize_t got;
+      while ((got = ::read(fd, buffer, sizeof(buffer))) > 0)
+         log.append(buffer, (size_t)got);
+
+      delta_header header;
+      if (got < 0 || log.size() < sizeof(header))
+      {
+         ::close(fd);
+         return got == 0 && startChain(generation);
+      }
+      std::memcpy(&header, log.data(), sizeof(header));
+      if (header.magic != deltaMagic || header.version != SNAPSHOT_VERSION ||
+          header.generation != generation)
+      {
+         ::close(fd);
+         return startChain(generation);
+      }
+
+      size_t offset = sizeof(header);
+      while (offset + recordBytes <= log.size())
+      {
+         uint32_t sum;
+         uint64_t length;
+         std::memcpy(&sum, log.data() + offset, sizeof(sum));
+         std::memcpy(&length, log.data() + offset + sizeof(sum), sizeof(length));
+         if (length > log.size() - offset - recordBytes ||
+             snapshot_detail::checksum(log.data() + offset + sizeof(sum),
+                                       sizeof(length) + length) != sum)
+            break;
+
+         // intact but not for this set: the chain cannot be trusted past here
+         std::istringstream in(log.substr(offset + recordBytes, length));
+         if (!us.template apply_delta<S>(in))
+         {
+            ::close(fd);
+            return false;
+         }
+         offset += recordBytes + length;
+         numDeltas++;
+      }
+      deltaBytes = offset - sizeof(header);
+
+      bool ok = offset == log.size() || (ftruncate(fd, (off_t)offset) == 0 && snapshot_detail::sync_file(fd));
+      ::close(fd);
+      return ok;
+   }
+
+   /*****************************************
+    * INCREMENTAL SNAPSHOT :: START CHAIN
+    * Empty the delta log and give it a header for
+    * newGeneration
+    ****************************************/
+   template <typename T, typename H, typename E, typename S>
+   bool incremental_snapshot <T, H, E, S> ::startChain(uint64_t newGeneration)
+   {
+      int fd = ::open(deltaPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0)
+         return false;
+      delta_header header = { deltaMagic, SNAPSHOT_VERSION, newGeneration };
+      bool ok = snapshot_detail::write_all(fd, (const char*)&header, sizeof(header)) && snapshot_detail::sync_file(fd);
+      ::close(fd);
+      if (!ok)
+         return false;
+      generation = newGeneration;
+      numDeltas = 0;
+      deltaBytes = 0;
+      return true;
+   }
+
+} // namespace custom
+
+#endif // CUSTOM_SNAPSHOT_POSIX
@@ -0,0 +1,274 @@
+/***********************************************************************
+ * Header:
+ *    INDEXED HEAP
+ * Summary:
+ *    A priority queue of keys that can find any key in O(1) and move
+ *    it in O(log n). A plain heap cannot change an entry once it is
+ *    in, so callers push a second copy and skip the stale one later;
+ *    this one updates the entry where it is.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        indexed_heap : a d-ary heap with a key to position index
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <functional>       // for std::greater, std::hash
+#include <utility>          // for std::move
+#include "vector.h"         // for the heap array
+#include "hash.h"           // for the key index
+#include "pair.h"           // for key and position
+
+class TestIndexedHeap; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************
+    * INDEXED HEAP
+    * heap holds (key, priority) as a D-ary heap. index
+    * is an unordered_set of (key, position) pairs;
+    * custom::pair compares only the key, so a lookup
+    * by key finds the entry and we rewrite its position
+    * in place whenever the heap moves that key.
+    *
+    * The default comparison puts the smallest priority
+    * on top, which is what timers and shortest paths
+    * want. decrease_key() and increase_key() name the
+    * change to the priority value, not the direction
+    * it moves in the heap.
+    ****************************************/
+   template <typename Key,
+             typename Priority,
+             typename Compare = std::greater<Priority>,
+             typename KeyHash = std::hash<Key>,
+             size_t D = 4>
+   class indexed_heap
+   {
+      friend class ::TestIndexedHeap; // give unit tests access to the privates
+      static_assert(D >= 2, "a heap needs at least two children per node");
+   public:
+
+      // one heap slot
+      struct entry
+      {
+         Key key;
+         Priority priority;
+      };
+
+      //
+      // Construct
+      //
+      indexed_heap(const Compare& c = Compare()) : comp(c) {}
+
+      //
+      // Access
+      //
+      const Key& top_key() const           { assert(!empty()); return heap.front().key; }
+      const Priority& top_priority() const { assert(!empty()); return heap.front().priority; }
+      bool contains(const Key& key)        { return index.find(position(key)) != index.end(); }
+      const Priority& priority(const Key& key)
+      {
+         return heap[where(key)].priority;
+      }
+
+      //
+      // Insert
+      //
+      bool push(const Key& key, const Priority& priority);
+      void update(const Key& key, const Priority& priority);
+      void decrease_key(const Key& key, const Priority& priority)
+      {
+         assert(!(heap[where(key)].priority < priority));
+         update(key, priority);
+      }
+      void increase_key(const Key& key, const Priority& priority)
+      {
+         assert(!(priority < heap[where(key)].priority));
+         update(key, priority);
+      }
+      void reserve(size_t newCapacity)
+      {
+         heap.reserve(newCapacity);
+         index.reserve(newCapacity);
+      }
+
+      //
+      // Remove
+      //
+      void pop();
+      bool erase(const Key& key);
+      void clear()
+      {
+         heap.clear();
+         index.clear();
+      }
+
+      //
+      // Status
+      //
+      size_t size() const { return heap.size(); }
+      bool empty()  const { return heap.empty(); }
+
+   private:
+
+      typedef custom::pair<Key, size_t> position;
+
+      // hash a (key, position) by the key alone
+      struct position_hash
+      {
+         size_t operator () (const position& p) const { return KeyHash()(p.first); }
+      };
+
+      static size_t parent(size_t i)     { return (i - 1) / D; }
+      static size_t firstChild(size_t i) { return i * D + 1; }
+
+      size_t where(const Key& key)
+      {
+         typename custom::unordered_set<position, position_hash>::iterator it = index.find(position(key));
+         assert(it != index.end());
+         return (*it).second;
+      }
+      void place(size_t i, entry&& e)
+      {
+         (*index.find(position(e.key))).second = i;
+         heap[i] = std::move(e);
+      }
+      void removeAt(size_t i);
+      void siftUp(size_t i);
+      void siftDown(size_t i);
+
+      custom::vector<entry> heap;                                   // the heap, root first
+      custom::unordered_set<position, position_hash> index;         // key to heap position
+      Compare comp;                                                 // comp(a, b) when a goes below b
+   };
+
+   /*****************************************
+    * INDEXED HEAP :: SIFT UP / SIFT DOWN
+    * Move the entry at i in a hole, as priority_queue
+    * does, recording the new position of every entry
+    * that moves
+    ****************************************/
+   template <typename K, typename P, typename C, typename H, size_t D>
+   void indexed_heap <K, P, C, H, D> ::siftUp(size_t i)
+   {
+      entry value = std::move(heap[i]);
+      while (i > 0 && comp(heap[parent(i)].priority, value.priority))
+      {
+         place(i, std::move(heap[parent(i)]));
+         i = parent(i);
+      }
+      place(i, std::move(value));
+   }
+
+   template <typename K, typename P, typename C, typename H, size_t D>
+   void indexed_heap <K, P, C, H, D> ::siftDown(size_t i)
+   {
+      size_t num = heap.size();
+      entry value = std::move(heap[i]);
+      for (;;)
+      {
+         size_t first = firstChild(i);
+         if (first >= num)
+            break;
+         size_t last = (num - first < D) ? num : first + D;
+         size_t best = first;
+         for (size_t c = first + 1; c < last; c++)
+            if (comp(heap[best].priority, heap[c].priority))
+               best = c;
+         if (!comp(value.priority, heap[best].priority))
+            break;
+         place(i, std::move(heap[best]));
+         i = best;
+      }
+      place(i, std::move(value));
+   }
+
+   /*****************************************
+    * INDEXED HEAP :: PUSH
+    * Add a key that is not already in the heap
+    *     OUTPUT : false if the key was already there
+    ****************************************/
+   template <typename K, typename P, typename C, typename H, size_t D>
+   bool indexed_heap <K, P, C, H, D> ::push(const K& key, const P& priority)
+   {
+      if (!index.insert(position(key, heap.size())).second)
+         return false;
+      entry e = { key, priority };
+      heap.push_back(std::move(e));
+      siftUp(heap.size() - 1);
+      return true;
+   }
+
+   /*****************************************
+    * INDEXED HEAP :: UPDATE
+    * Give a key a new priority and let it move up
+    * or down to where it now belongs
+    ****************************************/
+   template <typename K, typename P, typename C, typename H, size_t D>
+   void indexed_heap <K, P, C, H, D> ::update(const K& key, const P& priority)
+   {
+      size_t i = where(key);
+      bool up = comp(heap[i].priority, priority);
+      heap[i].priority = priority;
+      if (up)
+         siftUp(i);
+      else
+         siftDown(i);
+   }
+
+   /*****************************************
+    * INDEXED HEAP :: REMOVE AT
+    * Fill slot i with the last entry, then move that
+    * entry whichever way it needs to go
+    ****************************************/
+   template <typename K, typename P, typename C, typename H, size_t D>
+   void indexed_heap <K, P, C, H, D> ::removeAt(size_t i)
+   {
+      index.erase(position(heap[i].key));
+      size_t last = heap.size() - 1;
+      if (i != last)
+      {
+         bool up = comp(heap[i].priority, heap[last].priority);
+         place(i, std::move(heap[last]));
+         heap.pop_back();
+         if (up)
+            siftUp(i);
+         else
+            siftDown(i);
+      }
+      else
+         heap.pop_back();
+   }
+
+   /*****************************************
+    * INDEXED HEAP :: POP / ERASE
+    ****************************************/
+   template <typename K, typename P, typename C, typename H, size_t D>
+   void indexed_heap <K, P, C, H, D> ::pop()
+   {
+      assert(!empty());
+      removeAt(0);
+   }
+
+   template <typename K, typename P, typename C, typename H, size_t D>
+   bool indexed_heap <K, P, C, H, D> ::erase(const K& key)
+   {
+      typename custom::unordered_set<position, position_hash>::iterator it = index.find(position(key));
+      if (it == index.end())
+         return false;
+      removeAt((*it).second);
+      return true;
+   }
+
+} // namespace custom
@@ -0,0 +1,269 @@
+/***********************************************************************
+ * Header:
+ *    INTRUSIVE LIST
+ * Summary:
+ *    A doubly linked list that links objects the caller already owns.
+ *    The pointers live in a list_hook member of the object, so adding
+ *    an object never allocates or copies it, and one object can sit in
+ *    as many lists as it has hooks.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        list_hook                : The links an object embeds
+ *        intrusive_list           : A list of objects through one hook
+ *        intrusive_list::iterator : An iterator through intrusive_list
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <utility>          // for std::swap
+
+class TestIntrusiveList; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /**************************************************
+    * LIST HOOK
+    * Put one of these in a class for each list it can
+    * be in. A hook that is not in a list points at
+    * itself. Copying an object does not copy its
+    * membership, and destroying one that is still in
+    * a list is a bug we catch here.
+    **************************************************/
+   struct list_hook
+   {
+      list_hook() : pNext(this), pPrev(this) {}
+      list_hook(const list_hook&) : pNext(this), pPrev(this) {}
+      list_hook& operator = (const list_hook&) { return *this; }
+      ~list_hook() { assert(!is_linked()); }
+
+      bool is_linked() const { return pNext != this; }
+
+      list_hook* pNext;   // next hook in the list, nullptr at the end
+      list_hook* pPrev;   // previous hook in the list, nullptr at the front
+   };
+
+   /**************************************************
+    * INTRUSIVE LIST
+    * The list API over objects linked through their
+    * Hook member. The list never owns the objects:
+    * erase() and clear() unlink them and leave them
+    * alive, and the objects must outlive their time
+    * in the list.
+    **************************************************/
+   template <typename T, list_hook T::*Hook>
+   class intrusive_list
+   {
+      friend class ::TestIntrusiveList; // give unit tests access to the privates
+   public:
+
+      //
+      // Construct
+      //
+      intrusive_list() : numElements(0), pHead(nullptr), pTail(nullptr) {}
+      intrusive_list(const intrusive_list&) = delete;
+      intrusive_list(intrusive_list&& rhs) : intrusive_list()
+      {
+         swap(rhs);
+      }
+      ~intrusive_list()
+      {
+         clear();
+      }
+
+      //
+      // Assign
+      //
+      intrusive_list& operator = (const intrusive_list&) = delete;
+      intrusive_list& operator = (intrusive_list&& rhs)
+      {
+         clear();
+         swap(rhs);
+         return *this;
+      }
+      void swap(intrusive_list& rhs)
+      {
+         std::swap(numElements, rhs.numElements);
+         std::swap(pHead, rhs.pHead);
+         std::swap(pTail, rhs.pTail);
+      }
+
+      //
+      // Iterator
+      //
+      class iterator;
+      iterator begin()  { return iterator(pHead); }
+      iterator rbegin() { return iterator(pTail); }
+      iterator end()    { return iterator(nullptr); }
+      iterator iterator_to(T& t)
+      {
+         assert((t.*Hook).is_linked());
+         return iterator(&(t.*Hook));
+      }
+
+      //
+      // Access
+      //
+      T& front() { assert(pHead); return *owner(pHead); }
+      T& back()  { assert(pTail); return *owner(pTail); }
+
+      //
+      // Insert
+      //
+      void push_front(T& t) { insert(begin(), t); }
+      void push_back(T& t)  { insert(end(), t); }
+      iterator insert(iterator it, T& t);
+
+      //
+      // Remove
+      //
+      void pop_front() { if (pHead) erase(begin()); }
+      void pop_back()  { if (pTail) erase(rbegin()); }
+      void remove(T& t) { erase(iterator_to(t)); }
+      iterator erase(iterator it);
+      void clear();
+
+      //
+      // Status
+      //
+      bool empty()  const { return pHead == nullptr; }
+      size_t size() const { return numElements; }
+
+   private:
+
+      // the object a hook is embedded in
+      static T* owner(list_hook* p)
+      {
+         // where Hook sits in a T, measured from a T at a made-up address
+         const size_t probe = 4096;
+         size_t offset = (size_t)&(((T*)probe)->*Hook) - probe;
+         return (T*)((char*)p - offset);
+      }
+
+      size_t numElements;  // though we could count, it is faster to keep a variable
+      list_hook* pHead;    // the first object's hook
+      list_hook* pTail;    // the last object's hook
+   };
+
+   /*************************************************
+    * INTRUSIVE LIST ITERATOR
+    * Walk the hooks, hand back the objects
+    ************************************************/
+   template <typename T, list_hook T::*Hook>
+   class intrusive_list <T, Hook> ::iterator
+   {
+      friend class ::TestIntrusiveList; // give unit tests access to the privates
+      template <typename TT, list_hook TT::*HH>
+      friend class custom::intrusive_list;
+   public:
+      // constructors, destructors, and assignment operator
+      iterator() : p(nullptr) {}
+      iterator(list_hook* p) : p(p) {}
+      iterator(const iterator& rhs) : p(rhs.p) {}
+      iterator& operator = (const iterator& rhs)
+      {
+         p = rhs.p;
+         return *this;
+      }
+
+      // equals, not equals operator
+      bool operator == (const iterator& rhs) const { return p == rhs.p; }
+      bool operator != (const iterator& rhs) const { return p != rhs.p; }
+
+      // dereference operator, fetch the object
+      T& operator * () { return *owner(p); }
+
+      // increment and decrement
+      iterator& operator ++ () { p = p->pNext; return *this; }
+      iterator operator ++ (int) { iterator tmp = *this; p = p->pNext; return tmp; }
+      iterator& operator -- () { p = p->pPrev; return *this; }
+      iterator operator -- (int) { iterator tmp = *this; p = p->pPrev; return tmp; }
+
+   private:
+      list_hook* p;   // the hook, nullptr at the end
+   };
+
+   /******************************************
+    * INTRUSIVE LIST :: INSERT
+    * Link t in front of it
+    *     INPUT  : where t goes, and an object that
+    *              is not yet in a list through Hook
+    *     OUTPUT : iterator to t
+    *     COST   : O(1), no allocations
+    ******************************************/
+   template <typename T, list_hook T::*Hook>
+   typename intrusive_list <T, Hook> ::iterator intrusive_list <T, Hook> ::insert(iterator it, T& t)
+   {
+      list_hook* pNew = &(t.*Hook);
+      assert(!pNew->is_linked());
+      list_hook* pBefore = it.p ? it.p->pPrev : pTail;
+      pNew->pPrev = pBefore;
+      pNew->pNext = it.p;
+      if (pBefore)
+         pBefore->pNext = pNew;
+      else
+         pHead = pNew;
+      if (it.p)
+         it.p->pPrev = pNew;
+      else
+         pTail = pNew;
+      numElements++;
+      return iterator(pNew);
+   }
+
+   /******************************************
+    * INTRUSIVE LIST :: ERASE
+    * Unlink the object at it. The object itself is
+    * untouched and can go into a list again.
+    *     OUTPUT : iterator to what followed it
+    *     COST   : O(1)
+    ******************************************/
+   template <typename T, list_hook T::*Hook>
+   typename intrusive_list <T, Hook> ::iterator intrusive_list <T, Hook> ::erase(iterator it)
+   {
+      list_hook* p = it.p;
+      assert(p && p->is_linked());
+      if (p->pPrev)
+         p->pPrev->pNext = p->pNext;
+      else
+         pHead = p->pNext;
+      if (p->pNext)
+         p->pNext->pPrev = p->pPrev;
+      else
+         pTail = p->pPrev;
+      iterator next(p->pNext);
+      p->pNext = p->pPrev = p;
+      numElements--;
+      return next;
+   }
+
+   /******************************************
+    * INTRUSIVE LIST :: CLEAR
+    * Unlink every object
+    *     COST   : O(n)
+    ******************************************/
+   template <typename T, list_hook T::*Hook>
+   void intrusive_list <T, Hook> ::clear()
+   {
+      list_hook* p = pHead;
+      while (p)
+      {
+         list_hook* pNext = p->pNext;
+         p->pNext = p->pPrev = p;
+         p = pNext;
+      }
+      pHead = pTail = nullptr;
+      numElements = 0;
+   }
+
+} // namespace custom
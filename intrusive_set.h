@@ -0,0 +1,365 @@
+/***********************************************************************
+ * Header:
+ *    INTRUSIVE SET
+ * Summary:
+ *    A chaining hash set that links objects the caller already owns.
+ *    The chain pointer and the cached hash live in a set_hook member
+ *    of the object, so indexing an object never allocates a node or
+ *    copies its key, and one object can sit in as many sets as it
+ *    has hooks.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        set_hook                          : The link an object embeds
+ *        intrusive_unordered_set           : A hash of objects through one hook
+ *        intrusive_unordered_set::iterator : An iterator through the hash
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <cmath>            // for std::ceil
+#include <functional>       // for std::hash, std::equal_to
+#include <utility>          // for std::swap
+#include "vector.h"         // for the bucket array
+#include "pair.h"           // for the insert result
+
+class TestIntrusiveSet; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /**************************************************
+    * SET HOOK
+    * Put one of these in a class for each set it can
+    * be in. The hash is cached so a rehash never calls
+    * the hash function again. A hook that is not in a
+    * set points at itself.
+    **************************************************/
+   struct set_hook
+   {
+      set_hook() : pNext(this), hash(0) {}
+      set_hook(const set_hook&) : pNext(this), hash(0) {}
+      set_hook& operator = (const set_hook&) { return *this; }
+      ~set_hook() { assert(!is_linked()); }
+
+      bool is_linked() const { return pNext != this; }
+
+      set_hook* pNext;   // next hook in the bucket, nullptr at the end
+      size_t hash;       // Hash of the object when it went in
+   };
+
+   /**************************************************
+    * INTRUSIVE UNORDERED SET
+    * The unordered_set API over objects linked through
+    * their Hook member. Each bucket is the head of a
+    * singly linked chain. The set never owns the
+    * objects: erase() and clear() unlink them and the
+    * objects must outlive their time in the set.
+    **************************************************/
+   template <typename T,
+             set_hook T::*Hook,
+             typename Hash = std::hash<T>,
+             typename EqPred = std::equal_to<T>>
+   class intrusive_unordered_set
+   {
+      friend class ::TestIntrusiveSet; // give unit tests access to the privates
+   public:
+
+      //
+      // Construct
+      //
+      intrusive_unordered_set(size_t numBuckets = 8)
+         : buckets(numBuckets ? numBuckets : 1, nullptr), numElements(0), maxLoadFactor(1.0) {}
+      intrusive_unordered_set(const intrusive_unordered_set&) = delete;
+      intrusive_unordered_set(intrusive_unordered_set&& rhs) : intrusive_unordered_set()
+      {
+         swap(rhs);
+      }
+      ~intrusive_unordered_set()
+      {
+         clear();
+      }
+
+      //
+      // Assign
+      //
+      intrusive_unordered_set& operator = (const intrusive_unordered_set&) = delete;
+      intrusive_unordered_set& operator = (intrusive_unordered_set&& rhs)
+      {
+         clear();
+         swap(rhs);
+         return *this;
+      }
+      void swap(intrusive_unordered_set& rhs)
+      {
+         buckets.swap(rhs.buckets);
+         std::swap(numElements, rhs.numElements);
+         std::swap(maxLoadFactor, rhs.maxLoadFactor);
+      }
+
+      //
+      // Iterator
+      //
+      class iterator;
+      iterator begin()
+      {
+         for (size_t i = 0; i < buckets.size(); i++)
+            if (buckets[i])
+               return iterator(&buckets, i, buckets[i]);
+         return end();
+      }
+      iterator end() { return iterator(); }
+      iterator iterator_to(T& t)
+      {
+         set_hook* p = &(t.*Hook);
+         assert(p->is_linked());
+         return iterator(&buckets, p->hash % buckets.size(), p);
+      }
+
+      //
+      // Access
+      //
+      iterator find(const T& t)
+      {
+         return find(t, Hash(), EqPred());
+      }
+      template <class K, class KeyHash, class KeyEq>
+      iterator find(const K& key, const KeyHash& keyHash, const KeyEq& keyEq);
+      bool contains(const T& t) { return find(t) != end(); }
+
+      //
+      // Insert
+      //
+      custom::pair<iterator, bool> insert(T& t);
+      void rehash(size_t numBuckets);
+      void reserve(size_t num)
+      {
+         rehash(min_buckets_required(num));
+      }
+
+      //
+      // Remove
+      //
+      iterator erase(iterator it);
+      bool erase(T& t)
+      {
+         if (!(t.*Hook).is_linked())
+            return false;
+         erase(iterator_to(t));
+         return true;
+      }
+      void clear();
+
+      //
+      // Status
+      //
+      size_t size() const         { return numElements; }
+      bool empty() const          { return numElements == 0; }
+      size_t bucket_count() const { return buckets.size(); }
+      size_t bucket_size(size_t i) const
+      {
+         size_t num = 0;
+         for (set_hook* p = buckets[i]; p; p = p->pNext)
+            num++;
+         return num;
+      }
+      float load_factor() const      { return (float)size() / (float)bucket_count(); }
+      float max_load_factor() const  { return maxLoadFactor; }
+      void  max_load_factor(float m) { maxLoadFactor = m; }
+
+   private:
+
+      // the object a hook is embedded in
+      static T* owner(set_hook* p)
+      {
+         // where Hook sits in a T, measured from a T at a made-up address
+         const size_t probe = 4096;
+         size_t offset = (size_t)&(((T*)probe)->*Hook) - probe;
+         return (T*)((char*)p - offset);
+      }
+      size_t min_buckets_required(size_t num) const
+      {
+         return (size_t)std::ceil(num / maxLoadFactor);
+      }
+
+      custom::vector<set_hook*> buckets;   // the first hook of each chain
+      size_t numElements;                  // the number of objects in the set
+      float maxLoadFactor;                 // the ratio of elements to buckets signifying a rehash
+   };
+
+   /************************************************
+    * INTRUSIVE UNORDERED SET ITERATOR
+    * A bucket and a hook in its chain
+    ************************************************/
+   template <typename T, set_hook T::*Hook, typename H, typename E>
+   class intrusive_unordered_set <T, Hook, H, E> ::iterator
+   {
+      friend class ::TestIntrusiveSet; // give unit tests access to the privates
+      template <typename TT, set_hook TT::*HH, typename HHH, typename EE>
+      friend class custom::intrusive_unordered_set;
+   public:
+      // constructors, destructors, and assignment operator
+      iterator() : pBuckets(nullptr), iBucket(0), p(nullptr) {}
+      iterator(custom::vector<set_hook*>* pBuckets, size_t iBucket, set_hook* p)
+         : pBuckets(pBuckets), iBucket(iBucket), p(p) {}
+
+      // equals, not equals operator. Every end() has a null hook.
+      bool operator == (const iterator& rhs) const { return p == rhs.p; }
+      bool operator != (const iterator& rhs) const { return p != rhs.p; }
+
+      // dereference operator, fetch the object
+      T& operator * () { return *owner(p); }
+
+      // increment, moving to the next non-empty bucket at the end of a chain
+      iterator& operator ++ ()
+      {
+         p = p->pNext;
+         while (p == nullptr && ++iBucket < pBuckets->size())
+            p = (*pBuckets)[iBucket];
+         return *this;
+      }
+      iterator operator ++ (int) { iterator tmp = *this; ++(*this); return tmp; }
+
+   private:
+      custom::vector<set_hook*>* pBuckets;   // the set's buckets
+      size_t iBucket;                        // the bucket p is in
+      set_hook* p;                           // the hook, nullptr at the end
+   };
+
+   /*****************************************
+    * INTRUSIVE UNORDERED SET :: FIND
+    * Look up by anything that hashes the same way as
+    * the objects, so a caller holding only a key need
+    * not build a whole object to search with
+    *     INPUT  : the key, its hash, and keyEq(key, t)
+    *     OUTPUT : the matching object, or end()
+    ****************************************/
+   template <typename T, set_hook T::*Hook, typename H, typename E>
+   template <class K, class KeyHash, class KeyEq>
+   typename intrusive_unordered_set <T, Hook, H, E> ::iterator
+      intrusive_unordered_set <T, Hook, H, E> ::find(const K& key, const KeyHash& keyHash, const KeyEq& keyEq)
+   {
+      size_t hash = keyHash(key);
+      size_t iBucket = hash % buckets.size();
+      for (set_hook* p = buckets[iBucket]; p; p = p->pNext)
+         if (p->hash == hash && keyEq(key, *owner(p)))
+            return iterator(&buckets, iBucket, p);
+      return end();
+   }
+
+   /*****************************************
+    * INTRUSIVE UNORDERED SET :: INSERT
+    * Link t at the head of its chain unless an equal
+    * object is already there
+    *     OUTPUT : the object in the set, and whether
+    *              it was t that went in
+    *     COST   : O(1) average, no allocations except
+    *              when the bucket array grows
+    ****************************************/
+   template <typename T, set_hook T::*Hook, typename H, typename E>
+   custom::pair<typename intrusive_unordered_set <T, Hook, H, E> ::iterator, bool>
+      intrusive_unordered_set <T, Hook, H, E> ::insert(T& t)
+   {
+      set_hook* pNew = &(t.*Hook);
+      assert(!pNew->is_linked());
+
+      iterator it = find(t);
+      if (it != end())
+         return custom::pair<iterator, bool>(it, false);
+
+      if (min_buckets_required(numElements + 1) > bucket_count())
+         rehash(bucket_count() * 2);
+
+      pNew->hash = H()(t);
+      size_t iBucket = pNew->hash % buckets.size();
+      pNew->pNext = buckets[iBucket];
+      buckets[iBucket] = pNew;
+      numElements++;
+      return custom::pair<iterator, bool>(iterator(&buckets, iBucket, pNew), true);
+   }
+
+   /*****************************************
+    * INTRUSIVE UNORDERED SET :: REHASH
+    * Relink every hook into a larger bucket array
+    * using the hash cached in the hook
+    ****************************************/
+   template <typename T, set_hook T::*Hook, typename H, typename E>
+   void intrusive_unordered_set <T, Hook, H, E> ::rehash(size_t numBuckets)
+   {
+      if (numBuckets <= bucket_count())
+         return;
+
+      custom::vector<set_hook*> newBuckets(numBuckets, nullptr);
+      for (size_t i = 0; i < buckets.size(); i++)
+      {
+         set_hook* p = buckets[i];
+         while (p)
+         {
+            set_hook* pNext = p->pNext;
+            size_t iNew = p->hash % numBuckets;
+            p->pNext = newBuckets[iNew];
+            newBuckets[iNew] = p;
+            p = pNext;
+         }
+      }
+      buckets.swap(newBuckets);
+   }
+
+   /*****************************************
+    * INTRUSIVE UNORDERED SET :: ERASE
+    * Unlink the object at it, walking its chain to
+    * find the link that points at it
+    *     OUTPUT : iterator to the next object
+    ****************************************/
+   template <typename T, set_hook T::*Hook, typename H, typename E>
+   typename intrusive_unordered_set <T, Hook, H, E> ::iterator
+      intrusive_unordered_set <T, Hook, H, E> ::erase(iterator it)
+   {
+      set_hook* p = it.p;
+      assert(p && p->is_linked());
+      iterator next = it;
+      ++next;
+
+      set_hook** ppLink = &buckets[it.iBucket];
+      while (*ppLink != p)
+      {
+         assert(*ppLink);
+         ppLink = &(*ppLink)->pNext;
+      }
+      *ppLink = p->pNext;
+      p->pNext = p;
+      numElements--;
+      return next;
+   }
+
+   /*****************************************
+    * INTRUSIVE UNORDERED SET :: CLEAR
+    * Unlink every object, keeping the buckets
+    ****************************************/
+   template <typename T, set_hook T::*Hook, typename H, typename E>
+   void intrusive_unordered_set <T, Hook, H, E> ::clear()
+   {
+      for (size_t i = 0; i < buckets.size(); i++)
+      {
+         set_hook* p = buckets[i];
+         while (p)
+         {
+            set_hook* pNext = p->pNext;
+            p->pNext = p;
+            p = pNext;
+         }
+         buckets[i] = nullptr;
+      }
+      numElements = 0;
+   }
+
+} // namespace custom
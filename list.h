@@ -23,6 +23,8 @@
 #include <new>              // std::bad_alloc
 #include <memory>           // for std::allocator
 #include <initializer_list> // for std::initializer_list
+#include <functional>       // for std::less, std::equal_to
+#include "node_pool.h"      // for where the nodes live
 
 class TestList; // forward declaration for unit tests
 class TestHash; // forward declaration for hash used later
@@ -50,15 +52,13 @@ namespace custom
       list(list <T, A>& rhs, const A& a = A())
          : alloc(a), numElements(0), pHead(nullptr), pTail(nullptr)
       {
-         if (rhs.pHead != nullptr)
+         Node* pCurrent = rhs.pHead;
+         appendBulk(rhs.numElements, [&pCurrent](void* pSlot)
          {
-            Node* pCurrent = rhs.pHead;
-            while (pCurrent != nullptr)
-            {
-               push_back(pCurrent->data); // Copy each node's data
-               pCurrent = pCurrent->pNext;
-            }
-         }
+            Node* pNew = new (pSlot) Node(pCurrent->data); // Copy each node's data
+            pCurrent = pCurrent->pNext;
+            return pNew;
+         });
       }
       list(list <T, A>&& rhs, const A& a = A());
       list(size_t num, const T& t, const A& a = A());
@@ -66,15 +66,22 @@ namespace custom
       list(const std::initializer_list<T>& il, const A& a = A())
          : alloc(a), numElements(0), pHead(nullptr), pTail(nullptr)
       {
-         for (const T& item : il)
-            push_back(item); // Copy each element from the initializer list
+         const T* pItem = il.begin();
+         appendBulk(il.size(), [&pItem](void* pSlot) { return new (pSlot) Node(*pItem++); });
       }
       template <class Iterator>
       list(Iterator first, Iterator last, const A& a = A())
          : alloc(a), numElements(0), pHead(nullptr), pTail(nullptr)
       {
-         for (Iterator it = first; it != last; ++it)
-            push_back(*it); // Copy each element from the range
+         // the length is unknown, so appendBulk() stops at the first nullptr
+         appendBulk((size_t)-1, [&first, &last](void* pSlot) -> Node*
+         {
+            if (first == last)
+               return nullptr;
+            Node* pNew = new (pSlot) Node(*first); // Copy each element from the range
+            ++first;
+            return pNew;
+         });
       }
       ~list()
       {
@@ -140,6 +147,25 @@ namespace custom
       void clear();
       iterator erase(const iterator& it);
 
+      //
+      // Relink
+      //
+
+      void splice(iterator pos, list <T, A>& rhs);
+      void splice(iterator pos, list <T, A>& rhs, iterator it);
+      void splice(iterator pos, list <T, A>& rhs, iterator first, iterator last);
+      void splice(iterator pos, list <T, A>& rhs, iterator first, iterator last, size_t num);
+      void merge(list <T, A>& rhs) { merge(rhs, std::less<T>()); }
+      template <class Compare>
+      void merge(list <T, A>& rhs, Compare comp);
+      void sort() { sort(std::less<T>()); }
+      template <class Compare>
+      void sort(Compare comp);
+      size_t unique() { return unique(std::equal_to<T>()); }
+      template <class BinaryPredicate>
+      size_t unique(BinaryPredicate pred);
+      void reverse();
+
       //
       // Status
       //
@@ -151,6 +177,10 @@ namespace custom
       // nested linked list class
       class Node;
 
+      void linkBefore(Node* pPos, Node* pFirst, Node* pLast);
+      template <class Make>
+      void appendBulk(size_t num, Make make);
+
       // member variables
       A    alloc;         // use alloacator for memory allocation
       size_t numElements; // though we could count, it is faster to keep a variable
@@ -176,6 +206,22 @@ namespace custom
       Node(const T& data) : pNext(nullptr), pPrev(nullptr), data(data) {}
       Node(T&& data) : pNext(nullptr), pPrev(nullptr), data(std::move(data)) {}
 
+      //
+      // Allocate from the node pool, so new Node and delete
+      // work the same whether or not the node came in bulk
+      //
+      static void* operator new(size_t size)
+      {
+         assert(size == sizeof(Node));
+         return node_pool<sizeof(Node), alignof(Node)>::allocate();
+      }
+      static void operator delete(void* p)
+      {
+         node_pool<sizeof(Node), alignof(Node)>::deallocate(p);
+      }
+      static void* operator new(size_t, void* pSlot) { return pSlot; }
+      static void operator delete(void*, void*) {}
+
       //
       // Member Variables
       //
@@ -255,20 +301,7 @@ namespace custom
    list <T, A> ::list(size_t num, const T& t, const A& a)
       : alloc(a), numElements(0), pHead(0), pTail(0)
    {
-      if (num > 0)
-      {
-         pHead = new Node(t); // Copy constructor should be called here
-         Node* pCurrent = pHead;
-         for (size_t i = 1; i < num; ++i)
-         {
-            Node* pNew = new Node(t); // Copy constructor should be called here
-            pCurrent->pNext = pNew;
-            pNew->pPrev = pCurrent;
-            pCurrent = pNew;
-         }
-         pTail = pCurrent;
-         numElements = num;
-      }
+      appendBulk(num, [&t](void* pSlot) { return new (pSlot) Node(t); });
    }
 
    /*****************************************
@@ -279,23 +312,7 @@ namespace custom
    list <T, A> ::list(size_t num, const A& a)
       : alloc(a), numElements(0), pHead(0), pTail(0)
    {
-      if (num)
-      {
-         list <T, A> ::Node* pPrevious;
-         list <T, A> ::Node* pNew;
-         pHead = pPrevious = pNew = new list <T, A> ::Node();
-         pHead->pPrev = nullptr;
-         for (size_t i = 1; i < num; i++)
-         {
-            pNew = new list <T, A> ::Node();
-            pNew->pPrev = pPrevious;
-            pNew->pPrev->pNext = pNew;
-            pPrevious = pNew;
-         }
-         pNew->pNext = nullptr;
-         pTail = pNew;
-         numElements = num;
-      }
+      appendBulk(num, [](void* pSlot) { return new (pSlot) Node(); });
    }
 
    /*****************************************
@@ -346,11 +363,13 @@ namespace custom
 
       if (itRHS != rhs.end())
       {
-         while (itRHS != rhs.end())
+         Node* pCurrent = itRHS.p;
+         appendBulk(rhs.numElements - numElements, [&pCurrent](void* pSlot)
          {
-            push_back(*itRHS);
-            ++itRHS;
-         }
+            Node* pNew = new (pSlot) Node(pCurrent->data);
+            pCurrent = pCurrent->pNext;
+            return pNew;
+         });
       }
       else if (rhs.empty())
       {
@@ -396,11 +415,7 @@ namespace custom
 
       if (itRHS != rhs.end())
       {
-         while (itRHS != rhs.end())
-         {
-            push_back(*itRHS);
-            ++itRHS;
-         }
+         appendBulk(rhs.end() - itRHS, [&itRHS](void* pSlot) { return new (pSlot) Node(*itRHS++); });
       }
       else if (numElements > rhs.size()) // Initalizer list has no empty()
       {
@@ -750,6 +765,316 @@ namespace custom
          return end();
    }
 
+   /******************************************
+    * LIST :: LINK BEFORE
+    * Hook an already linked chain of nodes in
+    * front of pPos, or at the end if pPos is null.
+    * The caller keeps numElements up to date.
+    *     INPUT  : where the chain goes
+    *              the first and last node of the chain
+    *     COST   : O(1)
+    ******************************************/
+   template <typename T, typename A>
+   void list <T, A> ::linkBefore(Node* pPos, Node* pFirst, Node* pLast)
+   {
+      Node* pBefore = pPos ? pPos->pPrev : pTail;
+      pFirst->pPrev = pBefore;
+      pLast->pNext = pPos;
+      if (pBefore)
+         pBefore->pNext = pFirst;
+      else
+         pHead = pFirst;
+      if (pPos)
+         pPos->pPrev = pLast;
+      else
+         pTail = pLast;
+   }
+
+   /******************************************
+    * LIST :: APPEND BULK
+    * Add num nodes to the end of the list, taking
+    * their memory from the node pool a batch at a time
+    * and linking each as it is built. Nodes built
+    * together sit next to each other in memory.
+    *     INPUT  : how many nodes, or (size_t)-1 if not known
+    *              make(pSlot) builds a node in pSlot and
+    *              returns it, or returns nullptr when done
+    *     COST   : O(num), one pool lock per batch
+    ******************************************/
+   template <typename T, typename A>
+   template <class Make>
+   void list <T, A> ::appendBulk(size_t num, Make make)
+   {
+      typedef node_pool<sizeof(Node), alignof(Node)> pool;
+      const size_t BATCH = 64;
+      void* slots[BATCH];
+
+      // an unknown length starts small so a short range does not take a whole batch
+      size_t batch = (num == (size_t)-1) ? 8 : BATCH;
+      while (num > 0)
+      {
+         size_t got = pool::allocate_bulk(slots, num < batch ? num : batch);
+         size_t used = 0;
+         try
+         {
+            for (; used < got; used++)
+            {
+               Node* pNew = make(slots[used]);
+               if (pNew == nullptr)
+               {
+                  num = used;
+                  break;
+               }
+               pNew->pPrev = pTail;
+               if (pTail)
+                  pTail->pNext = pNew;
+               else
+                  pHead = pNew;
+               pTail = pNew;
+               numElements++;
+            }
+         }
+         catch (...)
+         {
+            for (size_t i = used; i < got; i++)
+               pool::deallocate(slots[i]);
+            throw;
+         }
+         for (size_t i = used; i < got; i++)
+            pool::deallocate(slots[i]);
+         num -= used;
+         batch = BATCH;
+      }
+   }
+
+   /******************************************
+    * LIST :: SPLICE
+    * Move nodes out of rhs and in front of pos.
+    * Nothing is copied or allocated; the nodes are
+    * relinked. rhs may be this list for the single
+    * node and range versions.
+    *     INPUT  : where the nodes go
+    *              the list they come from
+    *              which of its nodes: all, one, or
+    *              [first, last) holding num nodes
+    *     COST   : O(1), except [first, last) without
+    *              num, which counts the range when rhs
+    *              is another list
+    ******************************************/
+   template <typename T, typename A>
+   void list <T, A> ::splice(iterator pos, list <T, A>& rhs)
+   {
+      assert(&rhs != this);
+      if (rhs.empty())
+         return;
+      linkBefore(pos.p, rhs.pHead, rhs.pTail);
+      numElements += rhs.numElements;
+      rhs.pHead = rhs.pTail = nullptr;
+      rhs.numElements = 0;
+   }
+
+   template <typename T, typename A>
+   void list <T, A> ::splice(iterator pos, list <T, A>& rhs, iterator it)
+   {
+      // within one list, a node already in front of pos stays put
+      if (it.p == nullptr || (&rhs == this && (it == pos || it.p->pNext == pos.p)))
+         return;
+      iterator last(it.p->pNext);
+      splice(pos, rhs, it, last, 1);
+   }
+
+   template <typename T, typename A>
+   void list <T, A> ::splice(iterator pos, list <T, A>& rhs,
+                             iterator first, iterator last)
+   {
+      size_t num = 0;
+      if (&rhs != this)
+         for (Node* p = first.p; p != last.p; p = p->pNext)
+            num++;
+      splice(pos, rhs, first, last, num);
+   }
+
+   template <typename T, typename A>
+   void list <T, A> ::splice(iterator pos, list <T, A>& rhs,
+                             iterator first, iterator last, size_t num)
+   {
+      if (first == last)
+         return;
+      Node* pFirst = first.p;
+      Node* pLast = last.p ? last.p->pPrev : rhs.pTail;
+
+      // unhook [first, last) from rhs
+      if (pFirst->pPrev)
+         pFirst->pPrev->pNext = last.p;
+      else
+         rhs.pHead = last.p;
+      if (last.p)
+         last.p->pPrev = pFirst->pPrev;
+      else
+         rhs.pTail = pFirst->pPrev;
+
+      linkBefore(pos.p, pFirst, pLast);
+      if (&rhs != this)
+      {
+         rhs.numElements -= num;
+         numElements += num;
+      }
+   }
+
+   /******************************************
+    * LIST :: MERGE
+    * Fold a sorted rhs into this sorted list. Equal
+    * elements from this list stay in front of those
+    * from rhs, and rhs is left empty.
+    *     INPUT  : the list to merge in
+    *              comp(a, b) when a goes before b
+    *     COST   : O(n + m) comparisons, no allocations
+    ******************************************/
+   template <typename T, typename A>
+   template <class Compare>
+   void list <T, A> ::merge(list <T, A>& rhs, Compare comp)
+   {
+      if (&rhs == this)
+         return;
+      Node* p = pHead;
+      Node* q = rhs.pHead;
+      while (q)
+      {
+         // nothing left here to compare against, so the rest of rhs goes last
+         if (p == nullptr)
+         {
+            linkBefore(nullptr, q, rhs.pTail);
+            break;
+         }
+         if (comp(q->data, p->data))
+         {
+            Node* pNext = q->pNext;
+            linkBefore(p, q, q);
+            q = pNext;
+         }
+         else
+            p = p->pNext;
+      }
+      numElements += rhs.numElements;
+      rhs.pHead = rhs.pTail = nullptr;
+      rhs.numElements = 0;
+   }
+
+   /******************************************
+    * LIST :: SORT
+    * Stable bottom-up merge sort. Each pass merges
+    * neighbouring runs of width nodes into runs of
+    * 2 * width, following pNext only, and sets pPrev
+    * as each node is placed. There is no recursion
+    * and no scratch list, so the extra space is a
+    * handful of pointers.
+    *     INPUT  : comp(a, b) when a goes before b
+    *     COST   : O(n log n) comparisons, no allocations
+    ******************************************/
+   template <typename T, typename A>
+   template <class Compare>
+   void list <T, A> ::sort(Compare comp)
+   {
+      if (numElements < 2)
+         return;
+
+      for (size_t width = 1; ; width *= 2)
+      {
+         Node* p = pHead;
+         Node* pNewTail = nullptr;
+         size_t numMerges = 0;
+         pHead = nullptr;
+
+         while (p)
+         {
+            // the left run starts at p, the right run at q
+            numMerges++;
+            Node* q = p;
+            size_t pSize = 0;
+            for (; pSize < width && q; pSize++)
+               q = q->pNext;
+            size_t qSize = width;
+
+            while (pSize > 0 || (qSize > 0 && q))
+            {
+               Node* pNext;
+               if (pSize == 0 || (qSize > 0 && q && comp(q->data, p->data)))
+               {
+                  pNext = q;
+                  q = q->pNext;
+                  qSize--;
+               }
+               else
+               {
+                  pNext = p;
+                  p = p->pNext;
+                  pSize--;
+               }
+               if (pNewTail)
+                  pNewTail->pNext = pNext;
+               else
+                  pHead = pNext;
+               pNext->pPrev = pNewTail;
+               pNewTail = pNext;
+            }
+            p = q;
+         }
+         pNewTail->pNext = nullptr;
+         pTail = pNewTail;
+
+         // one merge means one run, which is the whole list
+         if (numMerges <= 1)
+            return;
+      }
+   }
+
+   /******************************************
+    * LIST :: UNIQUE
+    * Remove every element that matches the one just
+    * in front of it
+    *     INPUT  : pred(a, b) when b duplicates a
+    *     OUTPUT : how many elements were removed
+    *     COST   : O(n)
+    ******************************************/
+   template <typename T, typename A>
+   template <class BinaryPredicate>
+   size_t list <T, A> ::unique(BinaryPredicate pred)
+   {
+      size_t numRemoved = 0;
+      Node* p = pHead;
+      while (p && p->pNext)
+      {
+         if (pred(p->data, p->pNext->data))
+         {
+            erase(iterator(p->pNext));
+            numRemoved++;
+         }
+         else
+            p = p->pNext;
+      }
+      return numRemoved;
+   }
+
+   /******************************************
+    * LIST :: REVERSE
+    * Turn the list around by swapping each node's
+    * pointers
+    *     COST   : O(n)
+    ******************************************/
+   template <typename T, typename A>
+   void list <T, A> ::reverse()
+   {
+      for (Node* p = pHead; p; p = p->pPrev)
+      {
+         Node* pTemp = p->pNext;
+         p->pNext = p->pPrev;
+         p->pPrev = pTemp;
+      }
+      Node* pTemp = pHead;
+      pHead = pTail;
+      pTail = pTemp;
+   }
+
    /**********************************************
     * LIST :: assignment operator - MOVE
     * Copy one list onto another
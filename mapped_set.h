@@ -0,0 +1,320 @@
+/***********************************************************************
+ * Header:
+ *    MAPPED SET
+ * Summary:
+ *    A read-only hash set that is searched where it lies in a
+ *    memory-mapped file. The file holds no pointers, only a table of
+ *    bucket offsets and a flat array of slots, so opening it is one
+ *    mmap: nothing is read, rebuilt, or rehashed, pages come in from
+ *    the page cache as find() touches them, and every process that
+ *    opens the file shares the same pages.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        mapped_unordered_set : A file-backed, read-only hash
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CUSTOM_MAPPED_POSIX 1
+#endif
+
+#ifdef CUSTOM_MAPPED_POSIX
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uint64_t
+#include <cstdio>           // for std::rename
+#include <cstring>          // for std::memcpy
+#include <functional>       // for std::hash, std::equal_to
+#include <string>           // for the temporary file name
+#include <type_traits>      // for std::is_trivially_copyable
+#include <utility>          // for std::swap
+#include <fcntl.h>          // for open
+#include <sys/mman.h>       // for mmap, munmap, madvise
+#include <sys/stat.h>       // for fstat
+#include <unistd.h>         // for ftruncate, close, unlink
+
+class TestMappedSet; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************
+    * MAPPED UNORDERED SET
+    * The file is laid out as
+    *    | header | offsets[numBuckets + 1] | pad | slots |
+    * Bucket i is slots[offsets[i]] up to, not
+    * including, slots[offsets[i + 1]]. create() writes
+    * a new file from any set of elements; the set is
+    * never changed after that. The Hash that reads the
+    * file must be the one that wrote it, so a standard
+    * library std::hash is only safe within one build.
+    ****************************************/
+   template <typename T,
+             typename Hash = std::hash<T>,
+             typename EqPred = std::equal_to<T>>
+   class mapped_unordered_set
+   {
+      friend class ::TestMappedSet; // give unit tests access to the privates
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "mapped_unordered_set stores raw bytes, T must be trivially copyable");
+   public:
+      typedef const T* iterator;
+
+      //
+      // Construct
+      //
+      mapped_unordered_set() : pHeader(nullptr), offsets(nullptr), slots(nullptr), numBytes(0) {}
+      mapped_unordered_set(const char* path) : mapped_unordered_set() { open(path); }
+      mapped_unordered_set(mapped_unordered_set&& rhs) : mapped_unordered_set() { swap(rhs); }
+      ~mapped_unordered_set() { close(); }
+      mapped_unordered_set(const mapped_unordered_set&) = delete;
+      mapped_unordered_set& operator = (const mapped_unordered_set&) = delete;
+
+      //
+      // Assign
+      //
+      mapped_unordered_set& operator = (mapped_unordered_set&& rhs)
+      {
+         close();
+         swap(rhs);
+         return *this;
+      }
+      void swap(mapped_unordered_set& rhs)
+      {
+         std::swap(pHeader, rhs.pHeader);
+         std::swap(offsets, rhs.offsets);
+         std::swap(slots, rhs.slots);
+         std::swap(numBytes, rhs.numBytes);
+      }
+
+      //
+      // File
+      //
+      template <class Iterator>
+      static bool create(const char* path, Iterator first, Iterator last);
+      bool open(const char* path);
+      void close();
+      bool is_open() const { return pHeader != nullptr; }
+
+      //
+      // Iterator
+      //
+      iterator begin() const { return slots; }
+      iterator end()   const { return slots + size(); }
+      iterator begin(size_t iBucket) const { return slots + offsets[iBucket]; }
+      iterator end(size_t iBucket)   const { return slots + offsets[iBucket + 1]; }
+
+      //
+      // Access
+      //
+      size_t bucket(const T& t) const
+      {
+         return Hash()(t) % bucket_count();
+      }
+      iterator find(const T& t) const;
+      bool contains(const T& t) const { return find(t) != end(); }
+
+      //
+      // Status
+      //
+      size_t size() const          { return pHeader ? (size_t)pHeader->numElements : 0; }
+      bool empty() const           { return size() == 0; }
+      size_t bucket_count() const  { return pHeader ? (size_t)pHeader->numBuckets : 0; }
+      size_t bucket_size(size_t i) const
+      {
+         return (size_t)(offsets[i + 1] - offsets[i]);
+      }
+
+   private:
+
+      // the first bytes of the file
+      struct header
+      {
+         uint64_t magic;        // marks a file we wrote
+         uint64_t elementSize;  // sizeof(T) when the file was made
+         uint64_t numElements;  // the number of slots
+         uint64_t numBuckets;   // the number of offsets, less one
+      };
+      static const size_t headerBytes = 64;
+      static const uint64_t fileMagic = 0x5445534850414d43ull; // "CMAPHSET"
+      static_assert(sizeof(header) <= headerBytes, "header must fit before the offsets");
+      static_assert(alignof(T) <= headerBytes, "slots must be aligned after the offsets");
+
+      // where the slots start in a file with this many buckets
+      static size_t slotsOffset(size_t numBuckets)
+      {
+         size_t end = headerBytes + (numBuckets + 1) * sizeof(uint64_t);
+         return (end + headerBytes - 1) / headerBytes * headerBytes;
+      }
+
+      const header*   pHeader;    // the start of the mapping
+      const uint64_t* offsets;    // the first slot of each bucket
+      const T*        slots;      // every element, grouped by bucket
+      size_t          numBytes;   // the size of the file and of the mapping
+   };
+
+   /*****************************************
+    * MAPPED UNORDERED SET :: CREATE
+    * Write the elements in [first, last) to a new
+    * file, one bucket per element. The range is walked
+    * twice, once to count each bucket and once to
+    * place each element, straight into a writable
+    * mapping of the new file. The file is built
+    * beside path and renamed over it, so a process
+    * that has the old file open keeps a whole one.
+    *     INPUT  : the path, and distinct elements
+    *     OUTPUT : true if the file was written
+    ****************************************/
+   template <typename T, typename H, typename E>
+   template <class Iterator>
+   bool mapped_unordered_set <T, H, E> ::create(const char* path, Iterator first, Iterator last)
+   {
+      size_t numElements = 0;
+      for (Iterator it = first; it != last; ++it)
+         numElements++;
+      size_t numBuckets = numElements ? numElements : 1;
+      size_t bytes = slotsOffset(numBuckets) + numElements * sizeof(T);
+
+      std::string tmp = std::string(path) + ".tmp";
+      int fd = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0)
+         return false;
+      void* p = MAP_FAILED;
+      if (ftruncate(fd, (off_t)bytes) == 0)
+         p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if (p == MAP_FAILED)
+      {
+         unlink(tmp.c_str());
+         return false;
+      }
+
+      header* pNew = (header*)p;
+      pNew->magic = fileMagic;
+      pNew->elementSize = sizeof(T);
+      pNew->numElements = numElements;
+      pNew->numBuckets = numBuckets;
+      uint64_t* newOffsets = (uint64_t*)((unsigned char*)p + headerBytes);
+      unsigned char* newSlots = (unsigned char*)p + slotsOffset(numBuckets);
+
+      // count into offsets[i + 1], then sum so offsets[i] is where bucket i starts
+      for (Iterator it = first; it != last; ++it)
+         newOffsets[H()(*it) % numBuckets + 1]++;
+      for (size_t i = 0; i < numBuckets; i++)
+         newOffsets[i + 1] += newOffsets[i];
+
+      // place each element, using offsets[i] as bucket i's cursor, then put it back
+      for (Iterator it = first; it != last; ++it)
+      {
+         const T& t = *it;
+         std::memcpy(newSlots + newOffsets[H()(t) % numBuckets]++ * sizeof(T), &t, sizeof(T));
+      }
+      for (size_t i = numBuckets; i > 0; i--)
+         newOffsets[i] = newOffsets[i - 1];
+      newOffsets[0] = 0;
+
+      bool written = munmap(p, bytes) == 0;
+      if (written)
+         written = std::rename(tmp.c_str(), path) == 0;
+      if (!written)
+         unlink(tmp.c_str());
+      return written;
+   }
+
+   /*****************************************
+    * MAPPED UNORDERED SET :: OPEN
+    * Map a file made by create(), read only. A file
+    * whose header does not agree with its size or
+    * with T is refused.
+    *     INPUT  : the path to the file
+    *     OUTPUT : true if the set is now open
+    ****************************************/
+   template <typename T, typename H, typename E>
+   bool mapped_unordered_set <T, H, E> ::open(const char* path)
+   {
+      close();
+      int fd = ::open(path, O_RDONLY);
+      if (fd < 0)
+         return false;
+
+      struct stat info;
+      void* p = MAP_FAILED;
+      if (fstat(fd, &info) == 0 && (size_t)info.st_size >= headerBytes)
+         p = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);   // the mapping keeps the file
+      if (p == MAP_FAILED)
+         return false;
+
+      pHeader = (const header*)p;
+      numBytes = (size_t)info.st_size;
+      const header& h = *pHeader;
+      if (h.magic != fileMagic || h.elementSize != sizeof(T) || h.numBuckets == 0 ||
+          h.numBuckets >= (numBytes - headerBytes) / sizeof(uint64_t) ||
+          slotsOffset((size_t)h.numBuckets) > numBytes ||
+          h.numElements > (numBytes - slotsOffset((size_t)h.numBuckets)) / sizeof(T))
+      {
+         close();
+         return false;
+      }
+      offsets = (const uint64_t*)((const unsigned char*)p + headerBytes);
+      slots = (const T*)((const unsigned char*)p + slotsOffset((size_t)h.numBuckets));
+      // every bucket must lie within the slots, or a lookup reads past the mapping
+      bool valid = offsets[0] == 0 && offsets[h.numBuckets] == h.numElements;
+      for (size_t i = 0; valid && i < (size_t)h.numBuckets; i++)
+         valid = offsets[i] <= offsets[i + 1];
+      if (!valid)
+      {
+         close();
+         return false;
+      }
+
+      // lookups land anywhere, so reading ahead only wastes the page cache
+      madvise(p, numBytes, MADV_RANDOM);
+      return true;
+   }
+
+   /*****************************************
+    * MAPPED UNORDERED SET :: CLOSE
+    ****************************************/
+   template <typename T, typename H, typename E>
+   void mapped_unordered_set <T, H, E> ::close()
+   {
+      if (pHeader)
+         munmap((void*)pHeader, numBytes);
+      pHeader = nullptr;
+      offsets = nullptr;
+      slots = nullptr;
+      numBytes = 0;
+   }
+
+   /*****************************************
+    * MAPPED UNORDERED SET :: FIND
+    * Scan the one bucket t hashes to
+    *     OUTPUT : the slot holding t, or end()
+    ****************************************/
+   template <typename T, typename H, typename E>
+   typename mapped_unordered_set <T, H, E> ::iterator
+      mapped_unordered_set <T, H, E> ::find(const T& t) const
+   {
+      if (!pHeader)
+         return end();
+      size_t iBucket = bucket(t);
+      for (iterator it = begin(iBucket); it != end(iBucket); ++it)
+         if (E()(*it, t))
+            return it;
+      return end();
+   }
+
+} // namespace custom
+
+#endif // CUSTOM_MAPPED_POSIX
@@ -0,0 +1,420 @@
+/***********************************************************************
+ * Header:
+ *    MAPPED VECTOR
+ * Summary:
+ *    A vector whose elements live in a memory-mapped file. Opening
+ *    an existing file maps it straight in, so nothing is read or
+ *    copied element by element, and sync() makes it durable.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        mapped_vector           : A file-backed vector
+ *        mapped_vector::iterator : An iterator through mapped_vector
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CUSTOM_MAPPED_POSIX 1
+#endif
+
+#ifdef CUSTOM_MAPPED_POSIX
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uint64_t
+#include <new>              // for std::bad_alloc
+#include <utility>          // for std::swap
+#include <type_traits>      // for std::is_trivially_copyable
+#include <fcntl.h>          // for open
+#include <sys/mman.h>       // for mmap, munmap, msync
+#include <sys/stat.h>       // for fstat
+#include <unistd.h>         // for ftruncate, close, sysconf
+
+class TestMappedVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************
+    * MAPPED VECTOR
+    * The file is a small header followed by the
+    * elements. The header holds the element count,
+    * so it is saved along with the data.
+    *    | header | e0 | e1 | ... | spare capacity |
+    * Growing extends the file with ftruncate and maps
+    * it again, so pointers and references into the
+    * vector go stale on growth. Iterators hold an
+    * index and stay good.
+    ****************************************/
+   template <typename T>
+   class mapped_vector
+   {
+      friend class ::TestMappedVector; // give unit tests access to the privates
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "mapped_vector stores raw bytes, T must be trivially copyable");
+   public:
+
+      //
+      // Construct
+      //
+      mapped_vector() : fd(-1), pHeader(nullptr), data(nullptr), numBytes(0) {}
+      mapped_vector(const char* path) : mapped_vector() { open(path); }
+      mapped_vector(mapped_vector&& rhs);
+      ~mapped_vector() { close(); }
+      mapped_vector(const mapped_vector&) = delete;
+      mapped_vector& operator = (const mapped_vector&) = delete;
+
+      //
+      // Assign
+      //
+      void swap(mapped_vector& rhs);
+      mapped_vector& operator = (mapped_vector&& rhs);
+
+      //
+      // File
+      //
+      bool open(const char* path);
+      void close();
+      bool sync(bool wait = true);
+      bool is_open() const { return pHeader != nullptr; }
+
+      //
+      // Iterator
+      //
+      class iterator;
+      iterator begin() { return iterator(this, 0); }
+      iterator end()   { return iterator(this, size()); }
+
+      //
+      // Access
+      //
+      T& operator [] (size_t index)             { return data[index]; }
+      const T& operator [] (size_t index) const { return data[index]; }
+      T& front()                                { return data[0]; }
+      const T& front() const                    { return data[0]; }
+      T& back()                                 { return data[size() - 1]; }
+      const T& back() const                     { return data[size() - 1]; }
+
+      //
+      // Insert
+      //
+      void push_back(const T& t);
+      void reserve(size_t newCapacity);
+      void resize(size_t newElements);
+      void resize(size_t newElements, const T& t);
+
+      //
+      // Remove
+      //
+      void clear()    { if (pHeader) pHeader->numElements = 0; }
+      void pop_back() { if (!empty()) pHeader->numElements--; }
+      void shrink_to_fit();
+
+      //
+      // Status
+      //
+      size_t size()     const { return pHeader ? (size_t)pHeader->numElements : 0; }
+      size_t capacity() const { return numBytes > headerBytes ? (numBytes - headerBytes) / sizeof(T) : 0; }
+      bool empty()      const { return size() == 0; }
+
+   private:
+
+      // the first bytes of the file, padded so the elements are well aligned
+      struct header
+      {
+         uint64_t magic;        // marks a file we wrote
+         uint64_t elementSize;  // sizeof(T) when the file was made
+         uint64_t numElements;  // the number of items currently used
+      };
+      static const size_t headerBytes = 64;
+      static const uint64_t fileMagic = 0x524f5443455643ull; // "CVECTOR"
+      static_assert(sizeof(header) <= headerBytes, "header must fit before the data");
+      static_assert(alignof(T) <= headerBytes, "elements must be aligned after the header");
+
+      bool map(size_t newBytes);
+      bool remap(size_t newBytes);
+      static size_t pageRound(size_t bytes)
+      {
+         size_t page = (size_t)sysconf(_SC_PAGESIZE);
+         return (bytes + page - 1) / page * page;
+      }
+
+      int     fd;          // the open file, -1 if none
+      header* pHeader;     // the start of the mapping
+      T*      data;        // the elements, just past the header
+      size_t  numBytes;    // the size of the file and of the mapping
+   };
+
+   /**************************************************
+    * MAPPED VECTOR ITERATOR
+    * Remembers the container and an index, so it
+    * survives the file being mapped somewhere else.
+    *************************************************/
+   template <typename T>
+   class mapped_vector <T> ::iterator
+   {
+      friend class ::TestMappedVector; // give unit tests access to the privates
+   public:
+      // constructors, destructors, and assignment operator
+      iterator() : pOwner(nullptr), index(0) {}
+      iterator(mapped_vector* pOwner, size_t index) : pOwner(pOwner), index(index) {}
+      iterator(const iterator& rhs) : pOwner(rhs.pOwner), index(rhs.index) {}
+      iterator& operator = (const iterator& rhs)
+      {
+         pOwner = rhs.pOwner;
+         index = rhs.index;
+         return *this;
+      }
+
+      // equals, not equals operator
+      bool operator != (const iterator& rhs) const { return index != rhs.index || pOwner != rhs.pOwner; }
+      bool operator == (const iterator& rhs) const { return !(*this != rhs); }
+
+      // dereference operator
+      T& operator * () { return (*pOwner)[index]; }
+
+      // increment and decrement
+      iterator& operator ++ ()    { ++index; return *this; }
+      iterator  operator ++ (int) { iterator temp = *this; ++index; return temp; }
+      iterator& operator -- ()    { --index; return *this; }
+      iterator  operator -- (int) { iterator temp = *this; --index; return temp; }
+
+   private:
+      mapped_vector* pOwner;
+      size_t index;
+   };
+
+   /*****************************************
+    * MAPPED VECTOR :: MOVE CONSTRUCTOR
+    * Take over the file and the mapping
+    ****************************************/
+   template <typename T>
+   mapped_vector <T> ::mapped_vector(mapped_vector&& rhs) : mapped_vector()
+   {
+      swap(rhs);
+   }
+
+   /*****************************************
+    * MAPPED VECTOR :: SWAP
+    ****************************************/
+   template <typename T>
+   void mapped_vector <T> ::swap(mapped_vector& rhs)
+   {
+      std::swap(fd, rhs.fd);
+      std::swap(pHeader, rhs.pHeader);
+      std::swap(data, rhs.data);
+      std::swap(numBytes, rhs.numBytes);
+   }
+
+   /*****************************************
+    * MAPPED VECTOR :: MOVE ASSIGNMENT
+    * Our own file is closed, not copied over
+    ****************************************/
+   template <typename T>
+   mapped_vector <T>& mapped_vector <T> ::operator = (mapped_vector&& rhs)
+   {
+      close();
+      swap(rhs);
+      return *this;
+   }
+
+   /*****************************************
+    * MAPPED VECTOR :: OPEN
+    * Map an existing file, or start a new one if the
+    * file is empty. A file that was not written by a
+    * mapped_vector of the same element size is refused.
+    *     INPUT  : the path to the file
+    *     OUTPUT : true if the vector is now open
+    ****************************************/
+   template <typename T>
+   bool mapped_vector <T> ::open(const char* path)
+   {
+      close();
+      fd = ::open(path, O_RDWR | O_CREAT, 0644);
+      if (fd < 0)
+         return false;
+
+      struct stat info;
+      if (fstat(fd, &info) != 0)
+      {
+         close();
+         return false;
+      }
+
+      // a new file gets one page and a fresh header
+      if (info.st_size == 0)
+      {
+         size_t newBytes = pageRound(headerBytes + sizeof(T));
+         if (ftruncate(fd, (off_t)newBytes) != 0 || !map(newBytes))
+         {
+            close();
+            return false;
+         }
+         pHeader->magic = fileMagic;
+         pHeader->elementSize = sizeof(T);
+         pHeader->numElements = 0;
+         return true;
+      }
+
+      // an old file is trusted only if its header agrees with us
+      if ((size_t)info.st_size < headerBytes || !map((size_t)info.st_size) ||
+          pHeader->magic != fileMagic || pHeader->elementSize != sizeof(T) ||
+          pHeader->numElements > capacity())
+      {
+         close();
+         return false;
+      }
+      return true;
+   }
+
+   /*****************************************
+    * MAPPED VECTOR :: CLOSE
+    * Unmap and close. The kernel still writes dirty
+    * pages back, but only sync() waits for them.
+    ****************************************/
+   template <typename T>
+   void mapped_vector <T> ::close()
+   {
+      if (pHeader)
+         munmap(pHeader, numBytes);
+      if (fd >= 0)
+         ::close(fd);
+      fd = -1;
+      pHeader = nullptr;
+      data = nullptr;
+      numBytes = 0;
+   }
+
+   /*****************************************
+    * MAPPED VECTOR :: SYNC
+    * Flush the mapping to the file. With wait, return
+    * only once it is on disk, otherwise just start it.
+    *     OUTPUT : true if the flush succeeded
+    ****************************************/
+   template <typename T>
+   bool mapped_vector <T> ::sync(bool wait)
+   {
+      if (!pHeader)
+         return false;
+      return msync(pHeader, numBytes, wait ? MS_SYNC : MS_ASYNC) == 0;
+   }
+
+   /*****************************************
+    * MAPPED VECTOR :: MAP
+    * Map the first newBytes of the file
+    ****************************************/
+   template <typename T>
+   bool mapped_vector <T> ::map(size_t newBytes)
+   {
+      void* p = mmap(nullptr, newBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (p == MAP_FAILED)
+         return false;
+      pHeader = (header*)p;
+      data = (T*)((unsigned char*)p + headerBytes);
+      numBytes = newBytes;
+      return true;
+   }
+
+   /*****************************************
+    * MAPPED VECTOR :: REMAP
+    * Change the size of the file and map it again.
+    * The pages are shared with the file, so nothing
+    * is copied, the old mapping is just dropped.
+    ****************************************/
+   template <typename T>
+   bool mapped_vector <T> ::remap(size_t newBytes)
+   {
+      assert(is_open());
+      if (ftruncate(fd, (off_t)newBytes) != 0)
+         return false;
+      size_t oldBytes = numBytes;
+      munmap(pHeader, oldBytes);
+      pHeader = nullptr;
+      data = nullptr;
+      if (map(newBytes))
+         return true;
+
+      // put the old mapping back so the vector stays usable
+      if (ftruncate(fd, (off_t)oldBytes) != 0 || !map(oldBytes))
+         close();
+      return false;
+   }
+
+   /***************************************
+    * MAPPED VECTOR :: RESERVE
+    * Grow the file so newCapacity elements fit.
+    * Throws std::bad_alloc if the file cannot grow.
+    **************************************/
+   template <typename T>
+   void mapped_vector <T> ::reserve(size_t newCapacity)
+   {
+      assert(is_open());
+      if (newCapacity <= capacity())
+         return;
+      if (!remap(pageRound(headerBytes + newCapacity * sizeof(T))))
+         throw std::bad_alloc();
+   }
+
+   /***************************************
+    * MAPPED VECTOR :: PUSH BACK
+    * Double the file when it is full. A file of just
+    * the header has no room at all, so it grows to one.
+    **************************************/
+   template <typename T>
+   void mapped_vector <T> ::push_back(const T& t)
+   {
+      size_t num = size();
+      if (num == capacity())
+      {
+         T copy = t;   // t may be in the mapping we are about to drop
+         reserve(num ? num * 2 : 1);
+         data[pHeader->numElements++] = copy;
+         return;
+      }
+      data[pHeader->numElements++] = t;
+   }
+
+   /***************************************
+    * MAPPED VECTOR :: RESIZE
+    * New elements are value-initialized
+    **************************************/
+   template <typename T>
+   void mapped_vector <T> ::resize(size_t newElements)
+   {
+      resize(newElements, T());
+   }
+
+   template <typename T>
+   void mapped_vector <T> ::resize(size_t newElements, const T& t)
+   {
+      T copy = t;
+      reserve(newElements);
+      for (size_t i = size(); i < newElements; i++)
+         data[i] = copy;
+      pHeader->numElements = newElements;
+   }
+
+   /***************************************
+    * MAPPED VECTOR :: SHRINK TO FIT
+    * Trim the file to the pages the elements need
+    **************************************/
+   template <typename T>
+   void mapped_vector <T> ::shrink_to_fit()
+   {
+      assert(is_open());
+      size_t newBytes = pageRound(headerBytes + (size() ? size() : 1) * sizeof(T));
+      if (newBytes < numBytes)
+         remap(newBytes);
+   }
+
+} // namespace custom
+
+#endif // CUSTOM_MAPPED_POSIX
@@ -0,0 +1,408 @@
+/***********************************************************************
+ * Header:
+ *    NODE POOL
+ * Summary:
+ *    Fixed size allocation for linked structure nodes. Nodes are
+ *    carved out of 16K blocks, so nodes allocated one after another
+ *    sit next to each other in memory, a run of them can be taken with
+ *    one lock, and a block goes back to the system once every node in
+ *    it is freed.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        node_pool : blocks of fixed size slots
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uintptr_t
+#include <cstdlib>          // for posix_memalign, free
+#include <atomic>           // for std::atomic
+#include <mutex>            // for std::mutex
+#include <new>              // for std::bad_alloc, placement new
+#ifdef _WIN32
+#include <malloc.h>         // for _aligned_malloc
+#endif
+
+class TestNodePool; // forward declaration for unit tests
+
+namespace custom
+{
+   namespace pool_detail
+   {
+      // every block is this size and aligned to it, so a slot finds its
+      // block header by masking off the low bits of its address
+      const size_t BLOCK_BYTES = 16384;
+
+      inline void* allocate_block()
+      {
+         void* p = nullptr;
+#ifdef _WIN32
+         p = _aligned_malloc(BLOCK_BYTES, BLOCK_BYTES);
+#else
+         if (posix_memalign(&p, BLOCK_BYTES, BLOCK_BYTES) != 0)
+            p = nullptr;
+#endif
+         if (p == nullptr)
+            throw std::bad_alloc();
+         return p;
+      }
+
+      inline void free_block(void* p)
+      {
+#ifdef _WIN32
+         _aligned_free(p);
+#else
+         free(p);
+#endif
+      }
+   }
+
+   /*****************************************
+    * NODE POOL
+    * One pool per slot size. Each thread carves slots
+    * from its own current block, front to back, taking
+    * freed slots in that block first. A block that
+    * runs dry is retired: it is handed out again once
+    * half its slots are free, and returned to the
+    * system once all of them are. Slots can be freed
+    * from any thread; a small spin lock in each block
+    * guards its free list, and a mutex guards the rare
+    * moves between the retired and current states.
+    *
+    * Slots too big to fit sixteen to a block go
+    * straight to operator new instead.
+    ****************************************/
+   template <size_t Size, size_t Align>
+   class node_pool
+   {
+      friend class ::TestNodePool; // give unit tests access to the privates
+
+      struct slot
+      {
+         slot* pNext;
+      };
+      struct block
+      {
+         std::atomic<bool> busy;  // spin lock over the rest
+         slot* pFree;             // freed slots, reused first
+         char* pBump;             // the next slot never handed out
+         size_t live;             // slots handed out and not yet freed
+         size_t pending;          // frees waiting on the mutex to settle this block
+         bool retired;            // no thread carves from this block
+         bool queued;             // retired and waiting to be handed out again
+         block* pPrevQueued;
+         block* pNextQueued;
+      };
+      struct shared_state
+      {
+         std::mutex mutex;        // guards retired, queued, and the queue
+         block* pQueue = nullptr; // retired blocks with half their slots free
+      };
+      struct carver
+      {
+         block* p = nullptr;
+         ~carver() { if (p) retire(p); }
+      };
+
+      static const size_t SLOT_ALIGN = Align > alignof(slot) ? Align : alignof(slot);
+      static const size_t SLOT = ((Size > sizeof(slot) ? Size : sizeof(slot)) + SLOT_ALIGN - 1)
+                                 / SLOT_ALIGN * SLOT_ALIGN;
+      static const size_t FIRST = (sizeof(block) + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN;
+      static const size_t CAPACITY = pool_detail::BLOCK_BYTES > FIRST
+                                     ? (pool_detail::BLOCK_BYTES - FIRST) / SLOT : 0;
+      static_assert(Align <= 256, "node_pool slots are at most 256 byte aligned");
+
+   public:
+      static const bool pooled = CAPACITY >= 16;
+
+      static void* allocate();
+      static size_t allocate_bulk(void** slots, size_t num);
+      static void deallocate(void* p);
+
+   private:
+
+      static block* owner(void* p)
+      {
+         return (block*)((uintptr_t)p & ~(uintptr_t)(pool_detail::BLOCK_BYTES - 1));
+      }
+      static block*& current()
+      {
+         static thread_local carver c;
+         return c.p;
+      }
+      static shared_state& shared()
+      {
+         // never destroyed, so nodes freed during static destruction still work
+         static shared_state* s = new shared_state;
+         return *s;
+      }
+      static void lock(block* b)
+      {
+         while (b->busy.exchange(true, std::memory_order_acquire))
+            while (b->busy.load(std::memory_order_relaxed))
+               ;
+      }
+      static void unlock(block* b)
+      {
+         b->busy.store(false, std::memory_order_release);
+      }
+
+      static void* take(block* b);
+      static block* fresh(bool untouched);
+      static void retire(block* b);
+      static void settle(block* b);
+      static void enqueue(block* b);
+      static void dequeue(block* b);
+   };
+
+   /*****************************************
+    * NODE POOL :: TAKE
+    * One slot from a locked block, or nullptr if it
+    * is full
+    ****************************************/
+   template <size_t Size, size_t Align>
+   void* node_pool <Size, Align> ::take(block* b)
+   {
+      if (b->pFree)
+      {
+         slot* s = b->pFree;
+         b->pFree = s->pNext;
+         b->live++;
+         return s;
+      }
+      if (b->pBump + SLOT <= (char*)b + pool_detail::BLOCK_BYTES)
+      {
+         void* p = b->pBump;
+         b->pBump += SLOT;
+         b->live++;
+         return p;
+      }
+      return nullptr;
+   }
+
+   /*****************************************
+    * NODE POOL :: ENQUEUE / DEQUEUE
+    * Add or remove a retired block from the queue of
+    * blocks to hand out again. Both need the mutex.
+    ****************************************/
+   template <size_t Size, size_t Align>
+   void node_pool <Size, Align> ::enqueue(block* b)
+   {
+      shared_state& s = shared();
+      b->queued = true;
+      b->pPrevQueued = nullptr;
+      b->pNextQueued = s.pQueue;
+      if (s.pQueue)
+         s.pQueue->pPrevQueued = b;
+      s.pQueue = b;
+   }
+
+   template <size_t Size, size_t Align>
+   void node_pool <Size, Align> ::dequeue(block* b)
+   {
+      shared_state& s = shared();
+      if (b->pPrevQueued)
+         b->pPrevQueued->pNextQueued = b->pNextQueued;
+      else
+         s.pQueue = b->pNextQueued;
+      if (b->pNextQueued)
+         b->pNextQueued->pPrevQueued = b->pPrevQueued;
+      b->queued = false;
+   }
+
+   /*****************************************
+    * NODE POOL :: FRESH
+    * A block to carve from: a retired one that is at
+    * least half free, or a new one when the caller
+    * wants a long run of never used slots
+    ****************************************/
+   template <size_t Size, size_t Align>
+   typename node_pool <Size, Align> ::block* node_pool <Size, Align> ::fresh(bool untouched)
+   {
+      shared_state& s = shared();
+      if (!untouched)
+      {
+         std::lock_guard<std::mutex> guard(s.mutex);
+         if (block* b = s.pQueue)
+         {
+            lock(b);
+            dequeue(b);
+            b->retired = false;
+            unlock(b);
+            return b;
+         }
+      }
+
+      block* b = new (pool_detail::allocate_block()) block;
+      b->busy.store(false, std::memory_order_relaxed);
+      b->pFree = nullptr;
+      b->pBump = (char*)b + FIRST;
+      b->live = 0;
+      b->pending = 0;
+      b->retired = false;
+      b->queued = false;
+      b->pPrevQueued = b->pNextQueued = nullptr;
+      return b;
+   }
+
+   /*****************************************
+    * NODE POOL :: RETIRE / SETTLE
+    * Stop carving from a block. Settle, with the mutex
+    * and the block lock held, frees a retired block
+    * with nothing left in it or queues one that is
+    * half free, then releases the block lock.
+    ****************************************/
+   template <size_t Size, size_t Align>
+   void node_pool <Size, Align> ::retire(block* b)
+   {
+      std::lock_guard<std::mutex> guard(shared().mutex);
+      lock(b);
+      b->retired = true;
+      settle(b);
+   }
+
+   template <size_t Size, size_t Align>
+   void node_pool <Size, Align> ::settle(block* b)
+   {
+      assert(b->retired);
+      if (b->live == 0 && b->pending == 0)
+      {
+         if (b->queued)
+            dequeue(b);
+         b->~block();
+         pool_detail::free_block(b);
+         return;
+      }
+      if (!b->queued && CAPACITY - b->live >= CAPACITY / 2)
+         enqueue(b);
+      unlock(b);
+   }
+
+   /*****************************************
+    * NODE POOL :: ALLOCATE
+    * One slot, from this thread's block
+    ****************************************/
+   template <size_t Size, size_t Align>
+   void* node_pool <Size, Align> ::allocate()
+   {
+      if (!pooled)
+         return ::operator new(Size);
+
+      block*& b = current();
+      if (b)
+      {
+         lock(b);
+         void* p = take(b);
+         unlock(b);
+         if (p)
+            return p;
+         retire(b);
+         b = nullptr;
+      }
+      b = fresh(false);
+      lock(b);
+      void* p = take(b);
+      unlock(b);
+      assert(p);
+      return p;
+   }
+
+   /*****************************************
+    * NODE POOL :: ALLOCATE BULK
+    * Fill slots with num slots, taking as many as the
+    * current block has under one lock. While RUN or
+    * more are still wanted, only never used slots are
+    * taken, from a new block if need be, so the run
+    * is contiguous; freed slots fill the short tail.
+    *     OUTPUT : num
+    ****************************************/
+   template <size_t Size, size_t Align>
+   size_t node_pool <Size, Align> ::allocate_bulk(void** slots, size_t num)
+   {
+      size_t got = 0;
+      if (!pooled)
+      {
+         for (; got < num; got++)
+            slots[got] = ::operator new(Size);
+         return got;
+      }
+
+      const size_t RUN = 16;
+      block*& b = current();
+      while (got < num)
+      {
+         if (b == nullptr)
+            b = fresh(num - got >= RUN);
+         lock(b);
+         char* pEnd = (char*)b + pool_detail::BLOCK_BYTES;
+         for (; got < num && b->pBump + SLOT <= pEnd; got++)
+         {
+            slots[got] = b->pBump;
+            b->pBump += SLOT;
+            b->live++;
+         }
+         void* p = nullptr;
+         if (num - got < RUN)
+            for (; got < num && (p = take(b)); got++)
+               slots[got] = p;
+         unlock(b);
+         if (got < num)
+         {
+            retire(b);
+            b = nullptr;
+         }
+      }
+      return got;
+   }
+
+   /*****************************************
+    * NODE POOL :: DEALLOCATE
+    * Give a slot back to its block. Only a retired
+    * block that just emptied or just reached half
+    * free needs the mutex.
+    ****************************************/
+   template <size_t Size, size_t Align>
+   void node_pool <Size, Align> ::deallocate(void* p)
+   {
+      if (p == nullptr)
+         return;
+      if (!pooled)
+      {
+         ::operator delete(p);
+         return;
+      }
+
+      block* b = owner(p);
+      lock(b);
+      slot* s = (slot*)p;
+      s->pNext = b->pFree;
+      b->pFree = s;
+      b->live--;
+      bool rare = b->retired && (b->live == 0 || CAPACITY - b->live == CAPACITY / 2);
+      if (rare)
+         b->pending++;
+      unlock(b);
+
+      if (rare)
+      {
+         std::lock_guard<std::mutex> guard(shared().mutex);
+         lock(b);
+         b->pending--;
+         if (b->retired)
+            settle(b);
+         else
+            unlock(b);
+      }
+   }
+
+} // namespace custom
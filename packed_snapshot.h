@@ -0,0 +1,350 @@
+/***********************************************************************
+ * Header:
+ *    PACKED SNAPSHOT
+ * Summary:
+ *    A smaller snapshot of an unordered_set of integers. The keys are
+ *    sorted, split into blocks of 128, and each block stores only the
+ *    differences between neighbouring keys, bit-packed at the width
+ *    its largest difference needs. Dense keys take a few bits each
+ *    instead of eight bytes. Decoding is vectorized and feeds the
+ *    set's bulk build directly.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the definitions of:
+ *        save_packed : Write a set of integers, compressed
+ *        load_packed : Read one back
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uint64_t
+#include <cstring>          // for std::memset
+#include <istream>          // for std::istream
+#include <ostream>          // for std::ostream
+#include <type_traits>      // for std::is_integral, std::make_unsigned
+#include "vector.h"         // for the sorted keys
+#include "sort.h"           // for custom::sort
+#include "simd.h"           // for the decode dispatch
+#include "snapshot.h"       // for snapshot_header
+#include "pair.h"           // for the hash's insert
+#include "hash.h"           // for custom::unordered_set
+
+class TestPackedSnapshot; // forward declaration for unit tests
+
+namespace custom
+{
+   const uint32_t SNAPSHOT_PACKED_MAGIC = 0x50455343;  // "CSEP"
+
+   namespace packed_detail
+   {
+      /*****************************************
+       * BLOCK LAYOUT
+       * A block holds 128 keys as four interleaved lanes
+       * of 32: key i is in lane i % 4. Each key is stored
+       * as its distance from the key four places before
+       * it, so every lane decodes on its own with plain
+       * vector adds. Within a lane the differences are
+       * packed b bits apiece into 64 bit words, and word
+       * w of lane l is words[4 * w + l]; one load brings
+       * in the same word of every lane.
+       *    | b | words[4 * ceil(32 * b / 64)] |
+       * The keys after the last whole block are stored
+       * as varint gaps from the key before each.
+       ****************************************/
+      const size_t BLOCK = 128;
+      const size_t LANES = 4;
+      const size_t PER_LANE = BLOCK / LANES;
+      const size_t MAX_WORDS = LANES * PER_LANE;   // when b is 64
+
+      inline size_t block_words(unsigned b)
+      {
+         return LANES * ((PER_LANE * b + 63) / 64);
+      }
+
+      inline unsigned bit_width(uint64_t x)
+      {
+         unsigned b = 0;
+         while (x)
+         {
+            b++;
+            x >>= 1;
+         }
+         return b;
+      }
+
+      // a key as an unsigned number that sorts the same way
+      template <typename T>
+      uint64_t to_ordered(T t)
+      {
+         typedef typename std::make_unsigned<T>::type U;
+         U u = (U)t;
+         if (std::is_signed<T>::value)
+            u ^= (U)((U)1 << (sizeof(T) * 8 - 1));
+         return (uint64_t)u;
+      }
+      template <typename T>
+      T from_ordered(uint64_t x)
+      {
+         typedef typename std::make_unsigned<T>::type U;
+         U u = (U)x;
+         if (std::is_signed<T>::value)
+            u ^= (U)((U)1 << (sizeof(T) * 8 - 1));
+         return (T)u;
+      }
+
+      /*****************************************
+       * ENCODE BLOCK
+       * Pack 128 sorted keys that follow carry[], the
+       * last four keys before them
+       *     OUTPUT : b, and the words it filled
+       ****************************************/
+      inline unsigned encode_block(const uint64_t* keys, uint64_t* carry, uint64_t* words)
+      {
+         uint64_t deltas[BLOCK];
+         uint64_t all = 0;
+         for (size_t i = 0; i < BLOCK; i++)
+         {
+            deltas[i] = keys[i] - (i < LANES ? carry[i] : keys[i - LANES]);
+            all |= deltas[i];
+         }
+         unsigned b = bit_width(all);
+
+         std::memset(words, 0, block_words(b) * sizeof(uint64_t));
+         for (size_t j = 0; j < PER_LANE && b; j++)
+         {
+            size_t bit = j * b;
+            size_t w = bit / 64;
+            unsigned s = (unsigned)(bit % 64);
+            for (size_t l = 0; l < LANES; l++)
+            {
+               uint64_t d = deltas[j * LANES + l];
+               words[w * LANES + l] |= d << s;
+               if (s + b > 64)
+                  words[(w + 1) * LANES + l] |= d >> (64 - s);
+            }
+         }
+         for (size_t l = 0; l < LANES; l++)
+            carry[l] = keys[BLOCK - LANES + l];
+         return b;
+      }
+
+      /*****************************************
+       * DECODE BLOCK
+       * Unpack a block's differences and add them up,
+       * lane by lane, on top of carry[]. The same shift
+       * applies to every lane at each step, so a whole
+       * register of lanes is unpacked at once.
+       ****************************************/
+      struct decode_op
+      {
+         static bool scalar(const uint64_t* words, unsigned b, uint64_t* carry, uint64_t* keys)
+         {
+            uint64_t mask = b == 64 ? ~(uint64_t)0 : (((uint64_t)1 << b) - 1);
+            for (size_t j = 0; j < PER_LANE; j++)
+            {
+               size_t bit = j * b;
+               size_t w = bit / 64;
+               unsigned s = (unsigned)(bit % 64);
+               for (size_t l = 0; l < LANES; l++)
+               {
+                  uint64_t d = 0;
+                  if (b)
+                  {
+                     d = words[w * LANES + l] >> s;
+                     if (s + b > 64)
+                        d |= words[(w + 1) * LANES + l] << (64 - s);
+                  }
+                  carry[l] += d & mask;
+                  keys[j * LANES + l] = carry[l];
+               }
+            }
+            return true;
+         }
+#ifdef CUSTOM_SIMD_X86
+         // four lanes of 64 bits fill 32 bytes, so AVX-512 runs the AVX2 width
+         template <size_t W>
+         static CUSTOM_SIMD_INLINE bool run(const uint64_t* words, unsigned b, uint64_t* carry, uint64_t* keys)
+         {
+            const size_t V = W > 32 ? 32 : W;
+            const size_t K = V / sizeof(uint64_t);
+            typedef uint64_t vec __attribute__((vector_size(V)));
+            typedef uint64_t uvec __attribute__((vector_size(V), aligned(8)));
+            uint64_t mask = b == 64 ? ~(uint64_t)0 : (((uint64_t)1 << b) - 1);
+
+            for (size_t g = 0; g < LANES; g += K)
+            {
+               vec sum = *(const uvec*)(carry + g);
+               for (size_t j = 0; j < PER_LANE; j++)
+               {
+                  size_t bit = j * b;
+                  size_t w = bit / 64;
+                  unsigned s = (unsigned)(bit % 64);
+                  vec d = vec{};
+                  if (b)
+                  {
+                     d = *(const uvec*)(words + w * LANES + g) >> s;
+                     if (s + b > 64)
+                        d |= *(const uvec*)(words + (w + 1) * LANES + g) << (64 - s);
+                  }
+                  sum += d & mask;
+                  *(uvec*)(keys + j * LANES + g) = sum;
+               }
+               *(uvec*)(carry + g) = sum;
+            }
+            return true;
+         }
+#endif
+      };
+
+      inline void decode_block(const uint64_t* words, unsigned b, uint64_t* carry, uint64_t* keys)
+      {
+         simd_detail::dispatch<decode_op, bool>(std::true_type(), words, b, carry, keys);
+      }
+
+      inline void put_varint(std::ostream& out, uint64_t x)
+      {
+         while (x >= 0x80)
+         {
+            out.put((char)(x | 0x80));
+            x >>= 7;
+         }
+         out.put((char)x);
+      }
+      inline bool get_varint(std::istream& in, uint64_t& x)
+      {
+         x = 0;
+         for (unsigned shift = 0; shift < 64; shift += 7)
+         {
+            int c = in.get();
+            if (c == std::char_traits<char>::eof())
+               return false;
+            x |= (uint64_t)(c & 0x7f) << shift;
+            if (!(c & 0x80))
+               return true;
+         }
+         return false;
+      }
+   }
+
+   /*****************************************
+    * SAVE PACKED
+    * A snapshot_header, with its own magic, then the
+    * sorted keys in packed blocks and a varint tail
+    *     OUTPUT : whether the stream took it all
+    ****************************************/
+   template <typename T, typename H, typename E, typename A, typename B>
+   bool save_packed(unordered_set<T, H, E, A, B>& us, std::ostream& out)
+   {
+      static_assert(std::is_integral<T>::value && sizeof(T) <= 8,
+                    "packed snapshots are for sets of integers");
+      using namespace packed_detail;
+
+      custom::vector<uint64_t> keys;
+      keys.reserve(us.size());
+      for (auto it = us.begin(); it != us.end(); ++it)
+         keys.push_back(to_ordered(*it));
+      if (!keys.empty())
+         custom::sort(keys);
+
+      snapshot_header header = { SNAPSHOT_PACKED_MAGIC, SNAPSHOT_VERSION, (uint32_t)sizeof(T),
+                                 us.max_load_factor(), (uint64_t)keys.size(),
+                                 (uint64_t)us.bucket_count() };
+      out.write((const char*)&header, sizeof(header));
+
+      uint64_t carry[LANES] = {};
+      uint64_t words[MAX_WORDS];
+      size_t i = 0;
+      for (; i + BLOCK <= keys.size(); i += BLOCK)
+      {
+         unsigned b = encode_block(&keys[i], carry, words);
+         out.put((char)b);
+         out.write((const char*)words, block_words(b) * sizeof(uint64_t));
+      }
+      uint64_t previous = carry[LANES - 1];
+      for (; i < keys.size(); i++)
+      {
+         put_varint(out, keys[i] - previous);
+         previous = keys[i];
+      }
+      return (bool)out;
+   }
+
+   /*****************************************
+    * LOAD PACKED
+    * Replace the contents of us with a packed
+    * snapshot, decoding each block straight into the
+    * set's bulk build: one bucket array, no rehash
+    *     OUTPUT : false, and an empty set, if the stream
+    *              does not hold a packed snapshot of T
+    ****************************************/
+   template <typename T, typename H, typename E, typename A, typename B>
+   bool load_packed(unordered_set<T, H, E, A, B>& us, std::istream& in)
+   {
+      static_assert(std::is_integral<T>::value && sizeof(T) <= 8,
+                    "packed snapshots are for sets of integers");
+      using namespace packed_detail;
+
+      us.clear();
+      snapshot_header header;
+      if (!in.read((char*)&header, sizeof(header)) ||
+          header.magic != SNAPSHOT_PACKED_MAGIC || header.version != SNAPSHOT_VERSION ||
+          header.elementSize != sizeof(T) ||
+          header.numBuckets == 0 || !(header.maxLoadFactor > 0.0f))
+         return false;
+      us.max_load_factor(header.maxLoadFactor);
+
+      size_t numBlocks = (size_t)(header.numElements / BLOCK);
+      uint64_t carry[LANES] = {};
+      uint64_t words[MAX_WORDS];
+      uint64_t keys[BLOCK];
+      size_t have = 0;              // keys[] decoded
+      size_t used = 0;              // of those, already handed out
+      uint64_t previous = 0;
+
+      return us.assign_from((size_t)header.numBuckets, (size_t)header.numElements,
+                            [&](T* dest, size_t max) -> size_t
+      {
+         size_t written = 0;
+         while (written < max)
+         {
+            if (used == have)
+            {
+               // the next block, or one key of the tail
+               if (numBlocks)
+               {
+                  int b = in.get();
+                  if (b == std::char_traits<char>::eof() || b > 64 ||
+                      !in.read((char*)words, block_words((unsigned)b) * sizeof(uint64_t)))
+                     return 0;
+                  decode_block(words, (unsigned)b, carry, keys);
+                  numBlocks--;
+                  have = BLOCK;
+                  previous = carry[LANES - 1];
+               }
+               else
+               {
+                  uint64_t gap;
+                  if (!get_varint(in, gap))
+                     return 0;
+                  previous += gap;
+                  keys[0] = previous;
+                  have = 1;
+               }
+               used = 0;
+            }
+            for (; used < have && written < max; used++)
+               dest[written++] = from_ordered<T>(keys[used]);
+         }
+         return written;
+      });
+   }
+
+} // namespace custom
@@ -0,0 +1,245 @@
+/***********************************************************************
+ * Header:
+ *    PARALLEL
+ * Summary:
+ *    Parallel algorithms that work straight on custom::vector storage
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    The range is cut into blocks of about cacheBlockBytes so one
+ *    block of input and output stays in a core's cache, and the
+ *    blocks are handed to a thread_pool. Results combine in block
+ *    order, so reduce and scan only need an associative operation,
+ *    not a commutative one.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <algorithm>        // for std::min
+#include <vector>           // for std::vector
+#include "vector.h"         // for custom::vector
+#include "thread_pool.h"    // for custom::thread_pool
+
+namespace custom
+{
+   namespace parallel_detail
+   {
+      // the bytes of input we want one task to chew on at a time
+      const size_t cacheBlockBytes = 64 * 1024;
+
+      /*****************************************
+       * BLOCKS
+       * How a range of n elements of T is carved up
+       ****************************************/
+      template <typename T>
+      struct blocks
+      {
+         blocks(size_t n) : n(n)
+         {
+            size = cacheBlockBytes / sizeof(T);
+            if (size == 0)
+               size = 1;
+            count = (n + size - 1) / size;
+         }
+         size_t begin(size_t b) const { return b * size; }
+         size_t end(size_t b)   const { return std::min(n, (b + 1) * size); }
+
+         size_t n;       // elements in the whole range
+         size_t size;    // elements per block, the last may be short
+         size_t count;   // number of blocks
+      };
+   } // namespace parallel_detail
+
+   /***************************************
+    * PARALLEL FOR EACH
+    * Call f(element) on every element
+    **************************************/
+   template <typename T, typename A, typename G, class F>
+   void parallel_for_each(vector <T, A, G>& v, F f, thread_pool& pool = thread_pool::instance())
+   {
+      if (v.empty())
+         return;
+      T* p = &v[0];
+      parallel_detail::blocks<T> blk(v.size());
+      pool.parallel_for(blk.count, [&](size_t b)
+      {
+         for (size_t i = blk.begin(b); i < blk.end(b); i++)
+            f(p[i]);
+      });
+   }
+
+   /***************************************
+    * PARALLEL TRANSFORM
+    * out[i] = f(in[i]). out is resized to match in
+    * and may be the same vector as in.
+    **************************************/
+   template <typename T, typename A, typename G, typename U, typename AA, typename GG, class F>
+   void parallel_transform(const vector <T, A, G>& in, vector <U, AA, GG>& out, F f,
+                           thread_pool& pool = thread_pool::instance())
+   {
+      out.resize(in.size());
+      if (in.empty())
+         return;
+      const T* src = &in[0];
+      U* dst = &out[0];
+      parallel_detail::blocks<T> blk(in.size());
+      pool.parallel_for(blk.count, [&](size_t b)
+      {
+         for (size_t i = blk.begin(b); i < blk.end(b); i++)
+            dst[i] = f(src[i]);
+      });
+   }
+
+   /***************************************
+    * PARALLEL TRANSFORM REDUCE
+    * init op f(v[0]) op f(v[1]) ... with op associative
+    **************************************/
+   template <typename T, typename A, typename G, typename R, class Reduce, class Transform>
+   R parallel_transform_reduce(const vector <T, A, G>& v, R init, Reduce op, Transform f,
+                               thread_pool& pool = thread_pool::instance())
+   {
+      if (v.empty())
+         return init;
+      const T* p = &v[0];
+      parallel_detail::blocks<T> blk(v.size());
+      std::vector<R> partial(blk.count, init);
+      pool.parallel_for(blk.count, [&](size_t b)
+      {
+         size_t i = blk.begin(b);
+         R total = f(p[i]);
+         for (++i; i < blk.end(b); i++)
+            total = op(total, f(p[i]));
+         partial[b] = total;
+      });
+
+      R total = init;
+      for (size_t b = 0; b < blk.count; b++)
+         total = op(total, partial[b]);
+      return total;
+   }
+
+   /***************************************
+    * PARALLEL REDUCE
+    * init op v[0] op v[1] ... with op associative
+    **************************************/
+   template <typename T, typename A, typename G, class Reduce>
+   T parallel_reduce(const vector <T, A, G>& v, T init, Reduce op,
+                     thread_pool& pool = thread_pool::instance())
+   {
+      return parallel_transform_reduce(v, init, op, [](const T& t) -> const T& { return t; }, pool);
+   }
+
+   template <typename T, typename A, typename G>
+   T parallel_reduce(const vector <T, A, G>& v, T init, thread_pool& pool = thread_pool::instance())
+   {
+      return parallel_reduce(v, init, [](const T& lhs, const T& rhs) { return lhs + rhs; }, pool);
+   }
+
+   /***************************************
+    * PARALLEL INCLUSIVE SCAN
+    * out[i] = in[0] op in[1] op ... op in[i]
+    * Three steps: total each block, scan the block
+    * totals on this thread, then scan each block again
+    * starting from the total of the blocks before it.
+    * out may be the same vector as in.
+    **************************************/
+   template <typename T, typename A, typename G, typename AA, typename GG, class Op>
+   void parallel_inclusive_scan(const vector <T, A, G>& in, vector <T, AA, GG>& out, Op op,
+                                thread_pool& pool = thread_pool::instance())
+   {
+      size_t n = in.size();
+      out.resize(n);
+      if (n == 0)
+         return;
+      const T* src = &in[0];
+      T* dst = &out[0];
+      parallel_detail::blocks<T> blk(n);
+
+      // the total of every block but the last
+      std::vector<T> carry(blk.count);
+      pool.parallel_for(blk.count - 1, [&](size_t b)
+      {
+         size_t i = blk.begin(b);
+         T total = src[i];
+         for (++i; i < blk.end(b); i++)
+            total = op(total, src[i]);
+         carry[b] = total;
+      });
+      for (size_t b = 1; b + 1 < blk.count; b++)
+         carry[b] = op(carry[b - 1], carry[b]);
+
+      pool.parallel_for(blk.count, [&](size_t b)
+      {
+         size_t i = blk.begin(b);
+         T total = (b == 0) ? src[i] : op(carry[b - 1], src[i]);
+         dst[i] = total;
+         for (++i; i < blk.end(b); i++)
+            dst[i] = total = op(total, src[i]);
+      });
+   }
+
+   template <typename T, typename A, typename G, typename AA, typename GG>
+   void parallel_inclusive_scan(const vector <T, A, G>& in, vector <T, AA, GG>& out,
+                                thread_pool& pool = thread_pool::instance())
+   {
+      parallel_inclusive_scan(in, out, [](const T& lhs, const T& rhs) { return lhs + rhs; }, pool);
+   }
+
+   /***************************************
+    * PARALLEL COPY IF
+    * Copy the elements that satisfy pred into out,
+    * keeping their order. Each block marks its matches
+    * and counts them, the counts become offsets, and
+    * each block copies into its own slice of out.
+    * out must not be the same vector as in.
+    *     OUTPUT : the number of elements copied
+    **************************************/
+   template <typename T, typename A, typename G, typename AA, typename GG, class Pred>
+   size_t parallel_copy_if(const vector <T, A, G>& in, vector <T, AA, GG>& out, Pred pred,
+                           thread_pool& pool = thread_pool::instance())
+   {
+      assert((const void*)&in != (const void*)&out);
+      size_t n = in.size();
+      if (n == 0)
+      {
+         out.clear();
+         return 0;
+      }
+      const T* src = &in[0];
+      parallel_detail::blocks<T> blk(n);
+      std::vector<unsigned char> keep(n);
+      std::vector<size_t> offset(blk.count + 1, 0);
+
+      pool.parallel_for(blk.count, [&](size_t b)
+      {
+         size_t count = 0;
+         for (size_t i = blk.begin(b); i < blk.end(b); i++)
+            count += (keep[i] = pred(src[i]) ? 1 : 0);
+         offset[b + 1] = count;
+      });
+      for (size_t b = 0; b < blk.count; b++)
+         offset[b + 1] += offset[b];
+
+      out.resize(offset[blk.count]);
+      if (out.empty())
+         return 0;
+      T* dst = &out[0];
+      pool.parallel_for(blk.count, [&](size_t b)
+      {
+         size_t j = offset[b];
+         for (size_t i = blk.begin(b); i < blk.end(b); i++)
+            if (keep[i])
+               dst[j++] = src[i];
+      });
+      return out.size();
+   }
+
+} // namespace custom
@@ -0,0 +1,237 @@
+/***********************************************************************
+ * Header:
+ *    PRIORITY QUEUE
+ * Summary:
+ *    A d-ary heap on top of custom::vector. With four or eight
+ *    children to a node, the children of a node sit next to each
+ *    other in one or two cache lines and the tree is half as deep
+ *    as a binary heap, so a sift touches fewer lines.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        priority_queue : the largest element is always on top
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <functional>       // for std::less
+#include <initializer_list> // for std::initializer_list
+#include <utility>          // for std::move, std::forward
+#include "vector.h"         // for the heap array
+
+class TestPQueue; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************
+    * PRIORITY QUEUE
+    * The children of container[i] are container[i * D + 1]
+    * through container[i * D + D]. Like std::priority_queue
+    * the top is the element that compares largest.
+    ****************************************/
+   template <typename T, typename Compare = std::less<T>, size_t D = 4>
+   class priority_queue
+   {
+      friend class ::TestPQueue; // give unit tests access to the privates
+      static_assert(D >= 2, "a heap needs at least two children per node");
+   public:
+
+      //
+      // Construct
+      //
+      priority_queue(const Compare& c = Compare()) : comp(c) {}
+      priority_queue(const std::initializer_list<T>& l, const Compare& c = Compare())
+         : container(l), comp(c)
+      {
+         heapify();
+      }
+      template <class Iterator>
+      priority_queue(Iterator first, Iterator last, const Compare& c = Compare()) : comp(c)
+      {
+         for (Iterator it = first; it != last; ++it)
+            container.push_back(*it);
+         heapify();
+      }
+      priority_queue(custom::vector<T>&& v, const Compare& c = Compare())
+         : container(std::move(v)), comp(c)
+      {
+         heapify();
+      }
+
+      //
+      // Assign
+      //
+      void swap(priority_queue& rhs)
+      {
+         container.swap(rhs.container);
+         std::swap(comp, rhs.comp);
+      }
+
+      //
+      // Access
+      //
+      const T& top() const
+      {
+         assert(!empty());
+         return container.front();
+      }
+
+      //
+      // Insert
+      //
+      void push(const T& t)
+      {
+         container.push_back(t);
+         siftUp(container.size() - 1);
+      }
+      void push(T&& t)
+      {
+         container.push_back(std::move(t));
+         siftUp(container.size() - 1);
+      }
+      template <class... Args>
+      void emplace(Args&&... args)
+      {
+         container.push_back(T(std::forward<Args>(args)...));
+         siftUp(container.size() - 1);
+      }
+      T push_pop(T t);
+      void reserve(size_t newCapacity) { container.reserve(newCapacity); }
+
+      //
+      // Remove
+      //
+      void pop();
+      void clear() { container.clear(); }
+
+      //
+      // Status
+      //
+      size_t size() const { return container.size(); }
+      bool empty()  const { return container.empty(); }
+
+   private:
+
+      static size_t parent(size_t i)     { return (i - 1) / D; }
+      static size_t firstChild(size_t i) { return i * D + 1; }
+
+      void heapify();
+      void siftUp(size_t i);
+      void siftDown(size_t i);
+
+      custom::vector<T> container;   // the heap, root first
+      Compare comp;                  // comp(a, b) is true when a goes below b
+   };
+
+   /*****************************************
+    * PRIORITY QUEUE :: HEAPIFY
+    * Floyd's bottom up build: sift down every parent
+    * from the last one to the root. O(n), where n
+    * pushes would be O(n log n).
+    ****************************************/
+   template <typename T, typename Compare, size_t D>
+   void priority_queue <T, Compare, D> ::heapify()
+   {
+      if (container.size() < 2)
+         return;
+      for (size_t i = parent(container.size() - 1) + 1; i-- > 0; )
+         siftDown(i);
+   }
+
+   /*****************************************
+    * PRIORITY QUEUE :: SIFT UP
+    * Carry the element at i up in a hole, moving each
+    * smaller parent down into it. One move per level
+    * instead of the three a swap would cost.
+    ****************************************/
+   template <typename T, typename Compare, size_t D>
+   void priority_queue <T, Compare, D> ::siftUp(size_t i)
+   {
+      if (i == 0)
+         return;
+      T value = std::move(container[i]);
+      while (i > 0 && comp(container[parent(i)], value))
+      {
+         container[i] = std::move(container[parent(i)]);
+         i = parent(i);
+      }
+      container[i] = std::move(value);
+   }
+
+   /*****************************************
+    * PRIORITY QUEUE :: SIFT DOWN
+    * Carry the element at i down in a hole, pulling
+    * the largest of the D children up each level.
+    ****************************************/
+   template <typename T, typename Compare, size_t D>
+   void priority_queue <T, Compare, D> ::siftDown(size_t i)
+   {
+      size_t num = container.size();
+      T value = std::move(container[i]);
+      for (;;)
+      {
+         size_t first = firstChild(i);
+         if (first >= num)
+            break;
+
+         // the largest child, all D of them in a row
+         size_t last = (num - first < D) ? num : first + D;
+         size_t best = first;
+         for (size_t c = first + 1; c < last; c++)
+            if (comp(container[best], container[c]))
+               best = c;
+
+         if (!comp(value, container[best]))
+            break;
+         container[i] = std::move(container[best]);
+         i = best;
+      }
+      container[i] = std::move(value);
+   }
+
+   /*****************************************
+    * PRIORITY QUEUE :: POP
+    * Move the last element into the root's place
+    * and let it sink
+    ****************************************/
+   template <typename T, typename Compare, size_t D>
+   void priority_queue <T, Compare, D> ::pop()
+   {
+      assert(!empty());
+      if (container.size() > 1)
+         container.front() = std::move(container.back());
+      container.pop_back();
+      if (!container.empty())
+         siftDown(0);
+   }
+
+   /*****************************************
+    * PRIORITY QUEUE :: PUSH POP
+    * Push t then pop the top, in one sift. If t would
+    * be the new top it never goes in at all, which is
+    * the common case when keeping the K smallest.
+    *     INPUT  : t   the element to add
+    *     OUTPUT : the element that was removed
+    ****************************************/
+   template <typename T, typename Compare, size_t D>
+   T priority_queue <T, Compare, D> ::push_pop(T t)
+   {
+      if (empty() || !comp(t, container.front()))
+         return t;
+      T result = std::move(container.front());
+      container.front() = std::move(t);
+      siftDown(0);
+      return result;
+   }
+
+} // namespace custom
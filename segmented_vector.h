@@ -0,0 +1,357 @@
+/***********************************************************************
+ * Header:
+ *    SEGMENTED VECTOR
+ * Summary:
+ *    A vector that stores its elements in fixed-size chunks. Growing
+ *    never moves an element, so references stay good and we never
+ *    need twice the memory to copy into a bigger buffer.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        segmented_vector           : A chunked vector
+ *        segmented_vector::iterator : An iterator through segmented_vector
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <memory>           // for std::allocator
+#include <utility>          // for std::move
+#include <initializer_list> // for std::initializer_list
+#include "vector.h"         // for the chunk index
+
+class TestSegmentedVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************
+    * SEGMENTED VECTOR
+    * Elements live in chunks of C. The chunk index
+    * is a small vector of pointers, so element i is
+    * always chunks[i / C][i % C].
+    ****************************************/
+   template <typename T, size_t C = 512, typename A = std::allocator<T>>
+   class segmented_vector
+   {
+      friend class ::TestSegmentedVector; // give unit tests access to the privates
+      static_assert(C > 0 && (C & (C - 1)) == 0, "chunk size must be a power of two");
+   public:
+
+      //
+      // Construct
+      //
+      segmented_vector(const A& a = A()) : alloc(a), numElements(0) {}
+      segmented_vector(size_t numElements, const A& a = A());
+      segmented_vector(size_t numElements, const T& t, const A& a = A());
+      segmented_vector(const std::initializer_list<T>& l, const A& a = A());
+      segmented_vector(const segmented_vector& rhs);
+      segmented_vector(segmented_vector&& rhs);
+      ~segmented_vector();
+
+      //
+      // Assign
+      //
+      void swap(segmented_vector& rhs);
+      segmented_vector& operator = (const segmented_vector& rhs);
+      segmented_vector& operator = (segmented_vector&& rhs);
+
+      //
+      // Iterator
+      //
+      class iterator;
+      iterator begin() { return iterator(this, 0); }
+      iterator end()   { return iterator(this, numElements); }
+
+      //
+      // Access
+      //
+      T& operator [] (size_t index)             { return chunks[index / C][index % C]; }
+      const T& operator [] (size_t index) const { return chunks[index / C][index % C]; }
+      T& front()                                { return (*this)[0]; }
+      const T& front() const                    { return (*this)[0]; }
+      T& back()                                 { return (*this)[numElements - 1]; }
+      const T& back() const                     { return (*this)[numElements - 1]; }
+
+      //
+      // Insert
+      //
+      void push_back(const T& t);
+      void push_back(T&& t);
+      void reserve(size_t newCapacity);
+      void resize(size_t newElements);
+      void resize(size_t newElements, const T& t);
+
+      //
+      // Remove
+      //
+      void clear()
+      {
+         for (size_t i = 0; i < numElements; i++)
+            alloc.destroy(&(*this)[i]);
+         numElements = 0;
+      }
+      void pop_back()
+      {
+         if (numElements > 0)
+            alloc.destroy(&(*this)[--numElements]);
+      }
+      void shrink_to_fit();
+
+      //
+      // Status
+      //
+      size_t  size()          const { return numElements; }
+      size_t  capacity()      const { return chunks.size() * C; }
+      bool empty()            const { return (numElements == 0); }
+      size_t  chunk_count()   const { return chunks.size(); }
+
+   private:
+
+      void addChunk() { chunks.push_back(alloc.allocate(C)); }
+
+      A    alloc;                // use allocator for each chunk
+      custom::vector<T*> chunks; // the chunk index, each holds C elements
+      size_t  numElements;       // the number of items currently used
+   };
+
+   /**************************************************
+    * SEGMENTED VECTOR ITERATOR
+    * Remembers the container and an index, so it
+    * never dangles when new chunks are added.
+    *************************************************/
+   template <typename T, size_t C, typename A>
+   class segmented_vector <T, C, A> ::iterator
+   {
+      friend class ::TestSegmentedVector; // give unit tests access to the privates
+   public:
+      // constructors, destructors, and assignment operator
+      iterator() : pOwner(nullptr), index(0) {}
+      iterator(segmented_vector* pOwner, size_t index) : pOwner(pOwner), index(index) {}
+      iterator(const iterator& rhs) : pOwner(rhs.pOwner), index(rhs.index) {}
+      iterator& operator = (const iterator& rhs)
+      {
+         pOwner = rhs.pOwner;
+         index = rhs.index;
+         return *this;
+      }
+
+      // equals, not equals operator
+      bool operator != (const iterator& rhs) const { return index != rhs.index || pOwner != rhs.pOwner; }
+      bool operator == (const iterator& rhs) const { return !(*this != rhs); }
+
+      // dereference operator
+      T& operator * () { return (*pOwner)[index]; }
+
+      // increment and decrement
+      iterator& operator ++ ()    { ++index; return *this; }
+      iterator  operator ++ (int) { iterator temp = *this; ++index; return temp; }
+      iterator& operator -- ()    { --index; return *this; }
+      iterator  operator -- (int) { iterator temp = *this; --index; return temp; }
+
+   private:
+      segmented_vector* pOwner;
+      size_t index;
+   };
+
+   /*****************************************
+    * SEGMENTED VECTOR :: NON-DEFAULT constructors
+    ****************************************/
+   template <typename T, size_t C, typename A>
+   segmented_vector <T, C, A> ::segmented_vector(size_t num, const A& a)
+      : alloc(a), numElements(0)
+   {
+      resize(num);
+   }
+
+   template <typename T, size_t C, typename A>
+   segmented_vector <T, C, A> ::segmented_vector(size_t num, const T& t, const A& a)
+      : alloc(a), numElements(0)
+   {
+      resize(num, t);
+   }
+
+   /*****************************************
+    * SEGMENTED VECTOR :: INITIALIZATION LIST constructor
+    ****************************************/
+   template <typename T, size_t C, typename A>
+   segmented_vector <T, C, A> ::segmented_vector(const std::initializer_list<T>& l, const A& a)
+      : alloc(a), numElements(0)
+   {
+      reserve(l.size());
+      for (auto it = l.begin(); it != l.end(); ++it)
+         push_back(*it);
+   }
+
+   /*****************************************
+    * SEGMENTED VECTOR :: COPY CONSTRUCTOR
+    ****************************************/
+   template <typename T, size_t C, typename A>
+   segmented_vector <T, C, A> ::segmented_vector(const segmented_vector& rhs)
+      : alloc(rhs.alloc), numElements(0)
+   {
+      reserve(rhs.numElements);
+      for (size_t i = 0; i < rhs.numElements; i++)
+         push_back(rhs[i]);
+   }
+
+   /*****************************************
+    * SEGMENTED VECTOR :: MOVE CONSTRUCTOR
+    * Steal the chunk index, no element is touched
+    ****************************************/
+   template <typename T, size_t C, typename A>
+   segmented_vector <T, C, A> ::segmented_vector(segmented_vector&& rhs)
+      : alloc(rhs.alloc), chunks(std::move(rhs.chunks)), numElements(rhs.numElements)
+   {
+      rhs.numElements = 0;
+   }
+
+   /*****************************************
+    * SEGMENTED VECTOR :: DESTRUCTOR
+    ****************************************/
+   template <typename T, size_t C, typename A>
+   segmented_vector <T, C, A> :: ~segmented_vector()
+   {
+      clear();
+      for (size_t i = 0; i < chunks.size(); i++)
+         alloc.deallocate(chunks[i], C);
+   }
+
+   /***************************************
+    * SEGMENTED VECTOR :: RESERVE
+    * Add chunks until newCapacity fits. Existing
+    * elements never move.
+    **************************************/
+   template <typename T, size_t C, typename A>
+   void segmented_vector <T, C, A> ::reserve(size_t newCapacity)
+   {
+      size_t numChunks = (newCapacity + C - 1) / C;
+      if (numChunks > chunks.size())
+         chunks.reserve(numChunks);
+      while (chunks.size() < numChunks)
+         addChunk();
+   }
+
+   /***************************************
+    * SEGMENTED VECTOR :: RESIZE
+    **************************************/
+   template <typename T, size_t C, typename A>
+   void segmented_vector <T, C, A> ::resize(size_t newElements)
+   {
+      while (numElements > newElements)
+         pop_back();
+      reserve(newElements);
+      for (; numElements < newElements; numElements++)
+         alloc.construct(&(*this)[numElements]);
+   }
+
+   template <typename T, size_t C, typename A>
+   void segmented_vector <T, C, A> ::resize(size_t newElements, const T& t)
+   {
+      while (numElements > newElements)
+         pop_back();
+      reserve(newElements);
+      for (; numElements < newElements; numElements++)
+         alloc.construct(&(*this)[numElements], t);
+   }
+
+   /***************************************
+    * SEGMENTED VECTOR :: SHRINK TO FIT
+    * Free the chunks past the last element
+    **************************************/
+   template <typename T, size_t C, typename A>
+   void segmented_vector <T, C, A> ::shrink_to_fit()
+   {
+      size_t numChunks = (numElements + C - 1) / C;
+      while (chunks.size() > numChunks)
+      {
+         alloc.deallocate(chunks.back(), C);
+         chunks.pop_back();
+      }
+   }
+
+   /***************************************
+    * SEGMENTED VECTOR :: PUSH BACK
+    * Add to the end, starting a new chunk when the
+    * last one is full
+    **************************************/
+   template <typename T, size_t C, typename A>
+   void segmented_vector <T, C, A> ::push_back(const T& t)
+   {
+      if (numElements == capacity())
+         addChunk();
+      alloc.construct(&(*this)[numElements], t);
+      numElements++;
+   }
+
+   template <typename T, size_t C, typename A>
+   void segmented_vector <T, C, A> ::push_back(T&& t)
+   {
+      if (numElements == capacity())
+         addChunk();
+      alloc.construct(&(*this)[numElements], std::move(t));
+      numElements++;
+   }
+
+   /***************************************
+    * SEGMENTED VECTOR :: SWAP
+    **************************************/
+   template <typename T, size_t C, typename A>
+   void segmented_vector <T, C, A> ::swap(segmented_vector& rhs)
+   {
+      chunks.swap(rhs.chunks);
+
+      size_t tempElements = numElements;
+      numElements = rhs.numElements;
+      rhs.numElements = tempElements;
+   }
+
+   /***************************************
+    * SEGMENTED VECTOR :: ASSIGNMENT
+    **************************************/
+   template <typename T, size_t C, typename A>
+   segmented_vector <T, C, A>& segmented_vector <T, C, A> :: operator = (const segmented_vector& rhs)
+   {
+      if (this != &rhs)
+      {
+         while (numElements > rhs.numElements)
+            pop_back();
+         for (size_t i = 0; i < numElements; i++)
+            (*this)[i] = rhs[i];
+         reserve(rhs.numElements);
+         for (size_t i = numElements; i < rhs.numElements; i++)
+            push_back(rhs[i]);
+      }
+      return *this;
+   }
+
+   template <typename T, size_t C, typename A>
+   segmented_vector <T, C, A>& segmented_vector <T, C, A> :: operator = (segmented_vector&& rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         swap(rhs);
+      }
+      return *this;
+   }
+
+   /*****************************************
+    * SWAP
+    * Stand-alone segmented vector swap
+    ****************************************/
+   template <typename T, size_t C, typename A>
+   void swap(segmented_vector <T, C, A>& lhs, segmented_vector <T, C, A>& rhs)
+   {
+      lhs.swap(rhs);
+   }
+
+} // namespace custom
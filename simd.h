@@ -0,0 +1,493 @@
+/***********************************************************************
+ * Header:
+ *    SIMD
+ * Summary:
+ *    Vectorized scans over a custom::vector of arithmetic values:
+ *    find, count, min, max, sum and contains_any.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    Each scan is written once against GCC vector types and then
+ *    compiled three times, for SSE2, AVX2 and AVX-512. The widest one
+ *    the CPU supports is picked at run time. Compilers without GCC
+ *    vector extensions, and element types wider than 8 bytes, get the
+ *    plain scalar loop.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <cstdint>          // for int8_t ... int64_t
+#include <type_traits>      // for std::is_arithmetic
+#include <initializer_list> // for std::initializer_list
+#include "vector.h"         // for custom::vector
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CUSTOM_SIMD_X86 1
+#define CUSTOM_SIMD_INLINE inline __attribute__((always_inline))
+#endif
+
+class TestSimd; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************
+    * SIMD LEVEL
+    * The instruction sets we have kernels for
+    ****************************************/
+   enum simd_level { SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2, SIMD_AVX512 };
+
+   /*****************************************
+    * SIMD SUPPORTED
+    * The widest level this CPU can run
+    ****************************************/
+   inline simd_level simd_supported()
+   {
+#ifdef CUSTOM_SIMD_X86
+      static const simd_level level = []()
+      {
+         __builtin_cpu_init();
+         if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+            return SIMD_AVX512;
+         if (__builtin_cpu_supports("avx2"))
+            return SIMD_AVX2;
+         if (__builtin_cpu_supports("sse2"))
+            return SIMD_SSE2;
+         return SIMD_SCALAR;
+      }();
+      return level;
+#else
+      return SIMD_SCALAR;
+#endif
+   }
+
+   namespace simd_detail
+   {
+      inline simd_level& active()
+      {
+         static simd_level level = simd_supported();
+         return level;
+      }
+   }
+
+   /*****************************************
+    * SIMD ACTIVE / SIMD LIMIT
+    * The level the scans currently use. simd_limit()
+    * caps it, which is handy for tests and benchmarks.
+    ****************************************/
+   inline simd_level simd_active()
+   {
+      return simd_detail::active();
+   }
+   inline void simd_limit(simd_level level)
+   {
+      simd_detail::active() = (level < simd_supported()) ? level : simd_supported();
+   }
+
+   /*****************************************
+    * SUM TYPE
+    * sum() widens so that it does not overflow:
+    * 64 bit integers for integral T, double for float
+    ****************************************/
+   template <typename T>
+   struct sum_type
+   {
+      typedef typename std::conditional<std::is_floating_point<T>::value,
+                 typename std::conditional<(sizeof(T) > sizeof(double)), T, double>::type,
+                 typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type
+              >::type type;
+   };
+
+   namespace simd_detail
+   {
+      // only these element types have vector kernels
+      template <typename T>
+      struct simd_ok : std::integral_constant<bool,
+         std::is_arithmetic<T>::value && !std::is_same<T, bool>::value && sizeof(T) <= 8> {};
+
+#ifdef CUSTOM_SIMD_X86
+      template <size_t S> struct lane_int;
+      template <> struct lane_int<1> { typedef int8_t  type; };
+      template <> struct lane_int<2> { typedef int16_t type; };
+      template <> struct lane_int<4> { typedef int32_t type; };
+      template <> struct lane_int<8> { typedef int64_t type; };
+
+      /*****************************************
+       * LANES
+       * W bytes worth of T in one register
+       ****************************************/
+      template <typename T, size_t W>
+      struct lanes
+      {
+         static const size_t count = W / sizeof(T);
+         typedef T vec __attribute__((vector_size(W)));
+         typedef T uvec __attribute__((vector_size(W), aligned(sizeof(T))));
+         typedef typename lane_int<sizeof(T)>::type mvec __attribute__((vector_size(W)));
+         typedef uint64_t qvec __attribute__((vector_size(W)));
+      };
+
+      // view a possibly unaligned address as one register's worth.
+      // Returning the pointer rather than the vector keeps the wide
+      // type out of the signature of a function built without AVX.
+      template <typename T, size_t W>
+      CUSTOM_SIMD_INLINE const typename lanes<T, W>::uvec* at(const T* p)
+      {
+         return (const typename lanes<T, W>::uvec*)p;
+      }
+
+      // is any lane of the mask set?
+      template <typename T, size_t W>
+      CUSTOM_SIMD_INLINE bool any(const typename lanes<T, W>::mvec& m)
+      {
+         typename lanes<T, W>::qvec q = (typename lanes<T, W>::qvec)m;
+         uint64_t bits = 0;
+         for (size_t k = 0; k < W / 8; k++)
+            bits |= q[k];
+         return bits != 0;
+      }
+
+      // run Op at W bytes wide, compiled for the matching instruction set
+      template <class Op, typename R, typename... Args>
+      __attribute__((target("sse2"))) R run_sse2(Args... args)
+      {
+         return Op::template run<16>(args...);
+      }
+      template <class Op, typename R, typename... Args>
+      __attribute__((target("avx2"))) R run_avx2(Args... args)
+      {
+         return Op::template run<32>(args...);
+      }
+      template <class Op, typename R, typename... Args>
+      __attribute__((target("avx512f,avx512bw"))) R run_avx512(Args... args)
+      {
+         return Op::template run<64>(args...);
+      }
+#endif // CUSTOM_SIMD_X86
+
+      /*****************************************
+       * DISPATCH
+       * Pick the widest kernel allowed right now
+       ****************************************/
+      template <class Op, typename R, typename... Args>
+      R dispatch(std::false_type, Args... args)
+      {
+         return Op::scalar(args...);
+      }
+      template <class Op, typename R, typename... Args>
+      R dispatch(std::true_type, Args... args)
+      {
+#ifdef CUSTOM_SIMD_X86
+         switch (active())
+         {
+            case SIMD_AVX512: return run_avx512<Op, R>(args...);
+            case SIMD_AVX2:   return run_avx2<Op, R>(args...);
+            case SIMD_SSE2:   return run_sse2<Op, R>(args...);
+            default:          break;
+         }
+#endif
+         return Op::scalar(args...);
+      }
+
+      /*****************************************
+       * FIND
+       * Index of the first value, or n if missing
+       ****************************************/
+      struct find_op
+      {
+         template <typename T>
+         static size_t scalar(const T* p, size_t n, T value)
+         {
+            for (size_t i = 0; i < n; i++)
+               if (p[i] == value)
+                  return i;
+            return n;
+         }
+#ifdef CUSTOM_SIMD_X86
+         template <size_t W, typename T>
+         static CUSTOM_SIMD_INLINE size_t run(const T* p, size_t n, T value)
+         {
+            typedef lanes<T, W> V;
+            typename V::vec needle = typename V::vec{} + value;
+            size_t i = 0;
+            for (; i + V::count <= n; i += V::count)
+               if (any<T, W>((typename V::mvec)(*at<T, W>(p + i) == needle)))
+                  break;
+            for (; i < n; i++)
+               if (p[i] == value)
+                  return i;
+            return n;
+         }
+#endif
+      };
+
+      /*****************************************
+       * COUNT
+       * How many elements equal value. Each lane
+       * counts in its own width, so flush to the
+       * total before an 8 bit lane could overflow.
+       ****************************************/
+      struct count_op
+      {
+         template <typename T>
+         static size_t scalar(const T* p, size_t n, T value)
+         {
+            size_t total = 0;
+            for (size_t i = 0; i < n; i++)
+               total += (p[i] == value) ? 1 : 0;
+            return total;
+         }
+#ifdef CUSTOM_SIMD_X86
+         template <size_t W, typename T>
+         static CUSTOM_SIMD_INLINE size_t run(const T* p, size_t n, T value)
+         {
+            typedef lanes<T, W> V;
+            typename V::vec needle = typename V::vec{} + value;
+            typename V::mvec acc = {};
+            size_t total = 0;
+            size_t blocks = 0;
+            size_t i = 0;
+            for (; i + V::count <= n; i += V::count)
+            {
+               acc -= (typename V::mvec)(*at<T, W>(p + i) == needle);
+               if (++blocks == 127)
+               {
+                  for (size_t k = 0; k < V::count; k++)
+                     total += (size_t)acc[k];
+                  acc = typename V::mvec{};
+                  blocks = 0;
+               }
+            }
+            for (size_t k = 0; k < V::count; k++)
+               total += (size_t)acc[k];
+            return total + scalar(p + i, n - i, value);
+         }
+#endif
+      };
+
+      /*****************************************
+       * MIN MAX
+       * The smallest (or largest when IsMax) element
+       ****************************************/
+      template <bool IsMax>
+      struct minmax_op
+      {
+         template <typename T>
+         static T scalar(const T* p, size_t n)
+         {
+            T best = p[0];
+            for (size_t i = 1; i < n; i++)
+               if (IsMax ? (best < p[i]) : (p[i] < best))
+                  best = p[i];
+            return best;
+         }
+#ifdef CUSTOM_SIMD_X86
+         template <size_t W, typename T>
+         static CUSTOM_SIMD_INLINE T run(const T* p, size_t n)
+         {
+            typedef lanes<T, W> V;
+            if (n < V::count)
+               return scalar(p, n);
+
+            typename V::vec best = *at<T, W>(p);
+            size_t i = V::count;
+            for (; i + V::count <= n; i += V::count)
+            {
+               typename V::vec chunk = *at<T, W>(p + i);
+               best = (IsMax ? (best < chunk) : (chunk < best)) ? chunk : best;
+            }
+
+            T result = best[0];
+            for (size_t k = 1; k < V::count; k++)
+               if (IsMax ? (result < best[k]) : (best[k] < result))
+                  result = best[k];
+            for (; i < n; i++)
+               if (IsMax ? (result < p[i]) : (p[i] < result))
+                  result = p[i];
+            return result;
+         }
+#endif
+      };
+
+      /*****************************************
+       * SUM
+       * Add everything up in the widened sum_type.
+       * Floating point lanes add in a different order
+       * than the scalar loop, so the last bits may differ.
+       ****************************************/
+      struct sum_op
+      {
+         template <typename T>
+         static typename sum_type<T>::type scalar(const T* p, size_t n)
+         {
+            typename sum_type<T>::type total = 0;
+            for (size_t i = 0; i < n; i++)
+               total += p[i];
+            return total;
+         }
+#ifdef CUSTOM_SIMD_X86
+         template <size_t W, typename T>
+         static CUSTOM_SIMD_INLINE typename sum_type<T>::type run(const T* p, size_t n)
+         {
+            typedef lanes<T, W> V;
+            typedef typename sum_type<T>::type S;
+            typedef S svec __attribute__((vector_size(V::count * sizeof(S))));
+            svec acc = {};
+            size_t i = 0;
+            for (; i + V::count <= n; i += V::count)
+               acc += __builtin_convertvector(*at<T, W>(p + i), svec);
+
+            S total = 0;
+            for (size_t k = 0; k < V::count; k++)
+               total += acc[k];
+            return total + scalar(p + i, n - i);
+         }
+#endif
+      };
+
+      /*****************************************
+       * CONTAINS ANY
+       * Does any element equal any of the needles?
+       ****************************************/
+      struct any_op
+      {
+         template <typename T>
+         static bool scalar(const T* p, size_t n, const T* needles, size_t numNeedles)
+         {
+            for (size_t i = 0; i < n; i++)
+               for (size_t j = 0; j < numNeedles; j++)
+                  if (p[i] == needles[j])
+                     return true;
+            return false;
+         }
+#ifdef CUSTOM_SIMD_X86
+         template <size_t W, typename T>
+         static CUSTOM_SIMD_INLINE bool run(const T* p, size_t n, const T* needles, size_t numNeedles)
+         {
+            typedef lanes<T, W> V;
+            size_t i = 0;
+            for (; i + V::count <= n; i += V::count)
+            {
+               typename V::vec chunk = *at<T, W>(p + i);
+               typename V::mvec hit = {};
+               for (size_t j = 0; j < numNeedles; j++)
+                  hit |= (typename V::mvec)(chunk == (typename V::vec{} + needles[j]));
+               if (any<T, W>(hit))
+                  return true;
+            }
+            return scalar(p + i, n - i, needles, numNeedles);
+         }
+#endif
+      };
+
+      // raw access to the elements of a non-empty vector
+      template <typename T, typename A, typename G>
+      const T* begin(const custom::vector<T, A, G>& v)
+      {
+         return &v[0];
+      }
+   } // namespace simd_detail
+
+   /***************************************
+    * FIND
+    * Locate the first element equal to value
+    *     INPUT  : v     the vector to search
+    *              value what we are looking for
+    *     OUTPUT : iterator to it, or v.end()
+    **************************************/
+   template <typename T, typename A, typename G>
+   typename vector <T, A, G> ::iterator find(vector <T, A, G>& v, const T& value)
+   {
+      static_assert(std::is_arithmetic<T>::value, "find needs an arithmetic T");
+      if (v.empty())
+         return v.end();
+      size_t i = simd_detail::dispatch<simd_detail::find_op, size_t>(
+         simd_detail::simd_ok<T>(), simd_detail::begin(v), v.size(), value);
+      return typename vector <T, A, G> ::iterator(&v[0] + i);
+   }
+
+   /***************************************
+    * COUNT
+    * How many elements are equal to value
+    **************************************/
+   template <typename T, typename A, typename G>
+   size_t count(const vector <T, A, G>& v, const T& value)
+   {
+      static_assert(std::is_arithmetic<T>::value, "count needs an arithmetic T");
+      if (v.empty())
+         return 0;
+      return simd_detail::dispatch<simd_detail::count_op, size_t>(
+         simd_detail::simd_ok<T>(), simd_detail::begin(v), v.size(), value);
+   }
+
+   /***************************************
+    * MIN / MAX
+    * The smallest or largest element. Like front(),
+    * the vector must not be empty.
+    **************************************/
+   template <typename T, typename A, typename G>
+   T min(const vector <T, A, G>& v)
+   {
+      static_assert(std::is_arithmetic<T>::value, "min needs an arithmetic T");
+      assert(!v.empty());
+      return simd_detail::dispatch<simd_detail::minmax_op<false>, T>(
+         simd_detail::simd_ok<T>(), simd_detail::begin(v), v.size());
+   }
+
+   template <typename T, typename A, typename G>
+   T max(const vector <T, A, G>& v)
+   {
+      static_assert(std::is_arithmetic<T>::value, "max needs an arithmetic T");
+      assert(!v.empty());
+      return simd_detail::dispatch<simd_detail::minmax_op<true>, T>(
+         simd_detail::simd_ok<T>(), simd_detail::begin(v), v.size());
+   }
+
+   /***************************************
+    * SUM
+    * Add every element, widened to sum_type <T>
+    **************************************/
+   template <typename T, typename A, typename G>
+   typename sum_type<T>::type sum(const vector <T, A, G>& v)
+   {
+      static_assert(std::is_arithmetic<T>::value, "sum needs an arithmetic T");
+      if (v.empty())
+         return 0;
+      return simd_detail::dispatch<simd_detail::sum_op, typename sum_type<T>::type>(
+         simd_detail::simd_ok<T>(), simd_detail::begin(v), v.size());
+   }
+
+   /***************************************
+    * CONTAINS ANY
+    * Is at least one of values somewhere in v?
+    **************************************/
+   template <typename T, typename A, typename G>
+   bool contains_any(const vector <T, A, G>& v, const T* values, size_t numValues)
+   {
+      static_assert(std::is_arithmetic<T>::value, "contains_any needs an arithmetic T");
+      if (v.empty() || numValues == 0)
+         return false;
+      return simd_detail::dispatch<simd_detail::any_op, bool>(
+         simd_detail::simd_ok<T>(), simd_detail::begin(v), v.size(), values, numValues);
+   }
+
+   template <typename T, typename A, typename G>
+   bool contains_any(const vector <T, A, G>& v, const std::initializer_list<T>& values)
+   {
+      return contains_any(v, values.begin(), values.size());
+   }
+
+   template <typename T, typename A, typename G, typename AA, typename GG>
+   bool contains_any(const vector <T, A, G>& v, const vector <T, AA, GG>& values)
+   {
+      return values.empty() ? false : contains_any(v, &values[0], values.size());
+   }
+
+} // namespace custom
@@ -0,0 +1,502 @@
+/***********************************************************************
+ * Header:
+ *    SMALL VECTOR
+ * Summary:
+ *    A vector that keeps its first N elements inside the object itself
+ *    and only goes to the heap when it grows past that.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        small_vector           : A vector with inline storage for N items
+ *        small_vector::iterator : An iterator through small_vector
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <new>              // for placement new
+#include <memory>           // for std::allocator
+#include <utility>          // for std::move
+#include <initializer_list> // for std::initializer_list
+#include "vector.h"         // for vector::iterator
+
+class TestSmallVector; // forward declaration for unit tests
+class TestHash;
+
+namespace custom
+{
+
+   /*****************************************
+    * SMALL VECTOR
+    * Same interface as custom::vector <T>, but the
+    * first N elements live in a buffer inside the
+    * object. Only when the vector grows past N do we
+    * allocate from the heap.
+    ****************************************/
+   template <typename T, size_t N, typename A = std::allocator<T>>
+   class small_vector
+   {
+      friend class ::TestSmallVector; // give unit tests access to the privates
+      friend class ::TestHash;
+   public:
+
+      //
+      // Construct
+      //
+      small_vector(const A& a = A());
+      small_vector(size_t numElements, const A& a = A());
+      small_vector(size_t numElements, const T& t, const A& a = A());
+      small_vector(const std::initializer_list<T>& l, const A& a = A());
+      small_vector(const small_vector& rhs);
+      small_vector(small_vector&& rhs);
+      ~small_vector();
+
+      //
+      // Assign
+      //
+      void swap(small_vector& rhs);
+      small_vector& operator = (const small_vector& rhs);
+      small_vector& operator = (small_vector&& rhs);
+
+      //
+      // Iterator
+      //
+      typedef typename vector <T, A> ::iterator iterator;
+      iterator begin()
+      {
+         return iterator(data);
+      }
+      iterator end()
+      {
+         return iterator(data + numElements);
+      }
+
+      //
+      // Access
+      //
+      T& operator [] (size_t index)             { return data[index]; }
+      const T& operator [] (size_t index) const { return data[index]; }
+      T& front()                                { return data[0]; }
+      const T& front() const                    { return data[0]; }
+      T& back()                                 { return data[numElements - 1]; }
+      const T& back() const                     { return data[numElements - 1]; }
+      iterator find(const T& t);
+
+      //
+      // Insert
+      //
+      void push_back(const T& t);
+      void push_back(T&& t);
+      iterator insert(iterator it, const T& t);
+      iterator insert(iterator it, T&& t);
+      void reserve(size_t newCapacity);
+      void resize(size_t newElements);
+      void resize(size_t newElements, const T& t);
+
+      //
+      // Remove
+      //
+      void clear()
+      {
+         for (size_t i = 0; i < numElements; i++)
+            alloc.destroy(&data[i]);
+         numElements = 0;
+      }
+      void pop_back()
+      {
+         if (numElements > 0)
+            alloc.destroy(&data[--numElements]);
+      }
+      iterator erase(iterator it);
+      void shrink_to_fit();
+
+      //
+      // Status
+      //
+      size_t  size()          const { return numElements; }
+      size_t  capacity()      const { return numCapacity; }
+      bool empty()            const { return (numElements == 0); }
+      bool is_inline()        const { return data == inlineData(); }
+
+   private:
+
+      T* inlineData()             { return reinterpret_cast<T*>(buffer); }
+      const T* inlineData() const { return reinterpret_cast<const T*>(buffer); }
+      void moveFrom(small_vector& rhs);
+      void release();
+      size_t indexOf(iterator it) { return numElements == 0 ? 0 : &*it - data; }
+
+      A    alloc;                // use allocator for memory allocation
+      T* data;                   // either the inline buffer or the heap
+      size_t  numCapacity;       // the capacity of the array
+      size_t  numElements;       // the number of items currently used
+      alignas(T) unsigned char buffer[N == 0 ? 1 : N * sizeof(T)]; // inline storage
+   };
+
+   /*****************************************
+    * SMALL VECTOR :: DEFAULT constructor
+    * Point at the inline buffer, no allocation
+    ****************************************/
+   template <typename T, size_t N, typename A>
+   small_vector <T, N, A> ::small_vector(const A& a)
+      : alloc(a), data(inlineData()), numCapacity(N), numElements(0)
+   {
+   }
+
+   /*****************************************
+    * SMALL VECTOR :: NON-DEFAULT constructors
+    * Set the number of elements and default-construct
+    * each one, spilling to the heap only if num > N
+    ****************************************/
+   template <typename T, size_t N, typename A>
+   small_vector <T, N, A> ::small_vector(size_t num, const A& a)
+      : alloc(a), data(inlineData()), numCapacity(N), numElements(0)
+   {
+      resize(num);
+   }
+
+   template <typename T, size_t N, typename A>
+   small_vector <T, N, A> ::small_vector(size_t num, const T& t, const A& a)
+      : alloc(a), data(inlineData()), numCapacity(N), numElements(0)
+   {
+      resize(num, t);
+   }
+
+   /*****************************************
+    * SMALL VECTOR :: INITIALIZATION LIST constructor
+    ****************************************/
+   template <typename T, size_t N, typename A>
+   small_vector <T, N, A> ::small_vector(const std::initializer_list<T>& l, const A& a)
+      : alloc(a), data(inlineData()), numCapacity(N), numElements(0)
+   {
+      reserve(l.size());
+      for (auto it = l.begin(); it != l.end(); ++it)
+         alloc.construct(&data[numElements++], *it);
+   }
+
+   /*****************************************
+    * SMALL VECTOR :: COPY CONSTRUCTOR
+    * Copy each element, inline when it fits
+    ****************************************/
+   template <typename T, size_t N, typename A>
+   small_vector <T, N, A> ::small_vector(const small_vector& rhs)
+      : alloc(rhs.alloc), data(inlineData()), numCapacity(N), numElements(0)
+   {
+      reserve(rhs.numElements);
+      for (size_t i = 0; i < rhs.numElements; i++)
+         alloc.construct(&data[i], rhs.data[i]);
+      numElements = rhs.numElements;
+   }
+
+   /*****************************************
+    * SMALL VECTOR :: MOVE CONSTRUCTOR
+    * Steal the heap buffer if there is one, otherwise
+    * move the inline elements one at a time
+    ****************************************/
+   template <typename T, size_t N, typename A>
+   small_vector <T, N, A> ::small_vector(small_vector&& rhs)
+      : alloc(rhs.alloc), data(inlineData()), numCapacity(N), numElements(0)
+   {
+      moveFrom(rhs);
+   }
+
+   /*****************************************
+    * SMALL VECTOR :: DESTRUCTOR
+    ****************************************/
+   template <typename T, size_t N, typename A>
+   small_vector <T, N, A> :: ~small_vector()
+   {
+      release();
+   }
+
+   /*****************************************
+    * SMALL VECTOR :: RELEASE
+    * Destroy every element and give back the heap
+    * buffer, leaving us empty and inline
+    ****************************************/
+   template <typename T, size_t N, typename A>
+   void small_vector <T, N, A> ::release()
+   {
+      clear();
+      if (!is_inline())
+         alloc.deallocate(data, numCapacity);
+      data = inlineData();
+      numCapacity = N;
+   }
+
+   /*****************************************
+    * SMALL VECTOR :: MOVE FROM
+    * Take the contents of rhs. We must be empty and
+    * inline. rhs is left empty and inline.
+    ****************************************/
+   template <typename T, size_t N, typename A>
+   void small_vector <T, N, A> ::moveFrom(small_vector& rhs)
+   {
+      assert(numElements == 0 && is_inline());
+      if (rhs.is_inline())
+      {
+         for (size_t i = 0; i < rhs.numElements; i++)
+         {
+            alloc.construct(&data[i], std::move(rhs.data[i]));
+            alloc.destroy(&rhs.data[i]);
+         }
+         numElements = rhs.numElements;
+      }
+      else
+      {
+         data = rhs.data;
+         numCapacity = rhs.numCapacity;
+         numElements = rhs.numElements;
+         rhs.data = rhs.inlineData();
+         rhs.numCapacity = N;
+      }
+      rhs.numElements = 0;
+   }
+
+   /***************************************
+    * SMALL VECTOR :: RESIZE
+    * Grow or shrink to newElements
+    **************************************/
+   template <typename T, size_t N, typename A>
+   void small_vector <T, N, A> ::resize(size_t newElements)
+   {
+      while (numElements > newElements)
+         alloc.destroy(&data[--numElements]);
+      reserve(newElements);
+      while (numElements < newElements)
+         alloc.construct(&data[numElements++]);
+   }
+
+   template <typename T, size_t N, typename A>
+   void small_vector <T, N, A> ::resize(size_t newElements, const T& t)
+   {
+      while (numElements > newElements)
+         alloc.destroy(&data[--numElements]);
+      reserve(newElements);
+      while (numElements < newElements)
+         alloc.construct(&data[numElements++], t);
+   }
+
+   /***************************************
+    * SMALL VECTOR :: RESERVE
+    * Grow the buffer to newCapacity. The first time
+    * we exceed N this moves us from the inline buffer
+    * to the heap.
+    **************************************/
+   template <typename T, size_t N, typename A>
+   void small_vector <T, N, A> ::reserve(size_t newCapacity)
+   {
+      if (newCapacity <= numCapacity)
+         return;
+
+      T* dataNew = alloc.allocate(newCapacity);
+      for (size_t i = 0; i < numElements; i++)
+      {
+         new ((void*)(dataNew + i)) T(std::move(data[i]));
+         alloc.destroy(&data[i]);
+      }
+
+      if (!is_inline())
+         alloc.deallocate(data, numCapacity);
+
+      data = dataNew;
+      numCapacity = newCapacity;
+   }
+
+   /***************************************
+    * SMALL VECTOR :: SHRINK TO FIT
+    * Go back to the inline buffer if we fit there,
+    * otherwise trim the heap buffer to size
+    **************************************/
+   template <typename T, size_t N, typename A>
+   void small_vector <T, N, A> ::shrink_to_fit()
+   {
+      if (is_inline() || numElements == numCapacity)
+         return;
+
+      T* dataNew = (numElements <= N) ? inlineData() : alloc.allocate(numElements);
+      for (size_t i = 0; i < numElements; i++)
+      {
+         new ((void*)(dataNew + i)) T(std::move(data[i]));
+         alloc.destroy(&data[i]);
+      }
+      alloc.deallocate(data, numCapacity);
+
+      data = dataNew;
+      numCapacity = (dataNew == inlineData()) ? N : numElements;
+   }
+
+   /***************************************
+    * SMALL VECTOR :: PUSH BACK
+    * Add t to the end, doubling the capacity once
+    * the current buffer is full
+    **************************************/
+   template <typename T, size_t N, typename A>
+   void small_vector <T, N, A> ::push_back(const T& t)
+   {
+      if (numElements == numCapacity)
+         reserve(numCapacity ? numCapacity * 2 : 1);
+      alloc.construct(data + numElements++, t);
+   }
+
+   template <typename T, size_t N, typename A>
+   void small_vector <T, N, A> ::push_back(T&& t)
+   {
+      if (numElements == numCapacity)
+         reserve(numCapacity ? numCapacity * 2 : 1);
+      alloc.construct(data + numElements++, std::move(t));
+   }
+
+   /***************************************
+    * SMALL VECTOR :: INSERT
+    * Put t in front of it, sliding the rest down one
+    *     OUTPUT : iterator to the new element
+    **************************************/
+   template <typename T, size_t N, typename A>
+   typename small_vector <T, N, A> ::iterator small_vector <T, N, A> ::
+      insert(iterator it, const T& t)
+   {
+      T copy(t);
+      return insert(it, std::move(copy));
+   }
+
+   template <typename T, size_t N, typename A>
+   typename small_vector <T, N, A> ::iterator small_vector <T, N, A> ::
+      insert(iterator it, T&& t)
+   {
+      size_t index = indexOf(it);
+      if (index == numElements)
+      {
+         push_back(std::move(t));
+         return iterator(data + index);
+      }
+
+      if (numElements == numCapacity)
+         reserve(numCapacity ? numCapacity * 2 : 1);
+      alloc.construct(data + numElements, std::move(data[numElements - 1]));
+      for (size_t i = numElements - 1; i > index; i--)
+         data[i] = std::move(data[i - 1]);
+      data[index] = std::move(t);
+      numElements++;
+      return iterator(data + index);
+   }
+
+   /***************************************
+    * SMALL VECTOR :: ERASE
+    * Remove the element at it, sliding the rest up one
+    *     OUTPUT : iterator to the element after the one removed
+    **************************************/
+   template <typename T, size_t N, typename A>
+   typename small_vector <T, N, A> ::iterator small_vector <T, N, A> ::
+      erase(iterator it)
+   {
+      size_t index = indexOf(it);
+      if (index >= numElements)
+         return end();
+      for (size_t i = index; i + 1 < numElements; i++)
+         data[i] = std::move(data[i + 1]);
+      alloc.destroy(&data[--numElements]);
+      return iterator(data + index);
+   }
+
+   /***************************************
+    * SMALL VECTOR :: FIND
+    * Linear search for t
+    **************************************/
+   template <typename T, size_t N, typename A>
+   typename small_vector <T, N, A> ::iterator small_vector <T, N, A> ::
+      find(const T& t)
+   {
+      for (size_t i = 0; i < numElements; i++)
+         if (data[i] == t)
+            return iterator(data + i);
+      return end();
+   }
+
+   /***************************************
+    * SMALL VECTOR :: SWAP
+    * Exchange contents. When either side is inline we
+    * cannot just trade pointers, so go through a temporary.
+    **************************************/
+   template <typename T, size_t N, typename A>
+   void small_vector <T, N, A> ::swap(small_vector& rhs)
+   {
+      if (this == &rhs)
+         return;
+
+      if (!is_inline() && !rhs.is_inline())
+      {
+         T* tempData = data;
+         data = rhs.data;
+         rhs.data = tempData;
+
+         size_t tempCapacity = numCapacity;
+         numCapacity = rhs.numCapacity;
+         rhs.numCapacity = tempCapacity;
+
+         size_t tempElements = numElements;
+         numElements = rhs.numElements;
+         rhs.numElements = tempElements;
+         return;
+      }
+
+      small_vector temp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(temp);
+   }
+
+   /***************************************
+    * SMALL VECTOR :: ASSIGNMENT
+    **************************************/
+   template <typename T, size_t N, typename A>
+   small_vector <T, N, A>& small_vector <T, N, A> :: operator = (const small_vector& rhs)
+   {
+      if (this != &rhs)
+      {
+         // shrink first so we do not move elements we are about to drop
+         while (numElements > rhs.numElements)
+            alloc.destroy(&data[--numElements]);
+         reserve(rhs.numElements);
+
+         for (size_t i = 0; i < rhs.numElements; ++i)
+         {
+            if (i < numElements)
+               data[i] = rhs.data[i];
+            else
+               alloc.construct(&data[i], rhs.data[i]);
+         }
+         numElements = rhs.numElements;
+      }
+      return *this;
+   }
+
+   template <typename T, size_t N, typename A>
+   small_vector <T, N, A>& small_vector <T, N, A> :: operator = (small_vector&& rhs)
+   {
+      if (this != &rhs)
+      {
+         release();
+         moveFrom(rhs);
+      }
+      return *this;
+   }
+
+   /*****************************************
+    * SWAP
+    * Stand-alone small vector swap
+    ****************************************/
+   template <typename T, size_t N, typename A>
+   void swap(small_vector <T, N, A>& lhs, small_vector <T, N, A>& rhs)
+   {
+      lhs.swap(rhs);
+   }
+
+} // namespace custom
@@ -0,0 +1,286 @@
+/***********************************************************************
+ * Header:
+ *    SNAPSHOT
+ * Summary:
+ *    The pieces shared by everything that saves a container to a file
+ *    or a stream and loads it back: how one element becomes bytes, the
+ *    header in front of the elements, a stream buffer over a raw file
+ *    descriptor, and the checksum, write and sync helpers the durable
+ *    containers share.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        snapshot_serializer : How one element is written and read
+ *        snapshot_header     : The bytes in front of a saved hash
+ *        fd_streambuf        : A stream buffer over a file descriptor
+ *        snapshot_detail     : Checksums, whole writes and syncs
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CUSTOM_SNAPSHOT_POSIX 1
+#endif
+
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uint32_t, uint64_t
+#include <istream>          // for std::istream
+#include <ostream>          // for std::ostream
+#include <streambuf>        // for std::streambuf
+#include <string>           // for the directory of a path
+#include <type_traits>      // for std::is_trivially_copyable
+#ifdef CUSTOM_SNAPSHOT_POSIX
+#include <cerrno>           // for errno, EINTR
+#include <fcntl.h>          // for open
+#include <unistd.h>         // for read, write, pread, pwrite, fsync
+#endif
+
+namespace custom
+{
+
+   /**************************************************
+    * SNAPSHOT SERIALIZER
+    * How one T goes to and comes from a stream.
+    * Trivially copyable types are their own bytes:
+    * elementSize is sizeof(T) and containers copy them
+    * in large batches without calling write or read.
+    * Any other type needs a specialization with
+    * elementSize 0 and its own write and read:
+    *
+    *    template <>
+    *    struct snapshot_serializer<std::string>
+    *    {
+    *       static const uint32_t elementSize = 0;
+    *       static void write(std::ostream& out, const std::string& s);
+    *       static bool read(std::istream& in, std::string& s);
+    *    };
+    **************************************************/
+   template <typename T, typename Enable = void>
+   struct snapshot_serializer
+   {
+      static_assert(sizeof(T) == 0,
+                    "T is not trivially copyable, specialize custom::snapshot_serializer<T>");
+   };
+
+   template <typename T>
+   struct snapshot_serializer<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type>
+   {
+      static const uint32_t elementSize = sizeof(T);
+      static void write(std::ostream& out, const T& t)
+      {
+         out.write((const char*)&t, sizeof(T));
+      }
+      static bool read(std::istream& in, T& t)
+      {
+         return (bool)in.read((char*)&t, sizeof(T));
+      }
+   };
+
+   /**************************************************
+    * SNAPSHOT HEADER
+    * The first bytes of a saved hash. Everything is in
+    * the byte order of the machine that saved it; the
+    * element size catches a file from a different T.
+    **************************************************/
+   struct snapshot_header
+   {
+      uint32_t magic;          // marks a snapshot we wrote
+      uint32_t version;        // the layout of what follows
+      uint32_t elementSize;    // sizeof(T), or 0 for a custom serializer
+      float    maxLoadFactor;  // of the hash when it was saved
+      uint64_t numElements;    // elements that follow the header
+      uint64_t numBuckets;     // bucket count when it was saved
+   };
+   const uint32_t SNAPSHOT_MAGIC   = 0x54455343;  // "CSET"
+   const uint32_t SNAPSHOT_VERSION = 1;
+
+   /**************************************************
+    * SNAPSHOT DELTA
+    * The pages of buckets that changed since the last
+    * snapshot or delta. A delta starts with a
+    * snapshot_header whose magic is SNAPSHOT_DELTA_MAGIC
+    * and whose numElements is the size of the whole set
+    * afterwards, then the page count, then each page:
+    *    | page | count | the elements of its buckets |
+    * A page replaces everything in its buckets, so the
+    * bucket count must be the one the delta was taken at.
+    **************************************************/
+   const uint32_t SNAPSHOT_DELTA_MAGIC = 0x54445343;  // "CSDT"
+   const size_t   SNAPSHOT_PAGE_BUCKETS = 64;
+
+#ifdef CUSTOM_SNAPSHOT_POSIX
+   /**************************************************
+    * FD STREAMBUF
+    * Lets the stream based save and load work on a file
+    * descriptor the caller already has open. The
+    * descriptor is neither closed nor synced here.
+    **************************************************/
+   class fd_streambuf : public std::streambuf
+   {
+   public:
+      fd_streambuf(int fd) : fd(fd)
+      {
+         setp(buffer, buffer + sizeof(buffer));
+         setg(buffer, buffer, buffer);
+      }
+      ~fd_streambuf() { sync(); }
+      fd_streambuf(const fd_streambuf&) = delete;
+      fd_streambuf& operator = (const fd_streambuf&) = delete;
+
+   protected:
+      int_type overflow(int_type ch) override
+      {
+         if (!flush())
+            return traits_type::eof();
+         if (!traits_type::eq_int_type(ch, traits_type::eof()))
+         {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+         }
+         return traits_type::not_eof(ch);
+      }
+      int sync() override
+      {
+         return flush() ? 0 : -1;
+      }
+      int_type underflow() override
+      {
+         ssize_t got;
+         do
+            got = ::read(fd, buffer, sizeof(buffer));
+         while (got < 0 && errno == EINTR);
+         if (got <= 0)
+            return traits_type::eof();
+         setg(buffer, buffer, buffer + got);
+         return traits_type::to_int_type(buffer[0]);
+      }
+
+   private:
+      // write out everything put so far
+      bool flush()
+      {
+         char* p = pbase();
+         while (p < pptr())
+         {
+            ssize_t put = ::write(fd, p, pptr() - p);
+            if (put < 0 && errno == EINTR)
+               continue;
+            if (put <= 0)
+               return false;
+            p += put;
+         }
+         setp(buffer, buffer + sizeof(buffer));
+         return true;
+      }
+
+      int fd;                 // not ours to close
+      char buffer[65536];     // used for writing or reading, not both
+   };
+
+   namespace snapshot_detail
+   {
+      /*****************************************
+       * CHECKSUM
+       * FNV-1a over num bytes. Enough to tell a torn
+       * or stale record from one that was written whole.
+       ****************************************/
+      inline uint32_t checksum(const char* p, size_t num)
+      {
+         uint32_t hash = 2166136261u;
+         for (size_t i = 0; i < num; i++)
+            hash = (hash ^ (unsigned char)p[i]) * 16777619u;
+         return hash;
+      }
+
+      /*****************************************
+       * WRITE ALL / READ ALL AT / WRITE ALL AT
+       * Every byte or false, retrying short and
+       * interrupted calls. The _at forms use pread and
+       * pwrite and leave the file offset alone.
+       ****************************************/
+      inline bool write_all(int fd, const void* p, size_t num)
+      {
+         const char* pByte = (const char*)p;
+         while (num)
+         {
+            ssize_t put = ::write(fd, pByte, num);
+            if (put < 0 && errno == EINTR)
+               continue;
+            if (put <= 0)
+               return false;
+            pByte += put;
+            num -= (size_t)put;
+         }
+         return true;
+      }
+
+      inline bool read_all_at(int fd, void* p, size_t num, off_t offset)
+      {
+         char* pByte = (char*)p;
+         while (num)
+         {
+            ssize_t got = ::pread(fd, pByte, num, offset);
+            if (got < 0 && errno == EINTR)
+               continue;
+            if (got <= 0)
+               return false;
+            pByte += got;
+            offset += got;
+            num -= (size_t)got;
+         }
+         return true;
+      }
+
+      inline bool write_all_at(int fd, const void* p, size_t num, off_t offset)
+      {
+         const char* pByte = (const char*)p;
+         while (num)
+         {
+            ssize_t put = ::pwrite(fd, pByte, num, offset);
+            if (put < 0 && errno == EINTR)
+               continue;
+            if (put <= 0)
+               return false;
+            pByte += put;
+            offset += put;
+            num -= (size_t)put;
+         }
+         return true;
+      }
+
+      /*****************************************
+       * SYNC FILE / SYNC DIRECTORY
+       * The data of a file, then the directory that
+       * holds path, so a rename into it is on disk too
+       ****************************************/
+      inline bool sync_file(int fd)
+      {
+#ifdef __APPLE__
+         return fsync(fd) == 0;
+#else
+         return fdatasync(fd) == 0;
+#endif
+      }
+
+      inline bool sync_directory(const std::string& path)
+      {
+         size_t slash = path.rfind('/');
+         std::string directory = slash == std::string::npos ? "." : path.substr(0, slash ? slash : 1);
+         int dirFd = ::open(directory.c_str(), O_RDONLY);
+         if (dirFd < 0)
+            return false;
+         bool ok = fsync(dirFd) == 0;
+         ::close(dirFd);
+         return ok;
+      }
+   } // namespace snapshot_detail
+#endif // CUSTOM_SNAPSHOT_POSIX
+
+} // namespace custom
@@ -0,0 +1,288 @@
+/***********************************************************************
+ * Header:
+ *    SOA VECTOR
+ * Summary:
+ *    A vector of records stored a field at a time. Each field has its
+ *    own contiguous array, so a scan of one field reads only that
+ *    field and the loop over it can vectorize.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        span                   : A view of a contiguous run of T
+ *        soa_vector             : Records as parallel column arrays
+ *        soa_vector::reference  : One row, a field at a time
+ *        soa_vector::iterator   : An iterator through the rows
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <tuple>            // for std::tuple
+#include <utility>          // for std::index_sequence
+#include "vector.h"         // for the columns
+
+class TestSoaVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************
+    * SPAN
+    * A pointer and a count. It does not own the
+    * elements, so it goes stale when the owner grows.
+    ****************************************/
+   template <typename T>
+   class span
+   {
+   public:
+      span() : p(nullptr), num(0) {}
+      span(T* p, size_t num) : p(p), num(num) {}
+
+      T* begin() const { return p; }
+      T* end()   const { return p + num; }
+      T* data()  const { return p; }
+      T& operator [] (size_t index) const { return p[index]; }
+
+      size_t size() const { return num; }
+      bool empty()  const { return num == 0; }
+
+   private:
+      T* p;          // the first element
+      size_t num;    // how many there are
+   };
+
+   /*****************************************
+    * SOA VECTOR
+    * Row i is column<0>()[i], column<1>()[i] and so
+    * on. Every column always has size() elements.
+    ****************************************/
+   template <typename... Fields>
+   class soa_vector
+   {
+      friend class ::TestSoaVector; // give unit tests access to the privates
+      static_assert(sizeof...(Fields) > 0, "a record needs at least one field");
+   public:
+
+      // the type of field I
+      template <size_t I>
+      using field_type = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+      //
+      // Construct
+      //
+      soa_vector() {}
+      soa_vector(size_t numElements) { resize(numElements); }
+
+      //
+      // Assign
+      //
+      void swap(soa_vector& rhs) { swapColumns(rhs, std::index_sequence_for<Fields...>()); }
+
+      //
+      // Iterator
+      //
+      class reference;
+      class iterator;
+      iterator begin() { return iterator(this, 0); }
+      iterator end()   { return iterator(this, size()); }
+
+      //
+      // Access
+      //
+      reference operator [] (size_t index) { return reference(this, index); }
+      reference front()                    { return reference(this, 0); }
+      reference back()                     { return reference(this, size() - 1); }
+
+      template <size_t I>
+      field_type<I>& get(size_t index)             { return std::get<I>(columns)[index]; }
+      template <size_t I>
+      const field_type<I>& get(size_t index) const { return std::get<I>(columns)[index]; }
+
+      template <size_t I>
+      span<field_type<I>> column()
+      {
+         return span<field_type<I>>(empty() ? nullptr : &std::get<I>(columns)[0], size());
+      }
+      template <size_t I>
+      span<const field_type<I>> column() const
+      {
+         return span<const field_type<I>>(empty() ? nullptr : &std::get<I>(columns)[0], size());
+      }
+
+      // the column itself, read only, for the algorithms that take a vector
+      template <size_t I>
+      const custom::vector<field_type<I>>& column_vector() const { return std::get<I>(columns); }
+
+      //
+      // Insert
+      //
+      void push_back(const Fields&... fields)
+      {
+         pushBack(std::index_sequence_for<Fields...>(), fields...);
+      }
+      void push_back(const std::tuple<Fields...>& row)
+      {
+         pushTuple(row, std::index_sequence_for<Fields...>());
+      }
+      void reserve(size_t newCapacity) { reserveColumns(newCapacity, std::index_sequence_for<Fields...>()); }
+      void resize(size_t newElements)  { resizeColumns(newElements, std::index_sequence_for<Fields...>()); }
+
+      //
+      // Remove
+      //
+      void clear()    { clearColumns(std::index_sequence_for<Fields...>()); }
+      void pop_back() { popColumns(std::index_sequence_for<Fields...>()); }
+
+      //
+      // Status
+      //
+      size_t size()     const { return std::get<0>(columns).size(); }
+      size_t capacity() const { return std::get<0>(columns).capacity(); }
+      bool empty()      const { return size() == 0; }
+      static constexpr size_t field_count() { return sizeof...(Fields); }
+
+   private:
+
+      // do each column in turn. The array is only there
+      // so the pack expands in order in C++14.
+      template <size_t... I>
+      void pushBack(std::index_sequence<I...>, const Fields&... fields)
+      {
+         int order[] = { (std::get<I>(columns).push_back(fields), 0)... };
+         (void)order;
+      }
+      template <size_t... I>
+      void pushTuple(const std::tuple<Fields...>& row, std::index_sequence<I...>)
+      {
+         int order[] = { (std::get<I>(columns).push_back(std::get<I>(row)), 0)... };
+         (void)order;
+      }
+      template <size_t... I>
+      void reserveColumns(size_t n, std::index_sequence<I...>)
+      {
+         int order[] = { (std::get<I>(columns).reserve(n), 0)... };
+         (void)order;
+      }
+      template <size_t... I>
+      void resizeColumns(size_t n, std::index_sequence<I...>)
+      {
+         int order[] = { (std::get<I>(columns).resize(n), 0)... };
+         (void)order;
+      }
+      template <size_t... I>
+      void clearColumns(std::index_sequence<I...>)
+      {
+         int order[] = { (std::get<I>(columns).clear(), 0)... };
+         (void)order;
+      }
+      template <size_t... I>
+      void popColumns(std::index_sequence<I...>)
+      {
+         if (empty())
+            return;
+         int order[] = { (std::get<I>(columns).pop_back(), 0)... };
+         (void)order;
+      }
+      template <size_t... I>
+      void swapColumns(soa_vector& rhs, std::index_sequence<I...>)
+      {
+         int order[] = { (std::get<I>(columns).swap(std::get<I>(rhs.columns)), 0)... };
+         (void)order;
+      }
+      template <size_t... I>
+      std::tuple<Fields...> row(size_t index, std::index_sequence<I...>) const
+      {
+         return std::tuple<Fields...>(std::get<I>(columns)[index]...);
+      }
+
+      std::tuple<custom::vector<Fields>...> columns;   // one array per field
+   };
+
+   /**************************************************
+    * SOA VECTOR REFERENCE
+    * Stands in for a row. Reading a field touches only
+    * that column; converting to a tuple gathers them all.
+    *************************************************/
+   template <typename... Fields>
+   class soa_vector <Fields...> ::reference
+   {
+      friend class ::TestSoaVector; // give unit tests access to the privates
+   public:
+      reference(soa_vector* pOwner, size_t index) : pOwner(pOwner), index(index) {}
+
+      // one field of the row
+      template <size_t I>
+      field_type<I>& get() const { return pOwner->template get<I>(index); }
+
+      // the whole row, copied out or in
+      operator std::tuple<Fields...>() const
+      {
+         return pOwner->row(index, std::index_sequence_for<Fields...>());
+      }
+      reference& operator = (const std::tuple<Fields...>& rhs)
+      {
+         assign(rhs, std::index_sequence_for<Fields...>());
+         return *this;
+      }
+
+      size_t row_index() const { return index; }
+
+   private:
+      template <size_t... I>
+      void assign(const std::tuple<Fields...>& rhs, std::index_sequence<I...>)
+      {
+         int order[] = { (this->template get<I>() = std::get<I>(rhs), 0)... };
+         (void)order;
+      }
+
+      soa_vector* pOwner;
+      size_t index;
+   };
+
+   /**************************************************
+    * SOA VECTOR ITERATOR
+    * Walks the rows, handing out references
+    *************************************************/
+   template <typename... Fields>
+   class soa_vector <Fields...> ::iterator
+   {
+      friend class ::TestSoaVector; // give unit tests access to the privates
+   public:
+      // constructors, destructors, and assignment operator
+      iterator() : pOwner(nullptr), index(0) {}
+      iterator(soa_vector* pOwner, size_t index) : pOwner(pOwner), index(index) {}
+      iterator(const iterator& rhs) : pOwner(rhs.pOwner), index(rhs.index) {}
+      iterator& operator = (const iterator& rhs)
+      {
+         pOwner = rhs.pOwner;
+         index = rhs.index;
+         return *this;
+      }
+
+      // equals, not equals operator
+      bool operator != (const iterator& rhs) const { return index != rhs.index || pOwner != rhs.pOwner; }
+      bool operator == (const iterator& rhs) const { return !(*this != rhs); }
+
+      // dereference operator
+      reference operator * () { return reference(pOwner, index); }
+
+      // increment and decrement
+      iterator& operator ++ ()    { ++index; return *this; }
+      iterator  operator ++ (int) { iterator temp = *this; ++index; return temp; }
+      iterator& operator -- ()    { --index; return *this; }
+      iterator  operator -- (int) { iterator temp = *this; --index; return temp; }
+
+   private:
+      soa_vector* pOwner;
+      size_t index;
+   };
+
+} // namespace custom
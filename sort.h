@@ -0,0 +1,384 @@
+/***********************************************************************
+ * Header:
+ *    SORT
+ * Summary:
+ *    Sorting for custom::vector, serial and parallel
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    Integer and floating point keys sorted in their natural order
+ *    use an LSD radix sort, one byte per pass. Everything else, and
+ *    any call with a comparator, uses a comparison sort: introsort
+ *    serially, and a merge sort across a thread pool in parallel.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uint32_t, uint64_t
+#include <cstring>          // for std::memcpy
+#include <algorithm>        // for std::sort, std::merge
+#include <functional>       // for std::less
+#include <iterator>         // for std::make_move_iterator
+#include <type_traits>      // for std::is_integral
+#include <vector>           // for std::vector
+#include "vector.h"         // for custom::vector
+#include "thread_pool.h"    // for custom::thread_pool
+
+namespace custom
+{
+   namespace sort_detail
+   {
+      // below this many elements a radix sort is not worth its passes
+      const size_t radixThreshold = 256;
+
+      // below this many elements per thread, stay on one thread
+      const size_t parallelGrain = 16384;
+
+      /*****************************************
+       * RADIX KEY
+       * Map T onto an unsigned integer with the same
+       * ordering. Signed integers flip the sign bit.
+       * Floats flip the sign bit when positive and
+       * every bit when negative.
+       ****************************************/
+      template <typename T, bool IsIntegral = std::is_integral<T>::value>
+      struct radix_key
+      {
+         typedef typename std::make_unsigned<T>::type type;
+         static type get(T t)
+         {
+            type k = (type)t;
+            if (std::is_signed<T>::value)
+               k ^= (type)1 << (sizeof(T) * 8 - 1);
+            return k;
+         }
+      };
+
+      template <typename T>
+      struct radix_key <T, false>
+      {
+         typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type type;
+         static type get(T t)
+         {
+            type k;
+            std::memcpy(&k, &t, sizeof(T));
+            const type sign = (type)1 << (sizeof(T) * 8 - 1);
+            return (k & sign) ? ~k : (k | sign);
+         }
+      };
+
+      // which element types get the radix sort
+      template <typename T>
+      struct radixable : std::integral_constant<bool,
+         (std::is_integral<T>::value && !std::is_same<T, bool>::value) ||
+         std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+
+      template <typename T>
+      size_t digit(T t, size_t pass)
+      {
+         return (size_t)(radix_key<T>::get(t) >> (pass * 8)) & 0xff;
+      }
+
+      /*****************************************
+       * RADIX SORT
+       * One read of the data counts every byte of every
+       * key at once. A pass whose byte is the same for
+       * every key is skipped; the rest scatter from one
+       * buffer to the other.
+       ****************************************/
+      template <typename T>
+      void radix_sort(T* data, T* temp, size_t n)
+      {
+         const size_t numPasses = sizeof(T);
+         size_t counts[sizeof(T)][256] = {};
+         for (size_t i = 0; i < n; i++)
+         {
+            typename radix_key<T>::type k = radix_key<T>::get(data[i]);
+            for (size_t pass = 0; pass < numPasses; pass++)
+               counts[pass][(k >> (pass * 8)) & 0xff]++;
+         }
+
+         T* src = data;
+         T* dst = temp;
+         for (size_t pass = 0; pass < numPasses; pass++)
+         {
+            if (counts[pass][digit(src[0], pass)] == n)
+               continue;
+
+            size_t offset[256];
+            size_t total = 0;
+            for (size_t d = 0; d < 256; d++)
+            {
+               offset[d] = total;
+               total += counts[pass][d];
+            }
+            for (size_t i = 0; i < n; i++)
+               dst[offset[digit(src[i], pass)]++] = src[i];
+
+            T* swap = src;
+            src = dst;
+            dst = swap;
+         }
+
+         if (src != data)
+            std::memcpy(data, src, n * sizeof(T));
+      }
+
+      /*****************************************
+       * PARALLEL RADIX SORT
+       * Same as above, but the data is cut into one block
+       * per thread. Each block counts its own digits, the
+       * counts are turned into per-block offsets, and each
+       * block scatters its own elements. Blocks keep their
+       * order, so the sort stays stable.
+       ****************************************/
+      template <typename T>
+      void parallel_radix_sort(T* data, T* temp, size_t n, size_t numBlocks, thread_pool& pool)
+      {
+         const size_t numPasses = sizeof(T);
+         const size_t blockSize = (n + numBlocks - 1) / numBlocks;
+         std::vector<size_t> counts(numBlocks * 256);
+
+         // find the passes we can skip from a count of every digit
+         std::vector<size_t> all(numBlocks * numPasses * 256);
+         pool.parallel_for(numBlocks, [&](size_t b)
+         {
+            size_t* c = &all[b * numPasses * 256];
+            size_t end = std::min(n, (b + 1) * blockSize);
+            for (size_t i = b * blockSize; i < end; i++)
+            {
+               typename radix_key<T>::type k = radix_key<T>::get(data[i]);
+               for (size_t pass = 0; pass < numPasses; pass++)
+                  c[pass * 256 + ((k >> (pass * 8)) & 0xff)]++;
+            }
+         });
+
+         T* src = data;
+         T* dst = temp;
+         for (size_t pass = 0; pass < numPasses; pass++)
+         {
+            size_t d0 = digit(src[0], pass);
+            size_t same = 0;
+            for (size_t b = 0; b < numBlocks; b++)
+               same += all[(b * numPasses + pass) * 256 + d0];
+            if (same == n)
+               continue;
+
+            // count this digit block by block in the current order
+            pool.parallel_for(numBlocks, [&](size_t b)
+            {
+               size_t* c = &counts[b * 256];
+               std::fill(c, c + 256, 0);
+               size_t end = std::min(n, (b + 1) * blockSize);
+               for (size_t i = b * blockSize; i < end; i++)
+                  c[digit(src[i], pass)]++;
+            });
+
+            // digit-major, block-minor prefix sum
+            size_t total = 0;
+            for (size_t d = 0; d < 256; d++)
+               for (size_t b = 0; b < numBlocks; b++)
+               {
+                  size_t c = counts[b * 256 + d];
+                  counts[b * 256 + d] = total;
+                  total += c;
+               }
+
+            pool.parallel_for(numBlocks, [&](size_t b)
+            {
+               size_t* offset = &counts[b * 256];
+               size_t end = std::min(n, (b + 1) * blockSize);
+               for (size_t i = b * blockSize; i < end; i++)
+                  dst[offset[digit(src[i], pass)]++] = src[i];
+            });
+
+            T* swap = src;
+            src = dst;
+            dst = swap;
+         }
+
+         if (src != data)
+            pool.parallel_for(numBlocks, [&](size_t b)
+            {
+               size_t begin = std::min(n, b * blockSize);
+               size_t end = std::min(n, (b + 1) * blockSize);
+               std::memcpy(data + begin, src + begin, (end - begin) * sizeof(T));
+            });
+      }
+
+      /*****************************************
+       * PARALLEL MERGE SORT
+       * Sort one run per block at the same time, then
+       * merge neighbouring runs pairwise, each round in
+       * parallel, bouncing between data and temp.
+       ****************************************/
+      template <typename T, class Compare>
+      void parallel_merge_sort(T* data, T* temp, size_t n, size_t numBlocks,
+                               Compare comp, thread_pool& pool)
+      {
+         const size_t blockSize = (n + numBlocks - 1) / numBlocks;
+         std::vector<size_t> bounds;
+         for (size_t b = 0; b < numBlocks; b++)
+            bounds.push_back(std::min(n, b * blockSize));
+         bounds.push_back(n);
+
+         pool.parallel_for(numBlocks, [&](size_t b)
+         {
+            std::sort(data + bounds[b], data + bounds[b + 1], comp);
+         });
+
+         T* src = data;
+         T* dst = temp;
+         while (bounds.size() > 2)
+         {
+            size_t numRuns = bounds.size() - 1;
+            pool.parallel_for((numRuns + 1) / 2, [&](size_t pair)
+            {
+               size_t lo  = bounds[pair * 2];
+               size_t mid = bounds[pair * 2 + 1];
+               size_t hi  = (pair * 2 + 2 < bounds.size()) ? bounds[pair * 2 + 2] : mid;
+               std::merge(std::make_move_iterator(src + lo),  std::make_move_iterator(src + mid),
+                          std::make_move_iterator(src + mid), std::make_move_iterator(src + hi),
+                          dst + lo, comp);
+            });
+
+            std::vector<size_t> merged;
+            for (size_t i = 0; i < bounds.size(); i += 2)
+               merged.push_back(bounds[i]);
+            if (merged.back() != n)
+               merged.push_back(n);
+            bounds.swap(merged);
+
+            T* swap = src;
+            src = dst;
+            dst = swap;
+         }
+
+         if (src != data)
+            pool.parallel_for(numBlocks, [&](size_t b)
+            {
+               size_t begin = std::min(n, b * blockSize);
+               size_t end = std::min(n, (b + 1) * blockSize);
+               std::move(src + begin, src + end, data + begin);
+            });
+      }
+
+      // how many blocks is n worth on this pool
+      inline size_t blocks_for(size_t n, thread_pool& pool)
+      {
+         size_t numBlocks = n / parallelGrain;
+         if (numBlocks > pool.size() + 1)
+            numBlocks = pool.size() + 1;
+         return numBlocks ? numBlocks : 1;
+      }
+
+      template <typename T, typename A, typename G>
+      void sort_natural(vector <T, A, G>& v, std::true_type)
+      {
+         size_t n = v.size();
+         if (n < radixThreshold)
+         {
+            std::sort(&v[0], &v[0] + n);
+            return;
+         }
+         vector <T> temp;
+         temp.resize_for_overwrite(n);
+         radix_sort(&v[0], &temp[0], n);
+      }
+
+      template <typename T, typename A, typename G>
+      void sort_natural(vector <T, A, G>& v, std::false_type)
+      {
+         std::sort(&v[0], &v[0] + v.size(), std::less<T>());
+      }
+
+      template <typename T, typename A, typename G>
+      void parallel_sort_natural(vector <T, A, G>& v, thread_pool& pool, std::true_type)
+      {
+         size_t n = v.size();
+         size_t numBlocks = blocks_for(n, pool);
+         if (numBlocks == 1)
+         {
+            sort_natural(v, std::true_type());
+            return;
+         }
+         vector <T> temp;
+         temp.resize_for_overwrite(n);
+         parallel_radix_sort(&v[0], &temp[0], n, numBlocks, pool);
+      }
+
+      template <typename T, typename A, typename G, class Compare>
+      void parallel_sort_compare(vector <T, A, G>& v, Compare comp, thread_pool& pool)
+      {
+         size_t n = v.size();
+         size_t numBlocks = blocks_for(n, pool);
+         if (numBlocks == 1)
+         {
+            std::sort(&v[0], &v[0] + n, comp);
+            return;
+         }
+         vector <T> temp(n);
+         parallel_merge_sort(&v[0], &temp[0], n, numBlocks, comp, pool);
+      }
+
+      template <typename T, typename A, typename G>
+      void parallel_sort_natural(vector <T, A, G>& v, thread_pool& pool, std::false_type)
+      {
+         parallel_sort_compare(v, std::less<T>(), pool);
+      }
+   } // namespace sort_detail
+
+   /***************************************
+    * SORT
+    * Put v in ascending order. Integer and floating
+    * point elements use a radix sort.
+    *     INPUT  : v    the vector to sort
+    *              comp optional strict weak ordering
+    **************************************/
+   template <typename T, typename A, typename G>
+   void sort(vector <T, A, G>& v)
+   {
+      if (v.size() > 1)
+         sort_detail::sort_natural(v, sort_detail::radixable<T>());
+   }
+
+   template <typename T, typename A, typename G, class Compare>
+   void sort(vector <T, A, G>& v, Compare comp)
+   {
+      if (v.size() > 1)
+         std::sort(&v[0], &v[0] + v.size(), comp);
+   }
+
+   /***************************************
+    * PARALLEL SORT
+    * As sort(), spread over a thread pool. Small
+    * vectors are sorted on the calling thread. A
+    * comparison sort needs T to be default
+    * constructible for its merge buffer.
+    *     INPUT  : v    the vector to sort
+    *              comp optional strict weak ordering
+    *              pool the threads to use
+    **************************************/
+   template <typename T, typename A, typename G>
+   void parallel_sort(vector <T, A, G>& v, thread_pool& pool = thread_pool::instance())
+   {
+      if (v.size() > 1)
+         sort_detail::parallel_sort_natural(v, pool, sort_detail::radixable<T>());
+   }
+
+   template <typename T, typename A, typename G, class Compare>
+   void parallel_sort(vector <T, A, G>& v, Compare comp, thread_pool& pool = thread_pool::instance())
+   {
+      if (v.size() > 1)
+         sort_detail::parallel_sort_compare(v, comp, pool);
+   }
+
+} // namespace custom
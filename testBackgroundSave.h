@@ -0,0 +1,234 @@
+/***********************************************************************
+ * Header:
+ *    TEST BACKGROUND SAVE
+ * Summary:
+ *    Unit tests for background_save
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "background_save.h"
+#include "unitTest.h"
+
+#ifdef CUSTOM_SNAPSHOT_POSIX
+
+#include "pair.h"
+#include "hash.h"
+
+#include <cassert>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+class TestBackgroundSave : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Save
+      test_start_loadsBack();
+      test_start_pointInTime();
+      test_start_replacesOld();
+      test_start_badPath();
+      test_running_untilDone();
+
+      // Report
+      test_cow_parentWrites();
+
+      report("BackgroundSave");
+   }
+
+   /***************************************
+    * SAVE
+    ***************************************/
+
+   // the child's file holds the set
+   void test_start_loadsBack()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us;
+      for (int i = 0; i < 1000; i++)
+         us.insert(i);
+      custom::background_save bg;
+      // exercise
+      bool started = bg.start(us, path.c_str());
+      bool saved = bg.wait();
+      // verify
+      assertUnit(started);
+      assertUnit(saved);
+      assertUnit(bg.bytes_written() == sizeof(custom::snapshot_header) + 1000 * sizeof(int));
+      custom::unordered_set<int> copy;
+      assertUnit(loadFile(copy, path));
+      assertUnit(copy.size() == 1000);
+      assertUnit(copy.find(999) != copy.end());
+      // teardown
+      unlink(path.c_str());
+   }
+
+   // what the parent does after the fork is not in the file
+   void test_start_pointInTime()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us;
+      us.insert(26);
+      us.insert(49);
+      custom::background_save bg;
+      int gate[2];
+      int made = pipe(gate);
+      assert(made == 0);
+      bg.gateFd = gate[0];
+      // exercise
+      bg.start(us, path.c_str());
+      us.erase(26);
+      us.insert(67);
+      ssize_t sent = write(gate[1], "g", 1);
+      assert(sent == 1);
+      bool saved = bg.wait();
+      // verify
+      assertUnit(saved);
+      custom::unordered_set<int> copy;
+      assertUnit(loadFile(copy, path));
+      assertUnit(copy.size() == 2);
+      assertUnit(copy.find(26) != copy.end());
+      assertUnit(copy.find(67) == copy.end());
+      assertUnit(us.find(26) == us.end());
+      // teardown
+      close(gate[0]);
+      close(gate[1]);
+      unlink(path.c_str());
+   }
+
+   // a second save takes the place of the first
+   void test_start_replacesOld()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us;
+      us.insert(26);
+      custom::background_save bg;
+      bg.start(us, path.c_str());
+      bg.wait();
+      us.insert(49);
+      // exercise
+      bg.start(us, path.c_str());
+      bool saved = bg.wait();
+      // verify
+      assertUnit(saved);
+      custom::unordered_set<int> copy;
+      assertUnit(loadFile(copy, path));
+      assertUnit(copy.size() == 2);
+      assertUnit(access((path + ".tmp").c_str(), F_OK) != 0);
+      // teardown
+      unlink(path.c_str());
+   }
+
+   // the child cannot write, and says so
+   void test_start_badPath()
+   {  // setup
+      custom::unordered_set<int> us;
+      us.insert(26);
+      custom::background_save bg;
+      // exercise
+      bool started = bg.start(us, "/nonexistent/directory/set.snap");
+      bool saved = bg.wait();
+      // verify
+      assertUnit(started);
+      assertUnit(!saved);
+      assertUnit(bg.bytes_written() == 0);
+   }  // teardown
+
+   // running until the child is done, then not
+   void test_running_untilDone()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us;
+      us.insert(26);
+      custom::background_save bg;
+      int gate[2];
+      int made = pipe(gate);
+      assert(made == 0);
+      bg.gateFd = gate[0];
+      bg.start(us, path.c_str());
+      // exercise
+      bool before = bg.running();
+      ssize_t sent = write(gate[1], "g", 1);
+      assert(sent == 1);
+      while (bg.running())
+         usleep(1000);
+      // verify
+      assertUnit(before);
+      assertUnit(!bg.running());
+      assertUnit(bg.wait());
+      assertUnit(bg.pid == -1);
+      // teardown
+      close(gate[0]);
+      close(gate[1]);
+      unlink(path.c_str());
+   }
+
+   /***************************************
+    * REPORT
+    ***************************************/
+
+   // the parent frees every node while the child runs, so their pages are copied
+   void test_cow_parentWrites()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us;
+      us.max_load_factor(4.0f);
+      for (int i = 0; i < 100000; i++)
+         us.insert(i);
+      custom::background_save bg;
+      int gate[2];
+      int made = pipe(gate);
+      assert(made == 0);
+      bg.gateFd = gate[0];
+      // exercise
+      bg.start(us, path.c_str());
+      us.clear();
+      ssize_t sent = write(gate[1], "g", 1);
+      assert(sent == 1);
+      bool saved = bg.wait();
+      // verify
+      assertUnit(saved);
+#ifdef __linux__
+      assertUnit(bg.cow_bytes() >= 100000 * sizeof(int));
+#endif
+      // teardown
+      close(gate[0]);
+      close(gate[1]);
+      unlink(path.c_str());
+   }
+
+   /*************************************************************
+    * LOAD FILE
+    * A snapshot the child saved, back into a set
+    *************************************************************/
+   bool loadFile(custom::unordered_set<int>& us, const std::string& path)
+   {
+      int fd = open(path.c_str(), O_RDONLY);
+      if (fd < 0)
+         return false;
+      bool loaded = us.load(fd);
+      close(fd);
+      return loaded;
+   }
+};
+
+#else // !CUSTOM_SNAPSHOT_POSIX
+
+class TestBackgroundSave : public UnitTest
+{
+public:
+   void run() {}
+};
+
+#endif // CUSTOM_SNAPSHOT_POSIX
+
+#endif // DEBUG
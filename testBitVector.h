@@ -0,0 +1,423 @@
+/***********************************************************************
+ * Header:
+ *    TEST BIT VECTOR
+ * Summary:
+ *    Unit tests for bit_vector
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "bit_vector.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>
+
+class TestBitVector : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_sizeFill();
+      test_construct_initializerList();
+
+      // Access
+      test_set_resetFlip();
+      test_pushBack_acrossWords();
+      test_resize_growWithOnes();
+      test_resize_shrinkClearsTail();
+
+      // Bulk logic
+      test_and_standard();
+      test_or_standard();
+      test_xor_standard();
+      test_andNot_standard();
+      test_bulk_scalarMatches();
+
+      // Query
+      test_count_standard();
+      test_count_scalarMatches();
+      test_rank_standard();
+      test_rank_afterChange();
+      test_rank_constUnindexed();
+      test_select_standard();
+      test_select_tooMany();
+      test_selectRank_roundTrip();
+      test_findNext_standard();
+
+      report("BitVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // nothing allocated
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::bit_vector v;
+      // verify
+      assertUnit(v.size() == 0);
+      assertUnit(v.empty());
+      assertUnit(v.word_count() == 0);
+      assertUnit(v.count() == 0);
+   }  // teardown
+
+   // one bit per flag, and the tail of the last word is clear
+   void test_construct_sizeFill()
+   {  // setup
+      // exercise
+      custom::bit_vector v(100, true);
+      // verify
+      assertUnit(v.size() == 100);
+      assertUnit(v.word_count() == 2);
+      assertUnit(v.words[0] == ~(uint64_t)0);
+      assertUnit(v.words[1] == ((uint64_t)1 << 36) - 1);
+      assertUnit(v.count() == 100);
+   }  // teardown
+
+   // the flags in order
+   void test_construct_initializerList()
+   {  // setup
+      // exercise
+      custom::bit_vector v{ true, false, true, true };
+      // verify
+      assertUnit(v.size() == 4);
+      assertUnit(v.words[0] == 0xd);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // set, reset and flip single bits
+   void test_set_resetFlip()
+   {  // setup
+      custom::bit_vector v(130);
+      // exercise
+      v.set(0);
+      v.set(64);
+      v.set(129);
+      v.flip(65);
+      v.reset(64);
+      // verify
+      assertUnit(v[0]);
+      assertUnit(!v[64]);
+      assertUnit(v[65]);
+      assertUnit(v.test(129));
+      assertUnit(v.count() == 3);
+   }  // teardown
+
+   // a new word is added every 64 bits
+   void test_pushBack_acrossWords()
+   {  // setup
+      custom::bit_vector v;
+      // exercise
+      for (int i = 0; i < 65; i++)
+         v.push_back(i % 2 == 0);
+      // verify
+      assertUnit(v.size() == 65);
+      assertUnit(v.word_count() == 2);
+      assertUnit(v.words[0] == 0x5555555555555555ull);
+      assertUnit(v.words[1] == 1);
+   }  // teardown
+
+   // growing with ones fills the rest of the old last word
+   void test_resize_growWithOnes()
+   {  // setup
+      custom::bit_vector v(10);
+      // exercise
+      v.resize(70, true);
+      // verify
+      assertUnit(v.count() == 60);
+      assertUnit(!v[9]);
+      assertUnit(v[10]);
+      assertUnit(v[69]);
+      assertUnit(v.words[1] == 0x3f);
+   }  // teardown
+
+   // shrinking leaves no stray ones past the end
+   void test_resize_shrinkClearsTail()
+   {  // setup
+      custom::bit_vector v(128, true);
+      // exercise
+      v.resize(3);
+      v.resize(64);
+      // verify
+      assertUnit(v.count() == 3);
+      assertUnit(v.words[0] == 7);
+   }  // teardown
+
+   /***************************************
+    * BULK LOGIC
+    ***************************************/
+
+   // and keeps the bits in both
+   void test_and_standard()
+   {  // setup
+      custom::bit_vector a;
+      custom::bit_vector b;
+      fillPattern(a, b, 1000);
+      // exercise
+      a &= b;
+      // verify
+      assertUnit(a.count() == countIf(1000, [](size_t i) { return i % 2 == 0 && i % 3 == 0; }));
+      assertUnit(a[6] && !a[4] && !a[3]);
+   }  // teardown
+
+   // or keeps the bits in either
+   void test_or_standard()
+   {  // setup
+      custom::bit_vector a;
+      custom::bit_vector b;
+      fillPattern(a, b, 1000);
+      // exercise
+      a |= b;
+      // verify
+      assertUnit(a.count() == countIf(1000, [](size_t i) { return i % 2 == 0 || i % 3 == 0; }));
+      assertUnit(a[4] && a[3] && !a[5]);
+   }  // teardown
+
+   // xor keeps the bits in just one
+   void test_xor_standard()
+   {  // setup
+      custom::bit_vector a;
+      custom::bit_vector b;
+      fillPattern(a, b, 1000);
+      // exercise
+      a ^= b;
+      // verify
+      assertUnit(a.count() == countIf(1000, [](size_t i) { return (i % 2 == 0) != (i % 3 == 0); }));
+      assertUnit(!a[6] && a[4] && a[3]);
+   }  // teardown
+
+   // and not removes the bits of the right side
+   void test_andNot_standard()
+   {  // setup
+      custom::bit_vector a;
+      custom::bit_vector b;
+      fillPattern(a, b, 1000);
+      // exercise
+      a.and_not(b);
+      // verify
+      assertUnit(a.count() == countIf(1000, [](size_t i) { return i % 2 == 0 && i % 3 != 0; }));
+      assertUnit(!a[6] && a[4] && !a[3]);
+   }  // teardown
+
+   // the vector kernels agree with the word at a time loop
+   void test_bulk_scalarMatches()
+   {  // setup
+      custom::simd_level saved = custom::simd_active();
+      custom::bit_vector a;
+      custom::bit_vector b;
+      fillPattern(a, b, 777);
+      custom::bit_vector c = a;
+      // exercise
+      a ^= b;
+      custom::simd_limit(custom::SIMD_SCALAR);
+      c ^= b;
+      custom::simd_limit(saved);
+      // verify
+      bool same = true;
+      for (size_t i = 0; i < a.word_count(); i++)
+         same = same && a.words[i] == c.words[i];
+      assertUnit(same);
+   }  // teardown
+
+   /***************************************
+    * QUERY
+    ***************************************/
+
+   // every third bit
+   void test_count_standard()
+   {  // setup
+      custom::bit_vector v(3000);
+      for (size_t i = 0; i < 3000; i += 3)
+         v.set(i);
+      // exercise
+      size_t n = v.count();
+      // verify
+      assertUnit(n == 1000);
+      assertUnit(v.any());
+      assertUnit(!v.none());
+   }  // teardown
+
+   // popcnt and the fallback count the same
+   void test_count_scalarMatches()
+   {  // setup
+      custom::simd_level saved = custom::simd_active();
+      custom::bit_vector v(5000);
+      for (size_t i = 0; i < 5000; i += 7)
+         v.set(i);
+      // exercise
+      size_t fast = v.count();
+      custom::simd_limit(custom::SIMD_SCALAR);
+      size_t slow = v.count();
+      custom::simd_limit(saved);
+      // verify
+      assertUnit(fast == slow);
+      assertUnit(fast == 715);
+   }  // teardown
+
+   // ones before each index, inside and across superblocks
+   void test_rank_standard()
+   {  // setup
+      custom::bit_vector v(2000);
+      for (size_t i = 0; i < 2000; i += 5)
+         v.set(i);
+      v.build_index();
+      // exercise
+      size_t r0 = v.rank(0);
+      size_t r1 = v.rank(1);
+      size_t r512 = v.rank(512);
+      size_t r1001 = v.rank(1001);
+      size_t rEnd = v.rank(2000);
+      // verify
+      assertUnit(r0 == 0);
+      assertUnit(r1 == 1);
+      assertUnit(r512 == 103);
+      assertUnit(r1001 == 201);
+      assertUnit(rEnd == 400);
+      assertUnit(v.indexed);
+   }  // teardown
+
+   // a change throws away the samples
+   void test_rank_afterChange()
+   {  // setup
+      custom::bit_vector v(1024);
+      v.set(1000);
+      v.build_index();
+      assertUnit(v.rank(1024) == 1);
+      // exercise
+      v.set(10);
+      // verify
+      assertUnit(!v.indexed);
+      assertUnit(v.rank(1024) == 2);
+      assertUnit(v.rank(11) == 1);
+   }  // teardown
+
+   // a query on a const bit_vector leaves it as it was
+   void test_rank_constUnindexed()
+   {  // setup
+      custom::bit_vector v(2000);
+      for (size_t i = 0; i < 2000; i += 5)
+         v.set(i);
+      const custom::bit_vector& cv = v;
+      // exercise
+      size_t r1001 = cv.rank(1001);
+      size_t s200 = cv.select(200);
+      // verify
+      assertUnit(r1001 == 201);
+      assertUnit(s200 == 1000);
+      assertUnit(!v.indexed);
+      assertUnit(v.superCounts.empty());
+   }  // teardown
+
+   // where the k-th one is
+   void test_select_standard()
+   {  // setup
+      custom::bit_vector v(3000);
+      v.set(2);
+      v.set(700);
+      v.set(701);
+      v.set(2999);
+      // exercise
+      size_t s0 = v.select(0);
+      size_t s1 = v.select(1);
+      size_t s2 = v.select(2);
+      size_t s3 = v.select(3);
+      // verify
+      assertUnit(s0 == 2);
+      assertUnit(s1 == 700);
+      assertUnit(s2 == 701);
+      assertUnit(s3 == 2999);
+   }  // teardown
+
+   // asking past the last one gives size()
+   void test_select_tooMany()
+   {  // setup
+      custom::bit_vector v(100);
+      v.set(50);
+      // exercise
+      size_t s = v.select(1);
+      // verify
+      assertUnit(s == 100);
+   }  // teardown
+
+   // rank(select(k)) == k for every k
+   void test_selectRank_roundTrip()
+   {  // setup
+      custom::bit_vector v(10000);
+      uint32_t seed = 26;
+      for (size_t i = 0; i < 10000; i++)
+      {
+         seed = seed * 1103515245u + 12345u;
+         if ((seed >> 16) % 4 == 0)
+            v.set(i);
+      }
+      v.build_index();
+      // exercise
+      bool ok = true;
+      for (size_t k = 0; k < v.count(); k++)
+      {
+         size_t i = v.select(k);
+         ok = ok && v[i] && v.rank(i) == k;
+      }
+      // verify
+      assertUnit(ok);
+   }  // teardown
+
+   // walk the ones
+   void test_findNext_standard()
+   {  // setup
+      custom::bit_vector v(300);
+      v.set(5);
+      v.set(64);
+      v.set(299);
+      // exercise
+      size_t a = v.find_first();
+      size_t b = v.find_next(6);
+      size_t c = v.find_next(65);
+      size_t d = v.find_next(300);
+      // verify
+      assertUnit(a == 5);
+      assertUnit(b == 64);
+      assertUnit(c == 299);
+      assertUnit(d == 300);
+   }  // teardown
+
+   /*************************************************************
+    * FILL PATTERN
+    * a has every second bit, b every third
+    *************************************************************/
+   void fillPattern(custom::bit_vector& a, custom::bit_vector& b, size_t num)
+   {
+      for (size_t i = 0; i < num; i++)
+      {
+         a.push_back(i % 2 == 0);
+         b.push_back(i % 3 == 0);
+      }
+   }
+
+   template <class Pred>
+   size_t countIf(size_t num, Pred pred)
+   {
+      size_t n = 0;
+      for (size_t i = 0; i < num; i++)
+         if (pred(i))
+            n++;
+      return n;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,456 @@
+/***********************************************************************
+ * Header:
+ *    TEST DISK SET
+ * Summary:
+ *    Unit tests for buffer_pool and disk_unordered_set
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "disk_set.h"
+#include "unitTest.h"
+
+#ifdef CUSTOM_SNAPSHOT_POSIX
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+class TestDiskSet : public UnitTest
+{
+   typedef custom::disk_unordered_set<int> DiskSet;
+
+   // every element in the same place
+   struct SameHash
+   {
+      size_t operator()(int) const { return 26; }
+   };
+
+public:
+   void run()
+   {
+      reset();
+
+      // Pool
+      test_pool_clockSecondChance();
+      test_pool_writeBackOnEvict();
+      test_pool_allPinned();
+
+      // File
+      test_open_new();
+      test_open_reopen();
+      test_open_notOurs();
+      test_open_directoryDamaged();
+      test_open_crashAfterSplits();
+      test_flush_reusesPages();
+
+      // Insert
+      test_insert_duplicate();
+      test_insert_splits();
+      test_insert_sameHashFull();
+
+      // Remove
+      test_erase_moveLast();
+
+      // Iterate
+      test_iterate_all();
+      test_evict_smallPool();
+
+      report("DiskSet");
+   }
+
+   /***************************************
+    * POOL
+    ***************************************/
+
+   // a page used since the last sweep stays; the other goes
+   void test_pool_clockSecondChance()
+   {  // setup
+      std::string path = tempPath();
+      int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+      custom::buffer_pool pool(2, 64);
+      pool.attach(fd);
+      pool.pin(0, true);
+      pool.unpin(0, false);
+      pool.pin(1, true);
+      pool.unpin(1, false);
+      pool.frames[1].referenced = false;
+      // exercise
+      pool.pin(2, true);
+      pool.unpin(2, false);
+      // verify
+      assertUnit(pool.frameOf[0] != custom::buffer_pool::NONE);
+      assertUnit(pool.frameOf[1] == custom::buffer_pool::NONE);
+      assertUnit(pool.frameOf[2] == 1);
+      assertUnit(!pool.frames[0].referenced);
+      // teardown
+      close(fd);
+      unlink(path.c_str());
+   }
+
+   // a dirty page reaches the file when it leaves the pool
+   void test_pool_writeBackOnEvict()
+   {  // setup
+      std::string path = tempPath();
+      int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+      custom::buffer_pool pool(2, 64);
+      pool.attach(fd);
+      unsigned char* p = pool.pin(1, true);
+      p[5] = 67;
+      pool.unpin(1, true);
+      // exercise
+      for (uint64_t page = 2; page < 6; page++)
+      {
+         pool.pin(page, false);
+         pool.unpin(page, false);
+      }
+      p = pool.pin(1, false);
+      // verify
+      assertUnit(p[5] == 67);
+      assertUnit(pool.writes() == 1);
+      assertUnit(pool.reads() == 5);
+      pool.unpin(1, false);
+      // teardown
+      close(fd);
+      unlink(path.c_str());
+   }
+
+   // nothing to evict while every frame is in use
+   void test_pool_allPinned()
+   {  // setup
+      std::string path = tempPath();
+      int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+      custom::buffer_pool pool(2, 64);
+      pool.attach(fd);
+      pool.pin(0, true);
+      pool.pin(1, true);
+      // exercise
+      unsigned char* p = pool.pin(2, true);
+      // verify
+      assertUnit(p == nullptr);
+      // teardown
+      close(fd);
+      unlink(path.c_str());
+   }
+
+   /***************************************
+    * FILE
+    ***************************************/
+
+   // one empty bucket that every hash shares
+   void test_open_new()
+   {  // setup
+      std::string path = tempPath();
+      DiskSet ds;
+      // exercise
+      bool opened = ds.open(path.c_str());
+      // verify
+      assertUnit(opened);
+      assertUnit(ds.empty());
+      assertUnit(ds.bucket_count() == 1);
+      assertUnit(ds.global_depth() == 0);
+      assertUnit(ds.begin() == ds.end());
+      // teardown
+      ds.close();
+      unlink(path.c_str());
+   }
+
+   // everything is there after a close
+   void test_open_reopen()
+   {  // setup
+      std::string path = tempPath();
+      size_t buckets;
+      {
+         DiskSet ds(path.c_str());
+         for (int i = 0; i < 5000; i++)
+            ds.insert(i * 3);
+         ds.erase(300);
+         buckets = ds.bucket_count();
+      }
+      // exercise
+      DiskSet ds(path.c_str());
+      // verify
+      assertUnit(ds.is_open());
+      assertUnit(ds.size() == 4999);
+      assertUnit(ds.bucket_count() == buckets);
+      assertUnit(ds.find(3 * 4999) != ds.end());
+      assertUnit(ds.find(300) == ds.end());
+      assertUnit(ds.find(1) == ds.end());
+      // teardown
+      ds.close();
+      unlink(path.c_str());
+   }
+
+   // a file of another T is not opened
+   void test_open_notOurs()
+   {  // setup
+      std::string path = tempPath();
+      {
+         custom::disk_unordered_set<uint64_t> other(path.c_str());
+         other.insert(26);
+      }
+      DiskSet ds;
+      // exercise
+      bool opened = ds.open(path.c_str());
+      // verify
+      assertUnit(!opened);
+      assertUnit(!ds.is_open());
+      assertUnit(ds.find(26) == ds.end());
+      // teardown
+      unlink(path.c_str());
+   }
+
+   // a saved directory that was damaged is not taken for one
+   void test_open_directoryDamaged()
+   {  // setup
+      std::string path = tempPath();
+      {
+         DiskSet ds(path.c_str());
+         for (int i = 0; i < 3000; i++)
+            ds.insert(i);
+      }
+      int fd = open(path.c_str(), O_RDWR);
+      DiskSet::file_header h;
+      bool read = custom::snapshot_detail::read_all_at(fd, &h, sizeof(h), 0);
+      custom::vector<uint64_t> bucketBytes(DiskSet::pageBytes / sizeof(uint64_t), 1);
+      bool written = custom::snapshot_detail::write_all_at(fd, &bucketBytes[0], DiskSet::pageBytes,
+                                                           (off_t)(h.directoryPage * DiskSet::pageBytes));
+      close(fd);
+      assert(read && written);
+      DiskSet ds;
+      // exercise
+      bool opened = ds.open(path.c_str());
+      // verify
+      assertUnit(!opened);
+      assertUnit(!ds.is_open());
+      // teardown
+      unlink(path.c_str());
+   }
+
+   // splits evicted after a flush never land on the saved directory
+   void test_open_crashAfterSplits()
+   {  // setup
+      std::string path = tempPath();
+      size_t buckets;
+      uint64_t savedAt;
+      {
+         DiskSet ds(path.c_str(), 2);
+         for (int i = 0; i < 3000; i++)
+            ds.insert(i);
+         ds.flush();
+         buckets = ds.bucket_count();
+         savedAt = ds.directoryPage;
+         for (int i = 3000; i < 20000; i++)
+            ds.insert(i);
+         assertUnit(ds.bucket_count() > buckets);
+         assertUnit(ds.page_writes() > 0);
+         assertUnit(!ds.bucketPages[(size_t)savedAt]);
+         close(ds.fd);                  // a crash: no flush
+         ds.fd = -1;
+      }
+      DiskSet ds;
+      // exercise
+      bool opened = ds.open(path.c_str());
+      // verify
+      assertUnit(opened);
+      assertUnit(ds.directoryPage == savedAt);
+      assertUnit(ds.bucket_count() == buckets);
+      // teardown
+      ds.close();
+      unlink(path.c_str());
+   }
+
+   // pages of an old directory become buckets, and the file stops growing
+   void test_flush_reusesPages()
+   {  // setup
+      std::string path = tempPath();
+      DiskSet ds(path.c_str());
+      for (int i = 0; i < 3000; i++)
+         ds.insert(i);
+      ds.flush();
+      ds.flush();
+      uint64_t pages = ds.numPages;
+      // exercise
+      for (int i = 0; i < 10; i++)
+         ds.flush();
+      // verify
+      assertUnit(ds.numPages == pages);
+      assertUnit(ds.numPages == 1 + ds.bucket_count() + 2 * ds.directoryPages);
+      // teardown
+      ds.close();
+      unlink(path.c_str());
+   }
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the second insert finds the first
+   void test_insert_duplicate()
+   {  // setup
+      std::string path = tempPath();
+      DiskSet ds(path.c_str());
+      ds.insert(26);
+      // exercise
+      custom::pair<DiskSet::iterator, bool> result = ds.insert(26);
+      // verify
+      assertUnit(!result.second);
+      assertUnit(*result.first == 26);
+      assertUnit(ds.size() == 1);
+      // teardown
+      ds.close();
+      unlink(path.c_str());
+   }
+
+   // only the full bucket splits, and the directory doubles only when it must
+   void test_insert_splits()
+   {  // setup
+      std::string path = tempPath();
+      DiskSet ds(path.c_str());
+      // exercise
+      for (int i = 0; i <= (int)DiskSet::capacity; i++)
+         ds.insert(i);
+      // verify
+      assertUnit(ds.size() == DiskSet::capacity + 1);
+      assertUnit(ds.bucket_count() == 2);
+      assertUnit(ds.global_depth() == 1);
+      assertUnit(ds.directory[0] == 1);
+      assertUnit(ds.directory[1] == 3);   // page 2 holds the saved directory
+      ds.insert(2000);      // even, into bucket 1, which still has room
+      assertUnit(ds.bucket_count() == 2);
+      bool all = true;
+      for (int i = 0; i <= (int)DiskSet::capacity; i++)
+         all = all && ds.find(i) != ds.end();
+      assertUnit(all);
+      // teardown
+      ds.close();
+      unlink(path.c_str());
+   }
+
+   // no split can separate elements that share a hash
+   void test_insert_sameHashFull()
+   {  // setup
+      std::string path = tempPath();
+      custom::disk_unordered_set<int, SameHash> ds(path.c_str());
+      for (int i = 0; i < (int)DiskSet::capacity; i++)
+         ds.insert(i);
+      // exercise
+      custom::pair<custom::disk_unordered_set<int, SameHash>::iterator, bool> result =
+         ds.insert(-1);
+      // verify
+      assertUnit(!result.second);
+      assertUnit(result.first == ds.end());
+      assertUnit(ds.good());
+      assertUnit(ds.size() == DiskSet::capacity);
+      assertUnit(ds.bucket_count() == 1);
+      // teardown
+      ds.close();
+      unlink(path.c_str());
+   }
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // the last element of the bucket fills the hole
+   void test_erase_moveLast()
+   {  // setup
+      std::string path = tempPath();
+      DiskSet ds(path.c_str());
+      ds.insert(26);
+      ds.insert(49);
+      ds.insert(67);
+      // exercise
+      DiskSet::iterator it = ds.erase(26);
+      DiskSet::iterator missing = ds.erase(99);
+      // verify
+      assertUnit(it != ds.end());
+      assertUnit(*it == 67);
+      assertUnit(missing == ds.end());
+      assertUnit(ds.size() == 2);
+      assertUnit(ds.find(26) == ds.end());
+      assertUnit(ds.find(49) != ds.end());
+      // teardown
+      ds.close();
+      unlink(path.c_str());
+   }
+
+   /***************************************
+    * ITERATE
+    ***************************************/
+
+   // every element once
+   void test_iterate_all()
+   {  // setup
+      std::string path = tempPath();
+      DiskSet ds(path.c_str());
+      long long expected = 0;
+      for (int i = 0; i < 3000; i++)
+      {
+         ds.insert(i * 7);
+         expected += i * 7;
+      }
+      // exercise
+      long long sum = 0;
+      size_t count = 0;
+      for (DiskSet::iterator it = ds.begin(); it != ds.end(); ++it)
+      {
+         sum += *it;
+         count++;
+      }
+      // verify
+      assertUnit(count == 3000);
+      assertUnit(sum == expected);
+      // teardown
+      ds.close();
+      unlink(path.c_str());
+   }
+
+   // a pool of two frames works, just through the file
+   void test_evict_smallPool()
+   {  // setup
+      std::string path = tempPath();
+      DiskSet ds(path.c_str(), 2);
+      unsigned x = 26;
+      for (int i = 0; i < 20000; i++)
+      {
+         x = x * 1103515245u + 12345u;
+         ds.insert((int)(x >> 1));
+      }
+      // exercise
+      x = 26;
+      bool all = true;
+      for (int i = 0; i < 20000; i++)
+      {
+         x = x * 1103515245u + 12345u;
+         all = all && ds.find((int)(x >> 1)) != ds.end();
+      }
+      // verify
+      assertUnit(all);
+      assertUnit(ds.good());
+      assertUnit(ds.bucket_count() > 2);
+      assertUnit(ds.page_reads() > 0);
+      assertUnit(ds.page_writes() > 0);
+      // teardown
+      ds.close();
+      unlink(path.c_str());
+   }
+};
+
+#else // !CUSTOM_SNAPSHOT_POSIX
+
+class TestDiskSet : public UnitTest
+{
+public:
+   void run() {}
+};
+
+#endif // CUSTOM_SNAPSHOT_POSIX
+
+#endif // DEBUG
@@ -0,0 +1,428 @@
+/***********************************************************************
+ * Header:
+ *    TEST DURABLE SET
+ * Summary:
+ *    Unit tests for durable_unordered_set
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "durable_set.h"
+#include "unitTest.h"
+
+#ifdef CUSTOM_SNAPSHOT_POSIX
+
+#include "testSnapshot.h"   // for StringSerializer
+
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+class TestDurableSet : public UnitTest
+{
+   typedef custom::durable_unordered_set<int> DurableSet;
+
+public:
+   void run()
+   {
+      reset();
+
+      // File
+      test_open_new();
+      test_open_recoversInserts();
+      test_open_recoversErases();
+      test_open_tornRecord();
+      test_open_corruptRecord();
+      test_open_snapshotUnreadable();
+
+      // Insert
+      test_insert_duplicateNotLogged();
+      test_insert_groupCommit();
+      test_insert_interval();
+      test_insert_logFails();
+
+      // Checkpoint
+      test_checkpoint_emptiesLog();
+      test_checkpoint_staleLogIgnored();
+
+      // Use
+      test_customSerializer();
+
+      report("DurableSet");
+   }
+
+   /***************************************
+    * FILE
+    ***************************************/
+
+   // nothing there yet: an empty set and a log with only a header
+   void test_open_new()
+   {  // setup
+      std::string path = tempPath();
+      DurableSet ds;
+      // exercise
+      bool opened = ds.open(path.c_str());
+      // verify
+      assertUnit(opened);
+      assertUnit(ds.is_open());
+      assertUnit(ds.empty());
+      assertUnit(fileSize(path + ".log") == sizeof(DurableSet::log_header));
+      // teardown
+      ds.close();
+      removeAll(path);
+   }
+
+   // what went in before a close is there after
+   void test_open_recoversInserts()
+   {  // setup
+      std::string path = tempPath();
+      {
+         DurableSet ds(path.c_str());
+         ds.insert(26);
+         ds.insert(49);
+         ds.insert(67);
+      }
+      // exercise
+      DurableSet ds(path.c_str());
+      // verify
+      assertUnit(ds.size() == 3);
+      assertUnit(ds.contains(26));
+      assertUnit(ds.contains(67));
+      // teardown
+      ds.close();
+      removeAll(path);
+   }
+
+   // the log keeps the order of inserts and erases
+   void test_open_recoversErases()
+   {  // setup
+      std::string path = tempPath();
+      {
+         DurableSet ds(path.c_str());
+         ds.insert(26);
+         ds.insert(49);
+         ds.erase(26);
+         ds.insert(67);
+         ds.erase(67);
+         ds.insert(26);
+      }
+      // exercise
+      DurableSet ds(path.c_str());
+      // verify
+      assertUnit(ds.size() == 2);
+      assertUnit(ds.contains(26));
+      assertUnit(ds.contains(49));
+      assertUnit(!ds.contains(67));
+      // teardown
+      ds.close();
+      removeAll(path);
+   }
+
+   // a crash in the middle of the last record loses only that record
+   void test_open_tornRecord()
+   {  // setup
+      std::string path = tempPath();
+      {
+         DurableSet ds(path.c_str());
+         ds.insert(26);
+         ds.insert(49);
+      }
+      size_t whole = fileSize(path + ".log");
+      truncate((path + ".log").c_str(), (off_t)(whole - 3));
+      // exercise
+      DurableSet ds(path.c_str());
+      // verify
+      assertUnit(ds.size() == 1);
+      assertUnit(ds.contains(26));
+      assertUnit(fileSize(path + ".log") == whole - (DurableSet::recordBytes + sizeof(int)));
+      // teardown
+      ds.close();
+      removeAll(path);
+   }
+
+   // a record that fails its checksum ends the replay
+   void test_open_corruptRecord()
+   {  // setup
+      std::string path = tempPath();
+      {
+         DurableSet ds(path.c_str());
+         ds.insert(26);
+         ds.insert(49);
+         ds.insert(67);
+      }
+      size_t second = sizeof(DurableSet::log_header) + DurableSet::recordBytes + sizeof(int);
+      flipByte(path + ".log", second + DurableSet::recordBytes);
+      // exercise
+      DurableSet ds(path.c_str());
+      // verify
+      assertUnit(ds.size() == 1);
+      assertUnit(ds.contains(26));
+      assertUnit(!ds.contains(67));
+      // teardown
+      ds.close();
+      removeAll(path);
+   }
+
+   // a snapshot that is there but cannot be opened is not no snapshot
+   void test_open_snapshotUnreadable()
+   {  // setup
+      std::string path = tempPath();
+      {
+         DurableSet ds(path.c_str());
+         ds.insert(26);
+         ds.checkpoint();
+         ds.insert(49);
+      }
+      size_t logBytes = fileSize(path + ".log");
+      std::string snapPath = path + ".snap";
+      std::string hidden = path + ".hidden";
+      int renamed = rename(snapPath.c_str(), hidden.c_str());
+      assert(renamed == 0);
+      int linked = symlink(snapPath.c_str(), snapPath.c_str());   // opens with ELOOP
+      assert(linked == 0);
+      DurableSet ds;
+      // exercise
+      bool opened = ds.open(path.c_str());
+      // verify
+      assertUnit(!opened);
+      assertUnit(!ds.is_open());
+      assertUnit(fileSize(path + ".log") == logBytes);
+      unlink(snapPath.c_str());
+      rename(hidden.c_str(), snapPath.c_str());
+      DurableSet again(path.c_str());
+      assertUnit(again.size() == 2);
+      assertUnit(again.contains(49));
+      // teardown
+      again.close();
+      removeAll(path);
+   }
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // nothing changed, so nothing is logged
+   void test_insert_duplicateNotLogged()
+   {  // setup
+      std::string path = tempPath();
+      DurableSet ds(path.c_str());
+      ds.insert(26);
+      size_t before = fileSize(path + ".log");
+      // exercise
+      bool inserted = ds.insert(26);
+      bool erased = ds.erase(49);
+      // verify
+      assertUnit(!inserted);
+      assertUnit(!erased);
+      assertUnit(ds.sync());
+      assertUnit(fileSize(path + ".log") == before);
+      assertUnit(ds.appended == 1);
+      // teardown
+      ds.close();
+      removeAll(path);
+   }
+
+   // every insert is durable when it returns, and threads share the syncs
+   void test_insert_groupCommit()
+   {  // setup
+      std::string path = tempPath();
+      DurableSet ds(path.c_str());
+      const int perThread = 200;
+      // exercise
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; t++)
+         threads.push_back(std::thread([&ds, t, perThread]()
+         {
+            for (int i = 0; i < perThread; i++)
+               ds.insert(t * perThread + i);
+         }));
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+      // verify
+      assertUnit(ds.durable == ds.appended);
+      assertUnit(ds.numSyncs < (size_t)(4 * perThread));
+      assertUnit(fileSize(path + ".log") ==
+                 sizeof(DurableSet::log_header) + 4 * perThread * (DurableSet::recordBytes + sizeof(int)));
+      ds.close();
+      DurableSet again(path.c_str());
+      assertUnit(again.size() == 4 * perThread);
+      // teardown
+      again.close();
+      removeAll(path);
+   }
+
+   // with an interval, inserts do not wait but sync() does
+   void test_insert_interval()
+   {  // setup
+      std::string path = tempPath();
+      DurableSet ds(path.c_str(), std::chrono::seconds(60));
+      // exercise
+      for (int i = 0; i < 100; i++)
+         ds.insert(i);
+      size_t beforeSync = fileSize(path + ".log");
+      bool synced = ds.sync();
+      // verify
+      assertUnit(beforeSync == sizeof(DurableSet::log_header));
+      assertUnit(synced);
+      assertUnit(ds.durable == 100);
+      assertUnit(ds.numSyncs == 1);
+      assertUnit(fileSize(path + ".log") ==
+                 sizeof(DurableSet::log_header) + 100 * (DurableSet::recordBytes + sizeof(int)));
+      // teardown
+      ds.close();
+      removeAll(path);
+   }
+
+   // a record that cannot be written is undone and not reported durable
+   void test_insert_logFails()
+   {  // setup
+      std::string path = tempPath();
+      DurableSet ds(path.c_str());
+      ds.insert(26);
+      int readOnly = open((path + ".log").c_str(), O_RDONLY);
+      dup2(readOnly, ds.fd);            // every write to the log now fails
+      close(readOnly);
+      // exercise
+      bool lost = ds.insert(49);
+      bool refused = ds.insert(67);
+      bool erased = ds.erase(26);
+      // verify
+      assertUnit(!lost);
+      assertUnit(!refused);
+      assertUnit(!erased);
+      assertUnit(ds.failed);
+      assertUnit(!ds.contains(49));
+      assertUnit(!ds.contains(67));
+      assertUnit(ds.contains(26));
+      assertUnit(ds.size() == 1);
+      assertUnit(!ds.sync());
+      assertUnit(fileSize(path + ".log") ==
+                 sizeof(DurableSet::log_header) + DurableSet::recordBytes + sizeof(int));
+      // teardown
+      ds.close();
+      removeAll(path);
+   }
+
+   /***************************************
+    * CHECKPOINT
+    ***************************************/
+
+   // the snapshot takes over and the log starts again
+   void test_checkpoint_emptiesLog()
+   {  // setup
+      std::string path = tempPath();
+      {
+         DurableSet ds(path.c_str());
+         for (int i = 0; i < 50; i++)
+            ds.insert(i);
+         // exercise
+         bool done = ds.checkpoint();
+         ds.insert(99);
+         ds.erase(0);
+         // verify
+         assertUnit(done);
+         assertUnit(ds.epoch == 1);
+         assertUnit(fileSize(path + ".log") ==
+                    sizeof(DurableSet::log_header) + 2 * (DurableSet::recordBytes + sizeof(int)));
+      }
+      DurableSet ds(path.c_str());
+      assertUnit(ds.size() == 50);
+      assertUnit(ds.contains(99));
+      assertUnit(!ds.contains(0));
+      // teardown
+      ds.close();
+      removeAll(path);
+   }
+
+   // a crash after the snapshot but before the log is emptied
+   void test_checkpoint_staleLogIgnored()
+   {  // setup
+      std::string path = tempPath();
+      std::string oldLog;
+      {
+         DurableSet ds(path.c_str());
+         ds.insert(26);
+         oldLog = readFile(path + ".log");
+         ds.erase(26);
+         // exercise
+         ds.checkpoint();
+      }
+      writeFile(path + ".log", oldLog);
+      DurableSet ds(path.c_str());
+      // verify
+      assertUnit(ds.empty());
+      assertUnit(ds.epoch == 1);
+      assertUnit(fileSize(path + ".log") == sizeof(DurableSet::log_header));
+      // teardown
+      ds.close();
+      removeAll(path);
+   }
+
+   /***************************************
+    * USE
+    ***************************************/
+
+   // records of a type that is not its own bytes
+   void test_customSerializer()
+   {  // setup
+      typedef custom::durable_unordered_set<std::string, std::hash<std::string>,
+                                            std::equal_to<std::string>, StringSerializer> NameSet;
+      std::string path = tempPath();
+      {
+         NameSet ns(path.c_str());
+         ns.insert("alpha");
+         ns.insert("beta");
+         ns.checkpoint();
+         ns.insert(std::string(500, 'g'));
+         ns.erase("alpha");
+      }
+      // exercise
+      NameSet ns(path.c_str());
+      // verify
+      assertUnit(ns.size() == 2);
+      assertUnit(ns.contains("beta"));
+      assertUnit(ns.contains(std::string(500, 'g')));
+      assertUnit(!ns.contains("alpha"));
+      // teardown
+      ns.close();
+      removeAll(path);
+   }
+
+   /*************************************************************
+    * REMOVE ALL / FLIP BYTE
+    * The files a durable_unordered_set makes, and damage to one
+    *************************************************************/
+   void removeAll(const std::string& path)
+   {
+      unlink((path + ".log").c_str());
+      unlink((path + ".snap").c_str());
+   }
+
+   void flipByte(const std::string& path, size_t offset)
+   {
+      std::string bytes = readFile(path);
+      assert(offset < bytes.size());
+      bytes[offset] ^= 0x5a;
+      writeFile(path, bytes);
+   }
+};
+
+#else // !CUSTOM_SNAPSHOT_POSIX
+
+class TestDurableSet : public UnitTest
+{
+public:
+   void run() {}
+};
+
+#endif // CUSTOM_SNAPSHOT_POSIX
+
+#endif // DEBUG
@@ -0,0 +1,327 @@
+/***********************************************************************
+ * Header:
+ *    TEST FORWARD LIST
+ * Summary:
+ *    Unit tests for forward_list
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "forward_list.h"
+#include "hash.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <functional>
+
+class TestForwardList : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_initializerList();
+      test_constructCopy_standard();
+      test_constructMove_standard();
+
+      // Insert
+      test_pushFront_standard();
+      test_insertAfter_middle();
+      test_insertAfter_tail();
+      test_insert_end();
+
+      // Remove
+      test_eraseAfter_tail();
+      test_erase_middle();
+      test_clear_spy();
+
+      // Splice
+      test_spliceAfter_whole();
+      test_spliceAfter_one();
+
+      // Use
+      test_find_standard();
+      test_node_smallerThanList();
+      test_hash_bucket();
+
+      report("ForwardList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // nothing in the list
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::forward_list<int> l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.size() == 0);
+      assertUnit(l.head.pNext == nullptr);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // elements in order
+   void test_construct_initializerList()
+   {  // setup
+      // exercise
+      custom::forward_list<int> l{ 26, 49, 67 };
+      // verify
+      assertUnit(l.size() == 3);
+      assertUnit(l.front() == 26);
+      assertUnit(l.back() == 67);
+      assertUnit(sequence(l, { 26, 49, 67 }));
+   }  // teardown
+
+   // an independent copy
+   void test_constructCopy_standard()
+   {  // setup
+      custom::forward_list<int> src{ 26, 49, 67 };
+      // exercise
+      custom::forward_list<int> dest(src);
+      src.front() = 99;
+      // verify
+      assertUnit(sequence(dest, { 26, 49, 67 }));
+      assertUnit(dest.head.pNext != src.head.pNext);
+   }  // teardown
+
+   // the nodes change owner
+   void test_constructMove_standard()
+   {  // setup
+      custom::forward_list<int> src{ 26, 49, 67 };
+      void* pFirst = src.head.pNext;
+      // exercise
+      custom::forward_list<int> dest(std::move(src));
+      // verify
+      assertUnit(src.empty());
+      assertUnit(src.pTail == nullptr);
+      assertUnit((void*)dest.head.pNext == pFirst);
+      assertUnit(dest.back() == 67);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push front reverses the order
+   void test_pushFront_standard()
+   {  // setup
+      custom::forward_list<Spy> l;
+      Spy::reset();
+      // exercise
+      l.push_front(Spy(67));
+      l.push_front(Spy(49));
+      l.push_front(Spy(26));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 3);
+      assertUnit(l.size() == 3);
+      assertUnit(l.front() == Spy(26));
+      assertUnit(l.back() == Spy(67));
+   }  // teardown
+
+   // after an element in the middle
+   void test_insertAfter_middle()
+   {  // setup
+      custom::forward_list<int> l{ 26, 67 };
+      // exercise
+      custom::forward_list<int>::iterator it = l.insert_after(l.begin(), 49);
+      // verify
+      assertUnit(*it == 49);
+      assertUnit(sequence(l, { 26, 49, 67 }));
+      assertUnit(l.back() == 67);
+   }  // teardown
+
+   // after the last element moves the tail
+   void test_insertAfter_tail()
+   {  // setup
+      custom::forward_list<int> l{ 26, 49 };
+      // exercise
+      l.insert_after(l.find(49), 67);
+      l.push_back(89);
+      // verify
+      assertUnit(sequence(l, { 26, 49, 67, 89 }));
+      assertUnit(l.back() == 89);
+   }  // teardown
+
+   // the bucket interface appends at end()
+   void test_insert_end()
+   {  // setup
+      custom::forward_list<int> l{ 26 };
+      // exercise
+      custom::forward_list<int>::iterator it = l.insert(l.end(), 67);
+      l.insert(it, 49);
+      // verify
+      assertUnit(*it == 67);
+      assertUnit(sequence(l, { 26, 49, 67 }));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erasing the last element pulls the tail back
+   void test_eraseAfter_tail()
+   {  // setup
+      custom::forward_list<int> l{ 26, 49, 67 };
+      // exercise
+      custom::forward_list<int>::iterator it = l.erase_after(l.find(49));
+      // verify
+      assertUnit(it == l.end());
+      assertUnit(l.back() == 49);
+      l.push_back(89);
+      assertUnit(sequence(l, { 26, 49, 89 }));
+   }  // teardown
+
+   // erase by position returns what followed
+   void test_erase_middle()
+   {  // setup
+      custom::forward_list<int> l{ 26, 49, 67 };
+      // exercise
+      custom::forward_list<int>::iterator it = l.erase(l.find(49));
+      // verify
+      assertUnit(*it == 67);
+      assertUnit(sequence(l, { 26, 67 }));
+      l.erase(l.begin());
+      l.erase(l.begin());
+      assertUnit(l.empty());
+      assertUnit(l.pTail == nullptr);
+   }  // teardown
+
+   // every element is destroyed exactly once
+   void test_clear_spy()
+   {  // setup
+      custom::forward_list<Spy> l;
+      for (int i = 0; i < 10; i++)
+         l.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 10);
+      assertUnit(Spy::numDelete() == 10);
+      assertUnit(l.size() == 0);
+      assertUnit(l.pTail == nullptr);
+   }  // teardown
+
+   /***************************************
+    * SPLICE
+    ***************************************/
+
+   // all of one list into the middle of another
+   void test_spliceAfter_whole()
+   {  // setup
+      custom::forward_list<Spy> l;
+      custom::forward_list<Spy> rhs;
+      l.push_back(Spy(1));
+      l.push_back(Spy(4));
+      rhs.push_back(Spy(2));
+      rhs.push_back(Spy(3));
+      Spy::reset();
+      // exercise
+      l.splice_after(l.begin(), rhs);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(rhs.empty());
+      assertUnit(rhs.pTail == nullptr);
+      assertUnit(l.size() == 4);
+      assertUnit(l.back() == Spy(4));
+   }  // teardown
+
+   // one node across, including onto the tail
+   void test_spliceAfter_one()
+   {  // setup
+      custom::forward_list<int> l{ 26 };
+      custom::forward_list<int> rhs{ 49, 67 };
+      // exercise
+      l.splice_after(l.begin(), rhs, rhs.find(49));
+      l.splice_after(l.before_begin(), rhs, rhs.before_begin());
+      // verify
+      assertUnit(sequence(l, { 49, 26, 67 }));
+      assertUnit(l.back() == 67);
+      assertUnit(rhs.empty());
+      assertUnit(rhs.pTail == nullptr);
+   }  // teardown
+
+   /***************************************
+    * USE
+    ***************************************/
+
+   // find returns the first match or end
+   void test_find_standard()
+   {  // setup
+      custom::forward_list<int> l{ 26, 49, 67, 49 };
+      // exercise
+      custom::forward_list<int>::iterator it = l.find(49);
+      // verify
+      assertUnit(it.p == l.head.pNext->pNext);
+      assertUnit(l.find(11) == l.end());
+   }  // teardown
+
+   // one pointer less per element than list
+   void test_node_smallerThanList()
+   {  // setup
+      // exercise
+      size_t forward = sizeof(custom::forward_list<void*>::Node);
+      // verify
+      assertUnit(forward == 2 * sizeof(void*));
+   }  // teardown
+
+   // an unordered_set with forward_list chains
+   void test_hash_bucket()
+   {  // setup
+      custom::unordered_set<int, std::hash<int>, std::equal_to<int>,
+                            std::allocator<int>, custom::forward_list<int> > us;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         us.insert(i);
+      for (int i = 0; i < 100; i += 2)
+         us.erase(i);
+      // verify
+      assertUnit(us.size() == 50);
+      bool ok = true;
+      for (int i = 0; i < 100; i++)
+         ok = ok && ((us.find(i) != us.end()) == (i % 2 == 1));
+      assertUnit(ok);
+      size_t count = 0;
+      for (custom::unordered_set<int, std::hash<int>, std::equal_to<int>,
+              std::allocator<int>, custom::forward_list<int> >::iterator it = us.begin();
+           it != us.end(); ++it)
+         count++;
+      assertUnit(count == 50);
+   }  // teardown
+
+   /*************************************************************
+    * SEQUENCE
+    * Does the list hold exactly these values?
+    *************************************************************/
+   bool sequence(custom::forward_list<int>& l, const std::initializer_list<int>& il)
+   {
+      if (l.size() != il.size())
+         return false;
+      custom::forward_list<int>::iterator it = l.begin();
+      for (int value : il)
+      {
+         if (it == l.end() || *it != value)
+            return false;
+         ++it;
+      }
+      return it == l.end();
+   }
+};
+
+#endif // DEBUG
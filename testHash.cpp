@@ -16,6 +16,29 @@
 #include "testList.h"       // for the list unit tests
 #include "testVector.h"     // for the vector unit tests
 #include "testSpy.h"        // for the spy unit tests
+#include "testSmallVector.h" // for the small vector unit tests
+#include "testSegmentedVector.h" // for the segmented vector unit tests
+#include "testSimd.h" // for the simd unit tests
+#include "testThreadPool.h" // for the thread pool unit tests
+#include "testSort.h" // for the sort unit tests
+#include "testParallel.h" // for the parallel algorithm unit tests
+#include "testMappedVector.h" // for the mapped_vector unit tests
+#include "testBitVector.h" // for the bit_vector unit tests
+#include "testSoaVector.h" // for the soa_vector unit tests
+#include "testPQueue.h" // for the priority_queue unit tests
+#include "testIndexedHeap.h" // for the indexed_heap unit tests
+#include "testUnrolledList.h" // for the unrolled_list unit tests
+#include "testForwardList.h" // for the forward_list unit tests
+#include "testIntrusiveList.h" // for the intrusive_list unit tests
+#include "testIntrusiveSet.h" // for the intrusive_unordered_set unit tests
+#include "testNodePool.h" // for the node_pool unit tests
+#include "testSnapshot.h" // for the unordered_set snapshot unit tests
+#include "testMappedSet.h" // for the mapped_unordered_set unit tests
+#include "testDurableSet.h" // for the durable_unordered_set unit tests
+#include "testBackgroundSave.h" // for the background_save unit tests
+#include "testPackedSnapshot.h" // for the packed snapshot unit tests
+#include "testIncrementalSnapshot.h" // for the incremental_snapshot unit tests
+#include "testDiskSet.h" // for the disk_unordered_set unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -31,6 +54,29 @@ int main()
    TestList().run();
    TestVector().run();
    TestHash().run();
+   TestSmallVector().run();
+   TestSegmentedVector().run();
+   TestSimd().run();
+   TestThreadPool().run();
+   TestSort().run();
+   TestParallel().run();
+   TestMappedVector().run();
+   TestBitVector().run();
+   TestSoaVector().run();
+   TestPQueue().run();
+   TestIndexedHeap().run();
+   TestUnrolledList().run();
+   TestForwardList().run();
+   TestIntrusiveList().run();
+   TestIntrusiveSet().run();
+   TestNodePool().run();
+   TestSnapshot().run();
+   TestMappedSet().run();
+   TestDurableSet().run();
+   TestBackgroundSave().run();
+   TestPackedSnapshot().run();
+   TestIncrementalSnapshot().run();
+   TestDiskSet().run();
 #endif // DEBUG
    
    // driver
@@ -0,0 +1,417 @@
+/***********************************************************************
+ * Header:
+ *    TEST INCREMENTAL SNAPSHOT
+ * Summary:
+ *    Unit tests for unordered_set change tracking and deltas, and for
+ *    incremental_snapshot
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "incremental_snapshot.h"
+#include "unitTest.h"
+
+#ifdef CUSTOM_SNAPSHOT_POSIX
+
+#include "testSnapshot.h"   // for StringSerializer
+
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+class TestIncrementalSnapshot : public UnitTest
+{
+   typedef custom::incremental_snapshot<int> Snapshot;
+
+public:
+   void run()
+   {
+      reset();
+
+      // Changes
+      test_dirty_insertErase();
+      test_dirty_rehash();
+      test_delta_roundTrip();
+      test_delta_wrongBuckets();
+
+      // Save
+      test_save_firstIsFull();
+      test_save_thenDeltas();
+      test_save_rehashIsFull();
+      test_save_chainBounded();
+
+      // Load
+      test_load_replaysChain();
+      test_load_tornDelta();
+      test_load_staleChain();
+
+      // Compact
+      test_compact_mergesChain();
+      test_customSerializer();
+
+      report("IncrementalSnapshot");
+   }
+
+   /***************************************
+    * CHANGES
+    ***************************************/
+
+   // only the pages of the buckets that were touched
+   void test_dirty_insertErase()
+   {  // setup
+      custom::unordered_set<int> us(4 * custom::SNAPSHOT_PAGE_BUCKETS);
+      us.insert(3);
+      us.clear_dirty();
+      // exercise
+      us.insert(2 * (int)custom::SNAPSHOT_PAGE_BUCKETS + 5);
+      us.erase(3);
+      us.erase(49);
+      // verify
+      assertUnit(!us.dirty_all());
+      assertUnit(us.page_count() == 4);
+      assertUnit(us.page_dirty(0));
+      assertUnit(!us.page_dirty(1));
+      assertUnit(us.page_dirty(2));
+      assertUnit(!us.page_dirty(3));
+   }  // teardown
+
+   // a new bucket array changes every page
+   void test_dirty_rehash()
+   {  // setup
+      custom::unordered_set<int> us(8);
+      us.clear_dirty();
+      // exercise
+      for (int i = 0; i < 20; i++)
+         us.insert(i);
+      // verify
+      assertUnit(us.dirty_all());
+      us.clear_dirty();
+      assertUnit(!us.dirty_all());
+      us.clear();
+      assertUnit(us.dirty_all());
+   }  // teardown
+
+   // a copy taken at clear_dirty() catches up with one delta
+   void test_delta_roundTrip()
+   {  // setup
+      custom::unordered_set<int> us(4096);
+      for (int i = 0; i < 2000; i++)
+         us.insert(i);
+      custom::unordered_set<int> copy(us);
+      us.clear_dirty();
+      us.erase(26);
+      us.erase(1999);
+      us.insert(3000);
+      std::stringstream ss;
+      // exercise
+      bool saved = us.save_delta(ss);
+      bool applied = copy.apply_delta(ss);
+      // verify
+      assertUnit(saved);
+      assertUnit(applied);
+      assertUnit(ss.str().size() < 2000 * sizeof(int) / 2);
+      assertUnit(copy.size() == us.size());
+      assertUnit(copy.find(26) == copy.end());
+      assertUnit(copy.find(1999) == copy.end());
+      assertUnit(copy.find(3000) != copy.end());
+      assertUnit(copy.find(1998) != copy.end());
+   }  // teardown
+
+   // a delta only fits the bucket count it was taken at
+   void test_delta_wrongBuckets()
+   {  // setup
+      custom::unordered_set<int> us(512);
+      us.clear_dirty();
+      us.insert(26);
+      std::stringstream ss;
+      us.save_delta(ss);
+      custom::unordered_set<int> copy(1024);
+      copy.insert(49);
+      // exercise
+      bool applied = copy.apply_delta(ss);
+      // verify
+      assertUnit(!applied);
+      assertUnit(copy.empty());
+   }  // teardown
+
+   /***************************************
+    * SAVE
+    ***************************************/
+
+   // nothing known yet, so a full snapshot and an empty chain
+   void test_save_firstIsFull()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us;
+      us.insert(26);
+      Snapshot snapshot(path.c_str());
+      // exercise
+      bool saved = snapshot.save(us);
+      // verify
+      assertUnit(saved);
+      assertUnit(snapshot.generation == 1);
+      assertUnit(snapshot.delta_count() == 0);
+      assertUnit(fileSize(path + ".snap") == snapshot.snapshot_bytes());
+      assertUnit(fileSize(path + ".delta") == sizeof(Snapshot::delta_header));
+      assertUnit(!us.dirty_all());
+      // teardown
+      removeAll(path);
+   }
+
+   // small changes to a big set are small deltas
+   void test_save_thenDeltas()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us(8192);
+      for (int i = 0; i < 5000; i++)
+         us.insert(i);
+      Snapshot snapshot(path.c_str());
+      snapshot.save(us);
+      // exercise
+      us.insert(7000);
+      bool first = snapshot.save(us);
+      us.erase(7000);
+      us.erase(0);
+      bool second = snapshot.save(us);
+      // verify
+      assertUnit(first);
+      assertUnit(second);
+      assertUnit(snapshot.generation == 1);
+      assertUnit(snapshot.delta_count() == 2);
+      assertUnit(snapshot.delta_bytes() * 4 < snapshot.snapshot_bytes());
+      assertUnit(fileSize(path + ".delta") == sizeof(Snapshot::delta_header) + snapshot.delta_bytes());
+      // teardown
+      removeAll(path);
+   }
+
+   // a rehash moves everything, so only a full snapshot will do
+   void test_save_rehashIsFull()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us(8);
+      Snapshot snapshot(path.c_str());
+      snapshot.save(us);
+      // exercise
+      for (int i = 0; i < 20; i++)
+         us.insert(i);
+      bool saved = snapshot.save(us);
+      // verify
+      assertUnit(saved);
+      assertUnit(snapshot.generation == 2);
+      assertUnit(snapshot.delta_count() == 0);
+      // teardown
+      removeAll(path);
+   }
+
+   // after maxDeltas the chain starts over
+   void test_save_chainBounded()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us(4096);
+      for (int i = 0; i < 3000; i++)
+         us.insert(i);
+      Snapshot snapshot(path.c_str(), 2);
+      snapshot.save(us);
+      // exercise
+      for (int i = 0; i < 3; i++)
+      {
+         us.erase(i);
+         snapshot.save(us);
+      }
+      // verify
+      assertUnit(snapshot.generation == 2);
+      assertUnit(snapshot.delta_count() == 0);
+      // teardown
+      removeAll(path);
+   }
+
+   /***************************************
+    * LOAD
+    ***************************************/
+
+   // the snapshot, then every delta in order
+   void test_load_replaysChain()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us(2048);
+      for (int i = 0; i < 1000; i++)
+         us.insert(i);
+      {
+         Snapshot snapshot(path.c_str());
+         snapshot.save(us);
+         us.erase(26);
+         snapshot.save(us);
+         us.insert(26);
+         us.insert(5000);
+         us.erase(999);
+         snapshot.save(us);
+      }
+      Snapshot snapshot(path.c_str());
+      custom::unordered_set<int> copy;
+      // exercise
+      bool loaded = snapshot.load(copy);
+      // verify
+      assertUnit(loaded);
+      assertUnit(snapshot.delta_count() == 2);
+      assertUnit(copy.size() == us.size());
+      assertUnit(copy.bucket_count() == us.bucket_count());
+      assertUnit(copy.find(26) != copy.end());
+      assertUnit(copy.find(5000) != copy.end());
+      assertUnit(copy.find(999) == copy.end());
+      assertUnit(!copy.dirty_all());
+      // teardown
+      removeAll(path);
+   }
+
+   // a crash in the middle of the last delta loses only that delta
+   void test_load_tornDelta()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us(1024);
+      for (int i = 0; i < 500; i++)
+         us.insert(i);
+      size_t whole;
+      {
+         Snapshot snapshot(path.c_str());
+         snapshot.save(us);
+         us.erase(26);
+         snapshot.save(us);
+         whole = fileSize(path + ".delta");
+         us.erase(49);
+         snapshot.save(us);
+      }
+      truncate((path + ".delta").c_str(), (off_t)(fileSize(path + ".delta") - 3));
+      Snapshot snapshot(path.c_str());
+      custom::unordered_set<int> copy;
+      // exercise
+      bool loaded = snapshot.load(copy);
+      // verify
+      assertUnit(loaded);
+      assertUnit(snapshot.delta_count() == 1);
+      assertUnit(copy.find(26) == copy.end());
+      assertUnit(copy.find(49) != copy.end());
+      assertUnit(fileSize(path + ".delta") == whole);
+      // teardown
+      removeAll(path);
+   }
+
+   // a chain from before the last full snapshot is not replayed
+   void test_load_staleChain()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us(1024);
+      for (int i = 0; i < 500; i++)
+         us.insert(i);
+      Snapshot snapshot(path.c_str());
+      snapshot.save(us);
+      us.erase(26);
+      snapshot.save(us);
+      std::string oldChain = readFile(path + ".delta");
+      snapshot.save_full(us);
+      writeFile(path + ".delta", oldChain);
+      us.erase(49);
+      custom::unordered_set<int> copy;
+      // exercise
+      bool loaded = snapshot.load(copy);
+      // verify
+      assertUnit(loaded);
+      assertUnit(snapshot.generation == 2);
+      assertUnit(snapshot.delta_count() == 0);
+      assertUnit(copy.size() == 499);
+      assertUnit(fileSize(path + ".delta") == sizeof(Snapshot::delta_header));
+      // teardown
+      removeAll(path);
+   }
+
+   /***************************************
+    * COMPACT
+    ***************************************/
+
+   // the chain folds into the next snapshot, from the files alone
+   void test_compact_mergesChain()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us(1024);
+      for (int i = 0; i < 500; i++)
+         us.insert(i);
+      {
+         Snapshot snapshot(path.c_str());
+         snapshot.save(us);
+         us.erase(26);
+         snapshot.save(us);
+         us.insert(777);
+         snapshot.save(us);
+      }
+      Snapshot snapshot(path.c_str());
+      // exercise
+      bool compacted = snapshot.compact();
+      // verify
+      assertUnit(compacted);
+      assertUnit(snapshot.generation == 2);
+      assertUnit(snapshot.delta_count() == 0);
+      custom::unordered_set<int> copy;
+      assertUnit(snapshot.load(copy));
+      assertUnit(copy.size() == 500);
+      assertUnit(copy.find(26) == copy.end());
+      assertUnit(copy.find(777) != copy.end());
+      // teardown
+      removeAll(path);
+   }
+
+   // deltas of a type that is not its own bytes
+   void test_customSerializer()
+   {  // setup
+      typedef custom::incremental_snapshot<std::string, std::hash<std::string>,
+                                           std::equal_to<std::string>, StringSerializer> NameSnapshot;
+      std::string path = tempPath();
+      NameSnapshot::set_type ns(1024);
+      ns.insert("alpha");
+      ns.insert("beta");
+      {
+         NameSnapshot snapshot(path.c_str());
+         snapshot.save(ns);
+         ns.insert(std::string(500, 'g'));
+         ns.erase("alpha");
+         snapshot.save(ns);
+      }
+      NameSnapshot snapshot(path.c_str());
+      NameSnapshot::set_type copy;
+      // exercise
+      bool loaded = snapshot.load(copy);
+      // verify
+      assertUnit(loaded);
+      assertUnit(snapshot.delta_count() == 1);
+      assertUnit(copy.size() == 2);
+      assertUnit(copy.find("beta") != copy.end());
+      assertUnit(copy.find(std::string(500, 'g')) != copy.end());
+      assertUnit(copy.find("alpha") == copy.end());
+      // teardown
+      removeAll(path);
+   }
+
+   /*************************************************************
+    * REMOVE ALL
+    * The files an incremental_snapshot makes
+    *************************************************************/
+   void removeAll(const std::string& path)
+   {
+      unlink((path + ".snap").c_str());
+      unlink((path + ".delta").c_str());
+   }
+};
+
+#else // !CUSTOM_SNAPSHOT_POSIX
+
+class TestIncrementalSnapshot : public UnitTest
+{
+public:
+   void run() {}
+};
+
+#endif // CUSTOM_SNAPSHOT_POSIX
+
+#endif // DEBUG
@@ -0,0 +1,306 @@
+/***********************************************************************
+ * Header:
+ *    TEST INDEXED HEAP
+ * Summary:
+ *    Unit tests for indexed_heap
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "indexed_heap.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+class TestIndexedHeap : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Insert
+      test_push_smallestOnTop();
+      test_push_duplicateKey();
+      test_push_indexMatches();
+
+      // Update
+      test_decreaseKey_toTop();
+      test_increaseKey_sinks();
+      test_update_stringKeys();
+
+      // Remove
+      test_pop_order();
+      test_erase_middle();
+      test_erase_missing();
+      test_erase_last();
+
+      // Use
+      test_dijkstra_shortestPaths();
+      test_random_indexConsistent();
+
+      report("IndexedHeap");
+   }
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the default keeps the smallest priority on top
+   void test_push_smallestOnTop()
+   {  // setup
+      custom::indexed_heap<int, int> h;
+      // exercise
+      h.push(1, 67);
+      h.push(2, 26);
+      h.push(3, 89);
+      // verify
+      assertUnit(h.size() == 3);
+      assertUnit(h.top_key() == 2);
+      assertUnit(h.top_priority() == 26);
+   }  // teardown
+
+   // a key is in the heap at most once
+   void test_push_duplicateKey()
+   {  // setup
+      custom::indexed_heap<int, int> h;
+      h.push(7, 49);
+      // exercise
+      bool added = h.push(7, 11);
+      // verify
+      assertUnit(!added);
+      assertUnit(h.size() == 1);
+      assertUnit(h.priority(7) == 49);
+   }  // teardown
+
+   // every key knows its slot
+   void test_push_indexMatches()
+   {  // setup
+      custom::indexed_heap<int, int> h;
+      // exercise
+      for (int i = 0; i < 50; i++)
+         h.push(i, (i * 17) % 50);
+      // verify
+      assertUnit(isConsistent(h));
+   }  // teardown
+
+   /***************************************
+    * UPDATE
+    ***************************************/
+
+   // a lower priority moves a key up, in place
+   void test_decreaseKey_toTop()
+   {  // setup
+      custom::indexed_heap<int, int> h;
+      for (int i = 0; i < 20; i++)
+         h.push(i, 100 + i);
+      // exercise
+      h.decrease_key(15, 5);
+      // verify
+      assertUnit(h.size() == 20);
+      assertUnit(h.top_key() == 15);
+      assertUnit(h.priority(15) == 5);
+      assertUnit(isConsistent(h));
+   }  // teardown
+
+   // a higher priority moves the top key down
+   void test_increaseKey_sinks()
+   {  // setup
+      custom::indexed_heap<int, int> h;
+      for (int i = 0; i < 20; i++)
+         h.push(i, i);
+      // exercise
+      h.increase_key(0, 1000);
+      // verify
+      assertUnit(h.top_key() == 1);
+      assertUnit(h.priority(0) == 1000);
+      assertUnit(isConsistent(h));
+   }  // teardown
+
+   // keys that are not integers
+   void test_update_stringKeys()
+   {  // setup
+      custom::indexed_heap<std::string, double> h;
+      h.push("timer a", 2.5);
+      h.push("timer b", 1.5);
+      h.push("timer c", 3.5);
+      // exercise
+      h.update("timer c", 0.5);
+      // verify
+      assertUnit(h.top_key() == "timer c");
+      assertUnit(h.contains("timer a"));
+      assertUnit(!h.contains("timer d"));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pops come out smallest first, and leave the index
+   void test_pop_order()
+   {  // setup
+      custom::indexed_heap<int, int> h;
+      for (int i = 0; i < 100; i++)
+         h.push(i, (i * 37) % 100);
+      // exercise
+      bool ok = true;
+      for (int expect = 0; expect < 100; expect++)
+      {
+         ok = ok && h.top_priority() == expect;
+         int key = h.top_key();
+         h.pop();
+         ok = ok && !h.contains(key);
+      }
+      // verify
+      assertUnit(ok);
+      assertUnit(h.empty());
+      assertUnit(h.index.size() == 0);
+   }  // teardown
+
+   // take a key out of the middle
+   void test_erase_middle()
+   {  // setup
+      custom::indexed_heap<int, int> h;
+      for (int i = 0; i < 30; i++)
+         h.push(i, 30 - i);
+      // exercise
+      bool erased = h.erase(12);
+      // verify
+      assertUnit(erased);
+      assertUnit(h.size() == 29);
+      assertUnit(!h.contains(12));
+      assertUnit(isConsistent(h));
+   }  // teardown
+
+   // nothing to take out
+   void test_erase_missing()
+   {  // setup
+      custom::indexed_heap<int, int> h;
+      h.push(1, 1);
+      // exercise
+      bool erased = h.erase(2);
+      // verify
+      assertUnit(!erased);
+      assertUnit(h.size() == 1);
+   }  // teardown
+
+   // the last slot needs no sift
+   void test_erase_last()
+   {  // setup
+      custom::indexed_heap<int, int> h;
+      h.push(1, 1);
+      h.push(2, 2);
+      // exercise
+      h.erase(2);
+      // verify
+      assertUnit(h.size() == 1);
+      assertUnit(h.top_key() == 1);
+      assertUnit(isConsistent(h));
+   }  // teardown
+
+   /***************************************
+    * USE
+    ***************************************/
+
+   // shortest paths with one heap entry per vertex
+   void test_dijkstra_shortestPaths()
+   {  // setup
+      //   0 -4-> 1 -1-> 3
+      //   0 -1-> 2 -2-> 1
+      //   2 -5-> 3
+      const int num = 4;
+      const int inf = 1000000;
+      int weight[num][num];
+      for (int i = 0; i < num; i++)
+         for (int j = 0; j < num; j++)
+            weight[i][j] = inf;
+      weight[0][1] = 4;
+      weight[0][2] = 1;
+      weight[2][1] = 2;
+      weight[1][3] = 1;
+      weight[2][3] = 5;
+      int dist[num] = { 0, inf, inf, inf };
+      custom::indexed_heap<int, int> h;
+      for (int v = 0; v < num; v++)
+         h.push(v, dist[v]);
+      size_t largest = 0;
+      // exercise
+      while (!h.empty())
+      {
+         int u = h.top_key();
+         h.pop();
+         for (int v = 0; v < num; v++)
+            if (weight[u][v] < inf && h.contains(v) && dist[u] + weight[u][v] < dist[v])
+            {
+               dist[v] = dist[u] + weight[u][v];
+               h.decrease_key(v, dist[v]);
+            }
+         largest = h.size() > largest ? h.size() : largest;
+      }
+      // verify
+      assertUnit(dist[1] == 3);
+      assertUnit(dist[2] == 1);
+      assertUnit(dist[3] == 4);
+      assertUnit(largest <= (size_t)num);
+   }  // teardown
+
+   // a long mix of operations keeps heap and index in step
+   void test_random_indexConsistent()
+   {  // setup
+      custom::indexed_heap<int, int, std::less<int>, std::hash<int>, 8> h;
+      uint32_t seed = 67;
+      // exercise
+      for (int i = 0; i < 3000; i++)
+      {
+         seed = seed * 1103515245u + 12345u;
+         int key = (int)((seed >> 16) % 200);
+         int priority = (int)((seed >> 4) % 1000);
+         switch (seed % 4)
+         {
+            case 0:
+            case 1:
+               if (!h.push(key, priority))
+                  h.update(key, priority);
+               break;
+            case 2:
+               h.erase(key);
+               break;
+            default:
+               if (!h.empty())
+                  h.pop();
+         }
+      }
+      // verify
+      assertUnit(isConsistent(h));
+   }  // teardown
+
+   /*************************************************************
+    * IS CONSISTENT
+    * The heap is ordered and every key's index entry
+    * points at its slot
+    *************************************************************/
+   template <typename K, typename P, typename C, typename H, size_t D>
+   bool isConsistent(custom::indexed_heap<K, P, C, H, D>& h)
+   {
+      if (h.index.size() != h.heap.size())
+         return false;
+      for (size_t i = 0; i < h.heap.size(); i++)
+      {
+         if (i > 0 && h.comp(h.heap[(i - 1) / D].priority, h.heap[i].priority))
+            return false;
+         if (h.where(h.heap[i].key) != i)
+            return false;
+      }
+      return true;
+   }
+};
+
+#endif // DEBUG
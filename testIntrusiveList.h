@@ -0,0 +1,286 @@
+/***********************************************************************
+ * Header:
+ *    TEST INTRUSIVE LIST
+ * Summary:
+ *    Unit tests for intrusive_list
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "intrusive_list.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+
+/***************************************
+ * JOB
+ * Something that waits in two queues at once
+ ***************************************/
+struct Job
+{
+   Job(int id = 0) : id(id) {}
+   int id;
+   Spy payload;
+   custom::list_hook byArrival;
+   custom::list_hook byPriority;
+};
+
+class TestIntrusiveList : public UnitTest
+{
+   typedef custom::intrusive_list<Job, &Job::byArrival>  ArrivalList;
+   typedef custom::intrusive_list<Job, &Job::byPriority> PriorityList;
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructMove_standard();
+
+      // Insert
+      test_pushBack_noCopies();
+      test_pushFront_standard();
+      test_insert_middle();
+      test_hook_copyIsUnlinked();
+
+      // Remove
+      test_erase_middle();
+      test_remove_object();
+      test_clear_unlinksAll();
+
+      // Use
+      test_twoLists_oneObject();
+      test_iterator_backwards();
+
+      report("IntrusiveList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // nothing linked
+   void test_construct_default()
+   {  // setup
+      // exercise
+      ArrivalList l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.size() == 0);
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // the objects change lists without moving
+   void test_constructMove_standard()
+   {  // setup
+      Job a(1), b(2);
+      ArrivalList src;
+      src.push_back(a);
+      src.push_back(b);
+      // exercise
+      ArrivalList dest(std::move(src));
+      // verify
+      assertUnit(src.empty());
+      assertUnit(dest.size() == 2);
+      assertUnit(&dest.front() == &a);
+      assertUnit(&dest.back() == &b);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // linking an object neither copies nor allocates
+   void test_pushBack_noCopies()
+   {  // setup
+      Job a(1), b(2), c(3);
+      ArrivalList l;
+      Spy::reset();
+      // exercise
+      l.push_back(a);
+      l.push_back(b);
+      l.push_back(c);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(l.size() == 3);
+      assertUnit(sequence(l, { 1, 2, 3 }));
+      assertUnit(a.byArrival.is_linked());
+      assertUnit(!a.byPriority.is_linked());
+   }  // teardown
+
+   // push front puts the newest first
+   void test_pushFront_standard()
+   {  // setup
+      Job a(1), b(2);
+      ArrivalList l;
+      // exercise
+      l.push_front(b);
+      l.push_front(a);
+      // verify
+      assertUnit(sequence(l, { 1, 2 }));
+      assertUnit(l.pHead == &a.byArrival);
+      assertUnit(l.pTail == &b.byArrival);
+   }  // teardown
+
+   // in front of an iterator
+   void test_insert_middle()
+   {  // setup
+      Job a(1), b(2), c(3);
+      ArrivalList l;
+      l.push_back(a);
+      l.push_back(c);
+      // exercise
+      ArrivalList::iterator it = l.insert(l.iterator_to(c), b);
+      // verify
+      assertUnit(&*it == &b);
+      assertUnit(sequence(l, { 1, 2, 3 }));
+   }  // teardown
+
+   // a copy of a linked object is not in the list
+   void test_hook_copyIsUnlinked()
+   {  // setup
+      Job a(1);
+      ArrivalList l;
+      l.push_back(a);
+      // exercise
+      Job copy(a);
+      // verify
+      assertUnit(a.byArrival.is_linked());
+      assertUnit(!copy.byArrival.is_linked());
+      assertUnit(l.size() == 1);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // the object survives its removal
+   void test_erase_middle()
+   {  // setup
+      Job a(1), b(2), c(3);
+      ArrivalList l;
+      l.push_back(a);
+      l.push_back(b);
+      l.push_back(c);
+      Spy::reset();
+      // exercise
+      ArrivalList::iterator it = l.erase(l.iterator_to(b));
+      // verify
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(&*it == &c);
+      assertUnit(!b.byArrival.is_linked());
+      assertUnit(sequence(l, { 1, 3 }));
+   }  // teardown
+
+   // remove by object, from either end
+   void test_remove_object()
+   {  // setup
+      Job a(1), b(2), c(3);
+      ArrivalList l;
+      l.push_back(a);
+      l.push_back(b);
+      l.push_back(c);
+      // exercise
+      l.remove(a);
+      l.remove(c);
+      // verify
+      assertUnit(l.size() == 1);
+      assertUnit(l.pHead == &b.byArrival);
+      assertUnit(l.pTail == &b.byArrival);
+      assertUnit(b.byArrival.pPrev == nullptr);
+      assertUnit(b.byArrival.pNext == nullptr);
+   }  // teardown
+
+   // clear leaves every object free to join again
+   void test_clear_unlinksAll()
+   {  // setup
+      Job a(1), b(2);
+      ArrivalList l;
+      l.push_back(a);
+      l.push_back(b);
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(l.empty());
+      assertUnit(!a.byArrival.is_linked());
+      assertUnit(!b.byArrival.is_linked());
+      l.push_back(b);
+      assertUnit(sequence(l, { 2 }));
+   }  // teardown
+
+   /***************************************
+    * USE
+    ***************************************/
+
+   // the same objects in two orders at once
+   void test_twoLists_oneObject()
+   {  // setup
+      Job a(1), b(2), c(3);
+      ArrivalList arrival;
+      PriorityList priority;
+      // exercise
+      arrival.push_back(a);
+      arrival.push_back(b);
+      arrival.push_back(c);
+      priority.push_back(c);
+      priority.push_back(a);
+      priority.push_back(b);
+      arrival.remove(b);
+      // verify
+      assertUnit(sequence(arrival, { 1, 3 }));
+      int expect[] = { 3, 1, 2 };
+      bool same = priority.size() == 3;
+      int i = 0;
+      for (PriorityList::iterator it = priority.begin(); same && it != priority.end(); ++it)
+         same = (*it).id == expect[i++];
+      assertUnit(same);
+      assertUnit(b.byPriority.is_linked());
+   }  // teardown
+
+   // walk back from the last object
+   void test_iterator_backwards()
+   {  // setup
+      Job jobs[5] = { 0, 1, 2, 3, 4 };
+      ArrivalList l;
+      for (int i = 0; i < 5; i++)
+         l.push_back(jobs[i]);
+      // exercise
+      int expect = 4;
+      bool ok = true;
+      for (ArrivalList::iterator it = l.rbegin(); it != l.end(); --it)
+         ok = ok && (*it).id == expect--;
+      // verify
+      assertUnit(ok);
+      assertUnit(expect == -1);
+      l.clear();
+   }  // teardown
+
+   /*************************************************************
+    * SEQUENCE
+    * Does the list hold the jobs with exactly these ids?
+    *************************************************************/
+   bool sequence(ArrivalList& l, const std::initializer_list<int>& il)
+   {
+      if (l.size() != il.size())
+         return false;
+      ArrivalList::iterator it = l.begin();
+      for (int id : il)
+      {
+         if (it == l.end() || (*it).id != id)
+            return false;
+         ++it;
+      }
+      return it == l.end();
+   }
+};
+
+#endif // DEBUG
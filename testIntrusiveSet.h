@@ -0,0 +1,294 @@
+/***********************************************************************
+ * Header:
+ *    TEST INTRUSIVE SET
+ * Summary:
+ *    Unit tests for intrusive_unordered_set
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "intrusive_set.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <functional>
+#include <string>
+
+/***************************************
+ * CONNECTION
+ * Something indexed by two different keys
+ ***************************************/
+struct Connection
+{
+   Connection(int id = 0, const std::string& peer = "") : id(id), peer(peer) {}
+   int id;
+   std::string peer;
+   Spy payload;
+   custom::set_hook byId;
+   custom::set_hook byPeer;
+};
+
+struct ConnectionId
+{
+   size_t operator () (const Connection& c) const { return std::hash<int>()(c.id); }
+   size_t operator () (int id) const              { return std::hash<int>()(id); }
+   bool operator () (const Connection& a, const Connection& b) const { return a.id == b.id; }
+   bool operator () (int id, const Connection& c) const              { return id == c.id; }
+};
+
+struct ConnectionPeer
+{
+   size_t operator () (const Connection& c) const { return std::hash<std::string>()(c.peer); }
+   bool operator () (const Connection& a, const Connection& b) const { return a.peer == b.peer; }
+};
+
+class TestIntrusiveSet : public UnitTest
+{
+   typedef custom::intrusive_unordered_set<Connection, &Connection::byId, ConnectionId, ConnectionId> IdSet;
+   typedef custom::intrusive_unordered_set<Connection, &Connection::byPeer, ConnectionPeer, ConnectionPeer> PeerSet;
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructMove_standard();
+
+      // Insert
+      test_insert_noCopies();
+      test_insert_duplicate();
+      test_insert_rehashKeepsAll();
+
+      // Access
+      test_find_byKey();
+      test_find_missing();
+
+      // Remove
+      test_erase_object();
+      test_erase_iteratorReturnsNext();
+      test_clear_unlinksAll();
+
+      // Use
+      test_twoSets_oneObject();
+
+      report("IntrusiveSet");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // eight empty buckets
+   void test_construct_default()
+   {  // setup
+      // exercise
+      IdSet s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.bucket_count() == 8);
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // the objects change sets without moving
+   void test_constructMove_standard()
+   {  // setup
+      Connection a(1), b(2);
+      IdSet src;
+      src.insert(a);
+      src.insert(b);
+      // exercise
+      IdSet dest(std::move(src));
+      // verify
+      assertUnit(dest.size() == 2);
+      assertUnit(&*dest.find(a) == &a);
+      assertUnit(src.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // indexing an object neither copies nor allocates it
+   void test_insert_noCopies()
+   {  // setup
+      Connection a(26), b(49), c(67);
+      IdSet s;
+      Spy::reset();
+      // exercise
+      custom::pair<IdSet::iterator, bool> p = s.insert(a);
+      s.insert(b);
+      s.insert(c);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(p.second);
+      assertUnit(&*p.first == &a);
+      assertUnit(s.size() == 3);
+      assertUnit(a.byId.is_linked());
+      assertUnit(!a.byPeer.is_linked());
+   }  // teardown
+
+   // an equal object is already there
+   void test_insert_duplicate()
+   {  // setup
+      Connection a(26), twin(26);
+      IdSet s;
+      s.insert(a);
+      // exercise
+      custom::pair<IdSet::iterator, bool> p = s.insert(twin);
+      // verify
+      assertUnit(!p.second);
+      assertUnit(&*p.first == &a);
+      assertUnit(!twin.byId.is_linked());
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   // growing the buckets relinks every hook
+   void test_insert_rehashKeepsAll()
+   {  // setup
+      Connection connections[100];
+      for (int i = 0; i < 100; i++)
+         connections[i].id = i;
+      IdSet s;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         s.insert(connections[i]);
+      // verify
+      assertUnit(s.size() == 100);
+      assertUnit(s.bucket_count() >= 100);
+      bool all = true;
+      for (int i = 0; i < 100; i++)
+         all = all && &*s.find(connections[i]) == &connections[i];
+      assertUnit(all);
+      size_t count = 0;
+      for (IdSet::iterator it = s.begin(); it != s.end(); ++it)
+         count++;
+      assertUnit(count == 100);
+      s.clear();
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // look up with the bare key, no probe object
+   void test_find_byKey()
+   {  // setup
+      Connection a(26, "alpha"), b(49, "beta");
+      IdSet s;
+      s.insert(a);
+      s.insert(b);
+      // exercise
+      IdSet::iterator it = s.find(49, ConnectionId(), ConnectionId());
+      // verify
+      assertUnit(it != s.end());
+      assertUnit((*it).peer == "beta");
+   }  // teardown
+
+   // nothing to find
+   void test_find_missing()
+   {  // setup
+      Connection a(26);
+      IdSet s;
+      s.insert(a);
+      // exercise
+      IdSet::iterator it = s.find(11, ConnectionId(), ConnectionId());
+      // verify
+      assertUnit(it == s.end());
+      assertUnit(!s.contains(Connection(11)));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // the object leaves the set and survives
+   void test_erase_object()
+   {  // setup
+      Connection a(26), b(49);
+      IdSet s;
+      s.insert(a);
+      s.insert(b);
+      Spy::reset();
+      // exercise
+      bool erased = s.erase(a);
+      bool again = s.erase(a);
+      // verify
+      assertUnit(erased);
+      assertUnit(!again);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(!a.byId.is_linked());
+      assertUnit(s.size() == 1);
+      assertUnit(!s.contains(a));
+   }  // teardown
+
+   // erase while walking visits everything once
+   void test_erase_iteratorReturnsNext()
+   {  // setup
+      Connection connections[20];
+      for (int i = 0; i < 20; i++)
+         connections[i].id = i;
+      IdSet s(4);
+      for (int i = 0; i < 20; i++)
+         s.insert(connections[i]);
+      // exercise
+      size_t count = 0;
+      for (IdSet::iterator it = s.begin(); it != s.end(); count++)
+         it = s.erase(it);
+      // verify
+      assertUnit(count == 20);
+      assertUnit(s.empty());
+   }  // teardown
+
+   // clear leaves every object free to join again
+   void test_clear_unlinksAll()
+   {  // setup
+      Connection a(26), b(49);
+      IdSet s;
+      s.insert(a);
+      s.insert(b);
+      // exercise
+      s.clear();
+      // verify
+      assertUnit(s.empty());
+      assertUnit(!a.byId.is_linked());
+      assertUnit(!b.byId.is_linked());
+      assertUnit(s.insert(a).second);
+   }  // teardown
+
+   /***************************************
+    * USE
+    ***************************************/
+
+   // one object found through two keys
+   void test_twoSets_oneObject()
+   {  // setup
+      Connection a(26, "alpha"), b(49, "beta");
+      IdSet byId;
+      PeerSet byPeer;
+      Spy::reset();
+      // exercise
+      byId.insert(a);
+      byId.insert(b);
+      byPeer.insert(a);
+      byPeer.insert(b);
+      byId.erase(b);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(byId.size() == 1);
+      assertUnit(byPeer.size() == 2);
+      assertUnit(&*byPeer.find(Connection(0, "beta")) == &b);
+      assertUnit(&*byId.find(26, ConnectionId(), ConnectionId()) == &a);
+   }  // teardown
+};
+
+#endif // DEBUG
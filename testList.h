@@ -15,8 +15,10 @@
 #include <list>
 #include "unitTest.h"
 #include "spy.h"
+#include "pair.h"
 
 #include <vector>
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <iostream>
@@ -121,6 +123,27 @@ public:
       test_empty_empty();
       test_empty_three();
 
+      // Relink
+      test_splice_whole();
+      test_splice_oneSameList();
+      test_splice_oneOtherTail();
+      test_splice_oneOtherOnly();
+      test_splice_range();
+      test_splice_rangeCounted();
+      test_merge_standard();
+      test_merge_stable();
+      test_sort_random();
+      test_sort_spy();
+      test_sort_stable();
+      test_unique_standard();
+      test_reverse_standard();
+
+      // Bulk
+      test_construct_bulkAdjacent();
+      test_constructCopy_bulkAdjacent();
+      test_constructRange_bulkUnknownLength();
+      test_assign_bulkTail();
+
       report("List");
    }
 
@@ -3119,6 +3142,391 @@ public:
       teardownStandardFixture(l);
    }
 
+   /***************************************
+    * RELINK
+    ***************************************/
+
+   // all of one list moves into the middle of another
+   void test_splice_whole()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //                  pos
+      custom::list<Spy> l;
+      setupStandardFixture(l);
+      custom::list<Spy> rhs;
+      rhs.push_back(Spy(99));
+      rhs.push_back(Spy(88));
+      Spy::reset();
+      // exercise
+      l.splice(custom::list<Spy>::iterator(l.pHead->pNext), rhs);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(rhs.empty());
+      assertUnit(rhs.pHead == nullptr);
+      assertUnit(rhs.pTail == nullptr);
+      assertUnit(l.size() == 5);
+      assertUnit(sequence(l, { 11, 99, 88, 26, 31 }));
+      assertUnit(linked(l));
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // one node moves to the front of its own list
+   void test_splice_oneSameList()
+   {  // setup
+      custom::list<Spy> l;
+      setupStandardFixture(l);
+      Spy::reset();
+      // exercise
+      l.splice(l.begin(), l, custom::list<Spy>::iterator(l.pTail));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(l.size() == 3);
+      assertUnit(sequence(l, { 31, 11, 26 }));
+      assertUnit(linked(l));
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // the tail of another list moves to the end
+   void test_splice_oneOtherTail()
+   {  // setup
+      custom::list<Spy> l;
+      setupStandardFixture(l);
+      custom::list<Spy> rhs;
+      rhs.push_back(Spy(99));
+      rhs.push_back(Spy(88));
+      Spy::reset();
+      // exercise
+      l.splice(l.end(), rhs, custom::list<Spy>::iterator(rhs.pTail));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(l.size() == 4);
+      assertUnit(rhs.size() == 1);
+      assertUnit(sequence(l, { 11, 26, 31, 88 }));
+      assertUnit(sequence(rhs, { 99 }));
+      assertUnit(linked(l));
+      assertUnit(linked(rhs));
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // the only node of another list moves into an empty list
+   void test_splice_oneOtherOnly()
+   {  // setup
+      custom::list<Spy> l;
+      custom::list<Spy> rhs;
+      rhs.push_back(Spy(5));
+      // exercise
+      l.splice(l.end(), rhs, rhs.begin());
+      // verify
+      assertUnit(l.size() == 1);
+      assertUnit(rhs.empty());
+      assertUnit(rhs.pHead == nullptr);
+      assertUnit(rhs.pTail == nullptr);
+      assertUnit(sequence(l, { 5 }));
+      assertUnit(linked(l));
+   }  // teardown
+
+   // a range moves across, the sizes follow
+   void test_splice_range()
+   {  // setup
+      custom::list<Spy> l;
+      custom::list<Spy> rhs;
+      setupStandardFixture(rhs);
+      custom::list<Spy>::iterator first(rhs.pHead->pNext);
+      // exercise
+      l.splice(l.end(), rhs, first, rhs.end());
+      // verify
+      assertUnit(l.size() == 2);
+      assertUnit(rhs.size() == 1);
+      assertUnit(sequence(l, { 26, 31 }));
+      assertUnit(sequence(rhs, { 11 }));
+      assertUnit(rhs.pTail == rhs.pHead);
+      assertUnit(linked(l));
+      assertUnit(linked(rhs));
+      // teardown
+      l.splice(l.begin(), rhs);
+      teardownStandardFixture(l);
+   }
+
+   // a range whose size the caller already knows
+   void test_splice_rangeCounted()
+   {  // setup
+      custom::list<int> l{ 1, 5 };
+      custom::list<int> rhs{ 2, 3, 4 };
+      // exercise
+      l.splice(custom::list<int>::iterator(l.pTail), rhs, rhs.begin(), rhs.end(), 3);
+      // verify
+      assertUnit(l.size() == 5);
+      assertUnit(rhs.size() == 0);
+      assertUnit(rhs.empty());
+      assertUnit(sequence(l, { 1, 2, 3, 4, 5 }));
+      assertUnit(linked(l));
+   }  // teardown
+
+   // two sorted lists become one, nothing copied
+   void test_merge_standard()
+   {  // setup
+      custom::list<Spy> l;
+      setupStandardFixture(l);
+      custom::list<Spy> rhs;
+      rhs.push_back(Spy(5));
+      rhs.push_back(Spy(26));
+      rhs.push_back(Spy(49));
+      Spy::reset();
+      // exercise
+      l.merge(rhs);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(rhs.empty());
+      assertUnit(l.size() == 6);
+      assertUnit(sequence(l, { 5, 11, 26, 26, 31, 49 }));
+      assertUnit(linked(l));
+      // teardown
+      while (l.size() > 3)
+         l.pop_back();
+      teardownStandardFixture(l);
+   }
+
+   // equal elements keep this list's first
+   void test_merge_stable()
+   {  // setup
+      custom::list<custom::pair<int, int>> l{ { 1, 0 }, { 2, 0 } };
+      custom::list<custom::pair<int, int>> rhs{ { 1, 1 }, { 3, 1 } };
+      // exercise
+      l.merge(rhs);
+      // verify
+      custom::list<custom::pair<int, int>>::iterator it = l.begin();
+      assertUnit((*it).first == 1 && (*it).second == 0);
+      ++it;
+      assertUnit((*it).first == 1 && (*it).second == 1);
+      assertUnit(l.back().first == 3);
+   }  // teardown
+
+   // a large shuffled list sorts the same as std::sort
+   void test_sort_random()
+   {  // setup
+      custom::list<int> l;
+      std::vector<int> expect;
+      unsigned seed = 31;
+      for (int i = 0; i < 1000; i++)
+      {
+         seed = seed * 1103515245u + 12345u;
+         l.push_back((int)((seed >> 8) % 500));
+         expect.push_back(l.back());
+      }
+      std::sort(expect.begin(), expect.end());
+      // exercise
+      l.sort();
+      // verify
+      bool same = l.size() == expect.size();
+      custom::list<int>::iterator it = l.begin();
+      for (size_t i = 0; same && i < expect.size(); i++, ++it)
+         same = *it == expect[i];
+      assertUnit(same);
+      assertUnit(linked(l));
+   }  // teardown
+
+   // sorting relinks, it does not move elements
+   void test_sort_spy()
+   {  // setup
+      custom::list<Spy> l;
+      setupStandardFixture(l);
+      l.reverse();
+      Spy::reset();
+      // exercise
+      l.sort();
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // equal elements stay in their original order
+   void test_sort_stable()
+   {  // setup
+      custom::list<custom::pair<int, int>> l{ { 2, 0 }, { 1, 1 }, { 2, 2 }, { 1, 3 }, { 0, 4 } };
+      // exercise
+      l.sort();
+      // verify
+      int expect[] = { 4, 1, 3, 0, 2 };
+      bool same = true;
+      int i = 0;
+      for (custom::list<custom::pair<int, int>>::iterator it = l.begin(); it != l.end(); ++it)
+         same = same && (*it).second == expect[i++];
+      assertUnit(same);
+   }  // teardown
+
+   // runs of duplicates collapse to one
+   void test_unique_standard()
+   {  // setup
+      custom::list<int> l{ 1, 1, 2, 3, 3, 3, 1 };
+      // exercise
+      size_t numRemoved = l.unique();
+      // verify
+      assertUnit(numRemoved == 3);
+      assertUnit(sequence(l, { 1, 2, 3, 1 }));
+      assertUnit(linked(l));
+   }  // teardown
+
+   // back to front, twice is the identity
+   void test_reverse_standard()
+   {  // setup
+      custom::list<Spy> l;
+      setupStandardFixture(l);
+      // exercise
+      l.reverse();
+      // verify
+      assertUnit(sequence(l, { 31, 26, 11 }));
+      assertUnit(linked(l));
+      l.reverse();
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   /***************************************
+    * BULK
+    ***************************************/
+
+   // a list built in one go has its nodes side by side
+   void test_construct_bulkAdjacent()
+   {  // setup
+      // exercise
+      custom::list<int> l((size_t)200, 7);
+      // verify
+      assertUnit(l.size() == 200);
+      assertUnit(linked(l));
+      assertUnit(adjacent(l) >= 190);
+   }  // teardown
+
+   // so does a copy, even of a scattered list
+   void test_constructCopy_bulkAdjacent()
+   {  // setup
+      custom::list<int> src;
+      custom::list<double> spacer;
+      for (int i = 0; i < 200; i++)
+      {
+         src.push_front(i);
+         spacer.push_back(i);
+      }
+      // exercise
+      custom::list<int> dest(src);
+      // verify
+      assertUnit(dest.size() == 200);
+      assertUnit(dest.front() == 199);
+      assertUnit(dest.back() == 0);
+      assertUnit(linked(dest));
+      assertUnit(adjacent(dest) >= 190);
+   }  // teardown
+
+   // a range of unknown length takes what it needs
+   void test_constructRange_bulkUnknownLength()
+   {  // setup
+      std::list<int> src;
+      for (int i = 0; i < 100; i++)
+         src.push_back(i);
+      // exercise
+      custom::list<int> l(src.begin(), src.end());
+      custom::list<int> small(src.begin(), ++src.begin());
+      // verify
+      assertUnit(l.size() == 100);
+      assertUnit(l.back() == 99);
+      assertUnit(linked(l));
+      assertUnit(small.size() == 1);
+      assertUnit(linked(small));
+   }  // teardown
+
+   // the part of rhs past the end of lhs is copied in bulk
+   void test_assign_bulkTail()
+   {  // setup
+      custom::list<Spy> lhs;
+      lhs.push_back(Spy(1));
+      custom::list<Spy> rhs;
+      for (int i = 0; i < 100; i++)
+         rhs.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      lhs = rhs;
+      // verify
+      assertUnit(Spy::numAssign() == 1);
+      assertUnit(Spy::numCopy() == 99);
+      assertUnit(Spy::numAlloc() == 99);
+      assertUnit(lhs.size() == 100);
+      assertUnit(lhs.back() == Spy(99));
+      assertUnit(linked(lhs));
+   }  // teardown
+
+   /****************************************************************
+    * ADJACENT
+    * How many nodes sit right after the node in front of them?
+    ****************************************************************/
+   template <typename T>
+   size_t adjacent(custom::list<T>& l)
+   {
+      size_t num = 0;
+      for (typename custom::list<T>::Node* p = l.pHead; p && p->pNext; p = p->pNext)
+         if ((char*)p->pNext - (char*)p == (ptrdiff_t)sizeof(*p))
+            num++;
+      return num;
+   }
+
+   /****************************************************************
+    * SEQUENCE
+    * Does the list hold exactly these values?
+    ****************************************************************/
+   template <typename T>
+   bool sequence(custom::list<T>& l, const std::initializer_list<int>& il)
+   {
+      if (l.size() != il.size())
+         return false;
+      typename custom::list<T>::iterator it = l.begin();
+      for (int value : il)
+      {
+         if (it == l.end() || !(*it == T(value)))
+            return false;
+         ++it;
+      }
+      return it == l.end();
+   }
+
+   /****************************************************************
+    * LINKED
+    * Do the pNext and pPrev chains agree with each
+    * other, with pHead and pTail, and with the size?
+    ****************************************************************/
+   template <typename T>
+   bool linked(custom::list<T>& l)
+   {
+      size_t num = 0;
+      typename custom::list<T>::Node* pPrev = nullptr;
+      for (typename custom::list<T>::Node* p = l.pHead; p; p = p->pNext)
+      {
+         if (p->pPrev != pPrev)
+            return false;
+         pPrev = p;
+         num++;
+      }
+      return pPrev == l.pTail && num == l.numElements;
+   }
+
    /****************************************************************
     * Setup Standard Fixture
     *        pHead             pTail
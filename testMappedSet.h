@@ -0,0 +1,321 @@
+/***********************************************************************
+ * Header:
+ *    TEST MAPPED SET
+ * Summary:
+ *    Unit tests for mapped_unordered_set
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "mapped_set.h"
+#include "unitTest.h"
+
+#ifdef CUSTOM_MAPPED_POSIX
+
+#include "hash.h"
+
+#include <cstdint>
+#include <string>
+#include <unistd.h>
+
+class TestMappedSet : public UnitTest
+{
+   typedef custom::mapped_unordered_set<int> MappedSet;
+
+public:
+   void run()
+   {
+      reset();
+
+      // File
+      test_create_fromHash();
+      test_create_fromArray();
+      test_create_empty();
+      test_create_replacesOpenFile();
+      test_open_inPlace();
+      test_open_notOurs();
+      test_open_wrongElementSize();
+      test_open_truncated();
+      test_open_offsetOutOfRange();
+
+      // Construct
+      test_constructMove_standard();
+
+      // Access
+      test_find_missing();
+      test_bucket_holdsItsOwn();
+
+      report("MappedSet");
+   }
+
+   /***************************************
+    * FILE
+    ***************************************/
+
+   // every element of a hash can be found in the file
+   void test_create_fromHash()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us;
+      for (int i = 0; i < 5000; i++)
+         us.insert(i * 7);
+      // exercise
+      bool created = MappedSet::create(path.c_str(), us.begin(), us.end());
+      MappedSet ms(path.c_str());
+      // verify
+      assertUnit(created);
+      assertUnit(ms.is_open());
+      assertUnit(ms.size() == 5000);
+      assertUnit(ms.bucket_count() == 5000);
+      bool all = true;
+      for (int i = 0; i < 5000; i++)
+         all = all && ms.contains(i * 7);
+      assertUnit(all);
+      // teardown
+      ms.close();
+      unlink(path.c_str());
+   }
+
+   // any range will do
+   void test_create_fromArray()
+   {  // setup
+      std::string path = tempPath();
+      int values[] = { 26, 49, 67, 11, 89 };
+      // exercise
+      MappedSet::create(path.c_str(), values, values + 5);
+      MappedSet ms(path.c_str());
+      // verify
+      assertUnit(ms.size() == 5);
+      assertUnit(*ms.find(67) == 67);
+      size_t count = 0;
+      for (MappedSet::iterator it = ms.begin(); it != ms.end(); ++it)
+         count++;
+      assertUnit(count == 5);
+      // teardown
+      ms.close();
+      unlink(path.c_str());
+   }
+
+   // one empty bucket
+   void test_create_empty()
+   {  // setup
+      std::string path = tempPath();
+      int* none = nullptr;
+      // exercise
+      bool created = MappedSet::create(path.c_str(), none, none);
+      MappedSet ms(path.c_str());
+      // verify
+      assertUnit(created);
+      assertUnit(ms.is_open());
+      assertUnit(ms.empty());
+      assertUnit(ms.bucket_count() == 1);
+      assertUnit(!ms.contains(26));
+      // teardown
+      ms.close();
+      unlink(path.c_str());
+   }
+
+   // a reader of the old file keeps the old file
+   void test_create_replacesOpenFile()
+   {  // setup
+      std::string path = tempPath();
+      int oldValues[] = { 26, 49 };
+      int newValues[] = { 67, 89, 11 };
+      MappedSet::create(path.c_str(), oldValues, oldValues + 2);
+      MappedSet oldSet(path.c_str());
+      // exercise
+      bool created = MappedSet::create(path.c_str(), newValues, newValues + 3);
+      MappedSet newSet(path.c_str());
+      // verify
+      assertUnit(created);
+      assertUnit(oldSet.size() == 2);
+      assertUnit(oldSet.contains(49));
+      assertUnit(newSet.size() == 3);
+      assertUnit(!newSet.contains(49));
+      assertUnit(access((path + ".tmp").c_str(), F_OK) != 0);
+      // teardown
+      oldSet.close();
+      newSet.close();
+      unlink(path.c_str());
+   }
+
+   // find() reads the mapping itself, nothing was copied out
+   void test_open_inPlace()
+   {  // setup
+      std::string path = tempPath();
+      int values[] = { 26, 49, 67 };
+      MappedSet::create(path.c_str(), values, values + 3);
+      // exercise
+      MappedSet ms(path.c_str());
+      // verify
+      const unsigned char* pStart = (const unsigned char*)ms.pHeader;
+      const unsigned char* pFound = (const unsigned char*)ms.find(49);
+      assertUnit(pFound >= pStart + MappedSet::slotsOffset(3));
+      assertUnit(pFound < pStart + ms.numBytes);
+      assertUnit((const unsigned char*)ms.offsets == pStart + MappedSet::headerBytes);
+      // teardown
+      ms.close();
+      unlink(path.c_str());
+   }
+
+   // some other file
+   void test_open_notOurs()
+   {  // setup
+      std::string path = tempPath();
+      custom::unordered_set<int> us;
+      us.insert(26);
+      int fd = ::open(path.c_str(), O_WRONLY);
+      us.save(fd);
+      ::close(fd);
+      MappedSet ms;
+      // exercise
+      bool opened = ms.open(path.c_str());
+      // verify
+      assertUnit(!opened);
+      assertUnit(!ms.is_open());
+      assertUnit(ms.size() == 0);
+      assertUnit(!ms.contains(26));
+      // teardown
+      unlink(path.c_str());
+   }
+
+   // written with a different T
+   void test_open_wrongElementSize()
+   {  // setup
+      std::string path = tempPath();
+      uint64_t values[] = { 26, 49 };
+      custom::mapped_unordered_set<uint64_t>::create(path.c_str(), values, values + 2);
+      MappedSet ms;
+      // exercise
+      bool opened = ms.open(path.c_str());
+      // verify
+      assertUnit(!opened);
+      assertUnit(!ms.is_open());
+      // teardown
+      unlink(path.c_str());
+   }
+
+   // the file is shorter than its header says
+   void test_open_truncated()
+   {  // setup
+      std::string path = tempPath();
+      int values[] = { 26, 49, 67, 11, 89, 31, 59, 7 };
+      MappedSet::create(path.c_str(), values, values + 8);
+      truncate(path.c_str(), (off_t)MappedSet::slotsOffset(8) + 2 * sizeof(int));
+      MappedSet ms;
+      // exercise
+      bool opened = ms.open(path.c_str());
+      // verify
+      assertUnit(!opened);
+      assertUnit(!ms.is_open());
+      // teardown
+      unlink(path.c_str());
+   }
+
+   // a damaged bucket offset points past the slots
+   void test_open_offsetOutOfRange()
+   {  // setup
+      std::string path = tempPath();
+      int values[] = { 26, 49, 67, 11, 89, 31, 59, 7 };
+      MappedSet::create(path.c_str(), values, values + 8);
+      std::string bytes = readFile(path);
+      uint64_t offset = 1000000;
+      bytes.replace(MappedSet::headerBytes + sizeof(uint64_t), sizeof(offset),
+                    (const char*)&offset, sizeof(offset));
+      writeFile(path, bytes);
+      MappedSet ms;
+      // exercise
+      bool opened = ms.open(path.c_str());
+      // verify
+      assertUnit(!opened);
+      assertUnit(!ms.is_open());
+      // teardown
+      unlink(path.c_str());
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // the mapping changes hands
+   void test_constructMove_standard()
+   {  // setup
+      std::string path = tempPath();
+      int values[] = { 26, 49, 67 };
+      MappedSet::create(path.c_str(), values, values + 3);
+      MappedSet src(path.c_str());
+      // exercise
+      MappedSet dest(std::move(src));
+      // verify
+      assertUnit(!src.is_open());
+      assertUnit(dest.size() == 3);
+      assertUnit(dest.contains(26));
+      // teardown
+      dest.close();
+      unlink(path.c_str());
+   }
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // nothing to find, and no file at all
+   void test_find_missing()
+   {  // setup
+      std::string path = tempPath();
+      int values[] = { 26, 49, 67 };
+      MappedSet::create(path.c_str(), values, values + 3);
+      MappedSet ms(path.c_str());
+      MappedSet closed;
+      // exercise
+      MappedSet::iterator it = ms.find(11);
+      // verify
+      assertUnit(it == ms.end());
+      assertUnit(closed.find(11) == closed.end());
+      // teardown
+      ms.close();
+      unlink(path.c_str());
+   }
+
+   // each bucket holds exactly the elements that hash to it
+   void test_bucket_holdsItsOwn()
+   {  // setup
+      std::string path = tempPath();
+      int values[100];
+      for (int i = 0; i < 100; i++)
+         values[i] = i * 31;
+      MappedSet::create(path.c_str(), values, values + 100);
+      // exercise
+      MappedSet ms(path.c_str());
+      // verify
+      bool own = true;
+      size_t total = 0;
+      for (size_t i = 0; i < ms.bucket_count(); i++)
+      {
+         for (MappedSet::iterator it = ms.begin(i); it != ms.end(i); ++it)
+            own = own && ms.bucket(*it) == i;
+         total += ms.bucket_size(i);
+      }
+      assertUnit(own);
+      assertUnit(total == 100);
+      // teardown
+      ms.close();
+      unlink(path.c_str());
+   }
+};
+
+#else // !CUSTOM_MAPPED_POSIX
+
+class TestMappedSet : public UnitTest
+{
+public:
+   void run() {}
+};
+
+#endif // CUSTOM_MAPPED_POSIX
+
+#endif // DEBUG
@@ -0,0 +1,349 @@
+/***********************************************************************
+ * Header:
+ *    TEST MAPPED VECTOR
+ * Summary:
+ *    Unit tests for mapped_vector
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "mapped_vector.h"
+#include "unitTest.h"
+
+#ifdef CUSTOM_MAPPED_POSIX
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+class TestMappedVector : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // File
+      test_open_newFile();
+      test_open_reopenZeroCopy();
+      test_open_wrongElementSize();
+      test_open_notOurs();
+      test_sync_open();
+      test_sync_closed();
+
+      // Construct
+      test_constructMove_standard();
+
+      // Insert
+      test_pushBack_growsFile();
+      test_pushBack_selfReference();
+      test_pushBack_headerOnly();
+      test_resize_fill();
+      test_iterator_survivesGrowth();
+
+      // Remove
+      test_popBack_persisted();
+      test_shrinkToFit_trimsFile();
+
+      report("MappedVector");
+   }
+
+   /***************************************
+    * FILE
+    ***************************************/
+
+   // an empty file gets a header and one page
+   void test_open_newFile()
+   {  // setup
+      std::string path = tempPath();
+      // exercise
+      custom::mapped_vector<int> v(path.c_str());
+      // verify
+      assertUnit(v.is_open());
+      assertUnit(v.size() == 0);
+      assertUnit(v.capacity() > 0);
+      assertUnit(v.pHeader->elementSize == sizeof(int));
+      assertUnit(v.numBytes % (size_t)sysconf(_SC_PAGESIZE) == 0);
+      // teardown
+      v.close();
+      unlink(path.c_str());
+   }
+
+   // reopening maps the old elements in place
+   void test_open_reopenZeroCopy()
+   {  // setup
+      std::string path = tempPath();
+      {
+         custom::mapped_vector<uint64_t> v(path.c_str());
+         for (uint64_t i = 0; i < 5000; i++)
+            v.push_back(i * 3);
+         assertUnit(v.sync());
+      }
+      // exercise
+      custom::mapped_vector<uint64_t> v(path.c_str());
+      // verify
+      assertUnit(v.is_open());
+      assertUnit(v.size() == 5000);
+      assertUnit(v[0] == 0);
+      assertUnit(v[4999] == 14997);
+      assertUnit((unsigned char*)&v[0] == (unsigned char*)v.pHeader + 64);
+      // teardown
+      v.close();
+      unlink(path.c_str());
+   }
+
+   // a file of doubles will not open as a file of chars
+   void test_open_wrongElementSize()
+   {  // setup
+      std::string path = tempPath();
+      {
+         custom::mapped_vector<double> v(path.c_str());
+         v.push_back(2.6);
+      }
+      // exercise
+      custom::mapped_vector<char> v(path.c_str());
+      // verify
+      assertUnit(!v.is_open());
+      assertUnit(v.size() == 0);
+      // teardown
+      unlink(path.c_str());
+   }
+
+   // a file we did not write is refused
+   void test_open_notOurs()
+   {  // setup
+      std::string path = tempPath();
+      FILE* f = fopen(path.c_str(), "w");
+      fputs("this is not a mapped vector, it is just some text", f);
+      fputs(" that is long enough to hold a whole header of bytes", f);
+      fclose(f);
+      // exercise
+      custom::mapped_vector<int> v;
+      bool opened = v.open(path.c_str());
+      // verify
+      assertUnit(!opened);
+      assertUnit(!v.is_open());
+      // teardown
+      unlink(path.c_str());
+   }
+
+   // sync and async flushes both succeed
+   void test_sync_open()
+   {  // setup
+      std::string path = tempPath();
+      custom::mapped_vector<int> v(path.c_str());
+      v.push_back(26);
+      // exercise
+      bool waited = v.sync();
+      bool started = v.sync(false);
+      // verify
+      assertUnit(waited);
+      assertUnit(started);
+      // teardown
+      v.close();
+      unlink(path.c_str());
+   }
+
+   // nothing to flush
+   void test_sync_closed()
+   {  // setup
+      custom::mapped_vector<int> v;
+      // exercise
+      bool synced = v.sync();
+      // verify
+      assertUnit(!synced);
+      assertUnit(v.fd == -1);
+   }  // teardown
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // the mapping moves, the source is left closed
+   void test_constructMove_standard()
+   {  // setup
+      std::string path = tempPath();
+      custom::mapped_vector<int> src(path.c_str());
+      src.push_back(49);
+      // exercise
+      custom::mapped_vector<int> dest(std::move(src));
+      // verify
+      assertUnit(!src.is_open());
+      assertUnit(src.fd == -1);
+      assertUnit(dest.is_open());
+      assertUnit(dest.size() == 1);
+      assertUnit(dest[0] == 49);
+      // teardown
+      dest.close();
+      unlink(path.c_str());
+   }
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the file doubles past the first page
+   void test_pushBack_growsFile()
+   {  // setup
+      std::string path = tempPath();
+      custom::mapped_vector<int> v(path.c_str());
+      size_t firstCapacity = v.capacity();
+      // exercise
+      for (int i = 0; i < 10000; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(v.size() == 10000);
+      assertUnit(v.capacity() > firstCapacity);
+      assertUnit(v.front() == 0);
+      assertUnit(v.back() == 9999);
+      struct stat info;
+      stat(path.c_str(), &info);
+      assertUnit((size_t)info.st_size == v.numBytes);
+      // teardown
+      v.close();
+      unlink(path.c_str());
+   }
+
+   // pushing our own element survives the remap
+   void test_pushBack_selfReference()
+   {  // setup
+      std::string path = tempPath();
+      custom::mapped_vector<int> v(path.c_str());
+      v.push_back(67);
+      while (v.size() < v.capacity())
+         v.push_back(0);
+      // exercise
+      v.push_back(v.front());
+      // verify
+      assertUnit(v.back() == 67);
+      // teardown
+      v.close();
+      unlink(path.c_str());
+   }
+
+   // a file of only the header has no capacity to double
+   void test_pushBack_headerOnly()
+   {  // setup
+      std::string path = tempPath();
+      {
+         custom::mapped_vector<int> v(path.c_str());
+      }
+      int result = truncate(path.c_str(), (off_t)custom::mapped_vector<int>::headerBytes);
+      assert(result == 0);
+      custom::mapped_vector<int> v(path.c_str());
+      assertUnit(v.is_open());
+      assertUnit(v.capacity() == 0);
+      // exercise
+      v.push_back(26);
+      // verify
+      assertUnit(v.size() == 1);
+      assertUnit(v.back() == 26);
+      assertUnit(v.capacity() >= 1);
+      // teardown
+      v.close();
+      unlink(path.c_str());
+   }
+
+   // resize fills with the given value
+   void test_resize_fill()
+   {  // setup
+      std::string path = tempPath();
+      custom::mapped_vector<short> v(path.c_str());
+      v.push_back(1);
+      // exercise
+      v.resize(3000, 89);
+      // verify
+      assertUnit(v.size() == 3000);
+      assertUnit(v[0] == 1);
+      assertUnit(v[1] == 89);
+      assertUnit(v[2999] == 89);
+      // teardown
+      v.close();
+      unlink(path.c_str());
+   }
+
+   // an iterator is an index, so a remap does not hurt it
+   void test_iterator_survivesGrowth()
+   {  // setup
+      std::string path = tempPath();
+      custom::mapped_vector<int> v(path.c_str());
+      v.push_back(26);
+      v.push_back(49);
+      custom::mapped_vector<int>::iterator it = v.begin();
+      ++it;
+      // exercise
+      v.reserve(100000);
+      // verify
+      assertUnit(*it == 49);
+      int total = 0;
+      for (custom::mapped_vector<int>::iterator jt = v.begin(); jt != v.end(); ++jt)
+         total += *jt;
+      assertUnit(total == 75);
+      // teardown
+      v.close();
+      unlink(path.c_str());
+   }
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // the element count lives in the file
+   void test_popBack_persisted()
+   {  // setup
+      std::string path = tempPath();
+      {
+         custom::mapped_vector<int> v(path.c_str());
+         v.push_back(26);
+         v.push_back(49);
+         v.push_back(67);
+         // exercise
+         v.pop_back();
+      }
+      // verify
+      custom::mapped_vector<int> v(path.c_str());
+      assertUnit(v.size() == 2);
+      assertUnit(v.back() == 49);
+      // teardown
+      v.close();
+      unlink(path.c_str());
+   }
+
+   // the file shrinks back to a page
+   void test_shrinkToFit_trimsFile()
+   {  // setup
+      std::string path = tempPath();
+      custom::mapped_vector<int> v(path.c_str());
+      v.resize(50000);
+      v.resize(10);
+      v[9] = 89;
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.size() == 10);
+      assertUnit(v[9] == 89);
+      assertUnit(v.numBytes == (size_t)sysconf(_SC_PAGESIZE));
+      // teardown
+      v.close();
+      unlink(path.c_str());
+   }
+};
+
+#else // !CUSTOM_MAPPED_POSIX
+
+class TestMappedVector : public UnitTest
+{
+public:
+   void run() {}
+};
+
+#endif // CUSTOM_MAPPED_POSIX
+
+#endif // DEBUG
@@ -0,0 +1,206 @@
+/***********************************************************************
+ * Header:
+ *    TEST NODE POOL
+ * Summary:
+ *    Unit tests for node_pool
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "node_pool.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <thread>
+#include <vector>
+
+class TestNodePool : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Allocate
+      test_allocate_neighbours();
+      test_allocateBulk_contiguous();
+      test_deallocate_reused();
+      test_allocate_unpooled();
+
+      // Blocks
+      test_block_retiredWhenFull();
+      test_block_queuedWhenHalfFree();
+      test_block_freedWhenEmpty();
+
+      // Threads
+      test_threads_freeElsewhere();
+
+      report("NodePool");
+   }
+
+   /***************************************
+    * ALLOCATE
+    ***************************************/
+
+   // one slot after another, in the same block
+   void test_allocate_neighbours()
+   {  // setup
+      typedef custom::node_pool<136, 8> pool;
+      // exercise
+      char* p1 = (char*)pool::allocate();
+      char* p2 = (char*)pool::allocate();
+      // verify
+      assertUnit(pool::owner(p1) == pool::owner(p2));
+      assertUnit(p2 - p1 == (ptrdiff_t)pool::SLOT);
+      // teardown
+      pool::deallocate(p1);
+      pool::deallocate(p2);
+   }
+
+   // a run of slots side by side
+   void test_allocateBulk_contiguous()
+   {  // setup
+      typedef custom::node_pool<40, 8> pool;
+      void* slots[50];
+      // exercise
+      size_t got = pool::allocate_bulk(slots, 50);
+      // verify
+      assertUnit(got == 50);
+      bool adjacent = true;
+      for (size_t i = 1; i < 50; i++)
+         adjacent = adjacent && (char*)slots[i] - (char*)slots[i - 1] == (ptrdiff_t)pool::SLOT;
+      assertUnit(adjacent);
+      assertUnit(pool::current()->live == 50);
+      // teardown
+      for (size_t i = 0; i < 50; i++)
+         pool::deallocate(slots[i]);
+   }
+
+   // a freed slot is the next one handed out
+   void test_deallocate_reused()
+   {  // setup
+      typedef custom::node_pool<24, 8> pool;
+      void* p1 = pool::allocate();
+      void* p2 = pool::allocate();
+      // exercise
+      pool::deallocate(p1);
+      void* p3 = pool::allocate();
+      // verify
+      assertUnit(p3 == p1);
+      // teardown
+      pool::deallocate(p2);
+      pool::deallocate(p3);
+   }
+
+   // slots too big for a block use operator new
+   void test_allocate_unpooled()
+   {  // setup
+      typedef custom::node_pool<4096, 8> pool;
+      // exercise
+      void* p = pool::allocate();
+      // verify
+      assertUnit(!pool::pooled);
+      assertUnit(p != nullptr);
+      // teardown
+      pool::deallocate(p);
+   }
+
+   /***************************************
+    * BLOCKS
+    ***************************************/
+
+   // a full block is retired and a new one takes over
+   void test_block_retiredWhenFull()
+   {  // setup
+      typedef custom::node_pool<56, 8> pool;
+      std::vector<void*> slots;
+      // exercise
+      for (size_t i = 0; i <= pool::CAPACITY; i++)
+         slots.push_back(pool::allocate());
+      // verify
+      pool::block* pFirst = pool::owner(slots.front());
+      assertUnit(pFirst->retired);
+      assertUnit(pFirst->live == pool::CAPACITY);
+      assertUnit(pool::owner(slots.back()) == pool::current());
+      assertUnit(pool::owner(slots.back()) != pFirst);
+      // teardown
+      for (size_t i = 0; i < slots.size(); i++)
+         pool::deallocate(slots[i]);
+   }
+
+   // once half free, a retired block can be handed out again
+   void test_block_queuedWhenHalfFree()
+   {  // setup
+      typedef custom::node_pool<72, 8> pool;
+      std::vector<void*> slots;
+      for (size_t i = 0; i <= pool::CAPACITY; i++)
+         slots.push_back(pool::allocate());
+      pool::block* pFirst = pool::owner(slots.front());
+      // exercise
+      for (size_t i = 0; i < pool::CAPACITY / 2; i++)
+         pool::deallocate(slots[i]);
+      // verify
+      assertUnit(pFirst->queued);
+      assertUnit(pool::shared().pQueue == pFirst);
+      // teardown
+      for (size_t i = pool::CAPACITY / 2; i < slots.size(); i++)
+         pool::deallocate(slots[i]);
+   }
+
+   // a retired block with nothing in it leaves the queue
+   void test_block_freedWhenEmpty()
+   {  // setup
+      typedef custom::node_pool<88, 8> pool;
+      std::vector<void*> slots;
+      for (size_t i = 0; i <= pool::CAPACITY; i++)
+         slots.push_back(pool::allocate());
+      // exercise
+      for (size_t i = 0; i < pool::CAPACITY; i++)
+         pool::deallocate(slots[i]);
+      // verify
+      assertUnit(pool::shared().pQueue == nullptr);
+      assertUnit(pool::current()->live == 1);
+      // teardown
+      pool::deallocate(slots.back());
+   }
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // slots freed on other threads, while those threads allocate too
+   void test_threads_freeElsewhere()
+   {  // setup
+      typedef custom::node_pool<104, 8> pool;
+      const size_t num = 4000;
+      std::vector<void*> slots(num);
+      size_t got = pool::allocate_bulk(slots.data(), num);
+      // exercise
+      std::vector<std::thread> threads;
+      for (size_t t = 0; t < 4; t++)
+         threads.push_back(std::thread([&slots, t, num]()
+         {
+            std::vector<void*> mine;
+            for (size_t i = t; i < num; i += 4)
+            {
+               pool::deallocate(slots[i]);
+               mine.push_back(pool::allocate());
+            }
+            for (size_t i = 0; i < mine.size(); i++)
+               pool::deallocate(mine[i]);
+         }));
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+      // verify
+      assertUnit(got == num);
+      assertUnit(pool::shared().pQueue == nullptr);
+      assertUnit(pool::current()->live == 0);
+   }  // teardown
+};
+
+#endif // DEBUG
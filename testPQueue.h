@@ -0,0 +1,295 @@
+/***********************************************************************
+ * Header:
+ *    TEST PQUEUE
+ * Summary:
+ *    Unit tests for priority_queue
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "priority_queue.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+
+class TestPQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_initializerList();
+      test_construct_vectorHeapify();
+      test_construct_range();
+
+      // Insert
+      test_push_top();
+      test_push_spyNoCopy();
+      test_emplace_standard();
+      test_pushPop_newTop();
+      test_pushPop_replacesTop();
+      test_pushPop_topK();
+
+      // Remove
+      test_pop_sortedOrder();
+      test_pop_eightAry();
+      test_pop_minHeap();
+      test_pop_duplicates();
+
+      report("PQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // empty heap
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::priority_queue<int> pq;
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.size() == 0);
+      assertUnit(pq.container.size() == 0);
+   }  // teardown
+
+   // the largest is on top
+   void test_construct_initializerList()
+   {  // setup
+      // exercise
+      custom::priority_queue<int> pq{ 26, 89, 49, 67 };
+      // verify
+      assertUnit(pq.size() == 4);
+      assertUnit(pq.top() == 89);
+      assertUnit(isHeap(pq));
+   }  // teardown
+
+   // bulk build takes over the vector's buffer
+   void test_construct_vectorHeapify()
+   {  // setup
+      custom::vector<int> v;
+      fillRandom(v, 1000);
+      int* buffer = &v[0];
+      // exercise
+      custom::priority_queue<int> pq(std::move(v));
+      // verify
+      assertUnit(pq.size() == 1000);
+      assertUnit(&pq.container[0] == buffer);
+      assertUnit(isHeap(pq));
+   }  // teardown
+
+   // from a pair of iterators
+   void test_construct_range()
+   {  // setup
+      custom::vector<int> v{ 3, 1, 4, 1, 5, 9, 2, 6 };
+      // exercise
+      custom::priority_queue<int> pq(v.begin(), v.end());
+      // verify
+      assertUnit(pq.size() == 8);
+      assertUnit(pq.top() == 9);
+      assertUnit(isHeap(pq));
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // a new largest rises to the top
+   void test_push_top()
+   {  // setup
+      custom::priority_queue<int> pq{ 26, 49 };
+      // exercise
+      pq.push(67);
+      pq.push(11);
+      // verify
+      assertUnit(pq.size() == 4);
+      assertUnit(pq.top() == 67);
+      assertUnit(isHeap(pq));
+   }  // teardown
+
+   // the sift moves elements, it never copies them
+   void test_push_spyNoCopy()
+   {  // setup
+      custom::priority_queue<Spy> pq;
+      pq.reserve(20);
+      for (int i = 0; i < 10; i++)
+         pq.push(Spy(i));
+      Spy::reset();
+      // exercise
+      pq.push(Spy(99));
+      // verify
+      assertUnit(pq.top() == Spy(99));
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+   }  // teardown
+
+   // built from arguments
+   void test_emplace_standard()
+   {  // setup
+      custom::priority_queue<Spy> pq;
+      // exercise
+      pq.emplace(26);
+      pq.emplace(49);
+      // verify
+      assertUnit(pq.size() == 2);
+      assertUnit(pq.top() == Spy(49));
+   }  // teardown
+
+   // something larger than the top comes straight back
+   void test_pushPop_newTop()
+   {  // setup
+      custom::priority_queue<int> pq{ 26, 49 };
+      // exercise
+      int out = pq.push_pop(67);
+      // verify
+      assertUnit(out == 67);
+      assertUnit(pq.size() == 2);
+      assertUnit(pq.top() == 49);
+   }  // teardown
+
+   // something smaller takes the top's place
+   void test_pushPop_replacesTop()
+   {  // setup
+      custom::priority_queue<int> pq{ 26, 49, 67, 89 };
+      // exercise
+      int out = pq.push_pop(11);
+      // verify
+      assertUnit(out == 89);
+      assertUnit(pq.size() == 4);
+      assertUnit(pq.top() == 67);
+      assertUnit(isHeap(pq));
+   }  // teardown
+
+   // keep the ten smallest of many
+   void test_pushPop_topK()
+   {  // setup
+      custom::vector<int> v;
+      fillRandom(v, 5000);
+      custom::priority_queue<int> pq;
+      for (size_t i = 0; i < 10; i++)
+         pq.push(v[i]);
+      // exercise
+      for (size_t i = 10; i < v.size(); i++)
+         pq.push_pop(v[i]);
+      // verify
+      int smallest[10];
+      for (int i = 9; i >= 0; i--)
+      {
+         smallest[i] = pq.top();
+         pq.pop();
+      }
+      bool ok = true;
+      for (int i = 1; i < 10; i++)
+         ok = ok && smallest[i - 1] <= smallest[i];
+      size_t below = 0;
+      for (size_t i = 0; i < v.size(); i++)
+         if (v[i] < smallest[9])
+            below++;
+      assertUnit(ok);
+      assertUnit(below == 9);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // popping everything gives descending order
+   void test_pop_sortedOrder()
+   {  // setup
+      custom::vector<int> v;
+      fillRandom(v, 2000);
+      custom::priority_queue<int> pq(std::move(v));
+      // exercise
+      bool ok = true;
+      int last = pq.top();
+      while (!pq.empty())
+      {
+         ok = ok && pq.top() <= last;
+         last = pq.top();
+         pq.pop();
+      }
+      // verify
+      assertUnit(ok);
+      assertUnit(pq.size() == 0);
+   }  // teardown
+
+   // eight children to a node
+   void test_pop_eightAry()
+   {  // setup
+      custom::priority_queue<int, std::less<int>, 8> pq;
+      for (int i = 0; i < 500; i++)
+         pq.push((i * 37) % 500);
+      // exercise
+      bool ok = true;
+      for (int expect = 499; expect >= 0; expect--)
+      {
+         ok = ok && pq.top() == expect;
+         pq.pop();
+      }
+      // verify
+      assertUnit(ok);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // a greater comparator puts the smallest on top
+   void test_pop_minHeap()
+   {  // setup
+      custom::priority_queue<int, std::greater<int>> pq{ 67, 26, 89, 49 };
+      // exercise
+      pq.pop();
+      // verify
+      assertUnit(pq.top() == 49);
+      assertUnit(pq.size() == 3);
+   }  // teardown
+
+   // equal elements all come out
+   void test_pop_duplicates()
+   {  // setup
+      custom::priority_queue<int> pq{ 5, 5, 5, 1, 5 };
+      // exercise
+      pq.pop();
+      pq.pop();
+      pq.pop();
+      pq.pop();
+      // verify
+      assertUnit(pq.size() == 1);
+      assertUnit(pq.top() == 1);
+   }  // teardown
+
+   /*************************************************************
+    * IS HEAP
+    * No child is larger than its parent
+    *************************************************************/
+   template <typename T, typename C, size_t D>
+   bool isHeap(const custom::priority_queue<T, C, D>& pq)
+   {
+      for (size_t i = 1; i < pq.container.size(); i++)
+         if (pq.comp(pq.container[(i - 1) / D], pq.container[i]))
+            return false;
+      return true;
+   }
+
+   void fillRandom(custom::vector<int>& v, size_t num)
+   {
+      uint32_t seed = 4949;
+      for (size_t i = 0; i < num; i++)
+      {
+         seed = seed * 1103515245u + 12345u;
+         v.push_back((int)(seed >> 8) % 100000);
+      }
+   }
+};
+
+#endif // DEBUG
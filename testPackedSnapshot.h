@@ -0,0 +1,290 @@
+/***********************************************************************
+ * Header:
+ *    TEST PACKED SNAPSHOT
+ * Summary:
+ *    Unit tests for save_packed and load_packed
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "packed_snapshot.h"
+#include "unitTest.h"
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+class TestPackedSnapshot : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Save
+      test_save_header();
+      test_save_dense();
+      test_save_empty();
+
+      // Load
+      test_load_roundTrip();
+      test_load_tailOnly();
+      test_load_signed();
+      test_load_extremes();
+      test_load_sameBuckets();
+      test_load_everyLevel();
+
+      // Errors
+      test_load_notPacked();
+      test_load_truncated();
+
+      report("PackedSnapshot");
+   }
+
+   /***************************************
+    * SAVE
+    ***************************************/
+
+   // the usual header, with its own magic
+   void test_save_header()
+   {  // setup
+      custom::unordered_set<int> us(11);
+      us.max_load_factor(0.75f);
+      us.insert(26);
+      us.insert(49);
+      std::stringstream ss;
+      // exercise
+      bool saved = custom::save_packed(us, ss);
+      // verify
+      assertUnit(saved);
+      std::string bytes = ss.str();
+      custom::snapshot_header header;
+      std::memcpy(&header, bytes.data(), sizeof(header));
+      assertUnit(header.magic == custom::SNAPSHOT_PACKED_MAGIC);
+      assertUnit(header.elementSize == sizeof(int));
+      assertUnit(header.numElements == 2);
+      assertUnit(header.numBuckets == 11);
+      assertUnit(header.maxLoadFactor == 0.75f);
+   }  // teardown
+
+   // consecutive keys take about a byte and a half each, not eight
+   void test_save_dense()
+   {  // setup
+      custom::unordered_set<uint64_t> us;
+      for (uint64_t i = 0; i < 10000; i++)
+         us.insert(1000000 + i * 3);
+      std::stringstream packed;
+      std::stringstream raw;
+      // exercise
+      custom::save_packed(us, packed);
+      us.save(raw);
+      // verify
+      assertUnit(packed.str().size() < sizeof(custom::snapshot_header) + 10000 * 2);
+      assertUnit(packed.str().size() * 4 < raw.str().size());
+   }  // teardown
+
+   // just a header
+   void test_save_empty()
+   {  // setup
+      custom::unordered_set<int> us;
+      std::stringstream ss;
+      // exercise
+      custom::save_packed(us, ss);
+      custom::unordered_set<int> copy;
+      copy.insert(26);
+      bool loaded = custom::load_packed(copy, ss);
+      // verify
+      assertUnit(ss.str().size() == sizeof(custom::snapshot_header));
+      assertUnit(loaded);
+      assertUnit(copy.empty());
+   }  // teardown
+
+   /***************************************
+    * LOAD
+    ***************************************/
+
+   // whole blocks and a tail, scattered keys
+   void test_load_roundTrip()
+   {  // setup
+      custom::unordered_set<uint32_t> us;
+      uint32_t x = 26;
+      for (int i = 0; i < 1000; i++)
+      {
+         x = x * 1103515245u + 12345u;
+         us.insert(x);
+      }
+      std::stringstream ss;
+      custom::save_packed(us, ss);
+      custom::unordered_set<uint32_t> copy;
+      // exercise
+      bool loaded = custom::load_packed(copy, ss);
+      // verify
+      assertUnit(loaded);
+      assertUnit(copy.size() == us.size());
+      assertUnit(sameKeys(us, copy));
+   }  // teardown
+
+   // fewer keys than a block are all tail
+   void test_load_tailOnly()
+   {  // setup
+      custom::unordered_set<int> us;
+      for (int i : { 67, 26, 49, 7, 5000000 })
+         us.insert(i);
+      std::stringstream ss;
+      custom::save_packed(us, ss);
+      custom::unordered_set<int> copy;
+      // exercise
+      bool loaded = custom::load_packed(copy, ss);
+      // verify
+      assertUnit(loaded);
+      assertUnit(copy.size() == 5);
+      assertUnit(sameKeys(us, copy));
+   }  // teardown
+
+   // negative keys sort before positive ones and come back as they were
+   void test_load_signed()
+   {  // setup
+      custom::unordered_set<int> us;
+      for (int i = -300; i < 300; i += 2)
+         us.insert(i);
+      std::stringstream ss;
+      custom::save_packed(us, ss);
+      custom::unordered_set<int> copy;
+      // exercise
+      bool loaded = custom::load_packed(copy, ss);
+      // verify
+      assertUnit(loaded);
+      assertUnit(copy.size() == 300);
+      assertUnit(copy.find(-300) != copy.end());
+      assertUnit(copy.find(298) != copy.end());
+      assertUnit(copy.find(-1) == copy.end());
+   }  // teardown
+
+   // differences that need all 64 bits
+   void test_load_extremes()
+   {  // setup
+      custom::unordered_set<int64_t> us;
+      for (int64_t i = 0; i < 200; i++)
+      {
+         us.insert(INT64_MIN + i);
+         us.insert(INT64_MAX - i);
+      }
+      std::stringstream ss;
+      custom::save_packed(us, ss);
+      custom::unordered_set<int64_t> copy;
+      // exercise
+      bool loaded = custom::load_packed(copy, ss);
+      // verify
+      assertUnit(loaded);
+      assertUnit(copy.size() == 400);
+      assertUnit(sameKeys(us, copy));
+   }  // teardown
+
+   // the bucket array is sized once, from the header
+   void test_load_sameBuckets()
+   {  // setup
+      custom::unordered_set<int> us(1000);
+      for (int i = 0; i < 300; i++)
+         us.insert(i);
+      std::stringstream ss;
+      custom::save_packed(us, ss);
+      custom::unordered_set<int> copy;
+      // exercise
+      custom::load_packed(copy, ss);
+      // verify
+      assertUnit(copy.bucket_count() == us.bucket_count());
+      assertUnit(copy.size() == 300);
+   }  // teardown
+
+   // every vector width decodes the same keys
+   void test_load_everyLevel()
+   {  // setup
+      custom::unordered_set<uint64_t> us;
+      uint64_t x = 49;
+      for (int i = 0; i < 2000; i++)
+      {
+         x = x * 6364136223846793005ull + 1442695040888963407ull;
+         us.insert(x >> (i % 40));
+      }
+      std::stringstream ss;
+      custom::save_packed(us, ss);
+      std::string bytes = ss.str();
+      bool same = true;
+      // exercise
+      for (int level = custom::SIMD_SCALAR; level <= custom::simd_supported(); level++)
+      {
+         custom::simd_limit((custom::simd_level)level);
+         std::stringstream in(bytes);
+         custom::unordered_set<uint64_t> copy;
+         same = same && custom::load_packed(copy, in) && sameKeys(us, copy);
+      }
+      // verify
+      assertUnit(same);
+      // teardown
+      custom::simd_limit(custom::simd_supported());
+   }
+
+   /***************************************
+    * ERRORS
+    ***************************************/
+
+   // a plain snapshot is not a packed one
+   void test_load_notPacked()
+   {  // setup
+      custom::unordered_set<int> us;
+      us.insert(26);
+      std::stringstream ss;
+      us.save(ss);
+      custom::unordered_set<int> copy;
+      copy.insert(49);
+      // exercise
+      bool loaded = custom::load_packed(copy, ss);
+      // verify
+      assertUnit(!loaded);
+      assertUnit(copy.empty());
+   }  // teardown
+
+   // cut off in a block or in the tail
+   void test_load_truncated()
+   {  // setup
+      custom::unordered_set<int> us;
+      for (int i = 0; i < 200; i++)
+         us.insert(i * 1000);
+      std::stringstream ss;
+      custom::save_packed(us, ss);
+      std::string bytes = ss.str();
+      std::stringstream inBlock(bytes.substr(0, sizeof(custom::snapshot_header) + 20));
+      std::stringstream inTail(bytes.substr(0, bytes.size() - 1));
+      custom::unordered_set<int> copy;
+      // exercise
+      bool loadedBlock = custom::load_packed(copy, inBlock);
+      bool loadedTail = custom::load_packed(copy, inTail);
+      // verify
+      assertUnit(!loadedBlock);
+      assertUnit(!loadedTail);
+      assertUnit(copy.empty());
+   }  // teardown
+
+   /*************************************************************
+    * SAME KEYS
+    * Does every key of one set appear in the other?
+    *************************************************************/
+   template <class Set>
+   bool sameKeys(Set& lhs, Set& rhs)
+   {
+      if (lhs.size() != rhs.size())
+         return false;
+      for (auto it = lhs.begin(); it != lhs.end(); ++it)
+         if (rhs.find(*it) == rhs.end())
+            return false;
+      return true;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,255 @@
+/***********************************************************************
+ * Header:
+ *    TEST PARALLEL
+ * Summary:
+ *    Unit tests for the parallel algorithms
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "parallel.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+
+class TestParallel : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // blocks
+      test_blocks_cacheSized();
+
+      // for each, transform
+      test_forEach_standard();
+      test_transform_otherType();
+      test_transform_inPlace();
+
+      // reduce
+      test_reduce_empty();
+      test_reduce_sum();
+      test_reduce_orderKept();
+      test_transformReduce_sumSquares();
+
+      // scan
+      test_inclusiveScan_standard();
+      test_inclusiveScan_inPlace();
+
+      // copy if
+      test_copyIf_evens();
+      test_copyIf_none();
+
+      report("Parallel");
+   }
+
+   /***************************************
+    * BLOCKS
+    ***************************************/
+
+   // 64K of ints is 16384 per block
+   void test_blocks_cacheSized()
+   {  // setup
+      // exercise
+      custom::parallel_detail::blocks<int> blk(40000);
+      // verify
+      assertUnit(blk.size == 16384);
+      assertUnit(blk.count == 3);
+      assertUnit(blk.begin(2) == 32768);
+      assertUnit(blk.end(2) == 40000);
+   }  // teardown
+
+   /***************************************
+    * FOR EACH, TRANSFORM
+    ***************************************/
+
+   // double every element
+   void test_forEach_standard()
+   {  // setup
+      custom::thread_pool pool(3);
+      custom::vector<int> v;
+      fill(v, 100000);
+      // exercise
+      custom::parallel_for_each(v, [](int& i) { i *= 2; }, pool);
+      // verify
+      assertUnit(v[0] == 0);
+      assertUnit(v[50000] == 100000);
+      assertUnit(v[99999] == 199998);
+   }  // teardown
+
+   // ints into doubles
+   void test_transform_otherType()
+   {  // setup
+      custom::thread_pool pool(3);
+      custom::vector<int> in;
+      fill(in, 70000);
+      custom::vector<double> out;
+      // exercise
+      custom::parallel_transform(in, out, [](int i) { return i * 0.5; }, pool);
+      // verify
+      assertUnit(out.size() == 70000);
+      assertUnit(out[1] == 0.5);
+      assertUnit(out[69999] == 34999.5);
+   }  // teardown
+
+   // the input is the output
+   void test_transform_inPlace()
+   {  // setup
+      custom::thread_pool pool(3);
+      custom::vector<int> v;
+      fill(v, 50000);
+      // exercise
+      custom::parallel_transform(v, v, [](int i) { return -i; }, pool);
+      // verify
+      assertUnit(v.size() == 50000);
+      assertUnit(v[49999] == -49999);
+   }  // teardown
+
+   /***************************************
+    * REDUCE
+    ***************************************/
+
+   // an empty vector gives back init
+   void test_reduce_empty()
+   {  // setup
+      custom::vector<int> v;
+      // exercise
+      int total = custom::parallel_reduce(v, 26);
+      // verify
+      assertUnit(total == 26);
+   }  // teardown
+
+   // the sum of 0..n-1
+   void test_reduce_sum()
+   {  // setup
+      custom::thread_pool pool(3);
+      custom::vector<int64_t> v;
+      fill(v, 200000);
+      // exercise
+      int64_t total = custom::parallel_reduce(v, (int64_t)0, pool);
+      // verify
+      assertUnit(total == (int64_t)200000 * 199999 / 2);
+   }  // teardown
+
+   // concatenation is associative but not commutative
+   void test_reduce_orderKept()
+   {  // setup
+      custom::thread_pool pool(3);
+      custom::vector<std::string> v;
+      for (int i = 0; i < 5000; i++)
+         v.push_back(std::string(1, (char)('a' + i % 26)));
+      // exercise
+      std::string all = custom::parallel_reduce(v, std::string(">"),
+         [](const std::string& lhs, const std::string& rhs) { return lhs + rhs; }, pool);
+      // verify
+      assertUnit(all.size() == 5001);
+      assertUnit(all.substr(0, 4) == ">abc");
+      assertUnit(all[4999] == (char)('a' + 4998 % 26));
+   }  // teardown
+
+   // the sum of squares
+   void test_transformReduce_sumSquares()
+   {  // setup
+      custom::thread_pool pool(3);
+      custom::vector<int> v;
+      fill(v, 40000);
+      // exercise
+      int64_t total = custom::parallel_transform_reduce(v, (int64_t)0,
+         [](int64_t lhs, int64_t rhs) { return lhs + rhs; },
+         [](int i) { return (int64_t)i * i; }, pool);
+      // verify
+      int64_t expect = 0;
+      for (int64_t i = 0; i < 40000; i++)
+         expect += i * i;
+      assertUnit(total == expect);
+   }  // teardown
+
+   /***************************************
+    * SCAN
+    ***************************************/
+
+   // running totals across several blocks
+   void test_inclusiveScan_standard()
+   {  // setup
+      custom::thread_pool pool(3);
+      custom::vector<int64_t> in(100000, 1);
+      custom::vector<int64_t> out;
+      // exercise
+      custom::parallel_inclusive_scan(in, out, pool);
+      // verify
+      bool ok = out.size() == 100000;
+      for (size_t i = 0; ok && i < out.size(); i++)
+         ok = out[i] == (int64_t)i + 1;
+      assertUnit(ok);
+   }  // teardown
+
+   // scan in place with a different operator
+   void test_inclusiveScan_inPlace()
+   {  // setup
+      custom::thread_pool pool(3);
+      custom::vector<int> v;
+      fill(v, 60000);
+      v[40000] = 1000000;
+      // exercise
+      custom::parallel_inclusive_scan(v, v, [](int lhs, int rhs) { return lhs > rhs ? lhs : rhs; }, pool);
+      // verify
+      assertUnit(v[39999] == 39999);
+      assertUnit(v[40000] == 1000000);
+      assertUnit(v[59999] == 1000000);
+   }  // teardown
+
+   /***************************************
+    * COPY IF
+    ***************************************/
+
+   // keep the even numbers, in order
+   void test_copyIf_evens()
+   {  // setup
+      custom::thread_pool pool(3);
+      custom::vector<int> in;
+      fill(in, 100001);
+      custom::vector<int> out;
+      // exercise
+      size_t n = custom::parallel_copy_if(in, out, [](int i) { return i % 2 == 0; }, pool);
+      // verify
+      assertUnit(n == 50001);
+      bool ok = out.size() == 50001;
+      for (size_t i = 0; ok && i < out.size(); i++)
+         ok = out[i] == (int)i * 2;
+      assertUnit(ok);
+   }  // teardown
+
+   // nothing matches
+   void test_copyIf_none()
+   {  // setup
+      custom::vector<int> in;
+      fill(in, 1000);
+      custom::vector<int> out{ 26, 49 };
+      // exercise
+      size_t n = custom::parallel_copy_if(in, out, [](int i) { return i < 0; });
+      // verify
+      assertUnit(n == 0);
+      assertUnit(out.size() == 0);
+   }  // teardown
+
+   /*************************************************************
+    * FILL
+    * 0, 1, 2 ... num-1
+    *************************************************************/
+   template <typename T>
+   void fill(custom::vector<T>& v, int num)
+   {
+      for (int i = 0; i < num; i++)
+         v.push_back((T)i);
+   }
+};
+
+#endif // DEBUG
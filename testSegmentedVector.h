@@ -0,0 +1,292 @@
+/***********************************************************************
+ * Header:
+ *    TEST SEGMENTED VECTOR
+ * Summary:
+ *    Unit tests for segmented_vector
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "segmented_vector.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <memory>
+
+class TestSegmentedVector : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_sizeFill();
+      test_constructCopy_standard();
+      test_constructMove_standard();
+
+      // Assign
+      test_assign_bigToSmall();
+
+      // Access
+      test_subscript_acrossChunks();
+      test_iterator_walk();
+
+      // Insert
+      test_pushback_noMoves();
+      test_pushback_stableReferences();
+      test_reserve_chunks();
+
+      // Remove
+      test_popback_standard();
+      test_shrink_freesChunks();
+
+      report("SegmentedVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, no chunks
+   void test_construct_default()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::segmented_vector<Spy, 4> v;
+      // verify
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(v.numElements == 0);
+      assertUnit(v.chunks.size() == 0);
+   }  // teardown
+
+   // ten copies span three chunks of four
+   void test_construct_sizeFill()
+   {  // setup
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      custom::segmented_vector<Spy, 4> v(10, s);
+      // verify
+      assertUnit(Spy::numCopy() == 10);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(v.numElements == 10);
+      assertUnit(v.chunks.size() == 3);
+      assertUnit(v.capacity() == 12);
+      if (v.numElements == 10)
+         assertUnit(v[9] == Spy(99));
+   }  // teardown
+
+   // copy a vector spanning two chunks
+   void test_constructCopy_standard()
+   {  // setup
+      custom::segmented_vector<Spy, 4> vSrc;
+      setupStandardFixture(vSrc);
+      Spy::reset();
+      // exercise
+      custom::segmented_vector<Spy, 4> vDest(vSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 6);
+      assertUnit(vSrc.chunks[0] != vDest.chunks[0]);
+      assertStandardFixture(vSrc);
+      assertStandardFixture(vDest);
+   }  // teardown
+
+   // move steals the chunks without touching the elements
+   void test_constructMove_standard()
+   {  // setup
+      custom::segmented_vector<Spy, 4> vSrc;
+      setupStandardFixture(vSrc);
+      Spy* p = vSrc.chunks[0];
+      Spy::reset();
+      // exercise
+      custom::segmented_vector<Spy, 4> vDest(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(vSrc.numElements == 0);
+      assertUnit(vDest.chunks[0] == p);
+      assertStandardFixture(vDest);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // assign a bigger vector onto a smaller one
+   void test_assign_bigToSmall()
+   {  // setup
+      custom::segmented_vector<Spy, 4> vSrc;
+      setupStandardFixture(vSrc);
+      custom::segmented_vector<Spy, 4> vDest{ Spy(1), Spy(2) };
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertStandardFixture(vSrc);
+      assertStandardFixture(vDest);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // index 4 is the first slot of the second chunk
+   void test_subscript_acrossChunks()
+   {  // setup
+      custom::segmented_vector<Spy, 4> v;
+      setupStandardFixture(v);
+      // exercise
+      Spy& s = v[4];
+      // verify
+      assertUnit(&s == &v.chunks[1][0]);
+      assertUnit(s == Spy(55));
+   }  // teardown
+
+   // iterate over every element in order
+   void test_iterator_walk()
+   {  // setup
+      custom::segmented_vector<int, 4> v;
+      for (int i = 0; i < 11; i++)
+         v.push_back(i);
+      // exercise
+      int sum = 0;
+      int count = 0;
+      for (auto it = v.begin(); it != v.end(); ++it)
+      {
+         sum += *it;
+         count++;
+      }
+      // verify
+      assertUnit(count == 11);
+      assertUnit(sum == 55);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // growing into a new chunk never moves or copies existing elements
+   void test_pushback_noMoves()
+   {  // setup
+      custom::segmented_vector<Spy, 4> v;
+      v.push_back(Spy(11));
+      v.push_back(Spy(26));
+      v.push_back(Spy(31));
+      v.push_back(Spy(49));
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      v.push_back(s);
+      // verify
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(v.chunks.size() == 2);
+      assertUnit(v.numElements == 5);
+   }  // teardown
+
+   // a reference taken early survives many pushes
+   void test_pushback_stableReferences()
+   {  // setup
+      custom::segmented_vector<int, 4> v;
+      v.push_back(26);
+      int* p = &v[0];
+      // exercise
+      for (int i = 0; i < 100; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(p == &v[0]);
+      assertUnit(*p == 26);
+      assertUnit(v.numElements == 101);
+   }  // teardown
+
+   // reserve rounds up to whole chunks
+   void test_reserve_chunks()
+   {  // setup
+      custom::segmented_vector<int, 8> v;
+      // exercise
+      v.reserve(17);
+      // verify
+      assertUnit(v.chunks.size() == 3);
+      assertUnit(v.capacity() == 24);
+      assertUnit(v.numElements == 0);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop the last element
+   void test_popback_standard()
+   {  // setup
+      custom::segmented_vector<Spy, 4> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.back() == Spy(55));
+   }  // teardown
+
+   // shrinking drops the empty chunks at the end
+   void test_shrink_freesChunks()
+   {  // setup
+      custom::segmented_vector<int, 4> v;
+      v.reserve(20);
+      v.push_back(26);
+      v.push_back(49);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.chunks.size() == 1);
+      assertUnit(v.numElements == 2);
+      assertUnit(v[1] == 49);
+   }  // teardown
+
+   /*************************************************************
+    * SETUP STANDARD FIXTURE
+    *    chunk 0                chunk 1
+    *    +----+----+----+----+  +----+----+----+----+
+    *    | 11 | 26 | 31 | 49 |  | 55 | 67 |    |    |
+    *    +----+----+----+----+  +----+----+----+----+
+    *************************************************************/
+   void setupStandardFixture(custom::segmented_vector<Spy, 4>& v)
+   {
+      v.push_back(Spy(11));
+      v.push_back(Spy(26));
+      v.push_back(Spy(31));
+      v.push_back(Spy(49));
+      v.push_back(Spy(55));
+      v.push_back(Spy(67));
+   }
+
+   /*************************************************************
+    * VERIFY STANDARD FIXTURE PARAMETERS
+    *************************************************************/
+   void assertStandardFixtureParameters(const custom::segmented_vector<Spy, 4>& v, int line, const char* function)
+   {
+      assertIndirect(v.numElements == 6);
+      assertIndirect(v.chunks.size() == 2);
+      if (v.numElements == 6 && v.chunks.size() == 2)
+      {
+         assertIndirect(v.chunks[0][0] == Spy(11));
+         assertIndirect(v.chunks[0][1] == Spy(26));
+         assertIndirect(v.chunks[0][2] == Spy(31));
+         assertIndirect(v.chunks[0][3] == Spy(49));
+         assertIndirect(v.chunks[1][0] == Spy(55));
+         assertIndirect(v.chunks[1][1] == Spy(67));
+      }
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,245 @@
+/***********************************************************************
+ * Header:
+ *    TEST SIMD
+ * Summary:
+ *    Unit tests for the vectorized scans in simd.h. Every test runs
+ *    once at each instruction set level this CPU supports.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "simd.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>
+
+class TestSimd : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      for (int level = custom::SIMD_SCALAR; level <= custom::simd_supported(); level++)
+      {
+         custom::simd_limit((custom::simd_level)level);
+
+         // find
+         test_find_empty();
+         test_find_first();
+         test_find_tail();
+         test_find_missing();
+
+         // count
+         test_count_int();
+         test_count_byteOverflow();
+
+         // min max
+         test_min_int();
+         test_max_double();
+         test_minmax_short();
+
+         // sum
+         test_sum_bytesWiden();
+         test_sum_float();
+
+         // contains any
+         test_containsAny_hit();
+         test_containsAny_miss();
+      }
+      custom::simd_limit(custom::simd_supported());
+
+      report("Simd");
+   }
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // nothing to find in an empty vector
+   void test_find_empty()
+   {  // setup
+      custom::vector<int> v;
+      // exercise
+      custom::vector<int>::iterator it = custom::find(v, 26);
+      // verify
+      assertUnit(it == v.end());
+   }  // teardown
+
+   // the first of two matches is the one returned
+   void test_find_first()
+   {  // setup
+      custom::vector<int> v;
+      fill(v, 100);
+      v[37] = -1;
+      v[70] = -1;
+      // exercise
+      custom::vector<int>::iterator it = custom::find(v, -1);
+      // verify
+      assertUnit(it == custom::vector<int>::iterator(&v[37]));
+   }  // teardown
+
+   // a match in the leftover elements past the last full register
+   void test_find_tail()
+   {  // setup
+      custom::vector<int64_t> v;
+      fill(v, 67);
+      v[66] = -5;
+      // exercise
+      custom::vector<int64_t>::iterator it = custom::find(v, (int64_t)-5);
+      // verify
+      assertUnit(it == custom::vector<int64_t>::iterator(&v[66]));
+   }  // teardown
+
+   // a missing value gives end()
+   void test_find_missing()
+   {  // setup
+      custom::vector<float> v;
+      fill(v, 129);
+      // exercise
+      custom::vector<float>::iterator it = custom::find(v, 0.5f);
+      // verify
+      assertUnit(it == v.end());
+   }  // teardown
+
+   /***************************************
+    * COUNT
+    ***************************************/
+
+   // count every third element
+   void test_count_int()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 0; i < 301; i++)
+         v.push_back(i % 3);
+      // exercise
+      size_t n = custom::count(v, 1);
+      // verify
+      assertUnit(n == 100);
+   }  // teardown
+
+   // more matches than fit in an 8 bit lane
+   void test_count_byteOverflow()
+   {  // setup
+      custom::vector<uint8_t> v(20000, 7);
+      v[5] = 8;
+      // exercise
+      size_t n = custom::count(v, (uint8_t)7);
+      // verify
+      assertUnit(n == 19999);
+   }  // teardown
+
+   /***************************************
+    * MIN MAX
+    ***************************************/
+
+   // the smallest value, placed in the tail
+   void test_min_int()
+   {  // setup
+      custom::vector<int> v;
+      fill(v, 203);
+      v[202] = -99;
+      v[10] = -98;
+      // exercise
+      int value = custom::min(v);
+      // verify
+      assertUnit(value == -99);
+   }  // teardown
+
+   // the largest double
+   void test_max_double()
+   {  // setup
+      custom::vector<double> v;
+      fill(v, 90);
+      v[45] = 1e9;
+      // exercise
+      double value = custom::max(v);
+      // verify
+      assertUnit(value == 1e9);
+   }  // teardown
+
+   // short vectors shorter than one register
+   void test_minmax_short()
+   {  // setup
+      custom::vector<int16_t> v{ 26, -49, 67 };
+      // exercise
+      int16_t lo = custom::min(v);
+      int16_t hi = custom::max(v);
+      // verify
+      assertUnit(lo == -49);
+      assertUnit(hi == 67);
+   }  // teardown
+
+   /***************************************
+    * SUM
+    ***************************************/
+
+   // bytes add up into a 64 bit total without wrapping
+   void test_sum_bytesWiden()
+   {  // setup
+      custom::vector<uint8_t> v(1000, 255);
+      // exercise
+      uint64_t total = custom::sum(v);
+      // verify
+      assertUnit(total == 255000);
+   }  // teardown
+
+   // floats sum in double, whole numbers stay exact
+   void test_sum_float()
+   {  // setup
+      custom::vector<float> v;
+      for (int i = 1; i <= 1000; i++)
+         v.push_back((float)i);
+      // exercise
+      double total = custom::sum(v);
+      // verify
+      assertUnit(total == 500500.0);
+   }  // teardown
+
+   /***************************************
+    * CONTAINS ANY
+    ***************************************/
+
+   // one of the needles is in the middle
+   void test_containsAny_hit()
+   {  // setup
+      custom::vector<uint32_t> v;
+      fill(v, 500);
+      v[250] = 77777;
+      // exercise
+      bool found = custom::contains_any(v, { 5u, 77777u, 6u });
+      // verify
+      assertUnit(found);
+   }  // teardown
+
+   // none of the needles are there
+   void test_containsAny_miss()
+   {  // setup
+      custom::vector<double> v;
+      fill(v, 77);
+      custom::vector<double> needles{ -1.0, -2.0 };
+      // exercise
+      bool found = custom::contains_any(v, needles);
+      // verify
+      assertUnit(!found);
+   }  // teardown
+
+   /*************************************************************
+    * FILL
+    * 0, 1, 2 ... num-1, all distinct and non-negative
+    *************************************************************/
+   template <typename T>
+   void fill(custom::vector<T>& v, int num)
+   {
+      for (int i = 0; i < num; i++)
+         v.push_back((T)i);
+   }
+};
+
+#endif // DEBUG
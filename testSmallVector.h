@@ -0,0 +1,374 @@
+/***********************************************************************
+ * Header:
+ *    TEST SMALL VECTOR
+ * Summary:
+ *    Unit tests for small_vector
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "small_vector.h"
+#include "hash.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <memory>
+
+class TestSmallVector : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_sizeFitsInline();
+      test_construct_sizeSpills();
+      test_constructCopy_inline();
+      test_constructMove_inline();
+      test_constructMove_heap();
+
+      // Assign
+      test_assign_inlineToHeap();
+      test_swap_inlineHeap();
+
+      // Insert
+      test_pushback_inline();
+      test_pushback_spill();
+      test_insert_middle();
+
+      // Remove
+      test_erase_middle();
+      test_erase_last();
+      test_shrink_backToInline();
+
+      // Hash bucket
+      test_hash_smallVectorBucket();
+
+      report("SmallVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor points at the inline buffer, no allocations
+   void test_construct_default()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> v;
+      // verify
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(v.is_inline());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 0);
+   }  // teardown
+
+   // three fit inside the buffer
+   void test_construct_sizeFitsInline()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> v(3);
+      // verify
+      assertUnit(Spy::numDefault() == 3);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(v.is_inline());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+   }  // teardown
+
+   // six do not fit, go straight to the heap
+   void test_construct_sizeSpills()
+   {  // setup
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> v(6, s);
+      // verify
+      assertUnit(Spy::numCopy() == 6);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(!v.is_inline());
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 6);
+      if (v.numElements == 6)
+      {
+         assertUnit(v.data[0] == Spy(99));
+         assertUnit(v.data[5] == Spy(99));
+      }
+   }  // teardown
+
+   // copy an inline vector
+   void test_constructCopy_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> vSrc;
+      setupStandardFixture(vSrc);
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> vDest(vSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 3);
+      assertUnit(Spy::numAlloc() == 3);
+      assertUnit(vDest.is_inline());
+      assertStandardFixture(vSrc);
+      assertStandardFixture(vDest);
+   }  // teardown
+
+   // moving an inline vector moves each element
+   void test_constructMove_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> vSrc;
+      setupStandardFixture(vSrc);
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> vDest(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopyMove() == 3);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(vSrc.numElements == 0);
+      assertUnit(vSrc.is_inline());
+      assertUnit(vDest.is_inline());
+      assertStandardFixture(vDest);
+   }  // teardown
+
+   // moving a heap vector steals the buffer
+   void test_constructMove_heap()
+   {  // setup
+      custom::small_vector<Spy, 2> vSrc;
+      setupStandardFixture(vSrc);
+      Spy* p = vSrc.data;
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 2> vDest(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(vDest.data == p);
+      assertUnit(vSrc.is_inline());
+      assertUnit(vSrc.numElements == 0);
+      assertUnit(vSrc.numCapacity == 2);
+      assertStandardFixture(vDest);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // copy a heap vector onto an inline one
+   void test_assign_inlineToHeap()
+   {  // setup
+      custom::small_vector<Spy, 2> vSrc;
+      setupStandardFixture(vSrc);
+      custom::small_vector<Spy, 2> vDest;
+      vDest.push_back(Spy(50));
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertUnit(!vDest.is_inline());
+      assertStandardFixture(vSrc);
+      assertStandardFixture(vDest);
+   }  // teardown
+
+   // swap an inline vector with a heap vector
+   void test_swap_inlineHeap()
+   {  // setup
+      custom::small_vector<Spy, 2> vLeft;
+      setupStandardFixture(vLeft);
+      custom::small_vector<Spy, 2> vRight;
+      vRight.push_back(Spy(50));
+      // exercise
+      vLeft.swap(vRight);
+      // verify
+      assertUnit(vLeft.is_inline());
+      assertUnit(vLeft.numElements == 1);
+      if (vLeft.numElements == 1)
+         assertUnit(vLeft.data[0] == Spy(50));
+      assertStandardFixture(vRight);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push while there is still room inline
+   void test_pushback_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      v.push_back(s);
+      v.push_back(s);
+      // verify
+      assertUnit(Spy::numCopy() == 2);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(v.is_inline());
+      assertUnit(v.numElements == 2);
+      assertUnit(v.numCapacity == 4);
+   }  // teardown
+
+   // push past the inline capacity
+   void test_pushback_spill()
+   {  // setup
+      custom::small_vector<Spy, 3> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      v.push_back(Spy(99));
+      // verify
+      assertUnit(Spy::numCopyMove() == 4);   // move [11,26,31] and [99]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(!v.is_inline());
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 4);
+      if (v.numElements == 4)
+      {
+         assertUnit(v.data[0] == Spy(11));
+         assertUnit(v.data[3] == Spy(99));
+      }
+   }  // teardown
+
+   // insert in front of the second element
+   void test_insert_middle()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      setupStandardFixture(v);
+      // exercise
+      custom::small_vector<Spy, 4>::iterator it = v.insert(++v.begin(), Spy(20));
+      // verify
+      assertUnit(*it == Spy(20));
+      assertUnit(v.numElements == 4);
+      if (v.numElements == 4)
+      {
+         assertUnit(v.data[0] == Spy(11));
+         assertUnit(v.data[1] == Spy(20));
+         assertUnit(v.data[2] == Spy(26));
+         assertUnit(v.data[3] == Spy(31));
+      }
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase the middle element, the next one slides into place
+   void test_erase_middle()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      setupStandardFixture(v);
+      // exercise
+      custom::small_vector<Spy, 4>::iterator it = v.erase(++v.begin());
+      // verify
+      assertUnit(it != v.end());
+      if (it != v.end())
+         assertUnit(*it == Spy(31));
+      assertUnit(v.numElements == 2);
+      if (v.numElements == 2)
+      {
+         assertUnit(v.data[0] == Spy(11));
+         assertUnit(v.data[1] == Spy(31));
+      }
+   }  // teardown
+
+   // erase the last element returns end()
+   void test_erase_last()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      setupStandardFixture(v);
+      custom::small_vector<Spy, 4>::iterator it = v.begin();
+      ++it;
+      ++it;
+      // exercise
+      it = v.erase(it);
+      // verify
+      assertUnit(it == v.end());
+      assertUnit(v.numElements == 2);
+   }  // teardown
+
+   // shrinking a heap vector that now fits goes back inline
+   void test_shrink_backToInline()
+   {  // setup
+      custom::small_vector<Spy, 2> v;
+      setupStandardFixture(v);
+      v.pop_back();
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.is_inline());
+      assertUnit(v.numCapacity == 2);
+      assertUnit(v.numElements == 2);
+      if (v.numElements == 2)
+      {
+         assertUnit(v.data[0] == Spy(11));
+         assertUnit(v.data[1] == Spy(26));
+      }
+   }  // teardown
+
+   /***************************************
+    * HASH BUCKET
+    ***************************************/
+
+   // use a small vector as the chain of an unordered set
+   void test_hash_smallVectorBucket()
+   {  // setup
+      custom::unordered_set<Spy, std::hash<Spy>, std::equal_to<Spy>,
+                            std::allocator<Spy>, custom::small_vector<Spy, 2>> us;
+      // exercise
+      for (int i = 1; i <= 20; i++)
+         us.insert(Spy(i * 7));
+      us.erase(Spy(14));
+      us.erase(Spy(70));
+      // verify
+      assertUnit(us.size() == 18);
+      assertUnit(us.find(Spy(7)) != us.end());
+      assertUnit(us.find(Spy(140)) != us.end());
+      assertUnit(us.find(Spy(14)) == us.end());
+      assertUnit(us.find(Spy(70)) == us.end());
+      int count = 0;
+      for (auto it = us.begin(); it != us.end(); ++it)
+         count++;
+      assertUnit(count == 18);
+   }  // teardown
+
+   /*************************************************************
+    * SETUP STANDARD FIXTURE
+    *      0    1    2
+    *    +----+----+----+
+    *    | 11 | 26 | 31 |
+    *    +----+----+----+
+    *************************************************************/
+   template <size_t N>
+   void setupStandardFixture(custom::small_vector<Spy, N>& v)
+   {
+      v.push_back(Spy(11));
+      v.push_back(Spy(26));
+      v.push_back(Spy(31));
+   }
+
+   /*************************************************************
+    * VERIFY STANDARD FIXTURE PARAMETERS
+    *************************************************************/
+   template <size_t N>
+   void assertStandardFixtureParameters(const custom::small_vector<Spy, N>& v, int line, const char* function)
+   {
+      assertIndirect(v.numElements == 3);
+      if (v.numElements == 3)
+      {
+         assertIndirect(v.data[0] == Spy(11));
+         assertIndirect(v.data[1] == Spy(26));
+         assertIndirect(v.data[2] == Spy(31));
+      }
+   }
+};
+
+#endif // DEBUG
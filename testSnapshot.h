@@ -0,0 +1,339 @@
+/***********************************************************************
+ * Header:
+ *    TEST SNAPSHOT
+ * Summary:
+ *    Unit tests for saving and loading unordered_set
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "hash.h"
+#include "snapshot.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#ifdef CUSTOM_SNAPSHOT_POSIX
+#include <unistd.h>
+#endif
+
+/***************************************
+ * STRING SERIALIZER
+ * A length, then the characters
+ ***************************************/
+struct StringSerializer
+{
+   static const uint32_t elementSize = 0;
+   static void write(std::ostream& out, const std::string& s)
+   {
+      uint32_t length = (uint32_t)s.size();
+      out.write((const char*)&length, sizeof(length));
+      out.write(s.data(), length);
+   }
+   static bool read(std::istream& in, std::string& s)
+   {
+      uint32_t length;
+      if (!in.read((char*)&length, sizeof(length)))
+         return false;
+      s.resize(length);
+      return length == 0 || (bool)in.read(&s[0], length);
+   }
+};
+
+class TestSnapshot : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Save
+      test_save_header();
+      test_save_bucketOrder();
+      test_save_empty();
+
+      // Load
+      test_load_roundTrip();
+      test_load_presized();
+      test_load_sameBuckets();
+      test_load_replaces();
+      test_load_customSerializer();
+
+      // Errors
+      test_load_notOurs();
+      test_load_wrongElementSize();
+      test_load_truncated();
+
+      // File
+      test_saveLoad_fd();
+
+      report("Snapshot");
+   }
+
+   /***************************************
+    * SAVE
+    ***************************************/
+
+   // the header describes the table
+   void test_save_header()
+   {  // setup
+      custom::unordered_set<int> us(11);
+      us.max_load_factor(0.75f);
+      us.insert(26);
+      us.insert(49);
+      std::stringstream ss;
+      // exercise
+      bool saved = us.save(ss);
+      // verify
+      assertUnit(saved);
+      std::string bytes = ss.str();
+      assertUnit(bytes.size() == sizeof(custom::snapshot_header) + 2 * sizeof(int));
+      custom::snapshot_header header;
+      std::memcpy(&header, bytes.data(), sizeof(header));
+      assertUnit(header.magic == custom::SNAPSHOT_MAGIC);
+      assertUnit(header.version == custom::SNAPSHOT_VERSION);
+      assertUnit(header.elementSize == sizeof(int));
+      assertUnit(header.numElements == 2);
+      assertUnit(header.numBuckets == 11);
+      assertUnit(header.maxLoadFactor == 0.75f);
+   }  // teardown
+
+   // the elements follow in the order the iterator visits them
+   void test_save_bucketOrder()
+   {  // setup
+      custom::unordered_set<int> us(4);
+      for (int i : { 31, 49, 67, 59, 7, 12 })
+         us.insert(i);
+      std::stringstream ss;
+      // exercise
+      us.save(ss);
+      // verify
+      std::string bytes = ss.str();
+      bool same = true;
+      size_t offset = sizeof(custom::snapshot_header);
+      for (auto it = us.begin(); it != us.end(); ++it, offset += sizeof(int))
+      {
+         int saved;
+         std::memcpy(&saved, bytes.data() + offset, sizeof(int));
+         same = same && saved == *it;
+      }
+      assertUnit(same);
+      assertUnit(offset == bytes.size());
+   }  // teardown
+
+   // just a header
+   void test_save_empty()
+   {  // setup
+      custom::unordered_set<int> us;
+      std::stringstream ss;
+      // exercise
+      us.save(ss);
+      custom::unordered_set<int> copy;
+      bool loaded = copy.load(ss);
+      // verify
+      assertUnit(ss.str().size() == sizeof(custom::snapshot_header));
+      assertUnit(loaded);
+      assertUnit(copy.empty());
+      assertUnit(copy.bucket_count() == 8);
+   }  // teardown
+
+   /***************************************
+    * LOAD
+    ***************************************/
+
+   // everything comes back
+   void test_load_roundTrip()
+   {  // setup
+      custom::unordered_set<uint64_t> us;
+      for (uint64_t i = 0; i < 50000; i++)
+         us.insert(i * 2654435761ull);
+      std::stringstream ss;
+      us.save(ss);
+      custom::unordered_set<uint64_t> copy;
+      // exercise
+      bool loaded = copy.load(ss);
+      // verify
+      assertUnit(loaded);
+      assertUnit(copy.size() == 50000);
+      bool all = true;
+      for (uint64_t i = 0; i < 50000; i++)
+         all = all && copy.find(i * 2654435761ull) != copy.end();
+      assertUnit(all);
+      assertUnit(copy.find(1) == copy.end());
+   }  // teardown
+
+   // the bucket count comes from the header, not from growing
+   void test_load_presized()
+   {  // setup
+      custom::unordered_set<int> us;
+      us.max_load_factor(4.0f);
+      for (int i = 0; i < 1000; i++)
+         us.insert(i);
+      size_t numBuckets = us.bucket_count();
+      std::stringstream ss;
+      us.save(ss);
+      custom::unordered_set<int> copy;
+      // exercise
+      copy.load(ss);
+      // verify
+      assertUnit(copy.bucket_count() == numBuckets);
+      assertUnit(copy.max_load_factor() == 4.0f);
+      assertUnit(copy.size() == 1000);
+   }  // teardown
+
+   // every bucket holds what it held, in the same order
+   void test_load_sameBuckets()
+   {  // setup
+      custom::unordered_set<int> us(7);
+      us.max_load_factor(3.0f);
+      for (int i = 0; i < 20; i++)
+         us.insert(i * 13);
+      std::stringstream ss;
+      us.save(ss);
+      custom::unordered_set<int> copy;
+      // exercise
+      copy.load(ss);
+      // verify
+      assertUnit(copy.bucket_count() == 7);
+      bool same = true;
+      for (size_t i = 0; i < 7; i++)
+      {
+         auto itCopy = copy.begin(i);
+         for (auto it = us.begin(i); it != us.end(i); ++it, ++itCopy)
+            same = same && itCopy != copy.end(i) && *itCopy == *it;
+         same = same && itCopy == copy.end(i);
+      }
+      assertUnit(same);
+   }  // teardown
+
+   // whatever was there is gone
+   void test_load_replaces()
+   {  // setup
+      custom::unordered_set<int> us;
+      us.insert(26);
+      std::stringstream ss;
+      us.save(ss);
+      custom::unordered_set<int> copy;
+      copy.insert(49);
+      copy.insert(67);
+      // exercise
+      copy.load(ss);
+      // verify
+      assertUnit(copy.size() == 1);
+      assertUnit(copy.find(26) != copy.end());
+      assertUnit(copy.find(49) == copy.end());
+   }  // teardown
+
+   // a type that is not its own bytes
+   void test_load_customSerializer()
+   {  // setup
+      custom::unordered_set<std::string> us;
+      us.insert("alpha");
+      us.insert("");
+      us.insert(std::string(300, 'x'));
+      std::stringstream ss;
+      us.save<StringSerializer>(ss);
+      custom::unordered_set<std::string> copy;
+      // exercise
+      bool loaded = copy.load<StringSerializer>(ss);
+      // verify
+      assertUnit(loaded);
+      assertUnit(copy.size() == 3);
+      assertUnit(copy.find("alpha") != copy.end());
+      assertUnit(copy.find("") != copy.end());
+      assertUnit(copy.find(std::string(300, 'x')) != copy.end());
+   }  // teardown
+
+   /***************************************
+    * ERRORS
+    ***************************************/
+
+   // bytes we did not write
+   void test_load_notOurs()
+   {  // setup
+      std::stringstream ss(std::string(100, 'z'));
+      custom::unordered_set<int> us;
+      us.insert(26);
+      // exercise
+      bool loaded = us.load(ss);
+      // verify
+      assertUnit(!loaded);
+      assertUnit(us.empty());
+   }  // teardown
+
+   // a snapshot of some other type
+   void test_load_wrongElementSize()
+   {  // setup
+      custom::unordered_set<int> us;
+      us.insert(26);
+      std::stringstream ss;
+      us.save(ss);
+      custom::unordered_set<uint64_t> other;
+      // exercise
+      bool loaded = other.load(ss);
+      // verify
+      assertUnit(!loaded);
+      assertUnit(other.empty());
+   }  // teardown
+
+   // the stream ends before the last element
+   void test_load_truncated()
+   {  // setup
+      custom::unordered_set<int> us;
+      for (int i = 0; i < 100; i++)
+         us.insert(i);
+      std::stringstream full;
+      us.save(full);
+      std::string bytes = full.str();
+      std::stringstream ss(bytes.substr(0, bytes.size() - 2));
+      custom::unordered_set<int> copy;
+      // exercise
+      bool loaded = copy.load(ss);
+      // verify
+      assertUnit(!loaded);
+      assertUnit(copy.empty());
+   }  // teardown
+
+   /***************************************
+    * FILE
+    ***************************************/
+
+   // through a file descriptor
+   void test_saveLoad_fd()
+   {
+#ifdef CUSTOM_SNAPSHOT_POSIX
+      // setup
+      char path[] = "/tmp/snapshotXXXXXX";
+      int fd = mkstemp(path);
+      assert(fd >= 0);
+      custom::unordered_set<int> us;
+      for (int i = 0; i < 30000; i++)
+         us.insert(i);
+      // exercise
+      bool saved = us.save(fd);
+      lseek(fd, 0, SEEK_SET);
+      custom::unordered_set<int> copy;
+      bool loaded = copy.load(fd);
+      // verify
+      assertUnit(saved);
+      assertUnit(loaded);
+      assertUnit(copy.size() == 30000);
+      assertUnit(copy.bucket_count() == us.bucket_count());
+      assertUnit(copy.find(29999) != copy.end());
+      // teardown
+      close(fd);
+      unlink(path);
+#endif // CUSTOM_SNAPSHOT_POSIX
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,273 @@
+/***********************************************************************
+ * Header:
+ *    TEST SOA VECTOR
+ * Summary:
+ *    Unit tests for soa_vector
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "soa_vector.h"
+#include "simd.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <tuple>
+
+class TestSoaVector : public UnitTest
+{
+   typedef custom::soa_vector<int, double, std::string> Record;
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_size();
+
+      // Insert
+      test_pushBack_fields();
+      test_pushBack_tuple();
+      test_reserve_everyColumn();
+
+      // Access
+      test_get_oneField();
+      test_column_contiguous();
+      test_column_scan();
+      test_reference_toTuple();
+      test_reference_assign();
+      test_iterator_walk();
+
+      // Remove
+      test_popBack_everyColumn();
+      test_clear_spy();
+      test_swap_standard();
+
+      report("SoaVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // no rows, one column per field
+   void test_construct_default()
+   {  // setup
+      // exercise
+      Record r;
+      // verify
+      assertUnit(r.size() == 0);
+      assertUnit(r.empty());
+      assertUnit(Record::field_count() == 3);
+      assertUnit(r.column<0>().data() == nullptr);
+   }  // teardown
+
+   // value-initialized rows
+   void test_construct_size()
+   {  // setup
+      // exercise
+      Record r(5);
+      // verify
+      assertUnit(r.size() == 5);
+      assertUnit(std::get<1>(r.columns).size() == 5);
+      assertUnit(std::get<2>(r.columns).size() == 5);
+      assertUnit(r.get<0>(4) == 0);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // each field goes to its own column
+   void test_pushBack_fields()
+   {  // setup
+      Record r;
+      // exercise
+      r.push_back(26, 2.6, "twenty six");
+      r.push_back(49, 4.9, "forty nine");
+      // verify
+      assertUnit(r.size() == 2);
+      assertUnit(std::get<0>(r.columns)[1] == 49);
+      assertUnit(std::get<1>(r.columns)[0] == 2.6);
+      assertUnit(std::get<2>(r.columns)[1] == "forty nine");
+   }  // teardown
+
+   // a whole row at once
+   void test_pushBack_tuple()
+   {  // setup
+      Record r;
+      // exercise
+      r.push_back(std::make_tuple(67, 6.7, std::string("sixty seven")));
+      // verify
+      assertUnit(r.size() == 1);
+      assertUnit(r.get<2>(0) == "sixty seven");
+   }  // teardown
+
+   // capacity grows in every column together
+   void test_reserve_everyColumn()
+   {  // setup
+      Record r;
+      // exercise
+      r.reserve(100);
+      // verify
+      assertUnit(r.capacity() == 100);
+      assertUnit(std::get<1>(r.columns).capacity() == 100);
+      assertUnit(std::get<2>(r.columns).capacity() == 100);
+      assertUnit(r.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // change one field of one row
+   void test_get_oneField()
+   {  // setup
+      Record r;
+      fill(r, 10);
+      // exercise
+      r.get<1>(3) = 89.0;
+      // verify
+      assertUnit(r.get<1>(3) == 89.0);
+      assertUnit(r.get<0>(3) == 3);
+      assertUnit(r.get<1>(4) == 2.0);
+   }  // teardown
+
+   // a column is one array, neighbours are adjacent
+   void test_column_contiguous()
+   {  // setup
+      Record r;
+      fill(r, 10);
+      // exercise
+      custom::span<int> keys = r.column<0>();
+      // verify
+      assertUnit(keys.size() == 10);
+      assertUnit(&keys[1] == &keys[0] + 1);
+      assertUnit(keys.end() - keys.begin() == 10);
+      assertUnit(keys[9] == 9);
+   }  // teardown
+
+   // the scan kernels run over a single column
+   void test_column_scan()
+   {  // setup
+      Record r;
+      fill(r, 1000);
+      // exercise
+      int64_t total = custom::sum(r.column_vector<0>());
+      // verify
+      assertUnit(total == 999 * 1000 / 2);
+   }  // teardown
+
+   // gather a row
+   void test_reference_toTuple()
+   {  // setup
+      Record r;
+      fill(r, 3);
+      // exercise
+      std::tuple<int, double, std::string> row = r[2];
+      // verify
+      assertUnit(std::get<0>(row) == 2);
+      assertUnit(std::get<1>(row) == 1.0);
+      assertUnit(std::get<2>(row) == "2");
+   }  // teardown
+
+   // scatter a row
+   void test_reference_assign()
+   {  // setup
+      Record r;
+      fill(r, 3);
+      // exercise
+      r[1] = std::make_tuple(49, 4.9, std::string("forty nine"));
+      // verify
+      assertUnit(r.get<0>(1) == 49);
+      assertUnit(r.get<1>(1) == 4.9);
+      assertUnit(r.get<2>(1) == "forty nine");
+      assertUnit(r.get<0>(2) == 2);
+      assertUnit(r[1].row_index() == 1);
+   }  // teardown
+
+   // visit the rows in order
+   void test_iterator_walk()
+   {  // setup
+      Record r;
+      fill(r, 5);
+      // exercise
+      int total = 0;
+      for (Record::iterator it = r.begin(); it != r.end(); ++it)
+         total += (*it).get<0>();
+      // verify
+      assertUnit(total == 10);
+      assertUnit(r.front().get<2>() == "0");
+      assertUnit(r.back().get<2>() == "4");
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // the last row leaves every column
+   void test_popBack_everyColumn()
+   {  // setup
+      Record r;
+      fill(r, 3);
+      // exercise
+      r.pop_back();
+      // verify
+      assertUnit(r.size() == 2);
+      assertUnit(std::get<1>(r.columns).size() == 2);
+      assertUnit(std::get<2>(r.columns).size() == 2);
+   }  // teardown
+
+   // a field with a destructor is destroyed once
+   void test_clear_spy()
+   {  // setup
+      custom::soa_vector<int, Spy> r;
+      r.push_back(26, Spy(26));
+      r.push_back(49, Spy(49));
+      Spy::reset();
+      // exercise
+      r.clear();
+      // verify
+      assertUnit(r.size() == 0);
+      assertUnit(std::get<1>(r.columns).size() == 0);
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(Spy::numAlloc() == 0);
+   }  // teardown
+
+   // columns trade places, nothing is copied
+   void test_swap_standard()
+   {  // setup
+      Record a;
+      Record b;
+      fill(a, 4);
+      fill(b, 1);
+      int* keys = &a.get<0>(0);
+      // exercise
+      a.swap(b);
+      // verify
+      assertUnit(a.size() == 1);
+      assertUnit(b.size() == 4);
+      assertUnit(&b.get<0>(0) == keys);
+   }  // teardown
+
+   /*************************************************************
+    * FILL
+    * row i is (i, i / 2.0, "i")
+    *************************************************************/
+   void fill(Record& r, int num)
+   {
+      for (int i = 0; i < num; i++)
+         r.push_back(i, i / 2.0, std::to_string(i));
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,270 @@
+/***********************************************************************
+ * Header:
+ *    TEST SORT
+ * Summary:
+ *    Unit tests for sort and parallel_sort
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "sort.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+
+class TestSort : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // radix keys
+      test_radixKey_signedOrder();
+      test_radixKey_floatOrder();
+
+      // sort
+      test_sort_empty();
+      test_sort_small();
+      test_sort_intRadix();
+      test_sort_byteSkipsPasses();
+      test_sort_doubleNegative();
+      test_sort_comparator();
+      test_sort_spy();
+
+      // parallel sort
+      test_parallelSort_int();
+      test_parallelSort_float();
+      test_parallelSort_comparator();
+      test_parallelSort_unevenBlocks();
+
+      report("Sort");
+   }
+
+   /***************************************
+    * RADIX KEY
+    ***************************************/
+
+   // negative numbers map below positive ones
+   void test_radixKey_signedOrder()
+   {  // setup
+      // exercise
+      uint32_t a = custom::sort_detail::radix_key<int>::get(-5);
+      uint32_t b = custom::sort_detail::radix_key<int>::get(0);
+      uint32_t c = custom::sort_detail::radix_key<int>::get(7);
+      // verify
+      assertUnit(a < b);
+      assertUnit(b < c);
+   }  // teardown
+
+   // more negative floats map lower
+   void test_radixKey_floatOrder()
+   {  // setup
+      // exercise
+      uint32_t a = custom::sort_detail::radix_key<float>::get(-2.5f);
+      uint32_t b = custom::sort_detail::radix_key<float>::get(-1.0f);
+      uint32_t c = custom::sort_detail::radix_key<float>::get(0.0f);
+      uint32_t d = custom::sort_detail::radix_key<float>::get(3.0f);
+      // verify
+      assertUnit(a < b);
+      assertUnit(b < c);
+      assertUnit(c < d);
+   }  // teardown
+
+   /***************************************
+    * SORT
+    ***************************************/
+
+   // nothing to do
+   void test_sort_empty()
+   {  // setup
+      custom::vector<int> v;
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(v.size() == 0);
+   }  // teardown
+
+   // under the radix threshold
+   void test_sort_small()
+   {  // setup
+      custom::vector<int> v{ 67, 26, 89, 49 };
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(v[0] == 26);
+      assertUnit(v[1] == 49);
+      assertUnit(v[2] == 67);
+      assertUnit(v[3] == 89);
+   }  // teardown
+
+   // a large vector of mixed sign integers
+   void test_sort_intRadix()
+   {  // setup
+      custom::vector<int> v;
+      fillRandom(v, 5000);
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(v.size() == 5000);
+      assertUnit(isSorted(v));
+   }  // teardown
+
+   // small values leave the upper bytes alone
+   void test_sort_byteSkipsPasses()
+   {  // setup
+      custom::vector<uint64_t> v;
+      for (uint64_t i = 0; i < 1000; i++)
+         v.push_back((i * 37) % 200);
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(isSorted(v));
+      assertUnit(v[0] == 0);
+      assertUnit(v[999] == 199);
+   }  // teardown
+
+   // doubles with negatives
+   void test_sort_doubleNegative()
+   {  // setup
+      custom::vector<double> v;
+      fillRandom(v, 3000);
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(isSorted(v));
+   }  // teardown
+
+   // a comparator sorts the other way
+   void test_sort_comparator()
+   {  // setup
+      custom::vector<int> v;
+      fillRandom(v, 1000);
+      // exercise
+      custom::sort(v, std::greater<int>());
+      // verify
+      bool ok = true;
+      for (size_t i = 1; i < v.size(); i++)
+         ok = ok && !(v[i - 1] < v[i]);
+      assertUnit(ok);
+   }  // teardown
+
+   // a non-arithmetic type uses the comparison sort
+   void test_sort_spy()
+   {  // setup
+      custom::vector<Spy> v;
+      v.push_back(Spy(67));
+      v.push_back(Spy(26));
+      v.push_back(Spy(89));
+      // exercise
+      custom::sort(v);
+      // verify
+      assertUnit(v[0] == Spy(26));
+      assertUnit(v[1] == Spy(67));
+      assertUnit(v[2] == Spy(89));
+   }  // teardown
+
+   /***************************************
+    * PARALLEL SORT
+    ***************************************/
+
+   // radix sort spread over four threads
+   void test_parallelSort_int()
+   {  // setup
+      custom::thread_pool pool(3);
+      custom::vector<int> v;
+      fillRandom(v, 100000);
+      int64_t before = total(v);
+      // exercise
+      custom::parallel_sort(v, pool);
+      // verify
+      assertUnit(v.size() == 100000);
+      assertUnit(isSorted(v));
+      assertUnit(total(v) == before);
+   }  // teardown
+
+   // floats through the parallel radix sort
+   void test_parallelSort_float()
+   {  // setup
+      custom::thread_pool pool(3);
+      custom::vector<float> v;
+      fillRandom(v, 70000);
+      // exercise
+      custom::parallel_sort(v, pool);
+      // verify
+      assertUnit(isSorted(v));
+   }  // teardown
+
+   // merge sort with a comparator
+   void test_parallelSort_comparator()
+   {  // setup
+      custom::thread_pool pool(3);
+      custom::vector<int> v;
+      fillRandom(v, 100000);
+      int64_t before = total(v);
+      // exercise
+      custom::parallel_sort(v, std::greater<int>(), pool);
+      // verify
+      bool ok = true;
+      for (size_t i = 1; i < v.size(); i++)
+         ok = ok && !(v[i - 1] < v[i]);
+      assertUnit(ok);
+      assertUnit(total(v) == before);
+   }  // teardown
+
+   // three blocks leave an odd run out of the first merge round
+   void test_parallelSort_unevenBlocks()
+   {  // setup
+      custom::thread_pool pool(2);
+      custom::vector<long> v;
+      fillRandom(v, 50001);
+      // exercise
+      custom::parallel_sort(v, std::less<long>(), pool);
+      // verify
+      assertUnit(v.size() == 50001);
+      assertUnit(isSorted(v));
+   }  // teardown
+
+   /*************************************************************
+    * FILL RANDOM
+    * Deterministic pseudo-random values of both signs
+    *************************************************************/
+   template <typename T>
+   void fillRandom(custom::vector<T>& v, size_t num)
+   {
+      uint32_t seed = 12345;
+      for (size_t i = 0; i < num; i++)
+      {
+         seed = seed * 1103515245u + 12345u;
+         v.push_back((T)((int32_t)(seed >> 1) - (1 << 30)) / (T)3);
+      }
+   }
+
+   template <typename T>
+   bool isSorted(custom::vector<T>& v)
+   {
+      for (size_t i = 1; i < v.size(); i++)
+         if (v[i] < v[i - 1])
+            return false;
+      return true;
+   }
+
+   template <typename T>
+   int64_t total(custom::vector<T>& v)
+   {
+      int64_t sum = 0;
+      for (size_t i = 0; i < v.size(); i++)
+         sum += (int64_t)v[i];
+      return sum;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,126 @@
+/***********************************************************************
+ * Header:
+ *    TEST THREAD POOL
+ * Summary:
+ *    Unit tests for thread_pool
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "thread_pool.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <cassert>
+#include <vector>
+
+class TestThreadPool : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_size();
+
+      // Run
+      test_parallelFor_zero();
+      test_parallelFor_everyIndexOnce();
+      test_parallelFor_noWorkers();
+      test_parallelFor_nested();
+      test_submit_runs();
+
+      report("ThreadPool");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // the pool has the threads we asked for
+   void test_construct_size()
+   {  // setup
+      // exercise
+      custom::thread_pool pool(3);
+      // verify
+      assertUnit(pool.size() == 3);
+      assertUnit(pool.workers.size() == 3);
+   }  // teardown
+
+   /***************************************
+    * RUN
+    ***************************************/
+
+   // no tasks, nothing happens
+   void test_parallelFor_zero()
+   {  // setup
+      custom::thread_pool pool(2);
+      int calls = 0;
+      // exercise
+      pool.parallel_for(0, [&](size_t) { calls++; });
+      // verify
+      assertUnit(calls == 0);
+   }  // teardown
+
+   // every index is visited exactly once
+   void test_parallelFor_everyIndexOnce()
+   {  // setup
+      custom::thread_pool pool(4);
+      std::vector<std::atomic<int>> hits(1000);
+      for (auto& hit : hits)
+         hit = 0;
+      // exercise
+      pool.parallel_for(hits.size(), [&](size_t i) { hits[i]++; });
+      // verify
+      bool allOnce = true;
+      for (auto& hit : hits)
+         allOnce = allOnce && (hit == 1);
+      assertUnit(allOnce);
+   }  // teardown
+
+   // a pool with no workers runs everything on the caller
+   void test_parallelFor_noWorkers()
+   {  // setup
+      custom::thread_pool pool(0);
+      size_t total = 0;
+      // exercise
+      pool.parallel_for(10, [&](size_t i) { total += i; });
+      // verify
+      assertUnit(total == 45);
+   }  // teardown
+
+   // a task may itself call parallel_for without deadlocking
+   void test_parallelFor_nested()
+   {  // setup
+      custom::thread_pool pool(2);
+      std::atomic<int> total(0);
+      // exercise
+      pool.parallel_for(4, [&](size_t)
+      {
+         pool.parallel_for(4, [&](size_t) { total++; });
+      });
+      // verify
+      assertUnit(total == 16);
+   }  // teardown
+
+   // a submitted task runs before the pool shuts down
+   void test_submit_runs()
+   {  // setup
+      std::atomic<int> ran(0);
+      // exercise
+      {
+         custom::thread_pool pool(1);
+         pool.submit([&]() { ran++; });
+      }
+      // verify
+      assertUnit(ran == 1);
+   }  // teardown
+};
+
+#endif // DEBUG
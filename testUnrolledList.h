@@ -0,0 +1,353 @@
+/***********************************************************************
+ * Header:
+ *    TEST UNROLLED LIST
+ * Summary:
+ *    Unit tests for unrolled_list
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "unrolled_list.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <list>
+
+class TestUnrolledList : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_initializerList();
+      test_constructCopy_standard();
+      test_constructMove_standard();
+
+      // Insert
+      test_pushBack_packsNodes();
+      test_pushFront_standard();
+      test_insert_middle();
+      test_insert_splitsFullNode();
+      test_insert_end();
+
+      // Remove
+      test_erase_returnsNext();
+      test_erase_emptiesNode();
+      test_erase_mergesNeighbour();
+      test_pop_bothEnds();
+      test_clear_spy();
+
+      // Access
+      test_iterator_backwards();
+      test_find_standard();
+      test_random_matchesStdList();
+
+      report("UnrolledList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // no nodes at all
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::unrolled_list<int> l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.size() == 0);
+      assertUnit(l.node_count() == 0);
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // four elements in one node
+   void test_construct_initializerList()
+   {  // setup
+      // exercise
+      custom::unrolled_list<int, 4> l{ 26, 49, 67, 89 };
+      // verify
+      assertUnit(l.size() == 4);
+      assertUnit(l.node_count() == 1);
+      assertUnit(l.front() == 26);
+      assertUnit(l.back() == 89);
+   }  // teardown
+
+   // an independent copy
+   void test_constructCopy_standard()
+   {  // setup
+      custom::unrolled_list<int, 4> src{ 1, 2, 3, 4, 5, 6 };
+      // exercise
+      custom::unrolled_list<int, 4> dest(src);
+      src.front() = 99;
+      // verify
+      assertUnit(dest.size() == 6);
+      assertUnit(dest.front() == 1);
+      assertUnit(dest.back() == 6);
+      assertUnit(src.pHead != dest.pHead);
+   }  // teardown
+
+   // the nodes change owner
+   void test_constructMove_standard()
+   {  // setup
+      custom::unrolled_list<int, 4> src{ 1, 2, 3, 4, 5 };
+      void* pHead = src.pHead;
+      // exercise
+      custom::unrolled_list<int, 4> dest(std::move(src));
+      // verify
+      assertUnit(src.empty());
+      assertUnit(src.pHead == nullptr);
+      assertUnit(dest.size() == 5);
+      assertUnit((void*)dest.pHead == pHead);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // pushing fills each node before starting the next
+   void test_pushBack_packsNodes()
+   {  // setup
+      custom::unrolled_list<int, 8> l;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         l.push_back(i);
+      // verify
+      assertUnit(l.size() == 100);
+      assertUnit(l.node_count() == 13);
+      assertUnit(l.pHead->count == 8);
+      assertUnit(l.pTail->count == 4);
+      assertUnit(sequence(l, 0, 100));
+   }  // teardown
+
+   // push front keeps order
+   void test_pushFront_standard()
+   {  // setup
+      custom::unrolled_list<int, 4> l;
+      // exercise
+      for (int i = 9; i >= 0; i--)
+         l.push_front(i);
+      // verify
+      assertUnit(l.size() == 10);
+      assertUnit(l.node_count() == 3);
+      assertUnit(sequence(l, 0, 10));
+   }  // teardown
+
+   // room in the node, the rest slide over
+   void test_insert_middle()
+   {  // setup
+      custom::unrolled_list<int, 8> l{ 0, 1, 3, 4 };
+      custom::unrolled_list<int, 8>::iterator it = l.find(3);
+      // exercise
+      it = l.insert(it, 2);
+      // verify
+      assertUnit(*it == 2);
+      assertUnit(l.size() == 5);
+      assertUnit(l.node_count() == 1);
+      assertUnit(sequence(l, 0, 5));
+   }  // teardown
+
+   // a full node splits in half
+   void test_insert_splitsFullNode()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 0, 1, 2, 4 };
+      custom::unrolled_list<int, 4>::iterator it = l.find(4);
+      // exercise
+      it = l.insert(it, 3);
+      // verify
+      assertUnit(*it == 3);
+      assertUnit(l.node_count() == 2);
+      assertUnit(l.pHead->count == 2);
+      assertUnit(l.pTail->count == 3);
+      assertUnit(sequence(l, 0, 5));
+   }  // teardown
+
+   // inserting before end appends
+   void test_insert_end()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 0, 1 };
+      // exercise
+      custom::unrolled_list<int, 4>::iterator it = l.insert(l.end(), 2);
+      // verify
+      assertUnit(*it == 2);
+      assertUnit(l.back() == 2);
+      assertUnit(sequence(l, 0, 3));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // the iterator points at what followed
+   void test_erase_returnsNext()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 0, 1, 2, 3, 4, 5, 6, 7 };
+      // exercise
+      custom::unrolled_list<int, 4>::iterator it = l.erase(l.find(3));
+      // verify
+      assertUnit(*it == 4);
+      assertUnit(l.size() == 7);
+   }  // teardown
+
+   // the last element of a node takes the node with it
+   void test_erase_emptiesNode()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 0, 1, 2, 3, 4 };
+      // exercise
+      custom::unrolled_list<int, 4>::iterator it = l.erase(l.find(4));
+      // verify
+      assertUnit(it == l.end());
+      assertUnit(l.node_count() == 1);
+      assertUnit(l.pTail == l.pHead);
+   }  // teardown
+
+   // a thin node pulls in its neighbour
+   void test_erase_mergesNeighbour()
+   {  // setup
+      custom::unrolled_list<int, 8> l;
+      for (int i = 0; i < 12; i++)
+         l.push_back(i);
+      for (int i = 0; i < 4; i++)
+         l.pop_front();
+      assertUnit(l.node_count() == 2);
+      assertUnit(l.pHead->count == 4);
+      // exercise
+      custom::unrolled_list<int, 8>::iterator it = l.erase(l.find(4));
+      // verify
+      assertUnit(l.node_count() == 1);
+      assertUnit(l.pHead->count == 7);
+      assertUnit(*it == 5);
+      assertUnit(sequence(l, 5, 12));
+   }  // teardown
+
+   // pop until empty from both ends
+   void test_pop_bothEnds()
+   {  // setup
+      custom::unrolled_list<int, 4> l;
+      for (int i = 0; i < 10; i++)
+         l.push_back(i);
+      // exercise
+      l.pop_front();
+      l.pop_back();
+      // verify
+      assertUnit(sequence(l, 1, 9));
+      while (!l.empty())
+         l.pop_back();
+      assertUnit(l.node_count() == 0);
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+   }  // teardown
+
+   // every element is destroyed exactly once
+   void test_clear_spy()
+   {  // setup
+      custom::unrolled_list<Spy, 4> l;
+      for (int i = 0; i < 10; i++)
+         l.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 10);
+      assertUnit(Spy::numDelete() == 10);
+      assertUnit(l.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // walk back from the last element
+   void test_iterator_backwards()
+   {  // setup
+      custom::unrolled_list<int, 4> l;
+      for (int i = 0; i < 10; i++)
+         l.push_back(i);
+      // exercise
+      int expect = 9;
+      bool ok = true;
+      for (custom::unrolled_list<int, 4>::iterator it = l.rbegin(); it != l.end(); --it)
+         ok = ok && *it == expect--;
+      // verify
+      assertUnit(ok);
+      assertUnit(expect == -1);
+   }  // teardown
+
+   // find returns the first match or end
+   void test_find_standard()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 26, 49, 67, 89, 49 };
+      // exercise
+      custom::unrolled_list<int, 4>::iterator it = l.find(49);
+      // verify
+      assertUnit(it.p == l.pHead);
+      assertUnit(it.i == 1);
+      assertUnit(l.find(11) == l.end());
+   }  // teardown
+
+   // a long run of inserts and erases agrees with std::list
+   void test_random_matchesStdList()
+   {  // setup
+      custom::unrolled_list<int, 6> l;
+      std::list<int> expect;
+      unsigned seed = 89;
+      // exercise
+      for (int n = 0; n < 3000; n++)
+      {
+         seed = seed * 1103515245u + 12345u;
+         size_t pos = expect.empty() ? 0 : (seed >> 8) % (expect.size() + 1);
+         custom::unrolled_list<int, 6>::iterator it = l.begin();
+         std::list<int>::iterator jt = expect.begin();
+         for (size_t i = 0; i < pos; i++, ++it, ++jt)
+            ;
+         if ((seed >> 20) % 3 != 0 || jt == expect.end())
+         {
+            l.insert(it, n);
+            expect.insert(jt, n);
+         }
+         else
+         {
+            l.erase(it);
+            expect.erase(jt);
+         }
+      }
+      // verify
+      bool same = l.size() == expect.size();
+      custom::unrolled_list<int, 6>::iterator it = l.begin();
+      for (std::list<int>::iterator jt = expect.begin(); same && jt != expect.end(); ++jt, ++it)
+         same = *it == *jt;
+      assertUnit(same);
+      bool noneEmpty = true;
+      for (custom::unrolled_list<int, 6>::Node* p = l.pHead; p; p = p->pNext)
+         noneEmpty = noneEmpty && p->count > 0;
+      assertUnit(noneEmpty);
+   }  // teardown
+
+   /*************************************************************
+    * SEQUENCE
+    * Does the list hold first, first+1 ... last-1?
+    *************************************************************/
+   template <size_t K>
+   bool sequence(custom::unrolled_list<int, K>& l, int first, int last)
+   {
+      if (l.size() != (size_t)(last - first))
+         return false;
+      int expect = first;
+      for (typename custom::unrolled_list<int, K>::iterator it = l.begin(); it != l.end(); ++it)
+         if (*it != expect++)
+            return false;
+      return true;
+   }
+};
+
+#endif // DEBUG
@@ -100,6 +100,21 @@ public:
       test_reserve_fourTen();
       test_reserve_standardZero();
       test_reserve_standardTen();
+      test_growth_doubleFromEmpty();
+      test_growth_sizedFirstAllocation();
+      test_growth_sizedOneAndAHalf();
+      test_growth_sizeClass();
+      test_resizeForOverwrite_empty();
+      test_resizeForOverwrite_keepsExisting();
+      test_appendFrom_partial();
+      test_appendFrom_error();
+      test_stream_defaultThreshold();
+      test_stream_copyConstruct();
+      test_stream_assign();
+      test_stream_resizeFillShort();
+      test_stream_resizeFillOddSize();
+      test_stream_reserve();
+      test_stream_spyNotStreamed();
 
       // Remove
       test_popback_empty();
@@ -2709,6 +2724,271 @@ public:
       teardownStandardFixture(v);
    }
 
+   /***************************************
+    * GROWTH POLICY
+    ***************************************/
+
+   // the default policy starts at one and doubles
+   void test_growth_doubleFromEmpty()
+   {  // setup
+      custom::vector<int> v;
+      // exercise
+      v.push_back(1);
+      size_t first = v.numCapacity;
+      v.push_back(2);
+      v.push_back(3);
+      // verify
+      assertUnit(first == 1);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+   }  // teardown
+
+   // the sized policy allocates at least 64 bytes on the first push
+   void test_growth_sizedFirstAllocation()
+   {  // setup
+      custom::vector<int, std::allocator<int>, custom::sized_growth> v;
+      // exercise
+      v.push_back(26);
+      // verify
+      assertUnit(v.numCapacity == 64 / sizeof(int));
+      assertUnit(v.numElements == 1);
+      assertUnit(v.data != nullptr);
+      if (v.data)
+         assertUnit(v.data[0] == 26);
+   }  // teardown
+
+   // once full, the sized policy grows by half and keeps the elements
+   void test_growth_sizedOneAndAHalf()
+   {  // setup
+      custom::vector<Spy, std::allocator<Spy>, custom::sized_growth> v;
+      for (int i = 0; i < 40; i++)
+         v.push_back(Spy(i));
+      // exercise
+      v.shrink_to_fit();
+      size_t before = v.numCapacity;
+      v.push_back(Spy(99));
+      // verify
+      assertUnit(before == 40);
+      assertUnit(v.numCapacity >= 60);
+      assertUnit(v.numCapacity * sizeof(Spy) ==
+                 custom::sized_growth::size_class(v.numCapacity * sizeof(Spy)));
+      assertUnit(v.numElements == 41);
+      if (v.numElements == 41)
+      {
+         assertUnit(v.data[0] == Spy(0));
+         assertUnit(v.data[39] == Spy(39));
+         assertUnit(v.data[40] == Spy(99));
+      }
+   }  // teardown
+
+   // the size classes match what a malloc would round to
+   void test_growth_sizeClass()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(custom::sized_growth::size_class(1) == 16);
+      assertUnit(custom::sized_growth::size_class(64) == 64);
+      assertUnit(custom::sized_growth::size_class(100) == 112);
+      assertUnit(custom::sized_growth::size_class(129) == 160);
+      assertUnit(custom::sized_growth::size_class(256) == 256);
+      assertUnit(custom::sized_growth::size_class(257) == 320);
+      assertUnit(custom::sized_growth::size_class(5000) == 5120);
+   }  // teardown
+
+   /***************************************
+    * UNINITIALIZED GROWTH
+    ***************************************/
+
+   // grow an empty vector without constructing anything
+   void test_resizeForOverwrite_empty()
+   {  // setup
+      custom::vector<int> v;
+      // exercise
+      v.resize_for_overwrite(100);
+      // verify
+      assertUnit(v.numElements == 100);
+      assertUnit(v.numCapacity == 100);
+      assertUnit(v.data != nullptr);
+   }  // teardown
+
+   // growing keeps what was already there, shrinking just drops the end
+   void test_resizeForOverwrite_keepsExisting()
+   {  // setup
+      custom::vector<int> v{ 26, 49, 67, 89 };
+      // exercise
+      v.resize_for_overwrite(10);
+      v[9] = 99;
+      v.resize_for_overwrite(5);
+      // verify
+      assertUnit(v.numElements == 5);
+      assertUnit(v.numCapacity == 10);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[3] == 89);
+      }
+   }  // teardown
+
+   // the producer only fills part of what it was offered
+   void test_appendFrom_partial()
+   {  // setup
+      custom::vector<int> v{ 26, 49 };
+      // exercise
+      size_t n = v.append_from(8, [](int* p, size_t max)
+      {
+         for (size_t i = 0; i < 3; i++)
+            p[i] = 60 + (int)i;
+         return (size_t)3;
+      });
+      // verify
+      assertUnit(n == 3);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.numCapacity >= 10);
+      if (v.data && v.numElements == 5)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 49);
+         assertUnit(v.data[2] == 60);
+         assertUnit(v.data[4] == 62);
+      }
+   }  // teardown
+
+   // a negative return, like read() failing, appends nothing
+   void test_appendFrom_error()
+   {  // setup
+      custom::vector<char> v;
+      // exercise
+      size_t n = v.append_from(16, [](char* p, size_t max) { return -1; });
+      // verify
+      assertUnit(n == 0);
+      assertUnit(v.numElements == 0);
+      assertUnit(v.numCapacity >= 16);
+   }  // teardown
+
+   /***************************************
+    * STREAMING STORES
+    ***************************************/
+
+   // only really big buffers go around the cache
+   void test_stream_defaultThreshold()
+   {  // setup
+      // exercise
+      size_t bytes = custom::stream_threshold();
+      // verify
+      assertUnit(bytes >= 1024 * 1024);
+   }  // teardown
+
+   // an odd number of ints, so there is a head and a tail
+   void test_stream_copyConstruct()
+   {  // setup
+      size_t saved = custom::stream_threshold();
+      custom::stream_threshold(1);
+      custom::vector<int> src;
+      for (int i = 0; i < 1001; i++)
+         src.push_back(i * 3);
+      // exercise
+      custom::vector<int> dest(src);
+      custom::stream_threshold(saved);
+      // verify
+      assertUnit(dest.numElements == 1001);
+      bool same = true;
+      for (size_t i = 0; i < 1001; i++)
+         same = same && dest.data[i] == (int)i * 3;
+      assertUnit(same);
+   }  // teardown
+
+   // into a new buffer and into an old one
+   void test_stream_assign()
+   {  // setup
+      size_t saved = custom::stream_threshold();
+      custom::stream_threshold(1);
+      custom::vector<double> src(333, 2.5);
+      custom::vector<double> small{ 1.0 };
+      custom::vector<double> big(500, 9.0);
+      // exercise
+      small = src;
+      big = src;
+      custom::stream_threshold(saved);
+      // verify
+      assertUnit(small.numElements == 333);
+      assertUnit(big.numElements == 333);
+      assertUnit(big.numCapacity == 500);
+      assertUnit(small.data[332] == 2.5);
+      assertUnit(big.data[0] == 2.5);
+      assertUnit(big.data[332] == 2.5);
+   }  // teardown
+
+   // the fill starts two bytes past a 16 byte boundary
+   void test_stream_resizeFillShort()
+   {  // setup
+      size_t saved = custom::stream_threshold();
+      custom::stream_threshold(1);
+      custom::vector<short> v;
+      v.reserve(1000);
+      v.push_back(26);
+      // exercise
+      v.resize(999, 49);
+      custom::stream_threshold(saved);
+      // verify
+      assertUnit(v.numElements == 999);
+      bool filled = v.data[0] == 26;
+      for (size_t i = 1; i < 999; i++)
+         filled = filled && v.data[i] == 49;
+      assertUnit(filled);
+   }  // teardown
+
+   // three byte elements do not tile a register, so no streaming
+   void test_stream_resizeFillOddSize()
+   {  // setup
+      struct rgb { unsigned char r, g, b; };
+      size_t saved = custom::stream_threshold();
+      custom::stream_threshold(1);
+      custom::vector<rgb> v;
+      rgb gray = { 67, 67, 89 };
+      // exercise
+      v.resize(100, gray);
+      custom::stream_threshold(saved);
+      // verify
+      assertUnit(v.numElements == 100);
+      assertUnit(v.data[0].b == 89);
+      assertUnit(v.data[99].r == 67);
+   }  // teardown
+
+   // growing moves the old elements with streaming stores
+   void test_stream_reserve()
+   {  // setup
+      size_t saved = custom::stream_threshold();
+      custom::stream_threshold(1);
+      custom::vector<uint64_t> v;
+      for (uint64_t i = 0; i < 77; i++)
+         v.push_back(i);
+      // exercise
+      v.reserve(1000);
+      custom::stream_threshold(saved);
+      // verify
+      assertUnit(v.numCapacity == 1000);
+      assertUnit(v.numElements == 77);
+      assertUnit(v.data[0] == 0);
+      assertUnit(v.data[76] == 76);
+   }  // teardown
+
+   // a type with a copy constructor is always copied one at a time
+   void test_stream_spyNotStreamed()
+   {  // setup
+      size_t saved = custom::stream_threshold();
+      custom::stream_threshold(1);
+      custom::vector<Spy> src;
+      src.push_back(Spy(26));
+      src.push_back(Spy(49));
+      Spy::reset();
+      // exercise
+      custom::vector<Spy> dest(src);
+      custom::stream_threshold(saved);
+      // verify
+      assertUnit(Spy::numCopy() == 2);
+      assertUnit(dest.data[1] == Spy(49));
+   }  // teardown
+
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *      0    1    2    3
@@ -0,0 +1,183 @@
+/***********************************************************************
+ * Header:
+ *    THREAD POOL
+ * Summary:
+ *    A fixed set of worker threads for the parallel algorithms
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        thread_pool : workers pulling tasks off a shared queue
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>            // for size_t
+#include <atomic>             // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <deque>              // for std::deque
+#include <functional>         // for std::function
+#include <memory>             // for std::shared_ptr
+#include <mutex>              // for std::mutex
+#include <thread>             // for std::thread
+#include <vector>             // for std::vector
+
+class TestThreadPool; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************
+    * THREAD POOL
+    * Workers wait on a queue of tasks. The one thing
+    * the algorithms need is parallel_for(): run a body
+    * for every index and return when all are done.
+    ****************************************/
+   class thread_pool
+   {
+      friend class ::TestThreadPool; // give unit tests access to the privates
+   public:
+      //
+      // Construct
+      //
+      thread_pool(size_t numThreads = defaultThreads()) : stopping(false)
+      {
+         for (size_t i = 0; i < numThreads; i++)
+            workers.emplace_back([this]() { work(); });
+      }
+      ~thread_pool()
+      {
+         {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+         }
+         wake.notify_all();
+         for (auto& worker : workers)
+            worker.join();
+      }
+      thread_pool(const thread_pool&) = delete;
+      thread_pool& operator = (const thread_pool&) = delete;
+
+      // one pool for the whole program, sized to the machine
+      static thread_pool& instance()
+      {
+         static thread_pool pool;
+         return pool;
+      }
+
+      //
+      // Run
+      //
+      void submit(std::function<void()> task)
+      {
+         {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+         }
+         wake.notify_one();
+      }
+      template <class Body>
+      void parallel_for(size_t numTasks, const Body& body);
+
+      //
+      // Status
+      //
+      size_t size() const { return workers.size(); }
+
+   private:
+
+      static size_t defaultThreads()
+      {
+         size_t n = std::thread::hardware_concurrency();
+         return n > 1 ? n - 1 : 1;   // the caller is one of the threads
+      }
+
+      void work()
+      {
+         for (;;)
+         {
+            std::function<void()> task;
+            {
+               std::unique_lock<std::mutex> lock(mutex);
+               wake.wait(lock, [this]() { return stopping || !tasks.empty(); });
+               if (tasks.empty())
+                  return;
+               task = std::move(tasks.front());
+               tasks.pop_front();
+            }
+            task();
+         }
+      }
+
+      std::vector<std::thread> workers;           // the threads themselves
+      std::deque<std::function<void()>> tasks;    // work waiting for a thread
+      std::mutex mutex;                           // guards tasks and stopping
+      std::condition_variable wake;               // signalled on new work or shutdown
+      bool stopping;                              // the destructor has been called
+   };
+
+   /*****************************************
+    * THREAD POOL :: PARALLEL FOR
+    * Call body(i) for i in [0, numTasks). Helpers on
+    * the pool and the calling thread take indices from
+    * a shared counter, so the caller never sits idle
+    * and calling this from inside a task cannot
+    * deadlock. The state is shared so a helper that
+    * starts late finds nothing to do and leaves.
+    ****************************************/
+   template <class Body>
+   void thread_pool::parallel_for(size_t numTasks, const Body& body)
+   {
+      if (numTasks == 0)
+         return;
+      if (numTasks == 1 || workers.empty())
+      {
+         for (size_t i = 0; i < numTasks; i++)
+            body(i);
+         return;
+      }
+
+      struct State
+      {
+         std::atomic<size_t> next;
+         std::atomic<size_t> done;
+         std::mutex mutex;
+         std::condition_variable finished;
+      };
+      std::shared_ptr<State> state = std::make_shared<State>();
+      state->next = 0;
+      state->done = 0;
+
+      // the helpers only touch body while indices remain, and the caller
+      // does not return until every index has finished
+      const Body* pBody = &body;
+      auto drain = [state, pBody, numTasks]()
+      {
+         size_t i;
+         while ((i = state->next++) < numTasks)
+         {
+            (*pBody)(i);
+            if (++state->done == numTasks)
+            {
+               std::lock_guard<std::mutex> lock(state->mutex);
+               state->finished.notify_all();
+            }
+         }
+      };
+
+      size_t numHelpers = (numTasks - 1 < workers.size()) ? numTasks - 1 : workers.size();
+      for (size_t i = 0; i < numHelpers; i++)
+         submit(drain);
+      drain();
+
+      std::unique_lock<std::mutex> lock(state->mutex);
+      state->finished.wait(lock, [&]() { return state->done == numTasks; });
+   }
+
+} // namespace custom
@@ -27,6 +27,14 @@
 #include <string>    // for std::string
 #include <vector>    // for std::vector
 #include <map>       // for std::map
+#if defined(__unix__) || defined(__APPLE__)
+#include <cassert>   // for checking mkstemp
+#include <cstdlib>   // for mkstemp
+#include <fstream>   // for std::ifstream, std::ofstream
+#include <iterator>  // for std::istreambuf_iterator
+#include <sys/stat.h>// for stat
+#include <unistd.h>  // for close, unlink
+#endif
 
 
 class UnitTest
@@ -97,6 +105,47 @@ protected:
 
    }
    
+#if defined(__unix__) || defined(__APPLE__)
+   /*************************************************************
+    * TEMP PATH
+    * A name no other test is using, with nothing at it yet
+    *************************************************************/
+   std::string tempPath()
+   {
+      char path[] = "/tmp/unitTestXXXXXX";
+      int fd = mkstemp(path);
+      assert(fd >= 0);
+      close(fd);
+      unlink(path);
+      return path;
+   }
+
+   /*************************************************************
+    * FILE SIZE / READ FILE / WRITE FILE
+    * The bytes of a file a test made, to check or to damage.
+    * A missing file has size 0 and no bytes.
+    *************************************************************/
+   size_t fileSize(const std::string& path)
+   {
+      struct stat info;
+      if (stat(path.c_str(), &info) != 0)
+         return 0;
+      return (size_t)info.st_size;
+   }
+
+   std::string readFile(const std::string& path)
+   {
+      std::ifstream in(path, std::ios::binary);
+      return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+   }
+
+   void writeFile(const std::string& path, const std::string& bytes)
+   {
+      std::ofstream out(path, std::ios::binary | std::ios::trunc);
+      out.write(bytes.data(), bytes.size());
+   }
+#endif
+
    /*************************************************************
     * ASSERT UNIT PARAMETERS
     * Custom assert code so we can see all the errors at once
@@ -0,0 +1,466 @@
+/***********************************************************************
+ * Header:
+ *    UNROLLED LIST
+ * Summary:
+ *    A doubly linked list where each node holds up to K elements in
+ *    a small array. A walk through the list touches a node, and so a
+ *    cache miss and an allocation, once every K elements instead of
+ *    once per element.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        unrolled_list           : A list of small arrays
+ *        unrolled_list::iterator : An iterator through unrolled_list
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>          // because I am paranoid
+#include <cstddef>          // for size_t
+#include <memory>           // for std::allocator, std::allocator_traits
+#include <utility>          // for std::move
+#include <initializer_list> // for std::initializer_list
+
+class TestUnrolledList; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /**************************************************
+    * UNROLLED LIST
+    * The list API, but elements live K to a node.
+    * Inserting into a full node splits it in half, and
+    * erasing from a node that falls under half full
+    * pulls in its neighbour when both fit in one node,
+    * so nodes stay at least half full on average.
+    **************************************************/
+   template <typename T, size_t K = 16, typename A = std::allocator<T>>
+   class unrolled_list
+   {
+      friend class ::TestUnrolledList; // give unit tests access to the privates
+      static_assert(K >= 2, "a node must hold at least two elements to split");
+   public:
+
+      //
+      // Construct
+      //
+      unrolled_list(const A& a = A())
+         : alloc(a), nodeAlloc(a), numElements(0), numNodes(0), pHead(nullptr), pTail(nullptr) {}
+      unrolled_list(const std::initializer_list<T>& il, const A& a = A()) : unrolled_list(a)
+      {
+         for (const T& item : il)
+            push_back(item);
+      }
+      template <class Iterator>
+      unrolled_list(Iterator first, Iterator last, const A& a = A()) : unrolled_list(a)
+      {
+         for (Iterator it = first; it != last; ++it)
+            push_back(*it);
+      }
+      unrolled_list(const unrolled_list& rhs) : unrolled_list(rhs.alloc)
+      {
+         for (Node* p = rhs.pHead; p; p = p->pNext)
+            for (size_t i = 0; i < p->count; i++)
+               push_back(*p->at(i));
+      }
+      unrolled_list(unrolled_list&& rhs) : unrolled_list(rhs.alloc)
+      {
+         swap(rhs);
+      }
+      ~unrolled_list()
+      {
+         clear();
+      }
+
+      //
+      // Assign
+      //
+      unrolled_list& operator = (const unrolled_list& rhs)
+      {
+         if (this != &rhs)
+         {
+            unrolled_list copy(rhs);
+            swap(copy);
+         }
+         return *this;
+      }
+      unrolled_list& operator = (unrolled_list&& rhs)
+      {
+         clear();
+         swap(rhs);
+         return *this;
+      }
+      void swap(unrolled_list& rhs)
+      {
+         std::swap(numElements, rhs.numElements);
+         std::swap(numNodes, rhs.numNodes);
+         std::swap(pHead, rhs.pHead);
+         std::swap(pTail, rhs.pTail);
+      }
+
+      //
+      // Iterator
+      //
+      class iterator;
+      iterator begin()  { return iterator(pHead, 0); }
+      iterator rbegin() { return pTail ? iterator(pTail, pTail->count - 1) : end(); }
+      iterator end()    { return iterator(nullptr, 0); }
+
+      //
+      // Access
+      //
+      T& front() { assert(pHead); return *pHead->at(0); }
+      T& back()  { assert(pTail); return *pTail->at(pTail->count - 1); }
+      iterator find(const T& value);
+
+      //
+      // Insert
+      //
+      void push_front(const T& data) { T copy(data); push_front(std::move(copy)); }
+      void push_front(T&& data);
+      void push_back(const T& data)  { T copy(data); push_back(std::move(copy)); }
+      void push_back(T&& data);
+      iterator insert(iterator it, const T& data) { T copy(data); return insert(it, std::move(copy)); }
+      iterator insert(iterator it, T&& data);
+
+      //
+      // Remove
+      //
+      void pop_back()  { if (pTail) erase(rbegin()); }
+      void pop_front() { if (pHead) erase(begin()); }
+      void clear();
+      iterator erase(const iterator& it);
+
+      //
+      // Status
+      //
+      bool empty()       const { return numElements == 0; }
+      size_t size()      const { return numElements; }
+      size_t node_count() const { return numNodes; }
+
+   private:
+
+      /**************************************************
+       * NODE
+       * Up to K elements in raw storage; only the first
+       * count of them are constructed
+       **************************************************/
+      struct Node
+      {
+         alignas(T) unsigned char buffer[K * sizeof(T)];
+         size_t count;
+         Node* pPrev;
+         Node* pNext;
+
+         T* at(size_t i) { return (T*)buffer + i; }
+      };
+      typedef typename std::allocator_traits<A>::template rebind_alloc<Node> NodeAlloc;
+
+      Node* newNode(Node* pPrev, Node* pNext);
+      void deleteNode(Node* p);
+      void openGap(Node* p, size_t i);
+      void closeGap(Node* p, size_t i);
+      Node* split(Node* p);
+
+      A         alloc;        // constructs and destroys the elements
+      NodeAlloc nodeAlloc;    // allocates the nodes
+      size_t numElements;     // the number of elements in all the nodes
+      size_t numNodes;        // the number of nodes
+      Node* pHead;            // the first node
+      Node* pTail;            // the last node
+   };
+
+   /*************************************************
+    * UNROLLED LIST ITERATOR
+    * A node and a slot in it
+    ************************************************/
+   template <typename T, size_t K, typename A>
+   class unrolled_list <T, K, A> ::iterator
+   {
+      friend class ::TestUnrolledList; // give unit tests access to the privates
+      template <typename TT, size_t KK, typename AA>
+      friend class custom::unrolled_list;
+   public:
+      // constructors, destructors, and assignment operator
+      iterator() : p(nullptr), i(0) {}
+      iterator(Node* p, size_t i) : p(p), i(i) {}
+      iterator(const iterator& rhs) : p(rhs.p), i(rhs.i) {}
+      iterator& operator = (const iterator& rhs)
+      {
+         p = rhs.p;
+         i = rhs.i;
+         return *this;
+      }
+
+      // equals, not equals operator
+      bool operator == (const iterator& rhs) const { return p == rhs.p && i == rhs.i; }
+      bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+
+      // dereference operator
+      T& operator * () { return *p->at(i); }
+
+      // increment and decrement, stepping node to node at the edges
+      iterator& operator ++ ()
+      {
+         if (++i == p->count)
+         {
+            p = p->pNext;
+            i = 0;
+         }
+         return *this;
+      }
+      iterator operator ++ (int) { iterator tmp = *this; ++(*this); return tmp; }
+      iterator& operator -- ()
+      {
+         if (i == 0)
+         {
+            p = p->pPrev;
+            i = p ? p->count - 1 : 0;
+         }
+         else
+            --i;
+         return *this;
+      }
+      iterator operator -- (int) { iterator tmp = *this; --(*this); return tmp; }
+
+   private:
+      Node* p;     // the node, nullptr at the end
+      size_t i;    // the slot within the node
+   };
+
+   /*****************************************
+    * UNROLLED LIST :: NEW NODE / DELETE NODE
+    * Link an empty node between two others, or
+    * unlink and free one whose elements are gone
+    ****************************************/
+   template <typename T, size_t K, typename A>
+   typename unrolled_list <T, K, A> ::Node* unrolled_list <T, K, A> ::newNode(Node* pPrev, Node* pNext)
+   {
+      Node* p = nodeAlloc.allocate(1);
+      p->count = 0;
+      p->pPrev = pPrev;
+      p->pNext = pNext;
+      if (pPrev)
+         pPrev->pNext = p;
+      else
+         pHead = p;
+      if (pNext)
+         pNext->pPrev = p;
+      else
+         pTail = p;
+      numNodes++;
+      return p;
+   }
+
+   template <typename T, size_t K, typename A>
+   void unrolled_list <T, K, A> ::deleteNode(Node* p)
+   {
+      assert(p->count == 0);
+      if (p->pPrev)
+         p->pPrev->pNext = p->pNext;
+      else
+         pHead = p->pNext;
+      if (p->pNext)
+         p->pNext->pPrev = p->pPrev;
+      else
+         pTail = p->pPrev;
+      nodeAlloc.deallocate(p, 1);
+      numNodes--;
+   }
+
+   /*****************************************
+    * UNROLLED LIST :: OPEN GAP / CLOSE GAP
+    * Slide the elements after slot i right by one to
+    * leave slot i unconstructed, or left by one to fill
+    * the hole left by a destroyed slot i
+    ****************************************/
+   template <typename T, size_t K, typename A>
+   void unrolled_list <T, K, A> ::openGap(Node* p, size_t i)
+   {
+      assert(p->count < K);
+      for (size_t j = p->count; j > i; j--)
+      {
+         alloc.construct(p->at(j), std::move(*p->at(j - 1)));
+         alloc.destroy(p->at(j - 1));
+      }
+   }
+
+   template <typename T, size_t K, typename A>
+   void unrolled_list <T, K, A> ::closeGap(Node* p, size_t i)
+   {
+      for (size_t j = i; j + 1 < p->count; j++)
+      {
+         alloc.construct(p->at(j), std::move(*p->at(j + 1)));
+         alloc.destroy(p->at(j + 1));
+      }
+   }
+
+   /*****************************************
+    * UNROLLED LIST :: SPLIT
+    * Move the upper half of a full node into a new
+    * node right after it
+    *     OUTPUT : the new node
+    ****************************************/
+   template <typename T, size_t K, typename A>
+   typename unrolled_list <T, K, A> ::Node* unrolled_list <T, K, A> ::split(Node* p)
+   {
+      Node* pNew = newNode(p, p->pNext);
+      size_t keep = p->count / 2;
+      for (size_t j = keep; j < p->count; j++)
+      {
+         alloc.construct(pNew->at(j - keep), std::move(*p->at(j)));
+         alloc.destroy(p->at(j));
+      }
+      pNew->count = p->count - keep;
+      p->count = keep;
+      return pNew;
+   }
+
+   /*****************************************
+    * UNROLLED LIST :: PUSH BACK / PUSH FRONT
+    * Use the room in the end node, or start a new
+    * one. A full node is never split here, so a list
+    * built by pushing is packed K to a node.
+    ****************************************/
+   template <typename T, size_t K, typename A>
+   void unrolled_list <T, K, A> ::push_back(T&& data)
+   {
+      if (pTail == nullptr || pTail->count == K)
+         newNode(pTail, nullptr);
+      alloc.construct(pTail->at(pTail->count), std::move(data));
+      pTail->count++;
+      numElements++;
+   }
+
+   template <typename T, size_t K, typename A>
+   void unrolled_list <T, K, A> ::push_front(T&& data)
+   {
+      if (pHead == nullptr || pHead->count == K)
+         newNode(nullptr, pHead);
+      openGap(pHead, 0);
+      alloc.construct(pHead->at(0), std::move(data));
+      pHead->count++;
+      numElements++;
+   }
+
+   /*****************************************
+    * UNROLLED LIST :: INSERT
+    * Put data in front of it, splitting the node
+    * first if it is full
+    *     OUTPUT : an iterator to the new element
+    ****************************************/
+   template <typename T, size_t K, typename A>
+   typename unrolled_list <T, K, A> ::iterator unrolled_list <T, K, A> ::insert(iterator it, T&& data)
+   {
+      if (it.p == nullptr)
+      {
+         push_back(std::move(data));
+         return rbegin();
+      }
+
+      Node* p = it.p;
+      size_t i = it.i;
+      if (p->count == K)
+      {
+         Node* pNew = split(p);
+         if (i > p->count)
+         {
+            i -= p->count;
+            p = pNew;
+         }
+      }
+      openGap(p, i);
+      alloc.construct(p->at(i), std::move(data));
+      p->count++;
+      numElements++;
+      return iterator(p, i);
+   }
+
+   /*****************************************
+    * UNROLLED LIST :: ERASE
+    * Remove one element. A node left empty goes away;
+    * a node left under half full takes in the next
+    * node when they fit together.
+    *     OUTPUT : an iterator to the element after it
+    ****************************************/
+   template <typename T, size_t K, typename A>
+   typename unrolled_list <T, K, A> ::iterator unrolled_list <T, K, A> ::erase(const iterator& it)
+   {
+      Node* p = it.p;
+      size_t i = it.i;
+      if (p == nullptr)
+         return end();
+
+      alloc.destroy(p->at(i));
+      closeGap(p, i);
+      p->count--;
+      numElements--;
+
+      if (p->count == 0)
+      {
+         Node* pNext = p->pNext;
+         deleteNode(p);
+         return iterator(pNext, 0);
+      }
+
+      Node* pNext = p->pNext;
+      if (p->count < K / 2 && pNext && p->count + pNext->count <= K)
+      {
+         for (size_t j = 0; j < pNext->count; j++)
+         {
+            alloc.construct(p->at(p->count + j), std::move(*pNext->at(j)));
+            alloc.destroy(pNext->at(j));
+         }
+         p->count += pNext->count;
+         pNext->count = 0;
+         deleteNode(pNext);
+      }
+
+      if (i < p->count)
+         return iterator(p, i);
+      return iterator(p->pNext, 0);
+   }
+
+   /*****************************************
+    * UNROLLED LIST :: CLEAR
+    * Destroy every element and free every node
+    ****************************************/
+   template <typename T, size_t K, typename A>
+   void unrolled_list <T, K, A> ::clear()
+   {
+      Node* p = pHead;
+      while (p)
+      {
+         Node* pNext = p->pNext;
+         for (size_t i = 0; i < p->count; i++)
+            alloc.destroy(p->at(i));
+         nodeAlloc.deallocate(p, 1);
+         p = pNext;
+      }
+      pHead = pTail = nullptr;
+      numElements = 0;
+      numNodes = 0;
+   }
+
+   /*****************************************
+    * UNROLLED LIST :: FIND
+    * Linear search, a node's worth at a time
+    ****************************************/
+   template <typename T, size_t K, typename A>
+   typename unrolled_list <T, K, A> ::iterator unrolled_list <T, K, A> ::find(const T& value)
+   {
+      for (Node* p = pHead; p; p = p->pNext)
+         for (size_t i = 0; i < p->count; i++)
+            if (*p->at(i) == value)
+               return iterator(p, i);
+      return end();
+   }
+
+} // namespace custom
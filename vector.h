@@ -24,6 +24,15 @@
 #include <new>      // std::bad_alloc
 #include <memory>   // for std::allocator
 #include <initializer_list> // for std::initializer
+#include <algorithm>        // for std::max
+#include <type_traits>      // for std::is_trivially_default_constructible
+#include <cstdint>          // for uintptr_t
+#include <cstring>          // for std::memcpy
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>      // for _mm_stream_si128, _mm_sfence
+#define CUSTOM_STREAM_SSE2 1
+#endif
 
 class TestVector; // forward declaration for unit tests
 class TestStack;
@@ -33,11 +42,149 @@ class TestHash;
 namespace custom
 {
 
+   /*****************************************
+    * DOUBLE GROWTH
+    * The classic growth policy: start with one
+    * element and double every time we run out.
+    ****************************************/
+   struct double_growth
+   {
+      static size_t next(size_t capacity, size_t required, size_t /*elementSize*/)
+      {
+         size_t grow = (capacity == 0) ? 1 : capacity * 2;
+         return std::max(grow, required);
+      }
+   };
+
+   /*****************************************
+    * SIZED GROWTH
+    * Grow by 1.5x, never allocate less than 64 bytes
+    * the first time, and round every request up to the
+    * size class the allocator would hand back anyway.
+    * Small vectors reallocate less often and big ones
+    * carry less unused slack than with doubling.
+    ****************************************/
+   struct sized_growth
+   {
+      static const size_t minBytes = 64;
+
+      static size_t next(size_t capacity, size_t required, size_t elementSize)
+      {
+         size_t grow = capacity + capacity / 2;
+         size_t first = (minBytes + elementSize - 1) / elementSize;
+         size_t num = std::max(std::max(grow, required), first);
+         return size_class(num * elementSize) / elementSize;
+      }
+
+      // Malloc-style size classes: 16 byte steps up to 128 bytes,
+      // then four classes for every doubling after that
+      static size_t size_class(size_t bytes)
+      {
+         if (bytes <= 128)
+            return (bytes + 15) & ~size_t(15);
+         size_t power = 128;
+         while (power * 2 < bytes)
+            power *= 2;
+         size_t step = power / 4;
+         return (bytes + step - 1) / step * step;
+      }
+   };
+
+   namespace stream_detail
+   {
+      inline size_t& threshold()
+      {
+         static size_t bytes = (size_t)8 * 1024 * 1024;
+         return bytes;
+      }
+
+      /*****************************************
+       * STREAM COPY
+       * memcpy with non-temporal stores: plain stores up
+       * to a 16 byte boundary, streaming stores for the
+       * body, plain stores for the tail, then a fence so
+       * the streamed data is visible to other threads.
+       ****************************************/
+      inline void copy(void* dst, const void* src, size_t bytes)
+      {
+         unsigned char* d = (unsigned char*)dst;
+         const unsigned char* s = (const unsigned char*)src;
+#ifdef CUSTOM_STREAM_SSE2
+         size_t head = (16 - ((uintptr_t)d & 15)) & 15;
+         if (head > bytes)
+            head = bytes;
+         std::memcpy(d, s, head);
+         d += head;
+         s += head;
+         bytes -= head;
+         for (; bytes >= 64; bytes -= 64, d += 64, s += 64)
+         {
+            _mm_stream_si128((__m128i*)(d +  0), _mm_loadu_si128((const __m128i*)(s +  0)));
+            _mm_stream_si128((__m128i*)(d + 16), _mm_loadu_si128((const __m128i*)(s + 16)));
+            _mm_stream_si128((__m128i*)(d + 32), _mm_loadu_si128((const __m128i*)(s + 32)));
+            _mm_stream_si128((__m128i*)(d + 48), _mm_loadu_si128((const __m128i*)(s + 48)));
+         }
+         for (; bytes >= 16; bytes -= 16, d += 16, s += 16)
+            _mm_stream_si128((__m128i*)d, _mm_loadu_si128((const __m128i*)s));
+         _mm_sfence();
+#endif
+         std::memcpy(d, s, bytes);
+      }
+
+      /*****************************************
+       * STREAM FILL
+       * num copies of a size byte value with streaming
+       * stores. Only sizes that tile 16 bytes evenly can
+       * be streamed; anything else is copied normally.
+       ****************************************/
+      inline void fill(void* dst, const void* value, size_t size, size_t num)
+      {
+         unsigned char* d = (unsigned char*)dst;
+#ifdef CUSTOM_STREAM_SSE2
+         if (16 % size == 0 && (uintptr_t)d % size == 0)
+         {
+            for (; num > 0 && ((uintptr_t)d & 15) != 0; num--, d += size)
+               std::memcpy(d, value, size);
+
+            alignas(16) unsigned char pattern[16];
+            for (size_t i = 0; i < 16; i += size)
+               std::memcpy(pattern + i, value, size);
+            __m128i v = _mm_load_si128((const __m128i*)pattern);
+            size_t perStore = 16 / size;
+            for (; num >= perStore; num -= perStore, d += 16)
+               _mm_stream_si128((__m128i*)d, v);
+            _mm_sfence();
+         }
+#endif
+         for (; num > 0; num--, d += size)
+            std::memcpy(d, value, size);
+      }
+   } // namespace stream_detail
+
+   /*****************************************
+    * STREAM THRESHOLD
+    * Copies and fills of trivially copyable elements
+    * at least this many bytes long bypass the cache.
+    * Anything this big would not fit in the last level
+    * cache anyway, and normal stores would evict
+    * everything else on the way through. The default
+    * is 8 MiB.
+    ****************************************/
+   inline size_t stream_threshold()
+   {
+      return stream_detail::threshold();
+   }
+   inline void stream_threshold(size_t bytes)
+   {
+      stream_detail::threshold() = bytes;
+   }
+
    /*****************************************
     * VECTOR
-    * Just like the std :: vector <T> class
+    * Just like the std :: vector <T> class. G is the
+    * growth policy push_back() uses when full.
     ****************************************/
-   template <typename T, typename A = std::allocator<T>>
+   template <typename T, typename A = std::allocator<T>, typename G = double_growth>
    class vector
    {
       friend class ::TestVector; // give unit tests access to the privates
@@ -95,6 +242,9 @@ namespace custom
       void reserve(size_t newCapacity);
       void resize(size_t newElements);
       void resize(size_t newElements, const T& t);
+      void resize_for_overwrite(size_t newElements);
+      template <class Producer>
+      size_t append_from(size_t maxElements, Producer produce);
 
       //
       // Remove
@@ -129,6 +279,12 @@ namespace custom
 
    private:
 
+      // should copying or filling num elements go around the cache?
+      static bool streams(size_t num)
+      {
+         return std::is_trivially_copyable<T>::value && num * sizeof(T) >= stream_threshold();
+      }
+
       A    alloc;                // use allocator for memory allocation
       T* data;                 // user data, a dynamically-allocated array
       size_t  numCapacity;       // the capacity of the array
@@ -146,8 +302,8 @@ namespace custom
     * This particular iterator is a bi-directional meaning
     * that ++ and -- both work.  Not all iterators are that way.
     *************************************************/
-   template <typename T, typename A>
-   class vector <T, A> ::iterator
+   template <typename T, typename A, typename G>
+   class vector <T, A, G> ::iterator
    {
       friend class ::TestVector; // give unit tests access to the privates
       friend class ::TestStack;
@@ -158,7 +314,7 @@ namespace custom
       iterator() : p(nullptr) {  }
       iterator(T* p) : p(p) {  }
       iterator(const iterator& rhs) : p(rhs.p) {  }
-      iterator(size_t index, vector<T>& v) : p(&v.data[index]) {  }
+      iterator(size_t index, vector<T, A, G>& v) : p(&v.data[index]) {  }
       iterator& operator = (const iterator& rhs)
       {
          if (this != &rhs)
@@ -214,8 +370,8 @@ namespace custom
     * non-default constructor: set the number of elements,
     * construct each element, and copy the values over
     ****************************************/
-   template <typename T, typename A>                                             // bob
-   vector <T, A> ::vector(const A& a)
+   template <typename T, typename A, typename G>                                             // bob
+   vector <T, A, G> ::vector(const A& a)
    {
       data = nullptr;
       numElements = 0;
@@ -228,8 +384,8 @@ namespace custom
     * non-default constructor: set the number of elements,
     * construct each element, and copy the values over
     ****************************************/
-   template <typename T, typename A>                                             // joe
-   vector <T, A> ::vector(size_t num, const T& t, const A& a)
+   template <typename T, typename A, typename G>                                             // joe
+   vector <T, A, G> ::vector(size_t num, const T& t, const A& a)
    {
       if (num > 0)
       {
@@ -248,8 +404,8 @@ namespace custom
     * VECTOR :: INITIALIZATION LIST constructors
     * Create a vector with an initialization list.
     ****************************************/
-   template <typename T, typename A>
-   vector <T, A> ::vector(const std::initializer_list<T>& l, const A& a)      // moe
+   template <typename T, typename A, typename G>
+   vector <T, A, G> ::vector(const std::initializer_list<T>& l, const A& a)      // moe
       : numElements(l.size()), numCapacity(l.size())
    {
       if (numElements > 0)
@@ -265,8 +421,8 @@ namespace custom
     * non-default constructor: set the number of elements,
     * construct each element, and copy the values over
     ****************************************/
-   template <typename T, typename A>                                             // billy
-   vector <T, A> ::vector(size_t num, const A& a)
+   template <typename T, typename A, typename G>                                             // billy
+   vector <T, A, G> ::vector(size_t num, const A& a)
    {
       if (num > 0)
       {
@@ -289,16 +445,19 @@ namespace custom
     * Allocate the space for numElements and
     * call the copy constructor on each element
     ****************************************/
-   template <typename T, typename A>
-   vector <T, A> ::vector(const vector& rhs)                                  // jr
+   template <typename T, typename A, typename G>
+   vector <T, A, G> ::vector(const vector& rhs)                                  // jr
    {
       if (rhs.numCapacity > 0)
       {
          data = alloc.allocate(rhs.numElements);
          numElements = rhs.numElements;
          numCapacity = rhs.numElements;
-         for (size_t i = 0; i < rhs.numElements; i++)
-            alloc.construct(&data[i], rhs.data[i]);
+         if (streams(rhs.numElements))
+            stream_detail::copy(data, rhs.data, rhs.numElements * sizeof(T));
+         else
+            for (size_t i = 0; i < rhs.numElements; i++)
+               alloc.construct(&data[i], rhs.data[i]);
       }
       else
       {
@@ -313,8 +472,8 @@ namespace custom
     * VECTOR :: MOVE CONSTRUCTOR
     * Steal the values from the RHS and set it to zero.
     ****************************************/
-   template <typename T, typename A>
-   vector <T, A> ::vector(vector&& rhs)                                      // guss
+   template <typename T, typename A, typename G>
+   vector <T, A, G> ::vector(vector&& rhs)                                      // guss
    {
       data = rhs.data;
       rhs.data = nullptr;
@@ -329,8 +488,8 @@ namespace custom
     * Call the destructor for each element from 0..numElements
     * and then free the memory
     ****************************************/
-   template <typename T, typename A>
-   vector <T, A> :: ~vector()
+   template <typename T, typename A, typename G>
+   vector <T, A, G> :: ~vector()
    {
       if (data != nullptr)
       {
@@ -347,8 +506,8 @@ namespace custom
     *     INPUT  : newCapacity the size of the new buffer
     *     OUTPUT :
     **************************************/
-   template <typename T, typename A>
-   void vector <T, A> ::resize(size_t newElements)
+   template <typename T, typename A, typename G>
+   void vector <T, A, G> ::resize(size_t newElements)
    {
       // If capacity is the same, do nothing.
       if (newElements == numElements) {
@@ -376,8 +535,8 @@ namespace custom
       numElements = newElements;
    }
 
-   template <typename T, typename A>
-   void vector <T, A> ::resize(size_t newElements, const T& t)
+   template <typename T, typename A, typename G>
+   void vector <T, A, G> ::resize(size_t newElements, const T& t)
    {
       // If capacity is the same, do nothing.
       if (newElements == numElements) {
@@ -399,12 +558,65 @@ namespace custom
       }
 
       // Construct new elements (copy of t)
-      for (size_t i = numElements; i < newElements; i++) {
-         alloc.construct(data + i, t);
+      if (streams(newElements - numElements)) {
+         stream_detail::fill(data + numElements, &t, sizeof(T), newElements - numElements);
+      }
+      else {
+         for (size_t i = numElements; i < newElements; i++) {
+            alloc.construct(data + i, t);
+         }
       }
       numElements = newElements;
    }
 
+   /***************************************
+    * VECTOR :: RESIZE FOR OVERWRITE
+    * Like resize(), but new elements are left
+    * uninitialized because the caller is about to
+    * write over them (from read() or a decoder).
+    * This saves a full pass over the buffer.
+    *     INPUT  : newElements the new size
+    **************************************/
+   template <typename T, typename A, typename G>
+   void vector <T, A, G> ::resize_for_overwrite(size_t newElements)
+   {
+      static_assert(std::is_trivially_default_constructible<T>::value &&
+                    std::is_trivially_destructible<T>::value,
+                    "resize_for_overwrite needs a trivial T");
+      if (newElements > numCapacity)
+         reserve(newElements);
+      numElements = newElements;
+   }
+
+   /***************************************
+    * VECTOR :: APPEND FROM
+    * Make room for maxElements more and let produce()
+    * write straight into the spare capacity. produce is
+    * called as produce(T* dest, size_t max) and returns
+    * how many it wrote; zero or a negative value (as
+    * read() gives on error) appends nothing.
+    *     INPUT  : maxElements the most produce() may write
+    *              produce     the callable filling the buffer
+    *     OUTPUT : the number of elements appended
+    **************************************/
+   template <typename T, typename A, typename G>
+   template <class Producer>
+   size_t vector <T, A, G> ::append_from(size_t maxElements, Producer produce)
+   {
+      static_assert(std::is_trivially_default_constructible<T>::value &&
+                    std::is_trivially_destructible<T>::value,
+                    "append_from needs a trivial T");
+      if (numElements + maxElements > numCapacity)
+         reserve(G::next(numCapacity, numElements + maxElements, sizeof(T)));
+
+      auto written = produce(data + numElements, maxElements);
+      if (written <= 0)
+         return 0;
+      assert((size_t)written <= maxElements);
+      numElements += (size_t)written;
+      return (size_t)written;
+   }
+
    /***************************************
     * VECTOR :: RESERVE
     * This method will grow the current buffer
@@ -413,8 +625,8 @@ namespace custom
     *     INPUT  : newCapacity the size of the new buffer
     *     OUTPUT :
     **************************************/
-   template <typename T, typename A>
-   void vector <T, A> ::reserve(size_t newCapacity)
+   template <typename T, typename A, typename G>
+   void vector <T, A, G> ::reserve(size_t newCapacity)
    {
       if (newCapacity <= numCapacity) {
          return;
@@ -423,8 +635,13 @@ namespace custom
       T* dataNew = alloc.allocate(newCapacity);
 
       // move old elements to new array
-      for (size_t i = 0; i < numElements; i++) {
-         new ((void*)(dataNew + i)) T(std::move(data[i]));
+      if (streams(numElements)) {
+         stream_detail::copy(dataNew, data, numElements * sizeof(T));
+      }
+      else {
+         for (size_t i = 0; i < numElements; i++) {
+            new ((void*)(dataNew + i)) T(std::move(data[i]));
+         }
       }
 
       for (size_t i = 0; i < numElements; i++) {
@@ -443,8 +660,8 @@ namespace custom
     *     INPUT  :
     *     OUTPUT :
     **************************************/
-   template <typename T, typename A>
-   void vector <T, A> ::shrink_to_fit()
+   template <typename T, typename A, typename G>
+   void vector <T, A, G> ::shrink_to_fit()
    {
       if (numElements == numCapacity)
          return;
@@ -485,8 +702,8 @@ namespace custom
     * VECTOR :: SUBSCRIPT
     * Read-Write access
     ****************************************/
-   template <typename T, typename A>
-   T& vector <T, A> :: operator [] (size_t index)
+   template <typename T, typename A, typename G>
+   T& vector <T, A, G> :: operator [] (size_t index)
    {
       return data[index];
 
@@ -496,8 +713,8 @@ namespace custom
     * VECTOR :: SUBSCRIPT
     * Read-Write access
     *****************************************/
-   template <typename T, typename A>
-   const T& vector <T, A> :: operator [] (size_t index) const
+   template <typename T, typename A, typename G>
+   const T& vector <T, A, G> :: operator [] (size_t index) const
    {
       return data[index];
    }
@@ -506,8 +723,8 @@ namespace custom
     * VECTOR :: FRONT
     * Read-Write access
     ****************************************/
-   template <typename T, typename A>
-   T& vector <T, A> ::front()
+   template <typename T, typename A, typename G>
+   T& vector <T, A, G> ::front()
    {
       return data[0];
    }
@@ -516,8 +733,8 @@ namespace custom
     * VECTOR :: FRONT
     * Read-Write access
     *****************************************/
-   template <typename T, typename A>
-   const T& vector <T, A> ::front() const
+   template <typename T, typename A, typename G>
+   const T& vector <T, A, G> ::front() const
    {
       return data[0];
    }
@@ -526,8 +743,8 @@ namespace custom
     * VECTOR :: FRONT
     * Read-Write access
     ****************************************/
-   template <typename T, typename A>
-   T& vector <T, A> ::back()
+   template <typename T, typename A, typename G>
+   T& vector <T, A, G> ::back()
    {
       return data[numElements - 1];
    }
@@ -536,8 +753,8 @@ namespace custom
     * VECTOR :: FRONT
     * Read-Write access
     *****************************************/
-   template <typename T, typename A>
-   const T& vector <T, A> ::back() const
+   template <typename T, typename A, typename G>
+   const T& vector <T, A, G> ::back() const
    {
       return data[numElements - 1];
    }
@@ -546,33 +763,28 @@ namespace custom
     * VECTOR :: PUSH BACK
     * This method will add the element 't' to the
     * end of the current buffer.  It will also grow
-    * the buffer as needed to accomodate the new element
+    * the buffer as needed to accomodate the new element,
+    * sized by the growth policy G
     *     INPUT  : 't' the new element to be added
     *     OUTPUT : *this
     **************************************/
-   template <typename T, typename A>
-   void vector <T, A> ::push_back(const T& t)
+   template <typename T, typename A, typename G>
+   void vector <T, A, G> ::push_back(const T& t)
    {
-      if (size() == 0) {
-         reserve(1);
-      }
-      // Vector is at capacity: double capacity
+      // Vector is at capacity: ask the growth policy how big to go
       if (size() == capacity()) {
-         reserve(capacity() * 2);
+         reserve(G::next(capacity(), size() + 1, sizeof(T)));
       }
       // Add t to end of current values and increment numElements
       alloc.construct(data + numElements++, t);
    }
 
-   template <typename T, typename A>
-   void vector <T, A> ::push_back(T&& t)
+   template <typename T, typename A, typename G>
+   void vector <T, A, G> ::push_back(T&& t)
    {
-      if (size() == 0) {
-         reserve(1);
-      }
-      // Vector is at capacity: double capacity
+      // Vector is at capacity: ask the growth policy how big to go
       if (size() == capacity()) {
-         reserve(capacity() * 2);
+         reserve(G::next(capacity(), size() + 1, sizeof(T)));
       }
       // Move t to end of current values and increment numElements
       alloc.construct(data + numElements++, std::move(t));
@@ -585,8 +797,8 @@ namespace custom
     *     INPUT  : rhs the vector to swap with
     *     OUTPUT : *this
     **************************************/
-   template <typename T, typename A>
-   void vector <T, A> ::swap(vector& rhs)
+   template <typename T, typename A, typename G>
+   void vector <T, A, G> ::swap(vector& rhs)
    {
       // Swap data pointers
       T* tempData = data;
@@ -612,8 +824,8 @@ namespace custom
     *     INPUT  : rhs the vector to copy from
     *     OUTPUT : *this
     **************************************/
-   template <typename T, typename A>
-   vector <T, A>& vector <T, A> :: operator = (const vector& rhs)
+   template <typename T, typename A, typename G>
+   vector <T, A, G>& vector <T, A, G> :: operator = (const vector& rhs)
    {
       if (this != &rhs)
       {
@@ -624,8 +836,11 @@ namespace custom
             T* newData = alloc.allocate(rhs.numElements);
 
             // Copy elements from rhs to newData
-            for (size_t i = 0; i < rhs.numElements; ++i)
-               alloc.construct(&newData[i], rhs.data[i]);
+            if (streams(rhs.numElements))
+               stream_detail::copy(newData, rhs.data, rhs.numElements * sizeof(T));
+            else
+               for (size_t i = 0; i < rhs.numElements; ++i)
+                  alloc.construct(&newData[i], rhs.data[i]);
 
             // Destroy existing elements
             for (size_t i = 0; i < numElements; ++i)
@@ -639,13 +854,16 @@ namespace custom
          else
          {
             // Copy elements from rhs to existing data
-            for (size_t i = 0; i < rhs.numElements; ++i)
-            {
-               if (i < numElements)
-                  data[i] = rhs.data[i];
-               else
-                  alloc.construct(&data[i], rhs.data[i]);
-            }
+            if (streams(rhs.numElements))
+               stream_detail::copy(data, rhs.data, rhs.numElements * sizeof(T));
+            else
+               for (size_t i = 0; i < rhs.numElements; ++i)
+               {
+                  if (i < numElements)
+                     data[i] = rhs.data[i];
+                  else
+                     alloc.construct(&data[i], rhs.data[i]);
+               }
 
             // Destroy any remaining elements in the destination
             for (size_t i = rhs.numElements; i < numElements; ++i)
@@ -657,8 +875,8 @@ namespace custom
       }
       return *this;
    }
-   template <typename T, typename A>
-   vector <T, A>& vector <T, A> :: operator = (vector&& rhs)
+   template <typename T, typename A, typename G>
+   vector <T, A, G>& vector <T, A, G> :: operator = (vector&& rhs)
    {
       if (this != &rhs)
       {